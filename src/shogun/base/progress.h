@@ -36,6 +36,8 @@
 #ifndef __SG_PROGRESS_H__
 #define __SG_PROGRESS_H__
 
+#include <atomic>
+#include <chrono>
 #include <functional>
 #include <iterator>
 #include <memory>
@@ -45,6 +47,7 @@
 #include <shogun/base/range.h>
 #include <shogun/io/SGIO.h>
 #include <shogun/lib/Lock.h>
+#include <shogun/lib/Signal.h>
 #include <shogun/lib/Time.h>
 #include <shogun/mathematics/Math.h>
 
@@ -65,6 +68,16 @@ namespace shogun
 
 #define SG_SPROGRESS(...) progress(__FUNCTION__, __VA_ARGS__)
 
+	/** Minimum interval in milliseconds between two redraws of the
+	 * progress bar of a @ref ProgressPrinter
+	 */
+	static const int32_t PROGRESS_TICK_MILLIS = 100;
+
+	/** Number of steps a @ref ProgressBatch accumulates before it adds them
+	 * to the shared progress counter
+	 */
+	static const int64_t PROGRESS_BATCH_SIZE = 256;
+
 	/** Possible print modes */
 	enum SG_PRG_MODE
 	{
@@ -74,6 +87,11 @@ namespace shogun
 
 	/**
 	 * @class Printer class that displays the progress bar.
+	 *
+	 * The progress is an atomic counter that any thread can increment
+	 * without locking. Once showing progress is enabled, the thread whose
+	 * increment comes at least PROGRESS_TICK_MILLIS milliseconds after the
+	 * last redraw draws the bar, until finish() draws the last state.
 	 */
 	class ProgressPrinter
 	{
@@ -98,34 +116,49 @@ namespace shogun
 		}
 		~ProgressPrinter()
 		{
+			finish();
 		}
 
+		ProgressPrinter(const ProgressPrinter&) = delete;
+		ProgressPrinter& operator=(const ProgressPrinter&) = delete;
+
 		/**
-		 * Increment and print the progress bar.
-		 * Everything is locked to prevent race conditions
-		 * or characters overlapping (especially within
-		 * multi threaded environments).
+		 * Increment the progress by one step. This is a relaxed atomic
+		 * increment that can be called from all threads of a parallel loop.
 		 */
 		void print_progress() const
 		{
-			lock.lock();
-			if (m_current_value.load() - m_min_value >
-			    m_max_value - m_min_value)
-			{
-				increment();
-				lock.unlock();
-				return;
-			}
-			print_progress_impl();
-			if (m_current_value.load() - m_min_value ==
-			    m_max_value - m_min_value)
-			{
-				print_end();
-				increment();
-				lock.unlock();
+			add(1);
+		}
+
+		/**
+		 * Increment the progress by a number of steps without locking.
+		 * If showing progress is enabled and the bar was not drawn for
+		 * PROGRESS_TICK_MILLIS milliseconds, the calling thread redraws it.
+		 *
+		 * @param steps number of steps done
+		 */
+		void add(int64_t steps) const
+		{
+			m_current_value.fetch_add(steps, std::memory_order_relaxed);
+			if (m_io.get_show_progress())
+				draw_if_due();
+		}
+
+		/**
+		 * Draw the last state of the progress bar, if it was drawn before.
+		 * Later increments are not drawn.
+		 */
+		void finish() const
+		{
+			if (m_finished.exchange(true) || !m_drawn.load())
 				return;
-			}
-			increment();
+
+			lock.lock();
+			print_progress_impl(
+			    CMath::min(
+			        float64_t(m_current_value.load()), m_max_value));
+			print_end();
 			lock.unlock();
 		}
 
@@ -166,10 +199,38 @@ namespace shogun
 		}
 
 	private:
+		/**
+		 * Draw the progress bar if the last redraw is at least
+		 * PROGRESS_TICK_MILLIS milliseconds ago. Only the thread that
+		 * claims the next redraw time draws, the others return.
+		 */
+		void draw_if_due() const
+		{
+			int64_t now =
+			    std::chrono::duration_cast<std::chrono::milliseconds>(
+			        std::chrono::steady_clock::now().time_since_epoch())
+			        .count();
+			int64_t next_draw = m_next_draw.load(std::memory_order_relaxed);
+			if (now < next_draw || m_finished.load(std::memory_order_relaxed))
+				return;
+			if (!m_next_draw.compare_exchange_strong(
+			        next_draw, now + PROGRESS_TICK_MILLIS))
+				return;
+
+			lock.lock();
+			float64_t value = m_current_value.load();
+			if (value - m_min_value < m_max_value - m_min_value)
+				print_progress_impl(value);
+			m_drawn.store(true);
+			lock.unlock();
+		}
+
 		/**
 		 * Logic implementation of the progress bar.
+		 *
+		 * @param current_value value to draw
 		 */
-		void print_progress_impl() const
+		void print_progress_impl(float64_t current_value) const
 		{
 
 			// Check if the progress was enabled
@@ -202,7 +263,7 @@ namespace shogun
 			float64_t runtime = CTime::get_curtime();
 
 			if (difference > 0.0)
-				v = 100 * (m_current_value.load() - m_min_value) /
+				v = 100 * (current_value - m_min_value) /
 				    (m_max_value - m_min_value);
 
 			// Set up chunk size
@@ -232,7 +293,7 @@ namespace shogun
 			m_io.message(MSG_MESSAGEONLY, "", "", -1, "%s |", m_prefix.c_str());
 			for (index_t i = 1; i < progress_bar_space; i++)
 			{
-				if (m_current_value.load() - m_min_value > i * size_chunk)
+				if (current_value - m_min_value > i * size_chunk)
 				{
 					m_io.message(
 					    MSG_MESSAGEONLY, "", "", -1, "%s",
@@ -411,12 +472,6 @@ namespace shogun
 #endif
 		}
 
-		/* Increment the current value (atomically) */
-		void increment() const
-		{
-			m_current_value++;
-		}
-
 		/** IO object */
 		SGIO m_io;
 		/** Maxmimum value */
@@ -445,6 +500,94 @@ namespace shogun
 		mutable std::atomic<int64_t> m_current_value;
 		/** Lock for multithreaded operations **/
 		mutable CLock lock;
+		/** Earliest time of the next redraw, in steady clock milliseconds */
+		mutable std::atomic<int64_t> m_next_draw{0};
+		/** Whether the progress bar was drawn */
+		mutable std::atomic<bool> m_drawn{false};
+		/** Whether finish() was called */
+		mutable std::atomic<bool> m_finished{false};
+	};
+
+	/** @class Counts the steps one thread of a parallel loop makes and adds
+	 * them to the progress bar in batches, to keep the threads from
+	 * contending on the shared counter. Remaining steps are added on
+	 * destruction.
+	 *
+	 * @code
+	 *  auto pb = SG_PROGRESS(range(n));
+	 *  #pragma omp parallel
+	 *  {
+	 *  	auto batch = pb.batch();
+	 *  	#pragma omp for
+	 *  	for (index_t i = 0; i < n; i++)
+	 *  	{
+	 *  		// Do stuff
+	 *  		batch.step();
+	 *  	}
+	 *  }
+	 *  pb.complete();
+	 * @endcode
+	 */
+	class ProgressBatch
+	{
+	public:
+		/**
+		 * Constructor
+		 *
+		 * @param printer the printer to add the steps to
+		 * @param batch_size number of steps to accumulate
+		 */
+		ProgressBatch(
+		    std::shared_ptr<ProgressPrinter> printer,
+		    int64_t batch_size = PROGRESS_BATCH_SIZE)
+		    : m_printer(printer), m_batch_size(batch_size), m_steps(0)
+		{
+		}
+
+		ProgressBatch(ProgressBatch&& other)
+		    : m_printer(std::move(other.m_printer)),
+		      m_batch_size(other.m_batch_size), m_steps(other.m_steps)
+		{
+			other.m_steps = 0;
+		}
+
+		ProgressBatch(const ProgressBatch&) = delete;
+		ProgressBatch& operator=(const ProgressBatch&) = delete;
+
+		~ProgressBatch()
+		{
+			flush();
+		}
+
+		/**
+		 * Count steps done by the calling thread.
+		 *
+		 * @param steps number of steps
+		 */
+		void step(int64_t steps = 1)
+		{
+			m_steps += steps;
+			if (m_steps >= m_batch_size)
+				flush();
+		}
+
+		/** Add the accumulated steps to the progress bar. */
+		void flush()
+		{
+			if (m_steps > 0)
+			{
+				m_printer->add(m_steps);
+				m_steps = 0;
+			}
+		}
+
+	private:
+		/** The printer to add the steps to */
+		std::shared_ptr<ProgressPrinter> m_printer;
+		/** Number of steps to accumulate */
+		int64_t m_batch_size;
+		/** Accumulated steps */
+		int64_t m_steps;
 	};
 
 	/** @class Helper class to show a progress bar given a range.
@@ -472,7 +615,8 @@ namespace shogun
 		PRange(
 		    Range<T> range, const SGIO& io, const std::string prefix,
 		    const SG_PRG_MODE mode, std::function<bool()> condition)
-		    : m_range(range), m_condition(condition)
+		    : m_range(range), m_condition(condition),
+		      m_num_cancellations(CSignal::get_num_cancellations())
 		{
 			set_up_range();
 			m_printer = std::make_shared<ProgressPrinter>(
@@ -534,6 +678,7 @@ namespace shogun
 				{
 					m_printer->premature_end();
 					m_printer->print_progress();
+					m_printer->finish();
 					return false;
 				}
 				bool result = evaluate_condition();
@@ -551,6 +696,7 @@ namespace shogun
 				{
 					m_printer->premature_end();
 					m_printer->print_progress();
+					m_printer->finish();
 				}
 				return m_condition();
 			}
@@ -611,7 +757,10 @@ namespace shogun
 
 		/**
 		 * Print the progress bar. This method must be called
-		 * each time we want the progress bar to be updated.
+		 * each time we want the progress bar to be updated. It
+		 * increments an atomic counter and redraws the bar at most every
+		 * PROGRESS_TICK_MILLIS milliseconds. Parallel loops should prefer
+		 * batch().
 		 * @code
 		 * 	auto pr = progress(range(0,10), ASCII);
 		 * 	for (int i=0; i<10; i++)
@@ -627,6 +776,41 @@ namespace shogun
 			m_printer->print_progress();
 		}
 
+		/**
+		 * Create a counter for the steps of one thread of a parallel loop,
+		 * which adds them to the progress bar in batches.
+		 * @see ProgressBatch
+		 *
+		 * @return the counter
+		 */
+		ProgressBatch batch() const
+		{
+			return ProgressBatch(m_printer);
+		}
+
+		/**
+		 * Whether the user asked to cancel computations since the progress
+		 * bar was created. This is a relaxed atomic load, cheap enough to
+		 * be checked in every iteration of a parallel loop.
+		 * @code
+		 * 	auto pb = SG_PROGRESS(range(n));
+		 * 	#pragma omp parallel for
+		 * 	for (index_t i = 0; i < n; i++)
+		 * 	{
+		 * 		if (pb.cancelled())
+		 * 			continue;
+		 * 		// Do stuff
+		 * 	}
+		 * 	pb.complete();
+		 * @endcode
+		 *
+		 * @return whether to stop
+		 */
+		bool cancelled() const
+		{
+			return CSignal::get_num_cancellations() != m_num_cancellations;
+		}
+
 		/**
 		 * Print the absolute progress bar. This method must be called
 		 * each time we want the progress bar to be updated.
@@ -661,6 +845,7 @@ namespace shogun
 		{
 			m_printer->premature_end();
 			m_printer->print_progress();
+			m_printer->finish();
 		}
 
 		/**
@@ -701,6 +886,8 @@ namespace shogun
 		float64_t m_end_range;
 		/* Function which store the premature stop condition */
 		std::function<bool()> m_condition = []() { return true; };
+		/* Number of cancellation requests when the range was created */
+		int64_t m_num_cancellations;
 	};
 
 	/** Creates @ref PRange given a range.
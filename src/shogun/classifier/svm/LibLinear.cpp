@@ -15,6 +15,7 @@
 #include <shogun/labels/BinaryLabels.h>
 #include <shogun/lib/Signal.h>
 #include <shogun/lib/Time.h>
+#include <shogun/lib/Tracer.h>
 #include <shogun/optimization/liblinear/tron.h>
 
 using namespace shogun;
@@ -402,6 +403,7 @@ void CLibLinear::solve_l2r_l1l2_svc(
 		}
 
 		iter++;
+		SG_TRACE_COUNT(TC_SOLVER_ITERATIONS, 1);
 
 		float64_t gap=PGmax_new - PGmin_new;
 		pb.print_absolute(
@@ -759,6 +761,7 @@ void CLibLinear::solve_l1r_l2_svc(
 		if (iter == 0)
 			Gmax_init = Gmax_new;
 		iter++;
+		SG_TRACE_COUNT(TC_SOLVER_ITERATIONS, 1);
 
 		pb.print_absolute(
 		    Gmax_new, -CMath::log10(Gmax_new), -CMath::log10(Gmax_init),
@@ -1137,6 +1140,7 @@ void CLibLinear::solve_l1r_lr(
 		if (iter == 0)
 			Gmax_init = Gmax_new;
 		iter++;
+		SG_TRACE_COUNT(TC_SOLVER_ITERATIONS, 1);
 
 		pb.print_absolute(
 		    Gmax_new, -CMath::log10(Gmax_new), -CMath::log10(Gmax_init),
@@ -1344,6 +1348,7 @@ void CLibLinear::solve_l2r_lr_dual(
 		if (iter == 0)
 			Gmax_init = Gmax;
 		iter++;
+		SG_TRACE_COUNT(TC_SOLVER_ITERATIONS, 1);
 
 		pb.print_absolute(
 		    Gmax, -CMath::log10(Gmax), -CMath::log10(Gmax_init),
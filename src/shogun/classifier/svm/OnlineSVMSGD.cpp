@@ -8,6 +8,7 @@
 #include <shogun/base/Parameter.h>
 #include <shogun/base/progress.h>
 #include <shogun/classifier/svm/OnlineSVMSGD.h>
+#include <shogun/features/streaming/StreamingSparseFeatures.h>
 #include <shogun/lib/Signal.h>
 #include <shogun/loss/HingeLoss.h>
 #include <shogun/mathematics/Math.h>
@@ -89,13 +90,30 @@ bool COnlineSVMSGD::train(CFeatures* data)
 	if ((loss_type == L_LOGLOSS) || (loss_type == L_LOGLOSSMARGIN))
 		is_log_loss = true;
 
+	ESGDParallelMode mode=parallel_mode;
+	if (mode==SGD_AUTO)
+	{
+		mode=features->get_feature_class()==C_STREAMING_SPARSE ?
+			SGD_HOGWILD : SGD_AVERAGING;
+	}
+	int32_t num_threads=parallel->get_num_threads();
+	if (mode==SGD_SEQUENTIAL || num_threads<2)
+		mode=SGD_SEQUENTIAL;
+
+	epoch_losses=SGVector<float64_t>(epochs);
+	epoch_losses.zero();
 	int32_t vec_count;
+	int32_t num_epochs=0;
 	for (auto e : SG_PROGRESS(range(epochs)))
 	{
 		COMPUTATION_CONTROLLERS
+		num_epochs++;
 		vec_count=0;
 		count = skip;
-		while (features->get_next_example())
+		if (mode!=SGD_SEQUENTIAL)
+			vec_count=train_parallel(mode, num_threads, epoch_losses[e]);
+
+		while (mode==SGD_SEQUENTIAL && features->get_next_example())
 		{
 			vec_count++;
 			// Expand w vector if more features are seen in this example
@@ -104,6 +122,7 @@ bool COnlineSVMSGD::train(CFeatures* data)
 			float64_t eta = 1.0 / (lambda * t);
 			float64_t y = features->get_label();
 			float64_t z = y * (features->dense_dot(m_w.vector, m_w.vlen) + bias);
+			epoch_losses[e] += loss->loss(z, 1);
 
 			if (z < 1 || is_log_loss)
 			{
@@ -131,6 +150,11 @@ bool COnlineSVMSGD::train(CFeatures* data)
 			features->release_example();
 		}
 
+		if (vec_count)
+			epoch_losses[e]/=vec_count;
+		SG_DEBUG("epoch %d: %d vectors, average loss=%.6f\n", e, vec_count,
+			epoch_losses[e])
+
 		// If the stream is seekable, reset the stream to the first
 		// example (for epochs > 1)
 		if (features->is_seekable() && e < epochs-1)
@@ -141,12 +165,215 @@ bool COnlineSVMSGD::train(CFeatures* data)
 	}
 
 	features->end_parser();
+	epoch_losses.resize_vector(num_epochs);
 	float64_t wnorm = linalg::dot(m_w, m_w);
 	SG_INFO("Norm: %.6f, Bias: %.6f\n", wnorm, bias)
 
 	return true;
 }
 
+int32_t COnlineSVMSGD::train_parallel(
+	ESGDParallelMode mode, int32_t num_threads, float64_t& sum_loss)
+{
+	std::vector<SGSparseVector<float32_t>> examples;
+	SGVector<float64_t> labels(chunk_size);
+	SGVector<float32_t> buffer;
+	SGVector<float64_t> losses(num_threads);
+	SGVector<int32_t> counts(num_threads);
+	counts.set_const(skip);
+	int32_t count=skip;
+
+	int32_t vec_count=0;
+	while (true)
+	{
+		/* the stream is parsed by a single thread */
+		examples.clear();
+		int32_t dim=m_w.vlen;
+		while ((int32_t) examples.size()<chunk_size && features->get_next_example())
+		{
+			labels[examples.size()]=features->get_label();
+			examples.push_back(get_sparse_example(buffer));
+			dim=CMath::max(dim, examples.back().get_num_dimensions());
+			dim=CMath::max(dim, features->get_dim_feature_space());
+			features->release_example();
+		}
+		int32_t num_examples=examples.size();
+		if (!num_examples)
+			break;
+
+		if (dim>m_w.vlen)
+			m_w.resize_vector(dim);
+
+		int32_t chunk_threads=CMath::min(num_threads, num_examples);
+		if (mode==SGD_HOGWILD)
+		{
+			/* the threads share the weights and the bias, and only take the
+			 * sparse steps */
+			#pragma omp parallel for num_threads(chunk_threads)
+			for (int32_t k=0; k<chunk_threads; k++)
+			{
+				losses[k]=train_examples(m_w, bias, examples.data(), labels,
+					int64_t(num_examples)*k/chunk_threads,
+					int64_t(num_examples)*(k+1)/chunk_threads, t+k,
+					chunk_threads, counts[k], false);
+			}
+
+			/* the dense weight decay of the chunk is done afterwards, at the
+			 * examples where a sequential pass does it */
+			for (int32_t i=0; i<num_examples; i++)
+			{
+				if (--count <= 0)
+				{
+					float64_t eta = 1.0 / (lambda * (t + i));
+					float32_t r = 1 - eta * lambda * skip;
+					if (r < 0.8)
+						r = pow(1 - eta * lambda, skip);
+					linalg::scale(m_w, m_w, r);
+					count = skip;
+				}
+			}
+		}
+		else
+		{
+			SGMatrix<float32_t> thread_w(m_w.vlen, chunk_threads);
+			SGVector<float32_t> thread_bias(chunk_threads);
+
+			/* the threads start from the same weights and bias */
+			#pragma omp parallel for num_threads(chunk_threads)
+			for (int32_t k=0; k<chunk_threads; k++)
+			{
+				SGVector<float32_t> local_w(thread_w.get_column_vector(k),
+					m_w.vlen, false);
+				sg_memcpy(local_w.vector, m_w.vector, m_w.vlen*sizeof(float32_t));
+				thread_bias[k]=bias;
+				losses[k]=train_examples(local_w, thread_bias[k],
+					examples.data(), labels,
+					int64_t(num_examples)*k/chunk_threads,
+					int64_t(num_examples)*(k+1)/chunk_threads, t+k,
+					chunk_threads, counts[k], true);
+			}
+
+			/* averaged in the order of the threads */
+			m_w.zero();
+			bias=0;
+			for (int32_t k=0; k<chunk_threads; k++)
+			{
+				float32_t* local_w=thread_w.get_column_vector(k);
+				for (int32_t j=0; j<m_w.vlen; j++)
+					m_w[j]+=local_w[j]/chunk_threads;
+				bias+=thread_bias[k]/chunk_threads;
+			}
+		}
+
+		for (int32_t k=0; k<chunk_threads; k++)
+			sum_loss+=losses[k];
+		t+=num_examples;
+		vec_count+=num_examples;
+	}
+
+	return vec_count;
+}
+
+float64_t COnlineSVMSGD::train_examples(
+	SGVector<float32_t> w, float32_t& b,
+	const SGSparseVector<float32_t>* examples, SGVector<float64_t> labels,
+	int32_t begin, int32_t end, float64_t t_begin, float64_t t_step,
+	int32_t& count_cur, bool decay)
+{
+	ELossType loss_type = loss->get_loss_type();
+	bool is_log_loss = false;
+	if ((loss_type == L_LOGLOSS) || (loss_type == L_LOGLOSSMARGIN))
+		is_log_loss = true;
+
+	float64_t t_cur=t_begin;
+	float64_t sum_loss=0;
+	for (int32_t i=begin; i<end; i++)
+	{
+		const SGSparseVector<float32_t>& x=examples[i];
+		float64_t eta = 1.0 / (lambda * t_cur);
+		float64_t y = labels[i];
+		float64_t z = b;
+		for (int32_t k=0; k<x.num_feat_entries; k++)
+			z += w[x.features[k].feat_index] * x.features[k].entry;
+		z *= y;
+		sum_loss += loss->loss(z, 1);
+
+		if (z < 1 || is_log_loss)
+		{
+			float64_t etd = -eta * loss->first_derivative(z,1);
+			float32_t alpha = etd * y / wscale;
+			for (int32_t k=0; k<x.num_feat_entries; k++)
+				w[x.features[k].feat_index] += alpha * x.features[k].entry;
+
+			if (use_bias)
+			{
+				if (use_regularized_bias)
+					b *= 1 - eta * lambda * bscale;
+				b += etd * y * bscale;
+			}
+		}
+
+		if (decay && --count_cur <= 0)
+		{
+			float32_t r = 1 - eta * lambda * skip;
+			if (r < 0.8)
+				r = pow(1 - eta * lambda, skip);
+			for (int32_t j=0; j<w.vlen; j++)
+				w[j] *= r;
+			count_cur = skip;
+		}
+		t_cur+=t_step;
+	}
+	return sum_loss;
+}
+
+SGSparseVector<float32_t> COnlineSVMSGD::get_sparse_example(
+	SGVector<float32_t>& buffer)
+{
+	if (features->get_feature_class()==C_STREAMING_SPARSE)
+	{
+		if (features->get_feature_type()==F_SHORTREAL)
+			return ((CStreamingSparseFeatures<float32_t>*) features)->get_vector().clone();
+
+		if (features->get_feature_type()==F_DREAL)
+		{
+			SGSparseVector<float64_t> vec=
+				((CStreamingSparseFeatures<float64_t>*) features)->get_vector();
+			SGSparseVector<float32_t> example(vec.num_feat_entries);
+			for (int32_t k=0; k<vec.num_feat_entries; k++)
+			{
+				example.features[k].feat_index=vec.features[k].feat_index;
+				example.features[k].entry=vec.features[k].entry;
+			}
+			return example;
+		}
+	}
+
+	/* other features are added to a dense buffer to find the non-zeros */
+	int32_t dim=features->get_dim_feature_space();
+	if (dim>buffer.vlen)
+		buffer.resize_vector(dim);
+	features->add_to_dense_vec(1, buffer.vector, buffer.vlen);
+
+	int32_t nnz=0;
+	for (int32_t j=0; j<buffer.vlen; j++)
+		nnz+=buffer[j]!=0;
+
+	SGSparseVector<float32_t> example(nnz);
+	nnz=0;
+	for (int32_t j=0; j<buffer.vlen; j++)
+	{
+		if (buffer[j]!=0)
+		{
+			example.features[nnz].feat_index=j;
+			example.features[nnz].entry=buffer[j];
+			buffer[j]=0;
+			nnz++;
+		}
+	}
+	return example;
+}
+
 void COnlineSVMSGD::calibrate(int32_t max_vec_num)
 {
 	int32_t c_dim=1;
@@ -202,6 +429,8 @@ void COnlineSVMSGD::init()
 	use_bias=true;
 
 	use_regularized_bias=false;
+	parallel_mode=SGD_SEQUENTIAL;
+	chunk_size=10000;
 
 	loss=new CHingeLoss();
 	SG_REF(loss);
@@ -219,4 +448,12 @@ void COnlineSVMSGD::init()
 	SG_ADD(
 	    &use_regularized_bias, "use_regularized_bias",
 	    "Indicates if bias is regularized.");
+	SG_ADD_OPTIONS(
+	    (machine_int_t*)&parallel_mode, "parallel_mode",
+	    "How several threads are used.", ParameterProperties::NONE,
+	    SG_OPTIONS(SGD_SEQUENTIAL, SGD_HOGWILD, SGD_AVERAGING, SGD_AUTO));
+	SG_ADD(
+	    &chunk_size, "chunk_size",
+	    "Number of examples passed over by several threads at once.");
+	SG_ADD(&epoch_losses, "epoch_losses", "Average loss of the epochs.");
 }
@@ -14,10 +14,23 @@
 #include <shogun/machine/OnlineLinearMachine.h>
 #include <shogun/features/streaming/StreamingDotFeatures.h>
 #include <shogun/loss/LossFunction.h>
+#include <shogun/classifier/svm/SGDParallelMode.h>
+#include <shogun/lib/SGSparseVector.h>
 
 namespace shogun
 {
-/** @brief class OnlineSVMSGD */
+/** @brief class OnlineSVMSGD
+ *
+ * The passes over the stream can use several threads, see
+ * set_parallel_mode(). The stream is parsed in chunks of examples by a
+ * single thread, and the threads pass over parts of a chunk. With Hogwild,
+ * they take the sparse steps on the shared weights without locks, and the
+ * dense weight decay of the chunk is done by a single thread afterwards, at
+ * the examples where a sequential pass does it. With averaging, every
+ * thread updates its own copy of the weights, including the decay, and the
+ * copies are averaged after each chunk. A thread follows the learning rate
+ * schedule of every num_threads-th example.
+ */
 class COnlineSVMSGD : public COnlineLinearMachine
 {
 	public:
@@ -90,6 +103,43 @@ class COnlineSVMSGD : public COnlineLinearMachine
 		 */
 		inline int32_t get_epochs() { return epochs; }
 
+		/** set how several threads are used, the number of threads is
+		 * given by the parallel settings
+		 *
+		 * @param mode parallel mode (default SGD_SEQUENTIAL)
+		 */
+		inline void set_parallel_mode(ESGDParallelMode mode) { parallel_mode=mode; }
+
+		/** get how several threads are used
+		 *
+		 * @return parallel mode
+		 */
+		inline ESGDParallelMode get_parallel_mode() { return parallel_mode; }
+
+		/** set number of examples which are parsed before several threads
+		 * pass over them
+		 *
+		 * @param size number of examples (default 10000)
+		 */
+		inline void set_chunk_size(int32_t size)
+		{
+			REQUIRE(size>0, "Chunk size (%d) must be positive\n", size)
+			chunk_size=size;
+		}
+
+		/** get number of examples which are passed over at once
+		 *
+		 * @return number of examples
+		 */
+		inline int32_t get_chunk_size() { return chunk_size; }
+
+		/** get average loss of the examples of each epoch of the last
+		 * training, computed before their steps
+		 *
+		 * @return average losses
+		 */
+		inline SGVector<float64_t> get_epoch_losses() { return epoch_losses; }
+
 		/** set lambda
 		 *
 		 * @param l value of regularization parameter lambda
@@ -149,6 +199,45 @@ class COnlineSVMSGD : public COnlineLinearMachine
 		 * */
 		void calibrate(int32_t max_vec_num=1000);
 
+		/** pass over the rest of the stream with several threads
+		 *
+		 * @param mode SGD_HOGWILD or SGD_AVERAGING
+		 * @param num_threads number of threads
+		 * @param sum_loss where the losses of the examples are added to
+		 * @return number of examples
+		 */
+		int32_t train_parallel(
+			ESGDParallelMode mode, int32_t num_threads, float64_t& sum_loss);
+
+		/** pass over examples [begin, end) of a chunk
+		 *
+		 * @param w weights
+		 * @param b bias
+		 * @param examples examples of the chunk
+		 * @param labels labels of the chunk
+		 * @param begin first example
+		 * @param end one past the last example
+		 * @param t_begin t of the first example
+		 * @param t_step increment of t for each example
+		 * @param count_cur examples until the next weight decay
+		 * @param decay whether to do the weight decay, otherwise only the
+		 * sparse steps are taken
+		 * @return sum of the losses of the examples
+		 */
+		float64_t train_examples(
+			SGVector<float32_t> w, float32_t& b,
+			const SGSparseVector<float32_t>* examples,
+			SGVector<float64_t> labels, int32_t begin, int32_t end,
+			float64_t t_begin, float64_t t_step, int32_t& count_cur,
+			bool decay);
+
+		/** copy the current example of the stream
+		 *
+		 * @param buffer zero dense buffer for features which are not sparse
+		 * @return non-zero features of the example
+		 */
+		SGSparseVector<float32_t> get_sparse_example(SGVector<float32_t>& buffer);
+
 	private:
 		void init();
 
@@ -166,6 +255,10 @@ class COnlineSVMSGD : public COnlineLinearMachine
 		bool use_bias;
 		bool use_regularized_bias;
 
+		ESGDParallelMode parallel_mode;
+		int32_t chunk_size;
+		SGVector<float64_t> epoch_losses;
+
 		CLossFunction* loss;
 };
 }
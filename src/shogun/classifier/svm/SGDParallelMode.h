@@ -0,0 +1,31 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ */
+
+#ifndef _SGDPARALLELMODE_H___
+#define _SGDPARALLELMODE_H___
+
+#include <shogun/lib/config.h>
+
+namespace shogun
+{
+/** How the stochastic gradient descent of CSGDQN and COnlineSVMSGD uses
+ * several threads, which are given by the parallel settings of the machine
+ */
+enum ESGDParallelMode
+{
+	/** a single thread passes over the examples */
+	SGD_SEQUENTIAL = 0,
+	/** threads pass over parts of the examples and update shared weights
+	 * without locks, best for sparse examples which touch few weights
+	 */
+	SGD_HOGWILD = 1,
+	/** threads pass over parts of the examples with their own weights,
+	 * which are averaged after each part
+	 */
+	SGD_AVERAGING = 2,
+	/** Hogwild for sparse features and averaging otherwise */
+	SGD_AUTO = 3
+};
+}
+#endif // _SGDPARALLELMODE_H___
@@ -12,6 +12,7 @@
 #include <shogun/lib/Signal.h>
 #include <shogun/loss/HingeLoss.h>
 #include <shogun/mathematics/Math.h>
+#include <shogun/mathematics/linalg/LinalgNamespace.h>
 
 using namespace shogun;
 
@@ -113,81 +114,234 @@ bool CSGDQN::train(CFeatures* data)
 
 	SG_INFO("lambda=%f, epochs=%d, eta0=%f\n", lambda, epochs, eta0)
 
-
-	float64_t* Bc=SG_MALLOC(float64_t, w.vlen);
-	SGVector<float64_t>::fill_vector(Bc, w.vlen, 1/lambda);
-
-	float64_t* result=SG_MALLOC(float64_t, w.vlen);
-	float64_t* B=SG_MALLOC(float64_t, w.vlen);
+	SGVector<float64_t> Bc(w.vlen);
+	Bc.set_const(1/lambda);
 
 	//Calibrate
 	calibrate();
 
-	SG_INFO("Training on %d vectors\n", num_vec)
+	ESGDParallelMode mode=parallel_mode;
+	if (mode==SGD_AUTO)
+		mode=features->get_feature_class()==C_SPARSE ? SGD_HOGWILD : SGD_AVERAGING;
+	int32_t num_threads=CMath::min(parallel->get_num_threads(), num_vec);
+	if (mode==SGD_SEQUENTIAL || num_threads<2)
+	{
+		mode=SGD_SEQUENTIAL;
+		num_threads=1;
+	}
 
-	ELossType loss_type = loss->get_loss_type();
-	bool is_log_loss = false;
-	if ((loss_type == L_LOGLOSS) || (loss_type == L_LOGLOSSMARGIN))
-		is_log_loss = true;
+	SG_INFO("Training on %d vectors with %d threads\n", num_vec, num_threads)
 
+	/* the ratios of the diagonal scaling of each thread */
+	SGMatrix<float64_t> B(w.vlen, num_threads);
+	B.zero();
+
+	epoch_losses=SGVector<float64_t>(epochs);
+	epoch_losses.zero();
 	for (auto e : SG_PROGRESS(range(epochs)))
 	{
 		COMPUTATION_CONTROLLERS
-		count = skip;
-		bool updateB=false;
-		for (int32_t i=0; i<num_vec; i++)
+		if (mode==SGD_SEQUENTIAL)
+			epoch_losses[e]=train_examples(w, Bc, B, 0, num_vec, t, 1, false);
+		else if (mode==SGD_HOGWILD)
+			epoch_losses[e]=train_hogwild(w, Bc, B);
+		else
+			epoch_losses[e]=train_averaging(w, Bc, B);
+		t+=num_vec;
+
+		epoch_losses[e]/=num_vec;
+		SG_DEBUG("epoch %d: average loss=%.6f, norm=%.6f\n", e, epoch_losses[e],
+			CMath::sqrt(linalg::dot(w, w)))
+	}
+
+	set_w(w);
+
+	return true;
+}
+
+float64_t CSGDQN::train_hogwild(
+	SGVector<float64_t> w, SGVector<float64_t> Bc, SGMatrix<float64_t> B)
+{
+	int32_t num_threads=B.num_cols;
+	int32_t num_vec=features->get_num_vectors();
+	SGVector<float64_t> losses(num_threads);
+
+	/* the threads share the weights and the scaling, each one follows the
+	 * learning rate schedule of every num_threads-th example and only takes
+	 * the sparse steps */
+	#pragma omp parallel for num_threads(num_threads)
+	for (int32_t k=0; k<num_threads; k++)
+	{
+		SGVector<float64_t> local_B(B.get_column_vector(k), w.vlen, false);
+		losses[k]=train_examples(w, Bc, local_B,
+			int64_t(num_vec)*k/num_threads, int64_t(num_vec)*(k+1)/num_threads,
+			t+k, num_threads, true);
+	}
+
+	/* the dense weight decay and scaling updates of the epoch are done once
+	 * afterwards, at the examples where a sequential pass does them */
+	float64_t lambda=1.0/(C1*num_vec);
+	bool log_loss=is_log_loss();
+	SGVector<float64_t> B_0(B.get_column_vector(0), w.vlen, false);
+	SGVector<float64_t> result(w.vlen);
+	for (int32_t i=skip-1; i<num_vec; i+=skip+1)
+	{
+		decay_weights(w, Bc, result, 1.0/(t+i), lambda);
+		if (i+1<num_vec)
 		{
-			SGVector<float64_t> v = features->get_computed_dot_feature_vector(i);
-			ASSERT(w.vlen==v.vlen)
-			float64_t eta = 1.0/t;
-			float64_t y = ((CBinaryLabels*) m_labels)->get_label(i);
-			float64_t z = y * features->dense_dot(i, w.vector, w.vlen);
-			if(updateB==true)
+			float64_t y=((CBinaryLabels*) m_labels)->get_label(i+1);
+			float64_t z=y*features->dense_dot(i+1, w.vector, w.vlen);
+			if (z < 1 || log_loss)
+				update_scaling(w, Bc, B_0, result, i+1, z, t+i+1, lambda);
+		}
+	}
+
+	float64_t sum_loss=0;
+	for (int32_t k=0; k<num_threads; k++)
+		sum_loss+=losses[k];
+	return sum_loss;
+}
+
+float64_t CSGDQN::train_averaging(
+	SGVector<float64_t> w, SGVector<float64_t> Bc, SGMatrix<float64_t> B)
+{
+	int32_t num_threads=B.num_cols;
+	int32_t num_vec=features->get_num_vectors();
+	SGVector<float64_t> losses(num_threads);
+	SGMatrix<float64_t> thread_w(w.vlen, num_threads);
+	SGMatrix<float64_t> thread_Bc(w.vlen, num_threads);
+
+	/* the threads start from the same weights and scaling, and follow the
+	 * learning rate schedule of every num_threads-th example */
+	#pragma omp parallel for num_threads(num_threads)
+	for (int32_t k=0; k<num_threads; k++)
+	{
+		SGVector<float64_t> local_w(thread_w.get_column_vector(k), w.vlen, false);
+		SGVector<float64_t> local_Bc(thread_Bc.get_column_vector(k), w.vlen, false);
+		sg_memcpy(local_w.vector, w.vector, w.vlen*sizeof(float64_t));
+		sg_memcpy(local_Bc.vector, Bc.vector, w.vlen*sizeof(float64_t));
+		SGVector<float64_t> local_B(B.get_column_vector(k), w.vlen, false);
+		losses[k]=train_examples(local_w, local_Bc, local_B,
+			int64_t(num_vec)*k/num_threads, int64_t(num_vec)*(k+1)/num_threads,
+			t+k, num_threads, false);
+	}
+
+	/* averaged in the order of the threads */
+	float64_t sum_loss=0;
+	w.zero();
+	Bc.zero();
+	for (int32_t k=0; k<num_threads; k++)
+	{
+		sum_loss+=losses[k];
+		SGVector<float64_t>::add(w.vector, 1.0, w.vector, 1.0/num_threads,
+			thread_w.get_column_vector(k), w.vlen);
+		SGVector<float64_t>::add(Bc.vector, 1.0, Bc.vector, 1.0/num_threads,
+			thread_Bc.get_column_vector(k), w.vlen);
+	}
+	return sum_loss;
+}
+
+void CSGDQN::decay_weights(
+	SGVector<float64_t> w, SGVector<float64_t> Bc, SGVector<float64_t> result,
+	float64_t eta, float64_t lambda)
+{
+	SGVector<float64_t>::vector_multiply(result.vector,Bc.vector,w.vector,w.vlen);
+	SGVector<float64_t>::add(w.vector,-skip*lambda*eta,result.vector,1.0,w.vector,w.vlen);
+}
+
+void CSGDQN::update_scaling(
+	SGVector<float64_t> w, SGVector<float64_t> Bc, SGVector<float64_t> B,
+	SGVector<float64_t> result, int32_t i, float64_t z, float64_t t_cur,
+	float64_t lambda)
+{
+	float64_t eta = 1.0/t_cur;
+	float64_t y = ((CBinaryLabels*) m_labels)->get_label(i);
+	SGVector<float64_t> v = features->get_computed_dot_feature_vector(i);
+	ASSERT(w.vlen==v.vlen)
+	SGVector<float64_t> w_1=w.clone();
+	float64_t loss_1=-loss->first_derivative(z,1);
+	SGVector<float64_t>::vector_multiply(result.vector,Bc.vector,v.vector,w.vlen);
+	SGVector<float64_t>::add(w.vector,eta*loss_1*y,result.vector,1.0,w.vector,w.vlen);
+	float64_t z2 = y * features->dense_dot(i, w.vector, w.vlen);
+	float64_t diffloss = -loss->first_derivative(z2,1) - loss_1;
+	if(diffloss)
+	{
+		compute_ratio(w.vector,w_1.vector,B.vector,v.vector,w.vlen,lambda,y*diffloss);
+		if(t_cur>skip)
+			combine_and_clip(Bc.vector,B.vector,w.vlen,(t_cur-skip)/(t_cur+skip),2*skip/(t_cur+skip),1/(100*lambda),100/lambda);
+		else
+			combine_and_clip(Bc.vector,B.vector,w.vlen,t_cur/(t_cur+skip),skip/(t_cur+skip),1/(100*lambda),100/lambda);
+	}
+}
+
+bool CSGDQN::is_log_loss() const
+{
+	ELossType loss_type = loss->get_loss_type();
+	return (loss_type == L_LOGLOSS) || (loss_type == L_LOGLOSSMARGIN);
+}
+
+float64_t CSGDQN::train_examples(
+	SGVector<float64_t> w, SGVector<float64_t> Bc, SGVector<float64_t> B,
+	int32_t begin, int32_t end, float64_t t_begin, float64_t t_step,
+	bool sparse_steps)
+{
+	float64_t lambda=1.0/(C1*features->get_num_vectors());
+	bool log_loss=is_log_loss();
+
+	SGVector<float64_t> result(w.vlen);
+
+	float64_t t_cur=t_begin;
+	int32_t count_cur=skip;
+	bool updateB=false;
+	float64_t sum_loss=0;
+	for (int32_t i=begin; i<end; i++)
+	{
+		float64_t eta = 1.0/t_cur;
+		float64_t y = ((CBinaryLabels*) m_labels)->get_label(i);
+		float64_t z = y * features->dense_dot(i, w.vector, w.vlen);
+		sum_loss+=loss->loss(z, 1);
+		if (sparse_steps)
+		{
+			/* only the non-zero features are written, the weight decay and
+			 * the scaling are updated by train_hogwild() */
+			if (z < 1 || log_loss)
+			{
+				float64_t scale=eta*-loss->first_derivative(z,1)*y;
+				int32_t idx;
+				float64_t value;
+				void* it=features->get_feature_iterator(i);
+				while (features->get_next_feature(idx, value, it))
+					w[idx]+=scale*Bc[idx]*value;
+				features->free_feature_iterator(it);
+			}
+		}
+		else if(updateB==true)
+		{
+			if (z < 1 || log_loss)
+				update_scaling(w, Bc, B, result, i, z, t_cur, lambda);
+			updateB=false;
+		}
+		else
+		{
+			if(--count_cur<=0)
 			{
-				if (z < 1 || is_log_loss)
-				{
-					SGVector<float64_t> w_1=w.clone();
-					float64_t loss_1=-loss->first_derivative(z,1);
-					SGVector<float64_t>::vector_multiply(result,Bc,v.vector,w.vlen);
-					SGVector<float64_t>::add(w.vector,eta*loss_1*y,result,1.0,w.vector,w.vlen);
-					float64_t z2 = y * features->dense_dot(i, w.vector, w.vlen);
-					float64_t diffloss = -loss->first_derivative(z2,1) - loss_1;
-					if(diffloss)
-					{
-						compute_ratio(w.vector,w_1.vector,B,v.vector,w.vlen,lambda,y*diffloss);
-						if(t>skip)
-							combine_and_clip(Bc,B,w.vlen,(t-skip)/(t+skip),2*skip/(t+skip),1/(100*lambda),100/lambda);
-						else
-							combine_and_clip(Bc,B,w.vlen,t/(t+skip),skip/(t+skip),1/(100*lambda),100/lambda);
-					}
-				}
-				updateB=false;
+				decay_weights(w, Bc, result, eta, lambda);
+				count_cur = skip;
+				updateB=true;
 			}
-			else
+
+			if (z < 1 || log_loss)
 			{
-				if(--count<=0)
-				{
-					SGVector<float64_t>::vector_multiply(result,Bc,w.vector,w.vlen);
-					SGVector<float64_t>::add(w.vector,-skip*lambda*eta,result,1.0,w.vector,w.vlen);
-					count = skip;
-					updateB=true;
-				}
-
-				if (z < 1 || is_log_loss)
-				{
-					SGVector<float64_t>::vector_multiply(result,Bc,v.vector,w.vlen);
-					SGVector<float64_t>::add(w.vector,eta*-loss->first_derivative(z,1)*y,result,1.0,w.vector,w.vlen);
-				}
+				float64_t scale=eta*-loss->first_derivative(z,1)*y;
+				SGVector<float64_t> v = features->get_computed_dot_feature_vector(i);
+				ASSERT(w.vlen==v.vlen)
+				SGVector<float64_t>::vector_multiply(result.vector,Bc.vector,v.vector,w.vlen);
+				SGVector<float64_t>::add(w.vector,scale,result.vector,1.0,w.vector,w.vlen);
 			}
-			t++;
 		}
+		t_cur+=t_step;
 	}
-	SG_FREE(result);
-	SG_FREE(B);
-
-	set_w(w);
-
-	return true;
+	return sum_loss;
 }
 
 
@@ -222,6 +376,7 @@ void CSGDQN::init()
 	epochs=5;
 	skip=1000;
 	count=1000;
+	parallel_mode=SGD_SEQUENTIAL;
 
 	loss=new CHingeLoss();
 	SG_REF(loss);
@@ -231,4 +386,9 @@ void CSGDQN::init()
 	SG_ADD(&epochs, "epochs", "epochs", ParameterProperties::HYPER);
 	SG_ADD(&skip, "skip", "skip");
 	SG_ADD(&count, "count", "count");
+	SG_ADD_OPTIONS(
+	    (machine_int_t*)&parallel_mode, "parallel_mode",
+	    "How several threads are used.", ParameterProperties::NONE,
+	    SG_OPTIONS(SGD_SEQUENTIAL, SGD_HOGWILD, SGD_AVERAGING, SGD_AUTO));
+	SG_ADD(&epoch_losses, "epoch_losses", "Average loss of the epochs.");
 }
@@ -11,14 +11,26 @@
 #include <shogun/lib/config.h>
 
 #include <shogun/lib/common.h>
+#include <shogun/lib/SGMatrix.h>
 #include <shogun/machine/LinearMachine.h>
 #include <shogun/features/DotFeatures.h>
 #include <shogun/labels/Labels.h>
 #include <shogun/loss/LossFunction.h>
+#include <shogun/classifier/svm/SGDParallelMode.h>
 
 namespace shogun
 {
-/** @brief class SGDQN */
+/** @brief class SGDQN
+ *
+ * The passes over the examples can use several threads, see
+ * set_parallel_mode(). With Hogwild, the threads update the shared weights
+ * and scaling without locks, and the steps only write the non-zero features
+ * of the examples. With averaging, every thread trains its own copy of the
+ * weights and scaling on a part of the examples, and the copies are
+ * averaged after each epoch. In both modes, a thread follows the learning
+ * rate schedule of every num_threads-th example, so that the schedule of an
+ * epoch is the one of a single thread.
+ */
 class CSGDQN : public CLinearMachine
 {
 	public:
@@ -95,6 +107,26 @@ class CSGDQN : public CLinearMachine
 		 */
 		inline int32_t get_epochs() { return epochs; }
 
+		/** set how several threads are used, the number of threads is
+		 * given by the parallel settings
+		 *
+		 * @param mode parallel mode (default SGD_SEQUENTIAL)
+		 */
+		inline void set_parallel_mode(ESGDParallelMode mode) { parallel_mode=mode; }
+
+		/** get how several threads are used
+		 *
+		 * @return parallel mode
+		 */
+		inline ESGDParallelMode get_parallel_mode() { return parallel_mode; }
+
+		/** get average loss of the examples of each epoch of the last
+		 * training, computed before their steps
+		 *
+		 * @return average losses
+		 */
+		inline SGVector<float64_t> get_epoch_losses() { return epoch_losses; }
+
 		/**computing diagonal scaling matrix B as ratio*/
 		void compute_ratio(float64_t* W,float64_t* W_1,float64_t* B,float64_t* dst,int32_t dim,float64_t regularizer_lambda,float64_t loss);
 
@@ -120,6 +152,81 @@ class CSGDQN : public CLinearMachine
 		/** calibrate */
 		void calibrate();
 
+		/** pass over examples [begin, end)
+		 *
+		 * @param w weights
+		 * @param Bc diagonal scaling
+		 * @param B ratios of the scaling
+		 * @param begin first example
+		 * @param end one past the last example
+		 * @param t_begin t of the first example
+		 * @param t_step increment of t for each example
+		 * @param sparse_steps whether to only take steps on the non-zero
+		 * features, without the weight decay and the scaling updates
+		 * @return sum of the losses of the examples
+		 */
+		float64_t train_examples(
+			SGVector<float64_t> w, SGVector<float64_t> Bc,
+			SGVector<float64_t> B, int32_t begin, int32_t end,
+			float64_t t_begin, float64_t t_step, bool sparse_steps);
+
+		/** weight decay of skip examples
+		 *
+		 * @param w weights
+		 * @param Bc diagonal scaling
+		 * @param result workspace of the length of the weights
+		 * @param eta learning rate
+		 * @param lambda regularization
+		 */
+		void decay_weights(
+			SGVector<float64_t> w, SGVector<float64_t> Bc,
+			SGVector<float64_t> result, float64_t eta, float64_t lambda);
+
+		/** step on an example which also updates the scaling
+		 *
+		 * @param w weights
+		 * @param Bc diagonal scaling
+		 * @param B ratios of the scaling
+		 * @param result workspace of the length of the weights
+		 * @param i example
+		 * @param z margin of the example
+		 * @param t_cur t of the example
+		 * @param lambda regularization
+		 */
+		void update_scaling(
+			SGVector<float64_t> w, SGVector<float64_t> Bc,
+			SGVector<float64_t> B, SGVector<float64_t> result, int32_t i,
+			float64_t z, float64_t t_cur, float64_t lambda);
+
+		/** @return whether the loss is a log loss, which updates on all
+		 * examples
+		 */
+		bool is_log_loss() const;
+
+		/** epoch with shared weights and scaling, the threads take the
+		 * sparse steps and the weight decay and scaling updates are done
+		 * once after them
+		 *
+		 * @param w weights
+		 * @param Bc diagonal scaling
+		 * @param B ratios of the scaling, one column per thread
+		 * @return sum of the losses of the examples
+		 */
+		float64_t train_hogwild(
+			SGVector<float64_t> w, SGVector<float64_t> Bc,
+			SGMatrix<float64_t> B);
+
+		/** epoch with averaged weights and scaling
+		 *
+		 * @param w weights
+		 * @param Bc diagonal scaling
+		 * @param B ratios of the scaling, one column per thread
+		 * @return sum of the losses of the examples
+		 */
+		float64_t train_averaging(
+			SGVector<float64_t> w, SGVector<float64_t> Bc,
+			SGMatrix<float64_t> B);
+
 	private:
 		void init();
 
@@ -130,6 +237,8 @@ class CSGDQN : public CLinearMachine
 		int32_t epochs;
 		int32_t skip;
 		int32_t count;
+		ESGDParallelMode parallel_mode;
+		SGVector<float64_t> epoch_losses;
 
 		CLossFunction* loss;
 };
@@ -51,81 +51,12 @@
 #include <stdlib.h>
 #include <time.h>
 
-#ifdef HAVE_PTHREAD
-#include <pthread.h>
-
-#endif
+#include <vector>
 
 using namespace shogun;
 
-#ifndef DOXYGEN_SHOULD_SKIP_THIS
-struct S_THREAD_PARAM_REACTIVATE_LINADD
-{
-	CKernel* kernel;
-	float64_t* lin;
-	float64_t* last_lin;
-	int32_t* active;
-	int32_t* docs;
-	int32_t start;
-	int32_t end;
-};
-
-struct S_THREAD_PARAM_SVMLIGHT
-{
-	float64_t * lin ;
-	float64_t* W;
-	int32_t start, end;
-	int32_t * active2dnum ;
-	int32_t * docs ;
-	CKernel* kernel ;
-};
-
-struct S_THREAD_PARAM_REACTIVATE_VANILLA
-{
-	CKernel* kernel;
-	float64_t* lin;
-	float64_t* aicache;
-	float64_t* a;
-	float64_t* a_old;
-	int32_t* changed2dnum;
-	int32_t* inactive2dnum;
-	int32_t* label;
-	int32_t start;
-	int32_t end;
-};
-
-struct S_THREAD_PARAM_KERNEL
-{
-	float64_t *Kval ;
-	int32_t *KI, *KJ ;
-	int32_t start, end;
-    CSVMLight* svmlight;
-};
-
-#endif // DOXYGEN_SHOULD_SKIP_THIS
-
-void* CSVMLight::update_linear_component_linadd_helper(void* p)
-{
-	S_THREAD_PARAM_SVMLIGHT* params = (S_THREAD_PARAM_SVMLIGHT*) p;
-
-	int32_t jj=0, j=0 ;
-
-	for (jj=params->start;(jj<params->end) && (j=params->active2dnum[jj])>=0;jj++)
-		params->lin[j]+=params->kernel->compute_optimized(params->docs[j]);
-
-	return NULL ;
-}
-
-void* CSVMLight::compute_kernel_helper(void* p)
-{
-	S_THREAD_PARAM_KERNEL* params = (S_THREAD_PARAM_KERNEL*) p;
-
-	int32_t jj=0 ;
-	for (jj=params->start;jj<params->end;jj++)
-		params->Kval[jj]=params->svmlight->compute_kernel(params->KI[jj], params->KJ[jj]) ;
-
-	return NULL ;
-}
+/* maximum number of kernel values of the rows which are fetched at once */
+#define MAX_KERNEL_ROW_BATCH_ELEMENTS 4194304
 
 CSVMLight::CSVMLight()
 : CSVM()
@@ -1024,15 +955,10 @@ void CSVMLight::optimize_svm(
     int32_t i;
     float64_t *a_v;
 
-    //compute_matrices_for_optimization_parallel(docs,label,
-	//										   exclude_from_eq_const,eq_target,chosen,
-	//										   active2dnum,working2dnum,a,lin,c,
-	//										   varnum,totdoc,aicache,qp);
-
-    compute_matrices_for_optimization(docs,label,
-									  exclude_from_eq_const,eq_target,chosen,
-									  active2dnum,working2dnum,a,lin,c,
-									  varnum,totdoc,aicache,qp);
+    compute_matrices_for_optimization_parallel(docs,label,
+											   exclude_from_eq_const,eq_target,chosen,
+											   active2dnum,working2dnum,a,lin,c,
+											   varnum,totdoc,aicache,qp);
 
     if(verbosity>=3) {
      SG_DEBUG("Running optimizer...")
@@ -1057,19 +983,13 @@ void CSVMLight::compute_matrices_for_optimization_parallel(
 	float64_t *a, float64_t *lin, float64_t *c, int32_t varnum, int32_t totdoc,
 	float64_t *aicache, QP *qp)
 {
-	// TODO: port to use OpenMP backend instead of pthread
-#ifdef HAVE_PTHREAD
 	int32_t num_threads=parallel->get_num_threads();
-#else
-	int32_t num_threads=1;
-#endif
 	if (num_threads < 2)
 	{
 		compute_matrices_for_optimization(docs, label, exclude_from_eq_const, eq_target,
 												   chosen, active2dnum, key, a, lin, c,
 												   varnum, totdoc, aicache, qp) ;
 	}
-#ifdef HAVE_PTHREAD
 	else
 	{
 		register int32_t ki,kj,i,j;
@@ -1093,7 +1013,6 @@ void CSVMLight::compute_matrices_for_optimization_parallel(
 			qp->opt_g0[i]=lin[key[i]];
 		}
 
-		ASSERT(num_threads>1)
 		int32_t *KI=SG_MALLOC(int32_t, varnum*varnum);
 		int32_t *KJ=SG_MALLOC(int32_t, varnum*varnum);
 		int32_t Knum=0 ;
@@ -1113,28 +1032,10 @@ void CSVMLight::compute_matrices_for_optimization_parallel(
 		}
 		ASSERT(Knum<=varnum*(varnum+1)/2)
 
-		pthread_t* threads = SG_MALLOC(pthread_t, num_threads-1);
-		S_THREAD_PARAM_KERNEL* params = SG_MALLOC(S_THREAD_PARAM_KERNEL, num_threads-1);
-		int32_t step= Knum/num_threads;
-		//SG_DEBUG("\nkernel-step size: %i\n", step)
-		for (int32_t t=0; t<num_threads-1; t++)
-		{
-			params[t].svmlight = this;
-			params[t].start = t*step;
-			params[t].end = (t+1)*step;
-			params[t].KI=KI ;
-			params[t].KJ=KJ ;
-			params[t].Kval=Kval ;
-			pthread_create(&threads[t], NULL, CSVMLight::compute_kernel_helper, (void*)&params[t]);
-		}
-		for (i=params[num_threads-2].end; i<Knum; i++)
-			Kval[i]=compute_kernel(KI[i],KJ[i]) ;
-
-		for (int32_t t=0; t<num_threads-1; t++)
-			pthread_join(threads[t], NULL);
-
-		SG_FREE(params);
-		SG_FREE(threads);
+		/* the kernel values of the working set are computed concurrently */
+		#pragma omp parallel for schedule(dynamic)
+		for (int32_t k=0; k<Knum; k++)
+			Kval[k]=compute_kernel(KI[k],KJ[k]) ;
 
 		Knum=0 ;
 		for (i=0;i<varnum;i++) {
@@ -1186,7 +1087,6 @@ void CSVMLight::compute_matrices_for_optimization_parallel(
 			SG_DONE()
 		}
 	}
-#endif
 }
 
 void CSVMLight::compute_matrices_for_optimization(
@@ -1449,7 +1349,7 @@ void CSVMLight::update_linear_component(
      /* based on the change of the variables */
      /* in the current working set */
 {
-	register int32_t i=0,ii=0,j=0,jj=0;
+	register int32_t i=0,ii=0;
 
 	if (kernel->has_property(KP_LINADD) && get_linadd_enabled())
 	{
@@ -1472,54 +1372,16 @@ void CSVMLight::update_linear_component(
 
 			if (num_working>0)
 			{
-				// TODO: port to use OpenMP backend instead of pthread
-#ifdef HAVE_PTHREAD
-				int32_t num_threads=parallel->get_num_threads();
-#else
-				int32_t num_threads=1;
-#endif
-				if (num_threads < 2)
-				{
-					for (jj=0;(j=active2dnum[jj])>=0;jj++) {
-						lin[j]+=kernel->compute_optimized(docs[j]);
-					}
-				}
-#ifdef HAVE_PTHREAD
-				else
+				int32_t num_elem=0;
+				while (active2dnum[num_elem]>=0)
+					num_elem++;
+
+				#pragma omp parallel for
+				for (int32_t k=0; k<num_elem; k++)
 				{
-					int32_t num_elem = 0 ;
-					for (jj=0;(j=active2dnum[jj])>=0;jj++) num_elem++ ;
-
-					pthread_t* threads = SG_MALLOC(pthread_t, num_threads-1);
-					S_THREAD_PARAM_SVMLIGHT* params = SG_MALLOC(S_THREAD_PARAM_SVMLIGHT, num_threads-1);
-					int32_t start = 0 ;
-					int32_t step = num_elem/num_threads;
-					int32_t end = step ;
-
-					for (int32_t t=0; t<num_threads-1; t++)
-					{
-						params[t].kernel = kernel ;
-						params[t].lin = lin ;
-						params[t].docs = docs ;
-						params[t].active2dnum=active2dnum ;
-						params[t].start = start ;
-						params[t].end = end ;
-						start=end ;
-						end+=step ;
-						pthread_create(&threads[t], NULL, update_linear_component_linadd_helper, (void*)&params[t]) ;
-					}
-
-					for (jj=params[num_threads-2].end;(j=active2dnum[jj])>=0;jj++) {
-						lin[j]+=kernel->compute_optimized(docs[j]);
-					}
-					void* ret;
-					for (int32_t t=0; t<num_threads-1; t++)
-						pthread_join(threads[t], &ret) ;
-
-					SG_FREE(params);
-					SG_FREE(threads);
+					int32_t idx=active2dnum[k];
+					lin[idx]+=kernel->compute_optimized(docs[idx]);
 				}
-#endif
 			}
 		}
 	}
@@ -1531,12 +1393,50 @@ void CSVMLight::update_linear_component(
 					a, a_old, working2dnum, totdoc,	lin, aicache);
 		}
 		else {
-			for (jj=0;(i=working2dnum[jj])>=0;jj++) {
-				if(a[i] != a_old[i]) {
-					kernel->get_kernel_row(i,active2dnum,aicache);
-					for (ii=0;(j=active2dnum[ii])>=0;ii++)
-						lin[j]+=(a[i]-a_old[i])*aicache[j]*(float64_t)label[i];
-				}
+			update_linear_component_rows(working2dnum, active2dnum, a, a_old,
+				label, totdoc, lin);
+		}
+	}
+}
+
+void CSVMLight::update_linear_component_rows(
+	int32_t* rows2dnum, int32_t* cols2dnum, float64_t* a, float64_t* a_old,
+	int32_t* label, int32_t totdoc, float64_t* lin)
+{
+	std::vector<int32_t> rows;
+	for (int32_t ii=0, i=0;(i=rows2dnum[ii])>=0;ii++) {
+		if(a[i] != a_old[i])
+			rows.push_back(i);
+	}
+	int32_t num_rows=rows.size();
+	int32_t num_cols=0;
+	while (cols2dnum[num_cols]>=0)
+		num_cols++;
+	if (!num_rows || !num_cols)
+		return;
+
+	int32_t batch_size=CMath::min(num_rows,
+		CMath::max(MAX_KERNEL_ROW_BATCH_ELEMENTS/totdoc, 1));
+	SGMatrix<float64_t> batch(totdoc, batch_size);
+	for (int32_t begin=0; begin<num_rows; begin+=batch_size)
+	{
+		int32_t num_batch=CMath::min(batch_size, num_rows-begin);
+
+		/* fetching rows only reads the kernel cache, so the rows of a
+		 * batch are fetched concurrently */
+		#pragma omp parallel for schedule(dynamic)
+		for (int32_t r=0; r<num_batch; r++)
+			kernel->get_kernel_row(rows[begin+r], cols2dnum, batch.get_column_vector(r));
+
+		/* the rows are added in their order, as in a single thread */
+		#pragma omp parallel for
+		for (int32_t jj=0; jj<num_cols; jj++)
+		{
+			int32_t j=cols2dnum[jj];
+			for (int32_t r=0; r<num_batch; r++)
+			{
+				int32_t i=rows[begin+r];
+				lin[j]+=(a[i]-a_old[i])*batch(j, r)*(float64_t)label[i];
 			}
 		}
 	}
@@ -1651,45 +1551,10 @@ void CSVMLight::update_linear_component_mkl_linadd(
 			kernel->add_to_normal(docs[i], (a[i]-a_old[i])*(float64_t)label[i]);
 		}
 	}
-	// TODO: port to use OpenMP backend instead of pthread
-#ifdef HAVE_PTHREAD
-	int32_t num_threads=parallel->get_num_threads();
-#else
-	int32_t num_threads=1;
-#endif
-
-	if (num_threads < 2)
-	{
-		// determine contributions of different kernels
-		for (int32_t i=0; i<num; i++)
-			kernel->compute_by_subkernel(i,&W[i*num_kernels]);
-	}
-#ifdef HAVE_PTHREAD
-	else
-	{
-		pthread_t* threads = SG_MALLOC(pthread_t, num_threads-1);
-		S_THREAD_PARAM_SVMLIGHT* params = SG_MALLOC(S_THREAD_PARAM_SVMLIGHT, num_threads-1);
-		int32_t step= num/num_threads;
-
-		for (int32_t t=0; t<num_threads-1; t++)
-		{
-			params[t].kernel = kernel;
-			params[t].W = W;
-			params[t].start = t*step;
-			params[t].end = (t+1)*step;
-			pthread_create(&threads[t], NULL, CSVMLight::update_linear_component_mkl_linadd_helper, (void*)&params[t]);
-		}
-
-		for (int32_t i=params[num_threads-2].end; i<num; i++)
-			kernel->compute_by_subkernel(i,&W[i*num_kernels]);
-
-		for (int32_t t=0; t<num_threads-1; t++)
-			pthread_join(threads[t], NULL);
-
-		SG_FREE(params);
-		SG_FREE(threads);
-	}
-#endif
+	// determine contributions of different kernels
+	#pragma omp parallel for
+	for (int32_t i=0; i<num; i++)
+		kernel->compute_by_subkernel(i,&W[i*num_kernels]);
 
 	// restore old weights
 	kernel->set_subkernel_weights(SGVector<float64_t>(w_backup,num_weights));
@@ -1697,19 +1562,6 @@ void CSVMLight::update_linear_component_mkl_linadd(
 	call_mkl_callback(a, label, lin);
 }
 
-void* CSVMLight::update_linear_component_mkl_linadd_helper(void* p)
-{
-	S_THREAD_PARAM_SVMLIGHT* params = (S_THREAD_PARAM_SVMLIGHT*) p;
-
-	int32_t num_kernels=params->kernel->get_num_subkernels();
-
-	// determine contributions of different kernels
-	for (int32_t i=params->start; i<params->end; i++)
-		params->kernel->compute_by_subkernel(i,&(params->W[i*num_kernels]));
-
-	return NULL ;
-}
-
 void CSVMLight::call_mkl_callback(float64_t* a, int32_t* label, float64_t* lin)
 {
 	int32_t num = kernel->get_num_vec_rhs();
@@ -2062,66 +1914,6 @@ int32_t CSVMLight::shrink_problem(
   return(activenum);
 }
 
-void* CSVMLight::reactivate_inactive_examples_linadd_helper(void* p)
-{
-	S_THREAD_PARAM_REACTIVATE_LINADD* params = (S_THREAD_PARAM_REACTIVATE_LINADD*) p;
-
-	CKernel* k = params->kernel;
-	float64_t* lin = params->lin;
-	float64_t* last_lin = params->last_lin;
-	int32_t* active = params->active;
-	int32_t* docs = params->docs;
-	int32_t start = params->start;
-	int32_t end = params->end;
-
-	for (int32_t i=start;i<end;i++)
-	{
-		if (!active[i])
-			lin[i] = last_lin[i]+k->compute_optimized(docs[i]);
-
-		last_lin[i]=lin[i];
-	}
-
-	return NULL;
-}
-
-void* CSVMLight::reactivate_inactive_examples_vanilla_helper(void* p)
-{
-	S_THREAD_PARAM_REACTIVATE_VANILLA* params = (S_THREAD_PARAM_REACTIVATE_VANILLA*) p;
-	ASSERT(params)
-	ASSERT(params->kernel)
-	ASSERT(params->lin)
-	ASSERT(params->aicache)
-	ASSERT(params->a)
-	ASSERT(params->a_old)
-	ASSERT(params->changed2dnum)
-	ASSERT(params->inactive2dnum)
-	ASSERT(params->label)
-
-	CKernel* k = params->kernel;
-	float64_t* lin = params->lin;
-	float64_t* aicache = params->aicache;
-	float64_t* a= params->a;
-	float64_t* a_old = params->a_old;
-	int32_t* changed2dnum = params->changed2dnum;
-	int32_t* inactive2dnum = params->inactive2dnum;
-	int32_t* label = params->label;
-	int32_t start = params->start;
-	int32_t end = params->end;
-
-	for (int32_t ii=start;ii<end;ii++)
-	{
-		int32_t i=changed2dnum[ii];
-		int32_t j=0;
-		ASSERT(i>=0)
-
-		k->get_kernel_row(i,inactive2dnum,aicache);
-		for (int32_t jj=0;(j=inactive2dnum[jj])>=0;jj++)
-			lin[j]+=(a[i]-a_old[i])*aicache[j]*(float64_t)label[i];
-	}
-	return NULL;
-}
-
 void CSVMLight::reactivate_inactive_examples(
 	int32_t* label, float64_t *a, SHRINK_STATE *shrink_state, float64_t *lin,
 	float64_t *c, int32_t totdoc, int32_t iteration, int32_t *inconsistent,
@@ -2130,7 +1922,7 @@ void CSVMLight::reactivate_inactive_examples(
         shrinking. */
      /* Computes lin for those variables from scratch. */
 {
-  register int32_t i,j,ii,jj,t,*changed2dnum,*inactive2dnum;
+  register int32_t i,j,t,*changed2dnum,*inactive2dnum;
   int32_t *changed,*inactive;
   register float64_t *a_old,dist;
   float64_t ex_c,target;
@@ -2154,61 +1946,17 @@ void CSVMLight::reactivate_inactive_examples(
 
 		  if (num_modified>0)
 		  {
-		  		// TODO: port to use OpenMP backend instead of pthread
-#ifdef HAVE_PTHREAD
-				int32_t num_threads=parallel->get_num_threads();
-#else
-				int32_t num_threads=1;
-#endif
-			  ASSERT(num_threads>0)
-			  if (num_threads < 2)
-			  {
-				  S_THREAD_PARAM_REACTIVATE_LINADD params;
-				  params.kernel=kernel;
-				  params.lin=lin;
-				  params.last_lin=shrink_state->last_lin;
-				  params.docs=docs;
-				  params.active=shrink_state->active;
-				  params.start=0;
-				  params.end=totdoc;
-				  reactivate_inactive_examples_linadd_helper((void*) &params);
-			  }
-#ifdef HAVE_PTHREAD
-			  else
-			  {
-				  pthread_t* threads = SG_MALLOC(pthread_t, num_threads-1);
-				  S_THREAD_PARAM_REACTIVATE_LINADD* params = SG_MALLOC(S_THREAD_PARAM_REACTIVATE_LINADD, num_threads);
-				  int32_t step= totdoc/num_threads;
-
-				  for (t=0; t<num_threads-1; t++)
-				  {
-					  params[t].kernel=kernel;
-					  params[t].lin=lin;
-					  params[t].last_lin=shrink_state->last_lin;
-					  params[t].docs=docs;
-					  params[t].active=shrink_state->active;
-					  params[t].start = t*step;
-					  params[t].end = (t+1)*step;
-					  pthread_create(&threads[t], NULL, CSVMLight::reactivate_inactive_examples_linadd_helper, (void*)&params[t]);
-				  }
+			  float64_t* last_lin=shrink_state->last_lin;
+			  int32_t* active=shrink_state->active;
 
-				  params[t].kernel=kernel;
-				  params[t].lin=lin;
-				  params[t].last_lin=shrink_state->last_lin;
-				  params[t].docs=docs;
-				  params[t].active=shrink_state->active;
-				  params[t].start = t*step;
-				  params[t].end = totdoc;
-				  reactivate_inactive_examples_linadd_helper((void*) &params[t]);
-
-				  for (t=0; t<num_threads-1; t++)
-					  pthread_join(threads[t], NULL);
+			  #pragma omp parallel for
+			  for (int32_t k=0;k<totdoc;k++)
+			  {
+				  if (!active[k])
+					  lin[k]=last_lin[k]+kernel->compute_optimized(docs[k]);
 
-				  SG_FREE(threads);
-				  SG_FREE(params);
+				  last_lin[k]=lin[k];
 			  }
-#endif
-
 		  }
 	  }
 	  else
@@ -2293,86 +2041,8 @@ void CSVMLight::reactivate_inactive_examples(
 		  compute_index(inactive,totdoc,inactive2dnum);
 		  compute_index(changed,totdoc,changed2dnum);
 
-
-		  //TODO: PUT THIS BACK IN!!!!!!!! int32_t num_threads=parallel->get_num_threads();
-		  int32_t num_threads=1;
-		  ASSERT(num_threads>0)
-
-		  if (num_threads < 2)
-		  {
-			  for (ii=0;(i=changed2dnum[ii])>=0;ii++) {
-				  kernel->get_kernel_row(i,inactive2dnum,aicache);
-				  for (jj=0;(j=inactive2dnum[jj])>=0;jj++)
-					  lin[j]+=(a[i]-a_old[i])*aicache[j]*(float64_t)label[i];
-			  }
-		  }
-#ifdef HAVE_PTHREAD
-		  else
-		  {
-			  //find number of the changed ones
-			  int32_t num_changed=0;
-			  for (ii=0;changed2dnum[ii]>=0;ii++)
-				  num_changed++;
-
-			  if (num_changed>0)
-			  {
-				  pthread_t* threads= SG_MALLOC(pthread_t, num_threads-1);
-				  S_THREAD_PARAM_REACTIVATE_VANILLA* params = SG_MALLOC(S_THREAD_PARAM_REACTIVATE_VANILLA, num_threads);
-				  int32_t step= num_changed/num_threads;
-
-				  // alloc num_threads many tmp buffers
-				  float64_t* tmp_lin=SG_MALLOC(float64_t, totdoc*num_threads);
-				  memset(tmp_lin, 0, sizeof(float64_t)*((size_t) totdoc)*num_threads);
-				  float64_t* tmp_aicache=SG_MALLOC(float64_t, totdoc*num_threads);
-				  memset(tmp_aicache, 0, sizeof(float64_t)*((size_t) totdoc)*num_threads);
-
-				  int32_t thr;
-				  for (thr=0; thr<num_threads-1; thr++)
-				  {
-					  params[thr].kernel=kernel;
-					  params[thr].lin=&tmp_lin[thr*totdoc];
-					  params[thr].aicache=&tmp_aicache[thr*totdoc];
-					  params[thr].a=a;
-					  params[thr].a_old=a_old;
-					  params[thr].changed2dnum=changed2dnum;
-					  params[thr].inactive2dnum=inactive2dnum;
-					  params[thr].label=label;
-					  params[thr].start = thr*step;
-					  params[thr].end = (thr+1)*step;
-					  pthread_create(&threads[thr], NULL, CSVMLight::reactivate_inactive_examples_vanilla_helper, (void*)&params[thr]);
-				  }
-
-				  params[thr].kernel=kernel;
-				  params[thr].lin=&tmp_lin[thr*totdoc];
-				  params[thr].aicache=&tmp_aicache[thr*totdoc];
-				  params[thr].a=a;
-				  params[thr].a_old=a_old;
-				  params[thr].changed2dnum=changed2dnum;
-				  params[thr].inactive2dnum=inactive2dnum;
-				  params[thr].label=label;
-				  params[thr].start = thr*step;
-				  params[thr].end = num_changed;
-				  reactivate_inactive_examples_vanilla_helper((void*) &params[thr]);
-
-				  for (jj=0;(j=inactive2dnum[jj])>=0;jj++)
-					  lin[j]+=tmp_lin[totdoc*thr+j];
-
-				  for (thr=0; thr<num_threads-1; thr++)
-				  {
-					  pthread_join(threads[thr], NULL);
-
-					  //add up results
-					  for (jj=0;(j=inactive2dnum[jj])>=0;jj++)
-						  lin[j]+=tmp_lin[totdoc*thr+j];
-				  }
-
-				  SG_FREE(tmp_lin);
-				  SG_FREE(tmp_aicache);
-				  SG_FREE(threads);
-				  SG_FREE(params);
-			  }
-		  }
-#endif
+		  update_linear_component_rows(changed2dnum, inactive2dnum, a, a_old,
+			  label, totdoc, lin);
 	  }
 	  SG_FREE(changed);
 	  SG_FREE(changed2dnum);
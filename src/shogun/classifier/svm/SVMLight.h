@@ -440,11 +440,20 @@ class CSVMLight : public CSVM
 	float64_t* a_old, int32_t *working2dnum, int32_t totdoc, float64_t *lin,
 	float64_t *aicache, float64_t* c);
 
-  /** helper for update linear component MKL linadd
+  /** update linear component with the kernel rows of the changed
+   * variables, the rows are fetched in batches by several threads
    *
-   * @param p p
+   * @param rows2dnum index of the variables whose rows are added
+   * @param cols2dnum index of the variables whose linear component is updated
+   * @param a a
+   * @param a_old old a
+   * @param label label
+   * @param totdoc totdoc
+   * @param lin lin
    */
-  static void* update_linear_component_mkl_linadd_helper(void* p);
+  void update_linear_component_rows(
+	int32_t* rows2dnum, int32_t* cols2dnum, float64_t* a, float64_t* a_old,
+	int32_t* label, int32_t totdoc, float64_t* lin);
 
   /** update linear component MKL
    *
@@ -610,29 +619,9 @@ protected:
 		return kernel->kernel(i, j);
 	}
 
-	/** helper for compute kernel
-	 *
-	 * @param p p
-	 */
-	static void* compute_kernel_helper(void* p);
 
-	/** helper for update linear component linadd
-	 *
-	 * @param p p
-	 */
-	static void* update_linear_component_linadd_helper(void* p);
 
-	/** helper for reactivate inactive examples vanilla
-	 *
-	 * @param p p
-	 */
-	static void* reactivate_inactive_examples_vanilla_helper(void* p);
 
-	/** helper for reactivate inactive examples linadd
-	 *
-	 * @param p p
-	 */
-	static void* reactivate_inactive_examples_linadd_helper(void* p);
 
 	/* interface to QP-solver */
 	float64_t *optimize_qp( QP *qp,float64_t *epsilon_crit, int32_t nx,
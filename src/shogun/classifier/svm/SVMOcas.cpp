@@ -69,8 +69,9 @@ bool CSVMOcas::train_machine(CFeatures* data)
 	for (int32_t i=0; i<num_vec; i++)
 		lab[i] = ((CBinaryLabels*)m_labels)->get_label(i);
 
-	current_w = SGVector<float64_t>(features->get_dim_feature_space());
-	current_w.zero();
+	/* compute_W() swaps the data with old_w, so both use SG_MALLOC */
+	int32_t dim=features->get_dim_feature_space();
+	current_w = SGVector<float64_t>(SG_CALLOC(float64_t, dim), dim);
 
 	if (num_vec!=lab.vlen || num_vec<=0)
 		SG_ERROR("num_vec=%d num_train_labels=%d\n", num_vec, lab.vlen)
@@ -12,6 +12,8 @@
 #include <shogun/mathematics/Math.h>
 #include <shogun/mathematics/eigen3.h>
 
+#include <vector>
+
 using namespace shogun;
 using namespace Eigen;
 
@@ -34,11 +36,7 @@ namespace {
 		return std::tanh(x * alpha);
 	}
 
-	float64_t g_x(float64_t x)
-	{
-		return alpha * (1.0 - pow(gx(x),2));
-	}
-
+	// the derivative alpha * (1 - gx(x)^2) is computed from gx(x)
 };
 
 CFastICA::CFastICA() : CICAConverter()
@@ -124,15 +122,39 @@ void CFastICA::fit_dense(CDenseFeatures<float64_t>* features)
 
 	W = sym_decorrelation(W);
 
+	const index_t dim = WX.rows();
+	const index_t num_blocks = (p + BLOCK_SIZE - 1) / BLOCK_SIZE;
+
 	float64_t lim = tol+1;
 	for (auto i : SG_PROGRESS(range(0, max_iter), [&] { return lim > tol; }))
 	{
-		MatrixXd wtx = W * WX;
+		// Evaluate the contrast and its derivative on blocks of samples
+		std::vector<MatrixXd> block_gwtx_WX(num_blocks);
+		std::vector<VectorXd> block_g_wtx_sum(num_blocks);
 
-		MatrixXd gwtx = wtx.unaryExpr(std::ptr_fun(&gx));
-		MatrixXd g_wtx = wtx.unaryExpr(std::ptr_fun(&g_x));
+		#pragma omp parallel for schedule(static)
+		for (index_t b = 0; b < num_blocks; b++)
+		{
+			const index_t begin = b * BLOCK_SIZE;
+			const index_t len = CMath::min(BLOCK_SIZE, p - begin);
+			auto WX_block = WX.middleCols(begin, len);
+
+			MatrixXd gwtx = (W * WX_block).unaryExpr(&gx);
+			block_g_wtx_sum[b] =
+			    (alpha * (1.0 - gwtx.array().square())).matrix().rowwise().sum();
+			block_gwtx_WX[b].noalias() = gwtx * WX_block.transpose();
+		}
+
+		// summed in the order of the blocks for reproducible results
+		MatrixXd gwtx_WX = MatrixXd::Zero(m, dim);
+		VectorXd g_wtx_sum = VectorXd::Zero(m);
+		for (index_t b = 0; b < num_blocks; b++)
+		{
+			gwtx_WX += block_gwtx_WX[b];
+			g_wtx_sum += block_g_wtx_sum[b];
+		}
 
-		MatrixXd W1 = (gwtx * WX.transpose()) / (float64_t)p - (g_wtx.rowwise().sum()/(float64_t)p).asDiagonal() * W;
+		MatrixXd W1 = gwtx_WX / (float64_t)p - (g_wtx_sum/(float64_t)p).asDiagonal() * W;
 
 		W1 = sym_decorrelation(W1);
 
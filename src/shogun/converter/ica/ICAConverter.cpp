@@ -6,12 +6,17 @@
 
 #include <shogun/converter/ica/ICAConverter.h>
 #include <shogun/features/DenseFeatures.h>
+#include <shogun/mathematics/Math.h>
 #include <shogun/mathematics/eigen3.h>
 #include <shogun/mathematics/linalg/LinalgNamespace.h>
 
+#include <vector>
+
 using namespace shogun;
 using namespace Eigen;
 
+const index_t CICAConverter::BLOCK_SIZE = 1024;
+
 CICAConverter::CICAConverter() : CConverter()
 {
 	init();
@@ -106,3 +111,72 @@ CFeatures* CICAConverter::inverse_transform(CFeatures* features, bool inplace)
 
 	return new CDenseFeatures<float64_t>(X);
 }
+
+SGNDArray<float64_t> CICAConverter::lagged_covariances(
+    SGMatrix<float64_t> X, SGVector<float64_t> tau)
+{
+	const index_t n = X.num_rows;
+	const index_t T = X.num_cols;
+	const index_t N = tau.vlen;
+	for (index_t t = 0; t < N; t++)
+	{
+		REQUIRE(
+		    tau[t] >= 0 && index_t(tau[t]) < T,
+		    "Time lag %d (%f) must be in [0, %d)\n", t, tau[t], T);
+	}
+
+	Map<MatrixXd> EX(X.matrix, n, T);
+	VectorXd mean = EX.rowwise().sum() / (float64_t)T;
+	MatrixXd C = EX.colwise() - mean;
+
+	index_t* dims = SG_MALLOC(index_t, 3);
+	dims[0] = n;
+	dims[1] = n;
+	dims[2] = N;
+	SGNDArray<float64_t> covs(dims, 3);
+	covs.set_const(0);
+
+	const index_t num_blocks = (T + BLOCK_SIZE - 1) / BLOCK_SIZE;
+
+	// lagged products of each block and lag, block by block
+	std::vector<MatrixXd> partial(num_blocks * N);
+
+	#pragma omp parallel for schedule(static)
+	for (index_t b = 0; b < num_blocks; b++)
+	{
+		const index_t begin = b * BLOCK_SIZE;
+		for (index_t t = 0; t < N; t++)
+		{
+			const index_t lag = index_t(tau[t]);
+			const index_t end = CMath::min(begin + BLOCK_SIZE, T - lag);
+			if (end > begin)
+			{
+				partial[b * N + t].noalias() =
+				    C.middleCols(begin, end - begin) *
+				    C.middleCols(begin + lag, end - begin).transpose();
+			}
+		}
+	}
+
+	// summed in the order of the blocks for reproducible results
+	for (index_t b = 0; b < num_blocks; b++)
+	{
+		for (index_t t = 0; t < N; t++)
+		{
+			if (partial[b * N + t].size())
+			{
+				Map<MatrixXd> EM(covs.get_matrix(t), n, n);
+				EM += partial[b * N + t];
+			}
+		}
+	}
+
+	for (index_t t = 0; t < N; t++)
+	{
+		Map<MatrixXd> EM(covs.get_matrix(t), n, n);
+		EM /= (float64_t)(T - index_t(tau[t]));
+		EM = (EM + EM.transpose()).eval() / 2.0;
+	}
+
+	return covs;
+}
@@ -11,6 +11,8 @@
 #include <shogun/converter/Converter.h>
 #include <shogun/features/Features.h>
 #include <shogun/lib/SGMatrix.h>
+#include <shogun/lib/SGNDArray.h>
+#include <shogun/lib/SGVector.h>
 
 namespace shogun
 {
@@ -100,6 +102,20 @@ namespace shogun
 
 		virtual void fit_dense(CDenseFeatures<float64_t>* features) = 0;
 
+		/** computes the symmetrized time-delayed covariance matrices of
+		 * the centered signals, which are fed to the approximate joint
+		 * diagonalizers. The samples are split into blocks that are
+		 * processed in parallel.
+		 * @param X signals, one row per channel and one column per sample
+		 * @param tau time lags
+		 * @return one covariance matrix per time lag
+		 */
+		static SGNDArray<float64_t> lagged_covariances(
+		    SGMatrix<float64_t> X, SGVector<float64_t> tau);
+
+		/** number of samples of a block of parallel computations */
+		static const index_t BLOCK_SIZE;
+
 		/** mixing_matrix */
 		SGMatrix<float64_t> m_mixing_matrix;
 
@@ -93,24 +93,22 @@ void CJade::fit_dense(CDenseFeatures<float64_t>* features)
 	m_cumulant_matrix = SGMatrix<float64_t>(m,m*nbcm);	// Storage for cumulant matrices
 	Map<MatrixXd> CM(m_cumulant_matrix.matrix,m,m*nbcm);
 	MatrixXd R(m,m); R.setIdentity();
-	MatrixXd Qij = MatrixXd::Zero(m,m); // Temp for a cum. matrix
-	VectorXd Xim = VectorXd::Zero(m); // Temp
-	VectorXd Xjm = VectorXd::Zero(m); // Temp
-	VectorXd Xijm = VectorXd::Zero(m); // Temp
-	int Range = 0;
 
+	// The cumulant matrices of each row are independent, rows are
+	// scheduled dynamically as their number of matrices grows with im
+	#pragma omp parallel for schedule(dynamic)
 	for (int im = 0; im < m; im++)
 	{
-		Xim = SPX.row(im);
-		Xijm = Xim.cwiseProduct(Xim);
-		Qij = SPX.cwiseProduct(Xijm.replicate(1,m).transpose()) * SPX.transpose() / (float)T - R - 2*R.col(im)*R.col(im).transpose();
+		int Range = (im * (im + 1)) / 2 * m;
+		VectorXd Xim = SPX.row(im);
+		VectorXd Xijm = Xim.cwiseProduct(Xim);
+		MatrixXd Qij = SPX * Xijm.asDiagonal() * SPX.transpose() / (float)T - R - 2*R.col(im)*R.col(im).transpose();
 		CM.block(0,Range,m,m) = Qij;
 		Range = Range + m;
 		for (int jm = 0; jm < im; jm++)
 		{
-			Xjm = SPX.row(jm);
-			Xijm = Xim.cwiseProduct(Xjm);
-			Qij = SPX.cwiseProduct(Xijm.replicate(1,m).transpose()) * SPX.transpose() / (float)T - R.col(im)*R.col(jm).transpose() - R.col(jm)*R.col(im).transpose();
+			Xijm = Xim.cwiseProduct(SPX.row(jm).transpose());
+			Qij = SPX * Xijm.asDiagonal() * SPX.transpose() / (float)T - R.col(im)*R.col(jm).transpose() - R.col(jm)*R.col(im).transpose();
 			CM.block(0,Range,m,m) =  sqrt(2)*Qij;
 			Range = Range + m;
 		}
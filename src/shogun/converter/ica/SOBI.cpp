@@ -16,8 +16,6 @@
 using namespace shogun;
 using namespace Eigen;
 
-namespace { MatrixXd cor(MatrixXd x, int tau = 0, bool mean_flag = true); };
-
 CSOBI::CSOBI() : CICAConverter()
 {
 	init();
@@ -58,32 +56,26 @@ void CSOBI::fit_dense(CDenseFeatures<float64_t>* features)
 
 	int n = X.num_rows;
 	int m = X.num_cols;
-	int N = m_tau.vlen;
 
 	Map<MatrixXd> EX(X.matrix,n,m);
 
 	// Whitening or Sphering
-	MatrixXd M0 = cor(EX,int(m_tau[0]));
+	SGVector<float64_t> tau0(1);
+	tau0[0] = m_tau[0];
+	auto covs0 = lagged_covariances(X, tau0);
+	Map<MatrixXd> M0(covs0.get_matrix(0),n,n);
 	EigenSolver<MatrixXd> eig;
 	eig.compute(M0);
 	MatrixXd EVMsqrt = eig.pseudoEigenvalueMatrix().cwiseSqrt();
 	MatrixXd SPH = (eig.pseudoEigenvectors() * EVMsqrt *
 	                eig.pseudoEigenvectors().transpose())
 	                   .inverse();
-	MatrixXd spx = SPH * EX;
+	SGMatrix<float64_t> spx(n,m);
+	Map<MatrixXd> Espx(spx.matrix,n,m);
+	Espx = SPH * EX;
 
 	// Compute Correlation Matrices
-	index_t * M_dims = SG_MALLOC(index_t, 3);
-	M_dims[0] = n;
-	M_dims[1] = n;
-	M_dims[2] = N;
-	m_covs = SGNDArray< float64_t >(M_dims, 3);
-
-	for(int t = 0; t < N; t++)
-	{
-		Map<MatrixXd> EM(m_covs.get_matrix(t),n,n);
-		EM = cor(spx,m_tau[t]);
-	}
+	m_covs = lagged_covariances(spx, m_tau);
 
 	// Diagonalize
 	SGMatrix<float64_t> Q = CJADiagOrth::diagonalize(m_covs);
@@ -100,34 +92,3 @@ void CSOBI::fit_dense(CDenseFeatures<float64_t>* features)
 		C.col(t) /= C.col(t).maxCoeff();
 	}
 }
-
-// Computing time delayed correlation matrix
-namespace
-{
-	MatrixXd cor(MatrixXd x, int tau, bool mean_flag)
-	{
-		int m = x.rows();
-		int n = x.cols();
-
-		// Center the data
-		if ( mean_flag )
-		{
-			VectorXd mean = x.rowwise().sum();
-			mean /= n;
-			x = x.colwise() - mean;
-		}
-
-		// Time-delayed Signal Matrix
-		MatrixXd L = x.leftCols(n-tau);
-		MatrixXd R = x.rightCols(n-tau);
-
-		// Compute Correlations
-		MatrixXd K(m,m);
-		K = (L * R.transpose()) / (n-tau);
-
-		// Symmetrize
-		K = (K + K.transpose()) / 2.0;
-
-		return K;
-	}
-};
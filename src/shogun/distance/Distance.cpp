@@ -266,6 +266,7 @@ void CDistance::init()
 template <class T>
 SGMatrix<T> CDistance::get_distance_matrix()
 {
+	SG_TRACE_SCOPE("CDistance::get_distance_matrix");
 	T* result = NULL;
 
 	REQUIRE(has_features(), "no features assigned to distance\n")
@@ -275,7 +276,6 @@ SGMatrix<T> CDistance::get_distance_matrix()
 	int32_t n=get_num_vec_rhs();
 
 	int64_t total_num = int64_t(m)*n;
-	int64_t total=0;
 
 	// if lhs == rhs and sizes match assume k(i,j)=k(j,i)
 	bool symmetric= (lhs && lhs==rhs && m==n);
@@ -303,12 +303,11 @@ SGMatrix<T> CDistance::get_distance_matrix()
 		step=total_num;
 		int32_t thread_num=0;
 #endif
-		bool verbose=(thread_num == 0);
-
 		int32_t start=compute_row_start(thread_num*step, n, symmetric);
 		int32_t end=(thread_num==num_threads) ? m : compute_row_start((thread_num+1)*step, n, symmetric);
 
-		for (int32_t i=start; i<end; i++)
+		auto batch = pb.batch();
+		for (int32_t i = start; i < end && !pb.cancelled(); i++)
 		{
 			int32_t j_start=0;
 
@@ -322,25 +321,19 @@ SGMatrix<T> CDistance::get_distance_matrix()
 
 				if (symmetric && i!=j)
 					result[j+i*m]=v;
-
-				if (verbose)
-				{
-					total++;
-
-					if (symmetric && i!=j)
-						total++;
-
-					pb.print_progress();
-
-					// TODO: replace with new signal
-					// if (CSignal::cancel_computations())
-					//	break;
-				}
 			}
+
+			batch.step(symmetric ? 2 * (n - j_start) - 1 : n);
 		}
 	}
 	pb.complete();
 
+	if (pb.cancelled())
+	{
+		SG_FREE(result);
+		SG_ERROR("Computation of the distance matrix was cancelled\n")
+	}
+
 	return SGMatrix<T>(result,m,n,true);
 }
 
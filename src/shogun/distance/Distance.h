@@ -19,6 +19,7 @@
 #include <shogun/features/FeatureTypes.h>
 #include <shogun/features/Features.h>
 #include <shogun/lib/SGMatrix.h>
+#include <shogun/lib/Tracer.h>
 
 namespace shogun
 {
@@ -148,6 +149,9 @@ class CDistance : public CSGObject
 		virtual void reset_precompute(){}
 
 		/** get distance matrix
+		 *
+		 * Raises an error if the computation is cancelled, see
+		 * CSignal::cancel_computations().
 		 *
 		 * @return computed distance matrix (needs to be cleaned up)
 		 */
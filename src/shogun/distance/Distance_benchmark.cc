@@ -0,0 +1,103 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ */
+
+#include <shogun/util/benchmark_utilities.h>
+
+#include <shogun/distance/BrayCurtisDistance.h>
+#include <shogun/distance/CanberraMetric.h>
+#include <shogun/distance/ChebyshewMetric.h>
+#include <shogun/distance/ChiSquareDistance.h>
+#include <shogun/distance/CosineDistance.h>
+#include <shogun/distance/EuclideanDistance.h>
+#include <shogun/distance/GeodesicMetric.h>
+#include <shogun/distance/JensenMetric.h>
+#include <shogun/distance/ManhattanMetric.h>
+#include <shogun/distance/MinkowskiMetric.h>
+#include <shogun/distance/TanimotoDistance.h>
+
+#include <functional>
+
+namespace shogun
+{
+
+/** dimension of the features */
+static const index_t NUM_DIM = 32;
+
+/* distances on dense real features */
+static std::vector<std::pair<std::string, std::function<CDistance*()>>>
+dense_distances()
+{
+	return {
+	    {"BrayCurtisDistance", [] { return new CBrayCurtisDistance(); }},
+	    {"CanberraMetric", [] { return new CCanberraMetric(); }},
+	    {"ChebyshewMetric", [] { return new CChebyshewMetric(); }},
+	    {"ChiSquareDistance", [] { return new CChiSquareDistance(); }},
+	    {"CosineDistance", [] { return new CCosineDistance(); }},
+	    {"EuclideanDistance", [] { return new CEuclideanDistance(); }},
+	    {"GeodesicMetric", [] { return new CGeodesicMetric(); }},
+	    {"JensenMetric", [] { return new CJensenMetric(); }},
+	    {"ManhattanMetric", [] { return new CManhattanMetric(); }},
+	    {"MinkowskiMetric", [] { return new CMinkowskiMetric(3.0); }},
+	    {"TanimotoDistance", [] { return new CTanimotoDistance(); }},
+	};
+}
+
+/** computes the n x n matrix of pairwise distances */
+static void BM_Distance_pairwise(
+    benchmark::State& state, std::function<CDistance*()> create_distance)
+{
+	auto feats = create_random_features(NUM_DIM, state.range(0));
+	auto distance = wrap(create_distance());
+	distance->init(feats, feats);
+	ScopedNumThreads num_threads(state.range(1));
+
+	for (auto _ : state)
+		benchmark::DoNotOptimize(distance->get_distance_matrix());
+
+	state.SetItemsProcessed(state.iterations() * state.range(0) * state.range(0));
+}
+
+/** computes the distances of a few queries to all vectors, as in kNN */
+static void BM_Distance_queries(
+    benchmark::State& state, std::function<CDistance*()> create_distance)
+{
+	const index_t num_queries = 16;
+	auto feats = create_random_features(NUM_DIM, state.range(0));
+	auto queries = create_random_features(NUM_DIM, num_queries);
+	auto distance = wrap(create_distance());
+	distance->init(feats, queries);
+
+	for (auto _ : state)
+	{
+		for (auto j : range(num_queries))
+			for (auto i : range(state.range(0)))
+				benchmark::DoNotOptimize(distance->distance(i, j));
+	}
+
+	state.SetItemsProcessed(state.iterations() * state.range(0) * num_queries);
+}
+
+static bool register_distance_benchmarks()
+{
+	for (const auto& distance : dense_distances())
+	{
+		auto b = benchmark::RegisterBenchmark(
+		    ("BM_Distance_pairwise/" + distance.first).c_str(),
+		    BM_Distance_pairwise, distance.second);
+		add_size_and_thread_args(b, 256, 1024);
+		b->Unit(benchmark::kMillisecond)->UseRealTime();
+
+		benchmark::RegisterBenchmark(
+		    ("BM_Distance_queries/" + distance.first).c_str(),
+		    BM_Distance_queries, distance.second)
+		    ->RangeMultiplier(4)
+		    ->Range(1024, 16384)
+		    ->Unit(benchmark::kMicrosecond);
+	}
+	return true;
+}
+
+static const bool distance_benchmarks_registered =
+    register_distance_benchmarks();
+}
@@ -193,8 +193,10 @@ float64_t CGaussian::update_params_em(const SGVector<float64_t> alpha_k)
 
 		SGVector<float64_t> d0(num_dim);
 #ifdef HAVE_LAPACK
-		d0.vector = SGMatrix<float64_t>::compute_eigenvectors(
-		    cov_sum.matrix, num_dim, num_dim);
+		d0 = SGVector<float64_t>(
+		    SGMatrix<float64_t>::compute_eigenvectors(
+		        cov_sum.matrix, num_dim, num_dim),
+		    num_dim);
 #else
 		// FIXME use eigenvectors computeation warpper by micmn
 		typename SGMatrix<float64_t>::EigenMatrixXtMap eig = cov_sum;
@@ -356,8 +358,10 @@ void CGaussian::decompose_cov(SGMatrix<float64_t> cov)
 		m_u = cov.clone();
 		m_d = SGVector<float64_t>(cov.num_rows);
 #ifdef HAVE_LAPACK
-		m_d.vector = SGMatrix<float64_t>::compute_eigenvectors(
-		    m_u.matrix, cov.num_rows, cov.num_rows);
+		m_d = SGVector<float64_t>(
+		    SGMatrix<float64_t>::compute_eigenvectors(
+		        m_u.matrix, cov.num_rows, cov.num_rows),
+		    cov.num_rows);
 #else
 		// FIXME use eigenvectors computeation warpper by micmn
 		typename SGMatrix<float64_t>::EigenMatrixXtMap eig = m_u;
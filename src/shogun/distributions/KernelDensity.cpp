@@ -35,7 +35,7 @@
 
 using namespace shogun;
 
-CKernelDensity::CKernelDensity(float64_t bandwidth, EKernelType kernel, EDistanceType dist, EEvaluationMode eval, int32_t leaf_size, float64_t atol, float64_t rtol)
+CKernelDensity::CKernelDensity(float64_t bandwidth, EKDEKernelType kernel, EDistanceType dist, EEvaluationMode eval, int32_t leaf_size, float64_t atol, float64_t rtol)
 : CDistribution()
 {
 	init();
@@ -57,6 +57,8 @@ CKernelDensity::~CKernelDensity()
 bool CKernelDensity::train(CFeatures* data)
 {
 	REQUIRE(data,"Data not supplied\n")
+	REQUIRE(is_supported(m_kernel_type),"Kernel type (%d) is not supported\n",m_kernel_type)
+	REQUIRE(m_atol>=0 && m_rtol>=0,"Tolerances (%f, %f) must not be negative\n",m_atol,m_rtol)
 	CDenseFeatures<float64_t>* dense_data=data->as<CDenseFeatures<float64_t>>();
 
 	SG_UNREF(tree);
@@ -95,6 +97,7 @@ bool CKernelDensity::train(CFeatures* data)
 SGVector<float64_t> CKernelDensity::get_log_density(CDenseFeatures<float64_t>* test, int32_t leaf_size)
 {
 	REQUIRE(test,"data not supplied\n")
+	REQUIRE(tree,"Kernel density is not trained\n")
 
 	if ((m_eval==EM_KDTREE_SINGLE) || (m_eval==EM_BALLTREE_SINGLE))
 		return tree->log_kernel_density(test->get_feature_matrix(),m_kernel_type,m_bandwidth,m_atol,m_rtol);
@@ -108,17 +111,8 @@ SGVector<float64_t> CKernelDensity::get_log_density(CDenseFeatures<float64_t>* t
 		SG_ERROR("Evaluation mode not identified\n");
 
 	query_tree->build_tree(test);
-	CBinaryTreeMachineNode<NbodyTreeNodeData>* qroot=NULL;
-	CTreeMachineNode<NbodyTreeNodeData>* root=query_tree->get_root();
-	if (root)
-		qroot=dynamic_cast<CBinaryTreeMachineNode<NbodyTreeNodeData>*>(root);
-	else
-		SG_ERROR("Query tree root not found!\n")
-
-	SGVector<index_t> qid=query_tree->get_rearranged_vector_ids();
-	SGVector<float64_t> ret=tree->log_kernel_density_dual(test->get_feature_matrix(),qid,qroot,m_kernel_type,m_bandwidth,m_atol,m_rtol);
+	SGVector<float64_t> ret=tree->log_kernel_density_dual(query_tree,m_kernel_type,m_bandwidth,m_atol,m_rtol);
 
-	SG_UNREF(root);
 	SG_UNREF(query_tree);
 
 	return ret;
@@ -152,7 +146,7 @@ void CKernelDensity::init()
 {
 	m_bandwidth=1.0;
 	m_eval=EM_KDTREE_SINGLE;
-	m_kernel_type=K_GAUSSIAN;
+	m_kernel_type=KDE_GAUSSIAN;
 	m_dist=D_EUCLIDEAN;
 	m_leaf_size=1;
 	m_atol=0;
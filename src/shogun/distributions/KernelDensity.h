@@ -33,8 +33,8 @@
 
 #include <shogun/lib/config.h>
 #include <shogun/distributions/Distribution.h>
-#include <shogun/kernel/Kernel.h>
-#include <shogun/multiclass/tree/NbodyTree.h>
+#include <shogun/features/DenseFeatures.h>
+#include <shogun/distance/Distance.h>
 
 namespace shogun
 {
@@ -48,15 +48,33 @@ enum EEvaluationMode
 	EM_BALLTREE_DUAL
 };
 
+/** Kernel function of KDE, see CKernelDensity */
+enum EKDEKernelType
+{
+	KDE_GAUSSIAN,
+	KDE_EXPONENTIAL,
+	KDE_EPANECHNIKOV,
+	KDE_TOPHAT
+};
+
+class CNbodyTree;
+
 /** @brief This class implements the kernel density estimation technique. Kernel density estimation is a non-parametric
  * way to estimate an unknown pdf. The pdf at a query point given finite training samples is calculated using the
  * following formula : \\
  * \f$pdf(x')= \frac{1}{nh} \sum_{i=1}^n K(\frac{||x-x_i||}{h})\f$ \\
  * K() in the above formula is called the kernel function and is controlled by the parameter h called kernel bandwidth.
- * Presently, this class supports only Gaussian kernel which can be used with either Euclidean distance or Manhattan
- * distance. This class makes use of 2 tree structures KD-tree and Ball tree for fast calculation. KD-trees are
+ * The supported kernels are Gaussian (KDE_GAUSSIAN), exponential (KDE_EXPONENTIAL), Epanechnikov (KDE_EPANECHNIKOV)
+ * and tophat (KDE_TOPHAT), which can be used with either Euclidean distance or Manhattan distance; the kernels are
+ * normalized for Euclidean distance. The Epanechnikov and tophat kernels vanish beyond h, so node pairs further apart are
+ * pruned exactly. This class makes use of 2 tree structures KD-tree and Ball tree for fast calculation. KD-trees are
  * faster than ball trees at lower dimensions. In case of high dimensional data, ball tree tends to out-perform KD-tree.
  * By default, the class used is Ball tree.
+ *
+ * The density may be approximated: a tree node is not expanded once the uncertainty of its contribution is within
+ * its share of atol*N+rtol*density, so that the total error of a query point is about atol absolute plus rtol relative.
+ * Both are 0 by default, which gives the exact density. Query points are evaluated in parallel, in the dual tree
+ * modes by traversing subtrees of the query tree in parallel.
  */
 class CKernelDensity : public CDistribution
 {
@@ -71,7 +89,7 @@ public :
 	 * @param atol absolute tolerance
 	 * @param rtol relative tolerance
 	 */
-	CKernelDensity(float64_t bandwidth=1.0, EKernelType kernel_type=K_GAUSSIAN, EDistanceType dist=D_EUCLIDEAN, EEvaluationMode eval=EM_BALLTREE_SINGLE, int32_t leaf_size=1, float64_t atol=0, float64_t rtol=0);
+	CKernelDensity(float64_t bandwidth=1.0, EKDEKernelType kernel_type=KDE_GAUSSIAN, EDistanceType dist=D_EUCLIDEAN, EEvaluationMode eval=EM_BALLTREE_SINGLE, int32_t leaf_size=1, float64_t atol=0, float64_t rtol=0);
 
 	/** destructor */
 	~CKernelDensity();
@@ -97,6 +115,38 @@ public :
 	 */
 	SGVector<float64_t> get_log_density(CDenseFeatures<float64_t>* test, int32_t leaf_size=1);
 
+	/** set absolute tolerance of the density
+	 *
+	 * @param atol absolute tolerance
+	 */
+	void set_atol(float64_t atol)
+	{
+		REQUIRE(atol>=0,"Absolute tolerance (%f) must not be negative\n",atol)
+		m_atol=atol;
+	}
+
+	/** get absolute tolerance of the density
+	 *
+	 * @return absolute tolerance
+	 */
+	float64_t get_atol() const { return m_atol; }
+
+	/** set relative tolerance of the density
+	 *
+	 * @param rtol relative tolerance
+	 */
+	void set_rtol(float64_t rtol)
+	{
+		REQUIRE(rtol>=0,"Relative tolerance (%f) must not be negative\n",rtol)
+		m_rtol=rtol;
+	}
+
+	/** get relative tolerance of the density
+	 *
+	 * @return relative tolerance
+	 */
+	float64_t get_rtol() const { return m_rtol; }
+
 	/** return number of model parameters
 	 * NOT IMPLEMENTED
 	 *
@@ -129,6 +179,25 @@ public :
 	 */
 	virtual float64_t get_log_likelihood_example(int32_t num_example);
 
+	/** whether a kernel type can be used for density estimation
+	 *
+	 * @param kernel kernel type
+	 * @return whether the kernel is supported
+	 */
+	inline static bool is_supported(EKDEKernelType kernel)
+	{
+		switch(kernel)
+		{
+			case KDE_GAUSSIAN:
+			case KDE_EXPONENTIAL:
+			case KDE_EPANECHNIKOV:
+			case KDE_TOPHAT:
+				return true;
+			default:
+				return false;
+		}
+	}
+
 	/** returns norm of a given kernel
 	 *
 	 * @param kernel kernel whose norm is to be calculated
@@ -136,16 +205,38 @@ public :
 	 * @param dim kernel dimension
 	 * @return log of norm of kernel
 	 */
-	inline static float64_t log_norm(EKernelType kernel, float64_t width, int32_t dim)
+	inline static float64_t log_norm(EKDEKernelType kernel, float64_t width, int32_t dim)
 	{
+		// log of volume of the unit ball
+		float64_t log_unit_volume = 0.5 * dim * std::log(CMath::PI) -
+		                            std::lgamma(0.5 * dim + 1);
+
 		switch(kernel)
 		{
-			case K_GAUSSIAN:
+			case KDE_GAUSSIAN:
 			{
 				return -0.5 * dim * std::log(2 * CMath::PI) -
 				       dim * std::log(width);
 				break;
 			}
+			case KDE_EXPONENTIAL:
+			{
+				// integral over the ball surface of r^(dim-1) exp(-r)
+				return -log_unit_volume - std::log(dim) -
+				       std::lgamma(dim) - dim * std::log(width);
+				break;
+			}
+			case KDE_EPANECHNIKOV:
+			{
+				return std::log(0.5 * dim + 1) - log_unit_volume -
+				       dim * std::log(width);
+				break;
+			}
+			case KDE_TOPHAT:
+			{
+				return -log_unit_volume - dim * std::log(width);
+				break;
+			}
 			default:
 				SG_SPRINT("kernel type not recognized\n");
 		}
@@ -160,15 +251,36 @@ public :
 	 * @param width kernel width
 	 * @return log of kernel
 	 */
-	inline static float64_t log_kernel(EKernelType kernel, float64_t dist, float64_t width)
+	inline static float64_t log_kernel(EKDEKernelType kernel, float64_t dist, float64_t width)
 	{
 		switch(kernel)
 		{
-			case K_GAUSSIAN:
+			case KDE_GAUSSIAN:
 			{
 				return -0.5*dist*dist/(width*width);
 				break;
 			}
+			case KDE_EXPONENTIAL:
+			{
+				return -dist/width;
+				break;
+			}
+			case KDE_EPANECHNIKOV:
+			{
+				if (dist>=width)
+					return -CMath::INFTY;
+
+				return std::log(1-dist*dist/(width*width));
+				break;
+			}
+			case KDE_TOPHAT:
+			{
+				if (dist>=width)
+					return -CMath::INFTY;
+
+				return 0.0;
+				break;
+			}
 			default:
 				SG_SPRINT("kernel type not recognized\n");
 		}
@@ -197,7 +309,7 @@ private :
 	EEvaluationMode m_eval;
 
 	/** kernel */
-	EKernelType m_kernel_type;
+	EKDEKernelType m_kernel_type;
 
 	/** distance metric */
 	EDistanceType m_dist;
@@ -52,6 +52,9 @@ template<class ST> CDenseFeatures<ST>::CDenseFeatures(const CDenseFeatures & ori
 		m_subset_stack=new CSubsetStack(*orig.m_subset_stack);
 		SG_REF(m_subset_stack);
 	}
+
+	m_max_subset_copy_size = orig.m_max_subset_copy_size;
+	subset_changed_post();
 }
 
 template<class ST> CDenseFeatures<ST>::CDenseFeatures(SGMatrix<ST> matrix) :
@@ -115,6 +118,7 @@ template<class ST> void CDenseFeatures<ST>::free_features()
 template<class ST> void CDenseFeatures<ST>::free_feature_matrix()
 {
 	m_subset_stack->remove_all_subsets();
+	m_subset_matrix=SGMatrix<ST>();
 	feature_matrix=SGMatrix<ST>();
 	num_vectors = 0;
 	num_features = 0;
@@ -130,7 +134,11 @@ template<class ST> ST* CDenseFeatures<ST>::get_feature_vector(int32_t num, int32
 	ST* feat = NULL;
 	dofree = false;
 
-	if (feature_matrix.matrix)
+	if (m_subset_matrix.matrix)
+	{
+		feat = &m_subset_matrix.matrix[num * int64_t(num_features)];
+	}
+	else if (feature_matrix.matrix)
 	{
 		feat = &feature_matrix.matrix[real_num * int64_t(num_features)];
 	}
@@ -141,7 +149,11 @@ template<class ST> ST* CDenseFeatures<ST>::get_feature_vector(int32_t num, int32
 			feat = feature_cache->lock_entry(real_num);
 
 			if (!feat)
+			{
 				feat = feature_cache->set_entry(real_num);
+				if (feat)
+					compute_feature_vector(num, len, feat);
+			}
 		}
 
 		if (!feat)
@@ -195,7 +207,8 @@ template<class ST> SGVector<ST> CDenseFeatures<ST>::get_feature_vector(int32_t n
 
 template<class ST> void CDenseFeatures<ST>::free_feature_vector(ST* feat_vec, int32_t num, bool dofree) const
 {
-	if (feature_cache)
+	/* only vectors served from the cache are pinned */
+	if (feature_cache && !dofree && !feature_matrix.matrix)
 		feature_cache->unlock_entry(m_subset_stack->subset_idx_conversion(num));
 
 	if (dofree)
@@ -204,7 +217,9 @@ template<class ST> void CDenseFeatures<ST>::free_feature_vector(ST* feat_vec, in
 
 template<class ST> void CDenseFeatures<ST>::free_feature_vector(SGVector<ST> vec, int32_t num) const
 {
-	free_feature_vector(vec.vector, num, false);
+	/* vectors computed because the cache was full are not pinned */
+	if (feature_cache && feature_cache->is_entry(vec.vector))
+		free_feature_vector(vec.vector, num, false);
 	vec=SGVector<ST>();
 }
 
@@ -303,6 +318,11 @@ void CDenseFeatures<ST>::copy_feature_matrix(SGMatrix<ST> target, index_t column
 		auto dest=target.matrix+int64_t(num_features)*column_offset;
 		sg_memcpy(dest, src, feature_matrix.size()*sizeof(ST));
 	}
+	else if (m_subset_matrix.matrix)
+	{
+		auto dest=target.matrix+int64_t(num_features)*column_offset;
+		sg_memcpy(dest, m_subset_matrix.matrix, m_subset_matrix.size()*sizeof(ST));
+	}
 	else
 	{
 		for (int32_t i=0; i<num_vecs; ++i)
@@ -394,8 +414,8 @@ template<class ST> void CDenseFeatures<ST>::initialize_cache()
 	if (num_features && num_vectors)
 	{
 		SG_UNREF(feature_cache);
-		feature_cache = new CCache<ST>(get_cache_size(), num_features,
-				num_vectors);
+		feature_cache = new CConcurrentCache<ST>(get_cache_size(),
+				num_features, num_vectors);
 		SG_REF(feature_cache);
 	}
 }
@@ -584,6 +604,44 @@ CFeatures* CDenseFeatures<ST>::shallow_subset_copy()
 	return shallow_copy_features;
 }
 
+template <class ST>
+void CDenseFeatures<ST>::set_max_subset_copy_size(int64_t max_bytes)
+{
+	REQUIRE(max_bytes>=0, "Maximum subset copy size (%ld) cannot be negative!\n", max_bytes);
+	m_max_subset_copy_size = max_bytes;
+	subset_changed_post();
+}
+
+template <class ST>
+int64_t CDenseFeatures<ST>::get_max_subset_copy_size() const
+{
+	return m_max_subset_copy_size;
+}
+
+template <class ST>
+void CDenseFeatures<ST>::subset_changed_post()
+{
+	m_subset_matrix = SGMatrix<ST>();
+
+	if (!m_subset_stack->has_subsets() || !feature_matrix.matrix)
+		return;
+
+	index_t first = 0;
+	index_t num_vecs = get_num_vectors();
+	if (m_subset_stack->is_contiguous_range(first))
+	{
+		m_subset_matrix = SGMatrix<ST>(
+			feature_matrix.matrix + first * int64_t(num_features),
+			num_features, num_vecs, false);
+	}
+	else if (int64_t(num_features) * num_vecs * int64_t(sizeof(ST)) <= m_max_subset_copy_size)
+	{
+		SGMatrix<ST> subset_matrix(num_features, num_vecs);
+		copy_feature_matrix(subset_matrix);
+		m_subset_matrix = subset_matrix;
+	}
+}
+
 template<class ST> ST* CDenseFeatures<ST>::compute_feature_vector(int32_t num, int32_t& len,
 		ST* target) const
 {
@@ -598,6 +656,8 @@ template<class ST> void CDenseFeatures<ST>::init()
 	num_features = 0;
 
 	feature_matrix = SGMatrix<ST>();
+	m_subset_matrix = SGMatrix<ST>();
+	m_max_subset_copy_size = 0;
 	feature_cache = NULL;
 
 	set_generic<ST>();
@@ -608,6 +668,8 @@ template<class ST> void CDenseFeatures<ST>::init()
 	SG_ADD(&feature_matrix, "feature_matrix",
 			"Matrix of feature vectors / 1 vector per column.",
 			ParameterProperties::READONLY);
+	SG_ADD(&m_max_subset_copy_size, "max_subset_copy_size",
+			"Maximum size in bytes of a copy of the active subset.");
 }
 
 #define GET_FEATURE_TYPE(f_type, sg_type)	\
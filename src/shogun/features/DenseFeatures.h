@@ -14,7 +14,7 @@
 #include <shogun/features/DotFeatures.h>
 #include <shogun/features/StringFeatures.h>
 #include <shogun/io/File.h>
-#include <shogun/lib/Cache.h>
+#include <shogun/lib/ConcurrentCache.h>
 #include <shogun/lib/DataType.h>
 #include <shogun/lib/SGMatrix.h>
 #include <shogun/lib/common.h>
@@ -493,6 +493,27 @@ public:
 	virtual CFeatures* shallow_subset_copy();
 #endif
 
+	/** Set the maximum size of a contiguous copy of the active subset.
+	 *
+	 * Vectors of a subset that is a contiguous range of the feature matrix
+	 * are always accessed in place, without index conversion. For other
+	 * subsets whose vectors fit into the given size, the vectors are
+	 * gathered into a contiguous matrix when the subset is added, so that
+	 * subsequent accesses avoid random gathers through the subset indices.
+	 * Writes to vectors obtained while such a copy is active do not reach
+	 * the feature matrix.
+	 *
+	 * @param max_bytes maximum size of the copy in bytes, 0 (default)
+	 * disables copying
+	 */
+	void set_max_subset_copy_size(int64_t max_bytes);
+
+	/** @return maximum size of a contiguous copy of the active subset */
+	int64_t get_max_subset_copy_size() const;
+
+	/** updates the contiguous storage of the active subset */
+	virtual void subset_changed_post();
+
 	/** @return object name */
 	virtual const char* get_name() const { return "DenseFeatures"; }
 
@@ -555,8 +576,15 @@ protected:
 	 * */
 	SGMatrix<ST> feature_matrix;
 
-	/** feature cache */
-	CCache<ST>* feature_cache;
+	/** vectors of the active subset stored contiguously, either in place
+	 * in the feature matrix or a copy, empty if not available */
+	SGMatrix<ST> m_subset_matrix;
+
+	/** maximum size in bytes of a copy of the active subset */
+	int64_t m_max_subset_copy_size;
+
+	/** feature cache, safe to use from several threads */
+	CConcurrentCache<ST>* feature_cache;
 };
 }
 #endif // _DENSEFEATURES__H__
@@ -83,23 +83,20 @@ void CDotFeatures::dense_dot_range(float64_t* output, int32_t start, int32_t sto
 		int32_t t_start=thread_num*step;
 		int32_t t_stop=(thread_num==num_threads) ? stop : (thread_num+1)*step;
 
-#ifdef WIN32
-		for (int32_t i=t_start; i<t_stop; i++)
-#else
-		// TODO: replace with the new signal
-		// for (int32_t i=t_start; i<t_stop &&
-		//		!CSignal::cancel_computations(); i++)
-		for (int32_t i = t_start; i < t_stop; i++)
-#endif
+		auto batch = pb.batch();
+		for (int32_t i = t_start; i < t_stop && !pb.cancelled(); i++)
 		{
 			if (alphas)
 				output[i]=alphas[i]*this->dense_dot(i, vec, dim)+b;
 			else
 				output[i]=this->dense_dot(i, vec, dim)+b;
-			pb.print_progress();
+			batch.step();
 		}
 	}
 	pb.complete();
+
+	if (pb.cancelled())
+		SG_ERROR("Computation of the dot products was cancelled\n")
 }
 
 void CDotFeatures::dense_dot_range_subset(int32_t* sub_index, int32_t num, float64_t* output, float64_t* alphas, float64_t* vec, int32_t dim, float64_t b) const
@@ -129,23 +126,20 @@ void CDotFeatures::dense_dot_range_subset(int32_t* sub_index, int32_t num, float
 		int32_t t_start=thread_num*step;
 		int32_t t_stop=(thread_num==num_threads) ? num : (thread_num+1)*step;
 
-#ifdef WIN32
-		for (int32_t i=t_start; i<t_stop; i++)
-#else
-		// TODO: replace with the new signal
-		// for (int32_t i=t_start; i<t_stop &&
-		//		!CSignal::cancel_computations(); i++)
-		for (int32_t i = t_start; i < t_stop; i++)
-#endif
+		auto batch = pb.batch();
+		for (int32_t i = t_start; i < t_stop && !pb.cancelled(); i++)
 		{
 			if (alphas)
 				output[i]=alphas[sub_index[i]]*this->dense_dot(sub_index[i], vec, dim)+b;
 			else
 				output[i]=this->dense_dot(sub_index[i], vec, dim)+b;
-			pb.print_progress();
+			batch.step();
 		}
 	}
 	pb.complete();
+
+	if (pb.cancelled())
+		SG_ERROR("Computation of the dot products was cancelled\n")
 }
 
 SGMatrix<float64_t> CDotFeatures::get_computed_dot_feature_matrix()
@@ -114,6 +114,9 @@ class CDotFeatures : public CFeatures
 		 * @param b bias
 		 *
 		 * note that the result will be written to output[0...(stop-start-1)]
+		 *
+		 * Raises an error if the computation is cancelled, see
+		 * CSignal::cancel_computations().
 		 */
 		virtual void dense_dot_range(float64_t* output, int32_t start, int32_t stop, float64_t* alphas, float64_t* vec, int32_t dim, float64_t b) const;
 
@@ -127,6 +130,9 @@ class CDotFeatures : public CFeatures
 		 * @param vec dense vector to compute dot product with
 		 * @param dim length of the dense vector
 		 * @param b bias
+		 *
+		 * Raises an error if the computation is cancelled, see
+		 * CSignal::cancel_computations().
 		 */
 		virtual void dense_dot_range_subset(int32_t* sub_index, int32_t num,
 				float64_t* output, float64_t* alphas, float64_t* vec, int32_t dim, float64_t b) const;
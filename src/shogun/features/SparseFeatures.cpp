@@ -37,7 +37,7 @@ template<class ST> CSparseFeatures<ST>::CSparseFeatures(SGMatrix<ST> dense)
 
 template<class ST> CSparseFeatures<ST>::CSparseFeatures(const CSparseFeatures & orig)
 : CDotFeatures(orig), sparse_feature_matrix(orig.sparse_feature_matrix),
-	feature_cache(orig.feature_cache)
+	m_subset_vectors(orig.m_subset_vectors), feature_cache(orig.feature_cache)
 {
 	init();
 
@@ -113,6 +113,9 @@ template<class ST> SGSparseVector<ST> CSparseFeatures<ST>::get_sparse_feature_ve
 	REQUIRE(num>=0 && num<get_num_vectors(),
 		"get_sparse_feature_vector(num=%d): num exceeds [0;%d]\n",
 		num, get_num_vectors()-1);
+	if (!m_subset_vectors.empty())
+		return m_subset_vectors[num];
+
 	index_t real_num=m_subset_stack->subset_idx_conversion(num);
 
 	if (sparse_feature_matrix.sparse_matrix)
@@ -291,9 +294,24 @@ template<class ST> void CSparseFeatures<ST>::free_sparse_features()
 
 template<class ST> void CSparseFeatures<ST>::free_sparse_feature_matrix()
 {
+	m_subset_vectors.clear();
 	sparse_feature_matrix=SGSparseMatrix<ST>();
 }
 
+template<class ST> void CSparseFeatures<ST>::subset_changed_post()
+{
+	m_subset_vectors.clear();
+
+	if (!m_subset_stack->has_subsets() || !sparse_feature_matrix.sparse_matrix)
+		return;
+
+	index_t num_vec=get_num_vectors();
+	m_subset_vectors.reserve(num_vec);
+	for (index_t i=0; i<num_vec; i++)
+		m_subset_vectors.push_back(
+			sparse_feature_matrix[m_subset_stack->subset_idx_conversion(i)]);
+}
+
 template<class ST> void CSparseFeatures<ST>::set_full_feature_matrix(SGMatrix<ST> full)
 {
 	remove_all_subsets();
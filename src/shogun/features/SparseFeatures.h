@@ -19,6 +19,8 @@
 #include <shogun/lib/SGVector.h>
 #include <shogun/lib/SGSparseVector.h>
 
+#include <vector>
+
 namespace shogun
 {
 
@@ -455,6 +457,11 @@ template <class ST> class CSparseFeatures : public CDotFeatures
 		 */
 		virtual CFeatures* copy_subset(SGVector<index_t> indices);
 
+		/** gathers the vectors of the active subset, so that accessing them
+		 * does not require index conversion. Only the (reference counted)
+		 * vector headers are copied, not the feature entries. */
+		virtual void subset_changed_post();
+
 		/** @return object name */
 		virtual const char* get_name() const { return "SparseFeatures"; }
 
@@ -480,6 +487,9 @@ template <class ST> class CSparseFeatures : public CDotFeatures
 		/// array of sparse vectors of size num_vectors
 		SGSparseMatrix<ST> sparse_feature_matrix;
 
+		/// sparse vectors of the active subset, empty if there is none
+		std::vector<SGSparseVector<ST>> m_subset_vectors;
+
 		/** feature cache */
 		CCache< SGSparseVectorEntry<ST> >* feature_cache;
 };
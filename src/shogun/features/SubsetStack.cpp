@@ -184,3 +184,22 @@ void CSubsetStack::remove_subset()
 
 	/* do nothing if nothing on stack */
 }
+
+bool CSubsetStack::is_contiguous_range(index_t& first) const
+{
+	if (!m_active_subset)
+		return false;
+
+	auto& idx = m_active_subset->m_subset_idx;
+	if (!idx.vlen)
+		return false;
+
+	for (index_t i = 1; i < idx.vlen; i++)
+	{
+		if (idx.vector[i] != idx.vector[0] + i)
+			return false;
+	}
+
+	first = idx.vector[0];
+	return true;
+}
@@ -106,6 +106,15 @@ public:
 		return m_active_subset ? m_active_subset->m_subset_idx.vector[idx] : idx;
 	}
 
+	/** checks whether the active subset selects a contiguous range of
+	 * indices in increasing order, i.e. whether it can be accessed through
+	 * an offset instead of index conversion
+	 *
+	 * @param first set to the first index of the range if it is one
+	 * @return true iff a subset is active and it is a contiguous range
+	 */
+	bool is_contiguous_range(index_t& first) const;
+
 private:
 	/** registers and initializes parameters */
 	void init();
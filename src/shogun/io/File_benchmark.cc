@@ -0,0 +1,81 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ */
+
+#include <shogun/util/benchmark_utilities.h>
+
+#include <shogun/features/SparseFeatures.h>
+#include <shogun/io/CSVFile.h>
+#include <shogun/io/LibSVMFile.h>
+
+#include <cstdio>
+
+namespace shogun
+{
+
+/** dimension of the features */
+static const index_t NUM_DIM = 64;
+
+/** loads a dense n x NUM_DIM matrix from a CSV file */
+static void BM_CSVFile_load_matrix(benchmark::State& state)
+{
+	const char* fname = "File_benchmark_matrix.csv";
+	auto feats = create_random_features(NUM_DIM, state.range(0));
+	{
+		auto fout = some<CCSVFile>(fname, 'w');
+		feats->get_feature_matrix().save(fout);
+	}
+
+	for (auto _ : state)
+	{
+		auto fin = some<CCSVFile>(fname, 'r');
+		SGMatrix<float64_t> mat;
+		mat.load(fin);
+		benchmark::DoNotOptimize(mat.matrix);
+	}
+
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+	std::remove(fname);
+}
+
+/** loads n sparse vectors with labels from a LibSVM file, where a tenth of
+ * the features is non-zero
+ */
+static void BM_LibSVMFile_load_sparse(benchmark::State& state)
+{
+	const char* fname = "File_benchmark_sparse.libsvm";
+	auto dense = create_random_features(NUM_DIM, state.range(0));
+	auto mat = dense->get_feature_matrix();
+	for (auto i : range(mat.size()))
+	{
+		if (CMath::random(0, 9))
+			mat[i] = 0;
+	}
+
+	{
+		auto feats = some<CSparseFeatures<float64_t>>(mat);
+		auto fout = some<CLibSVMFile>(fname, 'w');
+		feats->save_with_labels(
+		    fout, create_binary_labels(dense)->get_labels());
+	}
+
+	for (auto _ : state)
+	{
+		auto fin = some<CLibSVMFile>(fname, 'r');
+		auto feats = some<CSparseFeatures<float64_t>>();
+		benchmark::DoNotOptimize(feats->load_with_labels(fin));
+	}
+
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+	std::remove(fname);
+}
+
+BENCHMARK(BM_CSVFile_load_matrix)
+    ->RangeMultiplier(4)
+    ->Range(1024, 65536)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_LibSVMFile_load_sparse)
+    ->RangeMultiplier(4)
+    ->Range(1024, 65536)
+    ->Unit(benchmark::kMillisecond);
+}
@@ -8,6 +8,7 @@
 #include <shogun/io/LineReader.h>
 #include <shogun/lib/CircularBuffer.h>
 #include <shogun/lib/Tokenizer.h>
+#include <shogun/lib/Tracer.h>
 #include <shogun/io/SGIO.h>
 #include <cstdio>
 
@@ -81,7 +82,10 @@ void CLineReader::skip_line()
 	if (m_next_token_length==-1)
 		return;
 	else
+	{
+		SG_TRACE_COUNT(TC_BYTES_PARSED, m_next_token_length);
 		m_buffer->skip_characters(bytes_to_skip);
+	}
 }
 
 SGVector<char> CLineReader::read_line()
@@ -94,6 +98,7 @@ SGVector<char> CLineReader::read_line()
 		line=SGVector<char>();
 	else
 	{
+		SG_TRACE_COUNT(TC_BYTES_PARSED, m_next_token_length);
 		m_buffer->skip_characters(bytes_to_skip);
 		line=read_token(m_next_token_length-bytes_to_skip);
 	}
@@ -25,6 +25,7 @@ void CCustomKernel::init()
 	SG_REF(m_col_subset_stack)
 	m_is_symmetric=false;
 	m_free_km=true;
+	m_precision=CKP_FLOAT32;
 
 	SG_ADD((CSGObject**)&m_row_subset_stack, "row_subset_stack",
 			"Subset stack of rows");
@@ -35,6 +36,11 @@ void CCustomKernel::init()
 	SG_ADD(&m_is_symmetric, "is_symmetric", "Whether kernel matrix is symmetric");
 	SG_ADD(&kmatrix, "kmatrix", "Kernel matrix.");
 	SG_ADD(&upper_diagonal, "upper_diagonal", "Upper diagonal");
+	SG_ADD(&m_half_matrix, "half_matrix", "Kernel matrix in 16bit precision.");
+	SG_ADD_OPTIONS(
+	    (machine_int_t*)&m_precision, "precision",
+	    "Precision of the stored kernel values.", ParameterProperties::NONE,
+	    SG_OPTIONS(CKP_FLOAT32, CKP_FLOAT16, CKP_BFLOAT16));
 }
 
 CCustomKernel::CCustomKernel()
@@ -44,8 +50,8 @@ CCustomKernel::CCustomKernel()
 	init();
 }
 
-CCustomKernel::CCustomKernel(CKernel* k)
-: CKernel(10)
+CCustomKernel::CCustomKernel(CKernel* k, ECustomKernelPrecision precision)
+: CKernel(10), upper_diagonal(false)
 {
 	SG_DEBUG("created CCustomKernel\n")
 	init();
@@ -54,15 +60,50 @@ CCustomKernel::CCustomKernel(CKernel* k)
 	if (k->get_kernel_type()==K_CUSTOM)
 	{
 		CCustomKernel* casted=(CCustomKernel*)k;
+		REQUIRE(!casted->m_row_subset_stack->has_subsets() &&
+				!casted->m_col_subset_stack->has_subsets(),
+				"Not possible with subsets of the custom kernel!\n")
+
 		m_is_symmetric=casted->m_is_symmetric;
-		set_full_kernel_matrix_from_full(casted->get_float32_kernel_matrix());
+		m_precision=casted->m_precision;
+		kmatrix=casted->kmatrix;
+		m_half_matrix=casted->m_half_matrix;
+		upper_diagonal=casted->upper_diagonal;
+		dummy_init(get_matrix_num_rows(), get_matrix_num_cols());
 		m_free_km=false;
 	}
-	else
+	else if (precision==CKP_FLOAT32)
 	{
 		m_is_symmetric=k->get_lhs_equals_rhs();
 		set_full_kernel_matrix_from_full(k->get_kernel_matrix());
 	}
+	else
+	{
+		m_is_symmetric=k->get_lhs_equals_rhs();
+		m_precision=precision;
+
+		index_t rows=k->get_num_vec_lhs();
+		index_t cols=k->get_num_vec_rhs();
+		allocate_kernel_matrix(rows, cols, m_is_symmetric);
+
+		#pragma omp parallel for schedule(dynamic)
+		for (index_t i=0; i<rows; i++)
+		{
+			if (m_is_symmetric)
+			{
+				int64_t offset=int64_t(i)*cols - int64_t(i)*(i+1)/2;
+				for (index_t j=i; j<cols; j++)
+					set_stored_value(offset+j, k->kernel(i, j));
+			}
+			else
+			{
+				for (index_t j=0; j<cols; j++)
+					set_stored_value(i+int64_t(j)*rows, k->kernel(i, j));
+			}
+		}
+
+		dummy_init(rows, cols);
+	}
 }
 
 CCustomKernel::CCustomKernel(SGMatrix<float64_t> km)
@@ -145,22 +186,69 @@ bool CCustomKernel::init(CFeatures* l, CFeatures* r)
 
 	lhs_equals_rhs=m_is_symmetric;
 
-	SG_DEBUG("num_vec_lhs: %d vs num_rows %d\n", l->get_num_vectors(), kmatrix.num_rows)
-	SG_DEBUG("num_vec_rhs: %d vs num_cols %d\n", r->get_num_vectors(), kmatrix.num_cols)
-	ASSERT(l->get_num_vectors()==kmatrix.num_rows)
-	ASSERT(r->get_num_vectors()==kmatrix.num_cols)
+	SG_DEBUG("num_vec_lhs: %d vs num_rows %d\n", l->get_num_vectors(), get_matrix_num_rows())
+	SG_DEBUG("num_vec_rhs: %d vs num_cols %d\n", r->get_num_vectors(), get_matrix_num_cols())
+	ASSERT(l->get_num_vectors()==get_matrix_num_rows())
+	ASSERT(r->get_num_vectors()==get_matrix_num_cols())
 	return init_normalizer();
 }
 
+void CCustomKernel::allocate_kernel_matrix(index_t rows, index_t cols, bool upper)
+{
+	upper_diagonal=upper;
+	kmatrix=SGMatrix<float32_t>();
+	m_half_matrix=SGMatrix<uint16_t>();
+
+	int64_t len=upper ? int64_t(cols)*(cols+1)/2 : int64_t(rows)*cols;
+	if (m_precision==CKP_FLOAT32)
+		kmatrix=SGMatrix<float32_t>(SG_MALLOC(float32_t, len), rows, cols);
+	else
+		m_half_matrix=SGMatrix<uint16_t>(SG_MALLOC(uint16_t, len), rows, cols);
+}
+
+void CCustomKernel::set_precision(ECustomKernelPrecision precision)
+{
+	if (precision==m_precision)
+		return;
+
+	if (!has_kernel_matrix())
+	{
+		m_precision=precision;
+		return;
+	}
+
+	SG_DEBUG("converting custom kernel from precision %d to %d\n",
+			m_precision, precision)
+
+	SGMatrix<float32_t> old_kmatrix=kmatrix;
+	SGMatrix<uint16_t> old_half_matrix=m_half_matrix;
+	ECustomKernelPrecision old_precision=m_precision;
+	index_t rows=get_matrix_num_rows();
+	index_t cols=get_matrix_num_cols();
+	int64_t len=get_num_stored_values();
+
+	m_precision=precision;
+	allocate_kernel_matrix(rows, cols, upper_diagonal);
+
+	#pragma omp parallel for
+	for (int64_t i=0; i<len; i++)
+	{
+		float32_t value=old_precision==CKP_FLOAT32 ? old_kmatrix.matrix[i]
+				: decode_half(old_half_matrix.matrix[i], old_precision);
+		set_stored_value(i, value);
+	}
+}
+
 float64_t CCustomKernel::sum_symmetric_block(index_t block_begin,
 		index_t block_size, bool no_diag)
 {
 	SG_DEBUG("Entering\n");
 
-	if (m_row_subset_stack->has_subsets() || m_col_subset_stack->has_subsets())
+	if (m_row_subset_stack->has_subsets() || m_col_subset_stack->has_subsets() ||
+			m_precision!=CKP_FLOAT32)
 	{
-		SG_INFO("Row/col subsets initialized! Falling back to "
-				"CKernel::sum_symmetric_block (slower)!\n");
+		SG_INFO("Row/col subsets initialized or 16bit precision! Falling back "
+				"to CKernel::sum_symmetric_block (slower)!\n");
 		return CKernel::sum_symmetric_block(block_begin, block_size, no_diag);
 	}
 
@@ -185,10 +273,11 @@ float64_t CCustomKernel::sum_block(index_t block_begin_row,
 {
 	SG_DEBUG("Entering\n");
 
-	if (m_row_subset_stack->has_subsets() || m_col_subset_stack->has_subsets())
+	if (m_row_subset_stack->has_subsets() || m_col_subset_stack->has_subsets() ||
+			m_precision!=CKP_FLOAT32)
 	{
-		SG_INFO("Row/col subsets initialized! Falling back to "
-				"CKernel::sum_block (slower)!\n");
+		SG_INFO("Row/col subsets initialized or 16bit precision! Falling back "
+				"to CKernel::sum_block (slower)!\n");
 		return CKernel::sum_block(block_begin_row, block_begin_col,
 				block_size_row, block_size_col, no_diag);
 	}
@@ -224,10 +313,11 @@ SGVector<float64_t> CCustomKernel::row_wise_sum_symmetric_block(index_t
 {
 	SG_DEBUG("Entering\n");
 
-	if (m_row_subset_stack->has_subsets() || m_col_subset_stack->has_subsets())
+	if (m_row_subset_stack->has_subsets() || m_col_subset_stack->has_subsets() ||
+			m_precision!=CKP_FLOAT32)
 	{
-		SG_INFO("Row/col subsets initialized! Falling back to "
-				"CKernel::row_wise_sum_symmetric_block (slower)!\n");
+		SG_INFO("Row/col subsets initialized or 16bit precision! Falling back "
+				"to CKernel::row_wise_sum_symmetric_block (slower)!\n");
 		return CKernel::row_wise_sum_symmetric_block(block_begin, block_size,
 				no_diag);
 	}
@@ -259,10 +349,11 @@ SGMatrix<float64_t> CCustomKernel::row_wise_sum_squared_sum_symmetric_block(
 {
 	SG_DEBUG("Entering\n");
 
-	if (m_row_subset_stack->has_subsets() || m_col_subset_stack->has_subsets())
+	if (m_row_subset_stack->has_subsets() || m_col_subset_stack->has_subsets() ||
+			m_precision!=CKP_FLOAT32)
 	{
-		SG_INFO("Row/col subsets initialized! Falling back to "
-				"CKernel::row_wise_sum_squared_sum_symmetric_block (slower)!\n");
+		SG_INFO("Row/col subsets initialized or 16bit precision! Falling back "
+				"to CKernel::row_wise_sum_squared_sum_symmetric_block (slower)!\n");
 		return CKernel::row_wise_sum_squared_sum_symmetric_block(block_begin,
 				block_size, no_diag);
 	}
@@ -305,10 +396,11 @@ SGVector<float64_t> CCustomKernel::row_col_wise_sum_block(index_t
 {
 	SG_DEBUG("Entering\n");
 
-	if (m_row_subset_stack->has_subsets() || m_col_subset_stack->has_subsets())
+	if (m_row_subset_stack->has_subsets() || m_col_subset_stack->has_subsets() ||
+			m_precision!=CKP_FLOAT32)
 	{
-		SG_INFO("Row/col subsets initialized! Falling back to "
-				"CKernel::row_col_wise_sum_block (slower)!\n");
+		SG_INFO("Row/col subsets initialized or 16bit precision! Falling back "
+				"to CKernel::row_col_wise_sum_block (slower)!\n");
 		return CKernel::row_col_wise_sum_block(block_begin_row, block_begin_col,
 				block_size_row, block_size_col, no_diag);
 	}
@@ -364,6 +456,7 @@ void CCustomKernel::cleanup_custom()
 	remove_all_col_subsets();
 
 	kmatrix=SGMatrix<float32_t>();
+	m_half_matrix=SGMatrix<uint16_t>();
 	upper_diagonal=false;
 
 	SG_DEBUG("Leaving\n")
@@ -404,7 +497,7 @@ void CCustomKernel::row_subset_changed_post()
 	if (m_row_subset_stack->has_subsets())
 		num_lhs=m_row_subset_stack->get_size();
 	else
-		num_lhs=kmatrix.num_rows;
+		num_lhs=get_matrix_num_rows();
 }
 
 void CCustomKernel::add_col_subset(SGVector<index_t> subset)
@@ -436,5 +529,5 @@ void CCustomKernel::col_subset_changed_post()
 	if (m_col_subset_stack->has_subsets())
 		num_rhs=m_col_subset_stack->get_size();
 	else
-		num_rhs=kmatrix.num_cols;
+		num_rhs=get_matrix_num_cols();
 }
@@ -15,8 +15,23 @@
 #include <shogun/kernel/Kernel.h>
 #include <shogun/features/Features.h>
 
+#include <cmath>
+#include <cstring>
+
 namespace shogun
 {
+/** precision in which CCustomKernel stores kernel values */
+enum ECustomKernelPrecision
+{
+	/** 32bit floats */
+	CKP_FLOAT32 = 0,
+	/** IEEE 754 half precision floats: 11 significant bits, values of
+	 * magnitude up to 65504 */
+	CKP_FLOAT16 = 1,
+	/** bfloat16: 8 significant bits, the range of 32bit floats */
+	CKP_BFLOAT16 = 2
+};
+
 /** @brief The Custom Kernel allows for custom user provided kernel matrices.
  *
  * For squared training matrices it allows to store only the upper triangle of
@@ -24,6 +39,15 @@ namespace shogun
  * is or can be internally converted into (or directly given in) upper triangle
  * representation. Also note that values are stored as 32bit floats.
  *
+ * Values can also be stored as 16bit floats, see set_precision(), which
+ * halves the memory of the kernel matrix. They are widened to 32bit floats
+ * on access. Use CKP_FLOAT16 for kernels with values in a bounded range,
+ * e.g. Gaussian kernels, and CKP_BFLOAT16 for kernels of arbitrary
+ * magnitude. The block sums are then computed entry by entry.
+ *
+ * Elements of the kernel matrix are indexed with 64bit integers, so the
+ * upper triangle may have more than 2**31 elements.
+ *
  * The custom kernel supports subsets each on the rows and the columns. See
  * documentation in CFeatures, CLabels how this works. The interface is similar.
  *
@@ -40,9 +64,16 @@ class CCustomKernel: public CKernel
 		/** constructor
 		 *
 		 * compute custom kernel from given kernel matrix
+		 *
+		 * In 16bit precision, the kernel values are computed in parallel
+		 * directly into the compact storage, only the upper triangle is
+		 * stored if lhs equals rhs. The storage of a custom kernel is
+		 * shared, in its own precision.
+		 *
 		 * @param k kernel matrix
+		 * @param precision precision of the stored kernel values
 		 */
-		CCustomKernel(CKernel* k);
+		CCustomKernel(CKernel* k, ECustomKernelPrecision precision=CKP_FLOAT32);
 
 		/** constructor
 		 *
@@ -177,12 +208,11 @@ class CCustomKernel: public CKernel
 			cleanup_custom();
 			SG_DEBUG("using custom kernel of size %dx%d\n", cols,cols)
 
-			float32_t* m = SG_MALLOC(float32_t, len);
-			kmatrix=SGMatrix<float32_t>(m, cols, cols);
-			upper_diagonal=true;
+			allocate_kernel_matrix(cols, cols, true);
 
+			#pragma omp parallel for
 			for (int64_t i=0; i<len; i++)
-				kmatrix.matrix[i]=tri_kernel_matrix.vector[i];
+				set_stored_value(i, tri_kernel_matrix.vector[i]);
 
 			m_is_symmetric=true;
 			dummy_init(cols,cols);
@@ -228,16 +258,15 @@ class CCustomKernel: public CKernel
 			cleanup_custom();
 			SG_DEBUG("using custom kernel of size %dx%d\n", cols,cols)
 
-			float32_t* m = SG_MALLOC(float32_t, cols*(cols+1)/2);
-			kmatrix=SGMatrix<float32_t>(m, rows, cols);
-			upper_diagonal = true;
+			allocate_kernel_matrix(rows, cols, true);
 
+			#pragma omp parallel for schedule(dynamic)
 			for (int64_t row=0; row<rows; row++)
 			{
 				for (int64_t col=row; col<cols; col++)
 				{
 					int64_t idx=row * cols - row*(row+1)/2 + col;
-					kmatrix.matrix[idx] = full_kernel_matrix.matrix[col*rows+row];
+					set_stored_value(idx, full_kernel_matrix.matrix[col*rows+row]);
 				}
 			}
 
@@ -268,12 +297,23 @@ class CCustomKernel: public CKernel
 			}
 
 			cleanup_custom();
-			kmatrix=full_kernel_matrix;
+			if (m_precision==CKP_FLOAT32)
+				kmatrix=full_kernel_matrix;
+			else
+			{
+				allocate_kernel_matrix(full_kernel_matrix.num_rows,
+						full_kernel_matrix.num_cols, false);
+
+				int64_t len=int64_t(full_kernel_matrix.num_rows)*full_kernel_matrix.num_cols;
+				#pragma omp parallel for
+				for (int64_t i=0; i<len; i++)
+					set_stored_value(i, full_kernel_matrix.matrix[i]);
+			}
 
 			if (check_symmetry)
-				m_is_symmetric=kmatrix.is_symmetric();
+				m_is_symmetric=full_kernel_matrix.is_symmetric();
 
-			dummy_init(kmatrix.num_rows, kmatrix.num_cols);
+			dummy_init(full_kernel_matrix.num_rows, full_kernel_matrix.num_cols);
 			return true;
 		}
 
@@ -303,19 +343,43 @@ class CCustomKernel: public CKernel
 			int32_t cols=full_kernel_matrix.num_cols;
 			SG_DEBUG("using custom kernel of size %dx%d\n", rows,cols)
 
-			kmatrix=SGMatrix<float32_t>(rows,cols);
-			upper_diagonal = false;
+			allocate_kernel_matrix(rows, cols, false);
 
+			#pragma omp parallel for
 			for (int64_t i=0; i<int64_t(rows) * cols; i++)
-				kmatrix.matrix[i]=full_kernel_matrix.matrix[i];
+				set_stored_value(i, full_kernel_matrix.matrix[i]);
 
 			if (check_symmetry)
-				m_is_symmetric=kmatrix.is_symmetric();
+				m_is_symmetric=full_kernel_matrix.is_symmetric();
 
-			dummy_init(kmatrix.num_rows, kmatrix.num_cols);
+			dummy_init(rows, cols);
 			return true;
 		}
 
+		/** set precision of the stored kernel values, a kernel matrix that
+		 * is already set is converted
+		 *
+		 * @param precision precision of the stored kernel values
+		 */
+		void set_precision(ECustomKernelPrecision precision);
+
+		/** get precision of the stored kernel values
+		 *
+		 * @return precision
+		 */
+		ECustomKernelPrecision get_precision() const
+		{
+			return m_precision;
+		}
+
+		/** @return whether only the upper triangle of the kernel matrix is
+		 * stored
+		 */
+		bool is_upper_triangle() const
+		{
+			return upper_diagonal;
+		}
+
 		/**
 		 * Overrides the sum_symmetric_block method of CKernel to compute the
 		 * sum directly from the precomputed kernel matrix.
@@ -539,12 +603,17 @@ class CCustomKernel: public CKernel
 			return (get_num_vec_lhs()>0) && (get_num_vec_rhs()>0);
 		}
 
-		/** returns kernel matrix as is (not possible with subset)
+		/** returns kernel matrix as is (not possible with subset or in 16bit
+		 * precision)
 		 *
 		 * @return kernel matrix
 		 */
 		SGMatrix<float32_t> get_float32_kernel_matrix()
 		{
+			REQUIRE(m_precision==CKP_FLOAT32, "%s::get_float32_kernel_matrix(): "
+					"Not possible in 16bit precision, use get_kernel_matrix()!\n",
+					get_name());
+
 			REQUIRE(!m_row_subset_stack->has_subsets(), "%s::get_float32_kernel_matrix(): "
 						"Not possible with row subset active! If you want to"
 						" create a %s from another one with a subset, use "
@@ -572,7 +641,7 @@ class CCustomKernel: public CKernel
 		 */
 		virtual float64_t compute(int32_t row, int32_t col)
 		{
-			REQUIRE(kmatrix.matrix, "%s::compute(%d, %d): No kenrel matrix "
+			REQUIRE(has_kernel_matrix(), "%s::compute(%d, %d): No kenrel matrix "
 					"set!\n", get_name(), row, col);
 
 			index_t real_row=m_row_subset_stack->subset_idx_conversion(row);
@@ -583,16 +652,150 @@ class CCustomKernel: public CKernel
 				if (real_row <= real_col)
 				{
 					int64_t r=real_row;
-					return kmatrix.matrix[r*kmatrix.num_rows - r*(r+1)/2 + real_col];
+					return get_stored_value(r*get_matrix_num_rows() - r*(r+1)/2 + real_col);
 				}
 				else
 				{
 					int64_t c=real_col;
-					return kmatrix.matrix[c*kmatrix.num_cols - c*(c+1)/2 + real_row];
+					return get_stored_value(c*get_matrix_num_cols() - c*(c+1)/2 + real_row);
 				}
 			}
 			else
-				return kmatrix(real_row, real_col);
+				return get_stored_value(real_row + int64_t(real_col)*get_matrix_num_rows());
+		}
+
+		/** allocate the storage of the kernel matrix in the current
+		 * precision
+		 *
+		 * @param rows number of rows
+		 * @param cols number of columns
+		 * @param upper whether only the upper triangle is stored
+		 */
+		void allocate_kernel_matrix(index_t rows, index_t cols, bool upper);
+
+		/** @return whether a kernel matrix is set */
+		bool has_kernel_matrix() const
+		{
+			return m_precision==CKP_FLOAT32 ? kmatrix.matrix!=NULL
+					: m_half_matrix.matrix!=NULL;
+		}
+
+		/** @return number of rows of the stored kernel matrix */
+		index_t get_matrix_num_rows() const
+		{
+			return m_precision==CKP_FLOAT32 ? kmatrix.num_rows
+					: m_half_matrix.num_rows;
+		}
+
+		/** @return number of columns of the stored kernel matrix */
+		index_t get_matrix_num_cols() const
+		{
+			return m_precision==CKP_FLOAT32 ? kmatrix.num_cols
+					: m_half_matrix.num_cols;
+		}
+
+		/** @return number of stored kernel values */
+		int64_t get_num_stored_values() const
+		{
+			int64_t cols=get_matrix_num_cols();
+			return upper_diagonal ? cols*(cols+1)/2 : get_matrix_num_rows()*cols;
+		}
+
+		/** store a kernel value
+		 *
+		 * @param idx index in the storage
+		 * @param value kernel value
+		 */
+		inline void set_stored_value(int64_t idx, float32_t value)
+		{
+			if (m_precision==CKP_FLOAT32)
+				kmatrix.matrix[idx]=value;
+			else
+				m_half_matrix.matrix[idx]=encode_half(value, m_precision);
+		}
+
+		/** get a stored kernel value
+		 *
+		 * @param idx index in the storage
+		 * @return kernel value
+		 */
+		inline float32_t get_stored_value(int64_t idx) const
+		{
+			if (m_precision==CKP_FLOAT32)
+				return kmatrix.matrix[idx];
+
+			return decode_half(m_half_matrix.matrix[idx], m_precision);
+		}
+
+	public:
+		/** convert a 32bit float to a 16bit float, rounding to nearest even
+		 *
+		 * @param value value to convert
+		 * @param precision CKP_FLOAT16 or CKP_BFLOAT16
+		 * @return bits of the 16bit float
+		 */
+		static inline uint16_t encode_half(float32_t value,
+				ECustomKernelPrecision precision)
+		{
+			uint32_t bits;
+			std::memcpy(&bits, &value, sizeof(bits));
+
+			if (precision==CKP_BFLOAT16)
+			{
+				if ((bits & 0x7fffffff) > 0x7f800000)
+					return (bits >> 16) | 0x40;
+				bits += 0x7fff + ((bits >> 16) & 1);
+				return bits >> 16;
+			}
+
+			uint16_t sign=(bits >> 16) & 0x8000;
+			uint32_t abs=bits & 0x7fffffff;
+			// infinity and nan
+			if (abs>=0x7f800000)
+				return sign | 0x7c00 | (abs>0x7f800000 ? 0x200 : 0);
+			// rounds to infinity beyond 65520
+			if (abs>=0x477ff000)
+				return sign | 0x7c00;
+			// subnormal, in multiples of 2**-24
+			if (abs<0x38800000)
+				return sign | uint16_t(std::nearbyint(std::fabs(value)*16777216.0f));
+			// rebias the exponent and round the mantissa to 10 bits
+			abs+=0xc8000fff + ((abs >> 13) & 1);
+			return sign | (abs >> 13);
+		}
+
+		/** convert a 16bit float to a 32bit float
+		 *
+		 * @param half bits of the 16bit float
+		 * @param precision CKP_FLOAT16 or CKP_BFLOAT16
+		 * @return value
+		 */
+		static inline float32_t decode_half(uint16_t half,
+				ECustomKernelPrecision precision)
+		{
+			uint32_t bits;
+			if (precision==CKP_BFLOAT16)
+				bits=uint32_t(half) << 16;
+			else
+			{
+				uint32_t sign=uint32_t(half & 0x8000) << 16;
+				uint32_t exponent=(half >> 10) & 0x1f;
+				uint32_t mantissa=half & 0x3ff;
+				if (exponent==0)
+				{
+					float32_t value=mantissa*(1.0f/16777216.0f);
+					return sign ? -value : value;
+				}
+
+				if (exponent==0x1f)
+					bits=sign | 0x7f800000 | (mantissa << 13);
+				else
+					bits=sign | ((exponent+112) << 23) | (mantissa << 13);
+			}
+
+			float32_t value;
+			std::memcpy(&value, &bits, sizeof(value));
+			return value;
 		}
 
 	protected:
@@ -600,6 +803,12 @@ class CCustomKernel: public CKernel
 		/** kernel matrix */
 		SGMatrix<float32_t> kmatrix;
 
+		/** kernel matrix in 16bit precision, same layout as kmatrix */
+		SGMatrix<uint16_t> m_half_matrix;
+
+		/** precision of the stored kernel values */
+		ECustomKernelPrecision m_precision;
+
 		/** upper diagonal */
 		bool upper_diagonal;
 
@@ -232,6 +232,7 @@ void CKernel::get_kernel_row(
 	/* is cached? */
 	if(kernel_cache.index[docnum] != -1)
 	{
+		SG_TRACE_COUNT(TC_CACHE_HITS, 1);
 		kernel_cache.lru[kernel_cache.index[docnum]]=kernel_cache.time; /* lru */
 		start=((KERNELCACHE_IDX) kernel_cache.activenum)*kernel_cache.index[docnum];
 
@@ -263,6 +264,7 @@ void CKernel::get_kernel_row(
 	}
 	else
 	{
+		SG_TRACE_COUNT(TC_CACHE_MISSES, 1);
 		if (full_line)
 		{
 			for(j=0;j<get_num_vec_lhs();j++)
@@ -423,10 +425,11 @@ void CKernel::cache_multiple_kernel_rows(int32_t* rows, int32_t num_rows)
 				params.start = t*step;
 				params.end = (t+1)*step;
 				params.num_vectors = get_num_vec_lhs();
-				end=params.end;
 
 				cache_multiple_kernel_row_helper(&params);
 			}
+			/* the remaining rows are cached by this thread */
+			end=num_threads*step;
 		}
 		else
 			num_threads=-1;
@@ -943,6 +946,7 @@ void CKernel::register_params()
 void CKernel::init()
 {
 	cache_size=10;
+	row_cache=NULL;
 	kernel_matrix=NULL;
 	lhs=NULL;
 	rhs=NULL;
@@ -973,8 +977,6 @@ template <class T> struct K_THREAD_PARAM
 	int32_t start;
 	/** end (unit row) */
 	int32_t end;
-	/** start (unit number of elements) */
-	int64_t total_start;
 	/** m */
 	int32_t m;
 	/** n */
@@ -983,8 +985,6 @@ template <class T> struct K_THREAD_PARAM
 	T* result;
 	/** kernel matrix k(i,j)=k(j,i) */
 	bool symmetric;
-	/** output progress */
-	bool verbose;
 	/* Progress bar*/
 	PRange<int64_t>* pb;
 };
@@ -1263,12 +1263,10 @@ template <class T> void* CKernel::get_kernel_matrix_helper(void* p)
 	bool symmetric=params->symmetric;
 	int32_t n=params->n;
 	int32_t m=params->m;
-	bool verbose=params->verbose;
-	int64_t total_start=params->total_start;
-	int64_t total=total_start;
 	PRange<int64_t>* pb = params->pb;
+	auto batch = pb->batch();
 
-	for (int32_t i=i_start; i<i_end; i++)
+	for (int32_t i = i_start; i < i_end && !pb->cancelled(); i++)
 	{
 		int32_t j_start=0;
 
@@ -1282,22 +1280,9 @@ template <class T> void* CKernel::get_kernel_matrix_helper(void* p)
 
 			if (symmetric && i!=j)
 				result[j+i*m]=v;
-
-			if (verbose)
-			{
-				total++;
-
-				if (symmetric && i!=j)
-					total++;
-
-				pb->print_progress();
-
-				// TODO: replace with the new signal
-				// if (CSignal::cancel_computations())
-				//	break;
-			}
 		}
 
+		batch.step(symmetric ? 2 * (n - j_start) - 1 : n);
 	}
 
 	return NULL;
@@ -1306,6 +1291,7 @@ template <class T> void* CKernel::get_kernel_matrix_helper(void* p)
 template <class T>
 SGMatrix<T> CKernel::get_kernel_matrix()
 {
+	SG_TRACE_SCOPE("CKernel::get_kernel_matrix");
 	T* result = NULL;
 
 	REQUIRE(has_features(), "no features assigned to kernel\n")
@@ -1334,11 +1320,9 @@ SGMatrix<T> CKernel::get_kernel_matrix()
 		params.result = result;
 		params.start = compute_row_start(t*step, n, symmetric);
 		params.end = compute_row_start((t+1)*step, n, symmetric);
-		params.total_start=t*step;
 		params.n=n;
 		params.m=m;
 		params.symmetric=symmetric;
-		params.verbose=false;
 		params.pb = &pb;
 		CKernel::get_kernel_matrix_helper<T>((void*)&params);
 	}
@@ -1349,17 +1333,21 @@ SGMatrix<T> CKernel::get_kernel_matrix()
 		params.result = result;
 		params.start = compute_row_start(t*step, n, symmetric);
 		params.end = m;
-		params.total_start=t*step;
 		params.n=n;
 		params.m=m;
 		params.symmetric=symmetric;
-		params.verbose=false;
 		params.pb = &pb;
 		CKernel::get_kernel_matrix_helper<T>((void*)&params);
 	}
 
 	pb.complete();
 
+	if (pb.cancelled())
+	{
+		SG_FREE(result);
+		SG_ERROR("Computation of the kernel matrix was cancelled\n")
+	}
+
 	return SGMatrix<T>(result,m,n,true);
 }
 
@@ -20,6 +20,7 @@
 #include <shogun/features/FeatureTypes.h>
 #include <shogun/base/SGObject.h>
 #include <shogun/lib/SGMatrix.h>
+#include <shogun/lib/Tracer.h>
 #include <shogun/features/Features.h>
 #include <shogun/kernel/normalizer/KernelNormalizer.h>
 
@@ -28,6 +29,7 @@ namespace shogun
 	class CFile;
 	class CFeatures;
 	class CKernelNormalizer;
+	class KernelRowCache;
 
 #ifdef USE_SHORTREAL_KERNELCACHE
 	/** kernel cache element */
@@ -205,10 +207,14 @@ class CKernel : public CSGObject
 				"%s::kernel(): index out of Range: idx_a=%d/%d idx_b=%d/%d\n",
 				get_name(), idx_a,num_lhs, idx_b,num_rhs);
 
+			SG_TRACE_COUNT(TC_KERNEL_EVALUATIONS, 1);
 			return normalizer->normalize(compute(idx_a, idx_b), idx_a, idx_b);
 		}
 
 		/** get kernel matrix
+		 *
+		 * Raises an error if the computation is cancelled, see
+		 * CSignal::cancel_computations().
 		 *
 		 * @return computed kernel matrix (needs to be cleaned up)
 		 */
@@ -593,6 +599,22 @@ class CKernel : public CSGObject
 		 */
 		inline int32_t get_cache_size() { return cache_size; }
 
+		/** set the cache of kernel rows shared by trainings on the same
+		 * features, see KernelRowCache which installs itself
+		 *
+		 * @param cache row cache, not owned, NULL for none
+		 */
+		inline void set_row_cache(KernelRowCache* cache)
+		{
+			row_cache = cache;
+		}
+
+		/** return the cache of kernel rows shared by trainings
+		 *
+		 * @return row cache, NULL if none is installed
+		 */
+		inline KernelRowCache* get_row_cache() const { return row_cache; }
+
 #ifdef USE_SVMLIGHT
 		/** cache reset */
 		inline void cache_reset() { resize_kernel_cache(cache_size); }
@@ -1051,6 +1073,9 @@ class CKernel : public CSGObject
 		KERNEL_CACHE kernel_cache;
 #endif //USE_SVMLIGHT
 
+		/// rows shared by trainings, not owned and not serialised
+		KernelRowCache* row_cache;
+
 		/// this *COULD* store the whole kernel matrix
 		/// usually not applicable / necessary to compute the whole matrix
 		KERNELCACHE_ELEM* kernel_matrix;
@@ -0,0 +1,260 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ */
+
+#include <shogun/kernel/KernelRowCache.h>
+#include <shogun/mathematics/Math.h>
+
+#include <algorithm>
+
+using namespace shogun;
+
+KernelRowCache::Row& KernelRowCache::Row::operator=(Row&& other)
+{
+	if (this != &other)
+	{
+		release();
+		m_cache = other.m_cache;
+		m_row = other.m_row;
+		m_kernel = other.m_kernel;
+		m_rhs_subsets = other.m_rhs_subsets;
+		m_idx_a = other.m_idx_a;
+		other.m_cache = NULL;
+		other.m_row = NULL;
+		other.m_kernel = NULL;
+		other.m_rhs_subsets = NULL;
+	}
+	return *this;
+}
+
+void KernelRowCache::Row::release()
+{
+	if (m_row)
+	{
+		std::lock_guard<std::mutex> lock(m_cache->m_mutex);
+		m_row->num_users--;
+	}
+	SG_UNREF(m_rhs_subsets);
+	m_cache = NULL;
+	m_row = NULL;
+	m_kernel = NULL;
+}
+
+KernelRowCache::KernelRowCache(CKernel* kernel, float64_t size)
+    : m_kernel(kernel), m_previous(NULL),
+      m_max_bytes(int64_t(size * (1l << 20))), m_bytes(0), m_lhs(NULL),
+      m_rhs(NULL), m_rhs_subset(NULL), m_num_cols(0)
+{
+	REQUIRE(kernel, "No kernel provided\n");
+	SG_REF(m_kernel);
+	m_previous = m_kernel->get_row_cache();
+	m_kernel->set_row_cache(this);
+}
+
+KernelRowCache::~KernelRowCache()
+{
+	clear_locked();
+	m_kernel->set_row_cache(m_previous);
+
+	SG_UNREF(m_rhs_subset);
+	SG_UNREF(m_lhs);
+	SG_UNREF(m_rhs);
+	SG_UNREF(m_kernel);
+}
+
+void KernelRowCache::update_features()
+{
+	CFeatures* lhs = m_kernel->get_lhs();
+	CFeatures* rhs = m_kernel->get_rhs();
+	REQUIRE(lhs && rhs, "Kernel is not initialised with features\n");
+	if (lhs != m_lhs || rhs != m_rhs)
+	{
+		clear_locked();
+		SG_UNREF(m_rhs_subset);
+		SG_UNREF(m_lhs);
+		SG_UNREF(m_rhs);
+		m_lhs = lhs;
+		m_rhs = rhs;
+		m_num_cols = 0;
+		SG_REF(m_lhs);
+		SG_REF(m_rhs);
+	}
+
+	/* the number of vectors without subsets is not known, rows cover the
+	 * vectors of the subsets seen so far. The subset is kept referenced so
+	 * that a new one cannot take its address. */
+	CSubsetStack* subsets = rhs->get_subset_stack();
+	CSubset* subset = subsets->get_last_subset();
+	if (subset != m_rhs_subset || (!subset && !m_num_cols))
+	{
+		index_t num_cols = rhs->get_num_vectors();
+		if (subset)
+		{
+			auto idx = subset->get_subset_idx();
+			num_cols = idx.vlen ? CMath::max(idx.vector, idx.vlen) + 1 : 0;
+		}
+		m_num_cols = CMath::max(m_num_cols, num_cols);
+
+		SG_REF(subset);
+		SG_UNREF(m_rhs_subset);
+		m_rhs_subset = subset;
+	}
+	SG_UNREF(subsets);
+
+	SG_UNREF(lhs);
+	SG_UNREF(rhs);
+}
+
+KernelRowCache::Row KernelRowCache::get_row(CKernel* kernel, index_t idx_a)
+{
+	CFeatures* lhs = kernel->get_lhs();
+	CFeatures* rhs = kernel->get_rhs();
+	REQUIRE(lhs && rhs, "Kernel is not initialised with features\n");
+	CSubsetStack* lhs_subsets = lhs->get_subset_stack();
+	index_t idx = lhs_subsets->subset_idx_conversion(idx_a);
+
+	Row result;
+	result.m_cache = this;
+	result.m_kernel = kernel;
+	result.m_rhs_subsets = rhs->get_subset_stack();
+	result.m_idx_a = idx_a;
+	SG_UNREF(lhs_subsets);
+	SG_UNREF(lhs);
+	SG_UNREF(rhs);
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+	update_features();
+
+	if (idx >= index_t(m_rows.size()))
+		m_rows.resize(idx + 1, NULL);
+
+	CachedRow* row = m_rows[idx];
+	if (row)
+		m_lru.splice(m_lru.end(), m_lru, row->lru_pos);
+
+	/* rows in use keep their length, they are read concurrently */
+	if (row && row->num_cols < m_num_cols && !row->num_users)
+	{
+		auto values = new std::atomic<float64_t>[m_num_cols];
+		for (index_t i = 0; i < m_num_cols; i++)
+		{
+			values[i].store(
+			    i < row->num_cols
+			        ? row->values[i].load(std::memory_order_relaxed)
+			        : CMath::NOT_A_NUMBER,
+			    std::memory_order_relaxed);
+		}
+		delete[] row->values;
+		m_bytes += int64_t(m_num_cols - row->num_cols) * sizeof(float64_t);
+		row->values = values;
+		row->num_cols = m_num_cols;
+	}
+
+	if (!row)
+	{
+		/* the requested row is cached even if it exceeds the size on its
+		 * own, rows in use are not evicted */
+		int64_t row_bytes = int64_t(m_num_cols) * sizeof(float64_t);
+		auto it = m_lru.begin();
+		while (it != m_lru.end() && m_bytes + row_bytes > m_max_bytes)
+		{
+			CachedRow* lru = m_rows[*it++];
+			if (!lru->num_users)
+			{
+				m_rows[lru->idx] = NULL;
+				free_row(lru);
+			}
+		}
+
+		row = new CachedRow();
+		row->idx = idx;
+		row->num_cols = m_num_cols;
+		row->num_users = 0;
+		row->values = new std::atomic<float64_t>[m_num_cols];
+		for (index_t i = 0; i < m_num_cols; i++)
+			row->values[i].store(CMath::NOT_A_NUMBER, std::memory_order_relaxed);
+		row->lru_pos = m_lru.insert(m_lru.end(), idx);
+		m_rows[idx] = row;
+		m_bytes += row_bytes;
+	}
+
+	row->num_users++;
+	result.m_row = row;
+	return result;
+}
+
+float64_t KernelRowCache::diagonal(CKernel* kernel, index_t idx)
+{
+	CFeatures* lhs = kernel->get_lhs();
+	CFeatures* rhs = kernel->get_rhs();
+	REQUIRE(lhs && rhs, "Kernel is not initialised with features\n");
+	bool same = lhs == rhs;
+	CSubsetStack* subsets = lhs->get_subset_stack();
+	index_t global_idx = subsets->subset_idx_conversion(idx);
+	SG_UNREF(subsets);
+	SG_UNREF(lhs);
+	SG_UNREF(rhs);
+
+	if (!same)
+		return kernel->kernel(idx, idx);
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		update_features();
+		if (global_idx >= index_t(m_diagonal.size()))
+			m_diagonal.resize(global_idx + 1, CMath::NOT_A_NUMBER);
+
+		float64_t value = m_diagonal[global_idx];
+		if (!std::isnan(value))
+		{
+			SG_TRACE_COUNT(TC_CACHE_HITS, 1);
+			return value;
+		}
+	}
+
+	SG_TRACE_COUNT(TC_CACHE_MISSES, 1);
+	float64_t value = kernel->kernel(idx, idx);
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+	if (global_idx < index_t(m_diagonal.size()))
+		m_diagonal[global_idx] = value;
+
+	return value;
+}
+
+int32_t KernelRowCache::get_num_rows()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_lru.size();
+}
+
+index_t KernelRowCache::get_num_cols()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_num_cols;
+}
+
+void KernelRowCache::clear()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	clear_locked();
+}
+
+void KernelRowCache::free_row(CachedRow* row)
+{
+	m_lru.erase(row->lru_pos);
+	m_bytes -= int64_t(row->num_cols) * sizeof(float64_t);
+	delete[] row->values;
+	delete row;
+}
+
+void KernelRowCache::clear_locked()
+{
+	for (auto row : m_rows)
+	{
+		if (row)
+			free_row(row);
+	}
+	m_rows.clear();
+	m_diagonal.clear();
+}
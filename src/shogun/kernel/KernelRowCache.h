@@ -0,0 +1,234 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ */
+
+#ifndef _KERNELROWCACHE_H___
+#define _KERNELROWCACHE_H___
+
+#include <shogun/lib/config.h>
+
+#include <shogun/features/SubsetStack.h>
+#include <shogun/kernel/Kernel.h>
+#include <shogun/lib/Tracer.h>
+#include <shogun/lib/common.h>
+
+#include <atomic>
+#include <cmath>
+#include <list>
+#include <mutex>
+#include <vector>
+
+namespace shogun
+{
+
+/** @brief KernelRowCache caches rows of a kernel by global, i.e. not
+ * subsetted, vector indices, so that trainings of several sub-problems on
+ * the same features share the kernel values they have in common, e.g. the
+ * one-vs-one or one-vs-rest sub-machines of a multiclass machine.
+ *
+ * The cache installs itself on the kernel on construction and removes
+ * itself on destruction, solvers pick it up with CKernel::get_row_cache().
+ * It may also be installed on copies of the kernel with
+ * CKernel::set_row_cache(), as long as these are initialised with the
+ * features of the kernel or with subset views of them, see
+ * CFeatures::shallow_subset_copy(). Rows are looked up and computed with the
+ * kernel passed to get_row(), whose subsets map the indices to global ones.
+ *
+ * Entries are computed on first use, a row only holds the entries of the
+ * sub-problems that needed it so far. Rows are evicted least recently used
+ * first once the cache size is exceeded, except for those in use, the
+ * diagonal is kept. The cache is emptied when the kernel is initialised with
+ * other features, and rows grow when a subset of the features reaches
+ * vectors beyond them.
+ *
+ * All methods may be called concurrently, trainings on several copies of
+ * the kernel can share one cache.
+ */
+class KernelRowCache
+{
+	/** a cached row */
+	struct CachedRow
+	{
+		/** global lhs index */
+		index_t idx;
+		/** number of entries, rhs vectors beyond are not cached */
+		index_t num_cols;
+		/** number of Row handles using it, it is not evicted while used */
+		int32_t num_users;
+		/** entries by global rhs index, NaN if missing */
+		std::atomic<float64_t>* values;
+		/** position in the list of least recently used rows */
+		std::list<index_t>::iterator lru_pos;
+	};
+
+public:
+	/** @brief a row of the cache, which is kept in the cache while the
+	 * handle exists, see KernelRowCache::get_row()
+	 */
+	class Row
+	{
+	public:
+		/** constructor, no row */
+		Row()
+		    : m_cache(NULL), m_row(NULL), m_kernel(NULL),
+		      m_rhs_subsets(NULL), m_idx_a(0)
+		{
+		}
+
+		/** move constructor */
+		Row(Row&& other) : Row()
+		{
+			*this = std::move(other);
+		}
+
+		/** move assignment */
+		Row& operator=(Row&& other);
+
+		/** destructor, releases the row */
+		~Row()
+		{
+			release();
+		}
+
+		Row(const Row&) = delete;
+		Row& operator=(const Row&) = delete;
+
+		/** @return whether the handle holds a row */
+		explicit operator bool() const
+		{
+			return m_row != NULL;
+		}
+
+		/** kernel value of the row, computed and stored if missing. May be
+		 * called concurrently.
+		 *
+		 * @param idx_b index of the rhs vector, subject to the subsets of
+		 * the kernel the row was obtained with
+		 * @return k(idx_a, idx_b)
+		 */
+		inline float64_t kernel(index_t idx_b) const
+		{
+			auto col = m_rhs_subsets->subset_idx_conversion(idx_b);
+			if (col < m_row->num_cols)
+			{
+				auto& entry = m_row->values[col];
+				float64_t value = entry.load(std::memory_order_relaxed);
+				if (!std::isnan(value))
+				{
+					SG_TRACE_COUNT(TC_CACHE_HITS, 1);
+					return value;
+				}
+				SG_TRACE_COUNT(TC_CACHE_MISSES, 1);
+				value = m_kernel->kernel(m_idx_a, idx_b);
+				entry.store(value, std::memory_order_relaxed);
+				return value;
+			}
+			return m_kernel->kernel(m_idx_a, idx_b);
+		}
+
+	private:
+		/** gives the row back to the cache */
+		void release();
+
+	private:
+		friend class KernelRowCache;
+
+		/** cache of the row */
+		KernelRowCache* m_cache;
+		/** the row */
+		CachedRow* m_row;
+		/** kernel to compute missing entries with */
+		CKernel* m_kernel;
+		/** subsets of the rhs of the kernel */
+		CSubsetStack* m_rhs_subsets;
+		/** index of the lhs vector, subject to the subsets of the kernel */
+		index_t m_idx_a;
+	};
+
+	/** constructor, installs the cache on the kernel
+	 *
+	 * @param kernel kernel whose rows are cached
+	 * @param size cache size in megabytes
+	 */
+	KernelRowCache(CKernel* kernel, float64_t size);
+
+	/** destructor, removes the cache from the kernel */
+	~KernelRowCache();
+
+	KernelRowCache(const KernelRowCache&) = delete;
+	KernelRowCache& operator=(const KernelRowCache&) = delete;
+
+	/** returns the cached row of a lhs vector. The row is not evicted while
+	 * the returned handle exists.
+	 *
+	 * @param kernel the kernel of the cache or a copy on (subset views of)
+	 * its features, whose subsets map the indices
+	 * @param idx_a index of the lhs vector, subject to the subsets of kernel
+	 * @return row of idx_a
+	 */
+	Row get_row(CKernel* kernel, index_t idx_a);
+
+	/** cached kernel value of a vector with itself
+	 *
+	 * @param kernel the kernel of the cache or a copy on (subset views of)
+	 * its features, whose subsets map the index
+	 * @param idx index of the vector, subject to the subsets of kernel
+	 * @return k(idx, idx)
+	 */
+	float64_t diagonal(CKernel* kernel, index_t idx);
+
+	/** @return number of rows in the cache */
+	int32_t get_num_rows();
+
+	/** @return number of entries of the rows that are allocated */
+	index_t get_num_cols();
+
+	/** removes all rows and the diagonal, no row may be in use */
+	void clear();
+
+private:
+	/** empties the cache if the kernel is not initialised with the features
+	 * the rows were computed on and binds it to the current ones, updates
+	 * the length of new rows if the subset of the features changed. Must be
+	 * called with the mutex locked.
+	 */
+	void update_features();
+
+	/** frees a row, it is removed from the list of least recently used ones
+	 * but not from m_rows
+	 */
+	void free_row(CachedRow* row);
+
+	/** removes all rows and the diagonal, the mutex must be locked */
+	void clear_locked();
+
+private:
+	/** kernel */
+	CKernel* m_kernel;
+	/** cache the kernel had before */
+	KernelRowCache* m_previous;
+	/** maximum number of bytes of the rows */
+	int64_t m_max_bytes;
+	/** number of bytes of the rows */
+	int64_t m_bytes;
+
+	/** guards everything except the entries of the rows */
+	std::mutex m_mutex;
+
+	/** features the rows were computed on */
+	CFeatures* m_lhs;
+	CFeatures* m_rhs;
+	/** active subset of the rhs the row length was computed for */
+	CSubset* m_rhs_subset;
+	/** length of new rows */
+	index_t m_num_cols;
+
+	/** rows by global lhs index, NULL if not cached */
+	std::vector<CachedRow*> m_rows;
+	/** global lhs indices of the cached rows, least recently used first */
+	std::list<index_t> m_lru;
+	/** diagonal by global index if lhs and rhs are the same */
+	std::vector<float64_t> m_diagonal;
+};
+}
+#endif
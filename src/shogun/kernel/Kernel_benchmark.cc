@@ -0,0 +1,119 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ */
+
+#include <shogun/util/benchmark_utilities.h>
+
+#include <shogun/distance/EuclideanDistance.h>
+#include <shogun/kernel/ANOVAKernel.h>
+#include <shogun/kernel/CauchyKernel.h>
+#include <shogun/kernel/Chi2Kernel.h>
+#include <shogun/kernel/CircularKernel.h>
+#include <shogun/kernel/GaussianKernel.h>
+#include <shogun/kernel/HistogramIntersectionKernel.h>
+#include <shogun/kernel/InverseMultiQuadricKernel.h>
+#include <shogun/kernel/JensenShannonKernel.h>
+#include <shogun/kernel/LinearKernel.h>
+#include <shogun/kernel/LogKernel.h>
+#include <shogun/kernel/MultiquadricKernel.h>
+#include <shogun/kernel/PolyKernel.h>
+#include <shogun/kernel/PowerKernel.h>
+#include <shogun/kernel/RationalQuadraticKernel.h>
+#include <shogun/kernel/SigmoidKernel.h>
+#include <shogun/kernel/SphericalKernel.h>
+#include <shogun/kernel/SplineKernel.h>
+#include <shogun/kernel/TStudentKernel.h>
+#include <shogun/kernel/WaveKernel.h>
+#include <shogun/kernel/WaveletKernel.h>
+
+#include <functional>
+
+namespace shogun
+{
+
+/** dimension of the features */
+static const index_t NUM_DIM = 32;
+
+/* kernels on dense real features, with moderate parameters */
+static std::vector<std::pair<std::string, std::function<CKernel*()>>>
+dense_kernels()
+{
+	const int32_t cache = 10;
+	return {
+	    {"ANOVAKernel", [] { return new CANOVAKernel(cache, 2); }},
+	    {"CauchyKernel",
+	     [] { return new CCauchyKernel(cache, 1.0, new CEuclideanDistance()); }},
+	    {"Chi2Kernel", [] { return new CChi2Kernel(cache, 1.0); }},
+	    {"CircularKernel",
+	     [] { return new CCircularKernel(cache, 2.0, new CEuclideanDistance()); }},
+	    {"GaussianKernel", [] { return new CGaussianKernel(cache, 2.0); }},
+	    {"HistogramIntersectionKernel",
+	     [] { return new CHistogramIntersectionKernel(cache); }},
+	    {"InverseMultiQuadricKernel",
+	     [] {
+		     return new CInverseMultiQuadricKernel(
+		         cache, 1.0, new CEuclideanDistance());
+	     }},
+	    {"JensenShannonKernel", [] { return new CJensenShannonKernel(cache); }},
+	    {"LinearKernel", [] { return new CLinearKernel(); }},
+	    {"LogKernel",
+	     [] { return new CLogKernel(cache, 2.0, new CEuclideanDistance()); }},
+	    {"MultiquadricKernel",
+	     [] {
+		     return new CMultiquadricKernel(
+		         cache, 1.0, new CEuclideanDistance());
+	     }},
+	    {"PolyKernel", [] { return new CPolyKernel(cache, 3); }},
+	    {"PowerKernel",
+	     [] { return new CPowerKernel(cache, 2.0, new CEuclideanDistance()); }},
+	    {"RationalQuadraticKernel",
+	     [] {
+		     return new CRationalQuadraticKernel(
+		         cache, 1.0, new CEuclideanDistance());
+	     }},
+	    {"SigmoidKernel", [] { return new CSigmoidKernel(cache, 0.01, 0.5); }},
+	    {"SphericalKernel",
+	     [] {
+		     return new CSphericalKernel(cache, 2.0, new CEuclideanDistance());
+	     }},
+	    {"SplineKernel", [] { return new CSplineKernel(); }},
+	    {"TStudentKernel",
+	     [] {
+		     return new CTStudentKernel(cache, 2.0, new CEuclideanDistance());
+	     }},
+	    {"WaveKernel",
+	     [] { return new CWaveKernel(cache, 2.0, new CEuclideanDistance()); }},
+	    {"WaveletKernel", [] { return new CWaveletKernel(cache, 1.5, 1.0); }},
+	};
+}
+
+/** computes the full n x n Gram matrix of a kernel */
+static void BM_Kernel_gram_matrix(
+    benchmark::State& state, std::function<CKernel*()> create_kernel)
+{
+	auto feats = create_random_features(NUM_DIM, state.range(0));
+	auto kernel = wrap(create_kernel());
+	kernel->init(feats, feats);
+	ScopedNumThreads num_threads(state.range(1));
+
+	for (auto _ : state)
+		benchmark::DoNotOptimize(kernel->get_kernel_matrix());
+
+	state.SetItemsProcessed(state.iterations() * state.range(0) * state.range(0));
+}
+
+static bool register_kernel_benchmarks()
+{
+	for (const auto& kernel : dense_kernels())
+	{
+		auto b = benchmark::RegisterBenchmark(
+		    ("BM_Kernel_gram_matrix/" + kernel.first).c_str(),
+		    BM_Kernel_gram_matrix, kernel.second);
+		add_size_and_thread_args(b, 256, 1024);
+		b->Unit(benchmark::kMillisecond)->UseRealTime();
+	}
+	return true;
+}
+
+static const bool kernel_benchmarks_registered = register_kernel_benchmarks();
+}
@@ -1246,13 +1246,14 @@ void CWeightedDegreePositionStringKernel::compute_batch(
 #endif
 	ASSERT(num_threads>0)
 	int32_t* vec=SG_MALLOC(int32_t, num_threads*num_feat);
+	auto pb = SG_PROGRESS(range(num_feat));
 
 	if (num_threads < 2)
 	{
-		// TODO: replace with the new signal
-		// for (int32_t j=0; j<num_feat && !CSignal::cancel_computations(); j++)
-		for (auto j : SG_PROGRESS(range(num_feat)))
+		for (auto j : pb)
 		{
+			if (pb.cancelled())
+				break;
 			init_optimization(num_suppvec, IDX, alphas, j);
 			S_THREAD_PARAM_WDS<DNATrie> params;
 			params.vec = vec;
@@ -1274,10 +1275,10 @@ void CWeightedDegreePositionStringKernel::compute_batch(
 #ifdef HAVE_PTHREAD
 	else
 	{
-		// TODO: replace with the new signal
-		// for (int32_t j=0; j<num_feat && !CSignal::cancel_computations(); j++)
-		for (auto j : SG_PROGRESS(range(num_feat)))
+		for (auto j : pb)
 		{
+			if (pb.cancelled())
+				break;
 			init_optimization(num_suppvec, IDX, alphas, j);
 			pthread_t* threads = SG_MALLOC(pthread_t, num_threads-1);
 			S_THREAD_PARAM_WDS<DNATrie>* params = SG_MALLOC(S_THREAD_PARAM_WDS<DNATrie>, num_threads);
@@ -1331,6 +1332,9 @@ void CWeightedDegreePositionStringKernel::compute_batch(
 	//really also free memory as this can be huge on testing especially when
 	//using the combined kernel
 	create_empty_tries();
+
+	if (pb.cancelled())
+		SG_ERROR("Computation of the kernel outputs was cancelled\n")
 }
 
 float64_t* CWeightedDegreePositionStringKernel::compute_scoring(
@@ -881,9 +881,7 @@ void CWeightedDegreeStringKernel::compute_batch(
 
 	if (num_threads < 2)
 	{
-		// TODO: replace with the new signal
-		// for (int32_t j=0; j<num_feat && !CSignal::cancel_computations(); j++)
-		for (int32_t j = 0; j < num_feat; j++)
+		for (int32_t j = 0; j < num_feat && !pb.cancelled(); j++)
 		{
 			init_optimization(num_suppvec, IDX, alphas, j);
 			S_THREAD_PARAM_WD params;
@@ -907,9 +905,7 @@ void CWeightedDegreeStringKernel::compute_batch(
 #ifdef HAVE_PTHREAD
 	else
 	{
-		// TODO: replace with the new signal
-		// for (int32_t j=0; j<num_feat && !CSignal::cancel_computations(); j++)
-		for (int32_t j = 0; j < num_feat; j++)
+		for (int32_t j = 0; j < num_feat && !pb.cancelled(); j++)
 		{
 			init_optimization(num_suppvec, IDX, alphas, j);
 			pthread_t* threads = SG_MALLOC(pthread_t, num_threads-1);
@@ -961,6 +957,9 @@ void CWeightedDegreeStringKernel::compute_batch(
 	//really also free memory as this can be huge on testing especially when
 	//using the combined kernel
 	create_empty_tries();
+
+	if (pb.cancelled())
+		SG_ERROR("Computation of the kernel outputs was cancelled\n")
 }
 
 bool CWeightedDegreeStringKernel::set_max_mismatch(int32_t max)
@@ -170,7 +170,8 @@ class CWeightedDegreeStringKernel: public CStringKernel<char>
 		 */
 		static void* compute_batch_helper(void* p);
 
-		/** compute batch
+		/** compute batch, raises an error if the computation is cancelled,
+		 * see CSignal::cancel_computations()
 		 *
 		 * @param num_vec number of vectors
 		 * @param vec_idx vector index
@@ -34,6 +34,8 @@ CDenseLabels::CDenseLabels(const CDenseLabels& orig)
     : CLabels(orig), m_labels(orig.m_labels)
 {
 	init();
+	m_max_subset_copy_size = orig.m_max_subset_copy_size;
+	subset_changed_post();
 }
 
 CDenseLabels::CDenseLabels(CFile* loader)
@@ -49,7 +51,12 @@ CDenseLabels::~CDenseLabels()
 
 void CDenseLabels::init()
 {
+	m_subset_labels_is_view = false;
+	m_max_subset_copy_size = 0;
+
 	SG_ADD(&m_labels, "labels", "The labels.");
+	SG_ADD(&m_max_subset_copy_size, "max_subset_copy_size",
+			"Maximum size in bytes of a copy of the active subset.");
 }
 
 void CDenseLabels::set_to_one()
@@ -71,6 +78,8 @@ void CDenseLabels::set_to_const(float64_t c)
 		m_labels.vector[m_subset_stack->subset_idx_conversion(i)]=c;
 		m_current_values.vector[m_subset_stack->subset_idx_conversion(i)]=c;
 	}
+
+	labels_changed();
 }
 
 void CDenseLabels::set_labels(SGVector<float64_t> v)
@@ -94,6 +103,9 @@ SGVector<float64_t> CDenseLabels::get_labels_copy() const
 	if (!m_subset_stack->has_subsets())
 		return m_labels.clone();
 
+	if (m_subset_labels.vector)
+		return m_subset_labels.clone();
+
 	index_t num_labels = get_num_labels();
 	SGVector<float64_t> result(num_labels);
 
@@ -153,6 +165,7 @@ void CDenseLabels::load(CFile* loader)
 	remove_subset();
 	m_labels = SGVector<float64_t>();
 	m_labels.load(loader);
+	subset_changed_post();
 }
 
 void CDenseLabels::save(CFile* writer)
@@ -166,9 +179,10 @@ void CDenseLabels::save(CFile* writer)
 bool CDenseLabels::set_label(int32_t idx, float64_t label)
 {
 	int32_t real_num=m_subset_stack->subset_idx_conversion(idx);
-	if (m_labels.vector && real_num<get_num_labels())
+	if (m_labels.vector && idx<get_num_labels())
 	{
 		m_labels.vector[real_num]=label;
+		labels_changed();
 		return true;
 	}
 	else
@@ -178,9 +192,10 @@ bool CDenseLabels::set_label(int32_t idx, float64_t label)
 bool CDenseLabels::set_int_label(int32_t idx, int32_t label)
 {
 	int32_t real_num=m_subset_stack->subset_idx_conversion(idx);
-	if (m_labels.vector && real_num<get_num_labels())
+	if (m_labels.vector && idx<get_num_labels())
 	{
 		m_labels.vector[real_num] = (float64_t)label;
+		labels_changed();
 		return true;
 	}
 	else
@@ -189,19 +204,21 @@ bool CDenseLabels::set_int_label(int32_t idx, int32_t label)
 
 float64_t CDenseLabels::get_label(int32_t idx) const
 {
-	int32_t real_num=m_subset_stack->subset_idx_conversion(idx);
 	ASSERT(m_labels.vector && idx<get_num_labels())
+	if (m_subset_labels.vector)
+		return m_subset_labels.vector[idx];
+
+	int32_t real_num=m_subset_stack->subset_idx_conversion(idx);
 	return m_labels.vector[real_num];
 }
 
 int32_t CDenseLabels::get_int_label(int32_t idx)
 {
-	int32_t real_num=m_subset_stack->subset_idx_conversion(idx);
-	ASSERT(m_labels.vector && idx<get_num_labels())
-	if (m_labels.vector[real_num] != float64_t((int32_t(m_labels.vector[real_num]))))
-		SG_ERROR("label[%d]=%g is not an integer\n", m_labels.vector[real_num])
+	float64_t label=get_label(idx);
+	if (label != float64_t((int32_t(label))))
+		SG_ERROR("label[%d]=%g is not an integer\n", idx, label)
 
-	return int32_t(m_labels.vector[real_num]);
+	return int32_t(label);
 }
 
 int32_t CDenseLabels::get_num_labels() const
@@ -209,3 +226,47 @@ int32_t CDenseLabels::get_num_labels() const
 	return m_subset_stack->has_subsets()
 			? m_subset_stack->get_size() : m_labels.vlen;
 }
+
+void CDenseLabels::set_max_subset_copy_size(int64_t max_bytes)
+{
+	REQUIRE(max_bytes>=0, "Maximum subset copy size (%ld) cannot be negative!\n", max_bytes);
+	m_max_subset_copy_size = max_bytes;
+	subset_changed_post();
+}
+
+int64_t CDenseLabels::get_max_subset_copy_size() const
+{
+	return m_max_subset_copy_size;
+}
+
+void CDenseLabels::labels_changed()
+{
+	/* a view sees the change, a copy is outdated */
+	if (m_subset_labels.vector && !m_subset_labels_is_view)
+		m_subset_labels = SGVector<float64_t>();
+}
+
+void CDenseLabels::subset_changed_post()
+{
+	m_subset_labels = SGVector<float64_t>();
+	m_subset_labels_is_view = false;
+
+	if (!m_subset_stack->has_subsets() || !m_labels.vector)
+		return;
+
+	index_t first = 0;
+	index_t num_labels = get_num_labels();
+	if (m_subset_stack->is_contiguous_range(first))
+	{
+		m_subset_labels =
+			SGVector<float64_t>(m_labels.vector + first, num_labels, false);
+		m_subset_labels_is_view = true;
+	}
+	else if (num_labels * int64_t(sizeof(float64_t)) <= m_max_subset_copy_size)
+	{
+		m_subset_labels = SGVector<float64_t>(num_labels);
+		for (index_t i = 0; i < num_labels; i++)
+			m_subset_labels[i] =
+				m_labels.vector[m_subset_stack->subset_idx_conversion(i)];
+	}
+}
@@ -133,6 +133,9 @@ namespace shogun
 				"Please ensure that you're using a valid index number.", idx, get_num_labels())
 			REQUIRE(m_labels.vector, "You're attempting to get a label when there are in fact none!  "
 				"Please ensure that you initialized the labels correctly.")
+			if (m_subset_labels.vector)
+				return m_subset_labels.vector[idx];
+
 			int32_t real_num=m_subset_stack->subset_idx_conversion(idx);
 			return m_labels.vector[real_num];
 		}
@@ -263,6 +266,29 @@ namespace shogun
 		 */
 		int32_t get_num_labels() const override;
 
+		/** Set the maximum size of a contiguous copy of the active subset.
+		 *
+		 * Labels of a subset that is a contiguous range are always accessed
+		 * in place, without index conversion. For other subsets whose labels
+		 * fit into the given size, the labels are gathered into a copy when
+		 * the subset is added. The label setters drop the copy. Writes
+		 * through label vectors obtained before the subset was added are not
+		 * seen while a copy is active.
+		 *
+		 * @param max_bytes maximum size of the copy in bytes, 0 (default)
+		 * disables copying
+		 */
+		void set_max_subset_copy_size(int64_t max_bytes);
+
+		/** @return maximum size of a contiguous copy of the active subset */
+		int64_t get_max_subset_copy_size() const;
+
+		/** stores the labels of the active subset contiguously, either as
+		 * a view into the label vector if the subset is a contiguous range,
+		 * or as a copy if it fits into get_max_subset_copy_size()
+		 */
+		void subset_changed_post() override;
+
 		virtual const char* get_name() const override = 0;
 
 	public:
@@ -272,9 +298,24 @@ namespace shogun
 	private:
 		void init();
 
+	protected:
+		/** drops a copy of the labels of the active subset, has to be
+		 * called after writing to m_labels
+		 */
+		void labels_changed();
+
 	protected:
 		/** the label vector */
 		SGVector<float64_t> m_labels;
+
+		/** labels of the active subset, empty if there is none */
+		SGVector<float64_t> m_subset_labels;
+
+		/** whether m_subset_labels is a view into m_labels */
+		bool m_subset_labels_is_view;
+
+		/** maximum size in bytes of a copy of the active subset */
+		int64_t m_max_subset_copy_size;
 };
 
 /**
@@ -51,21 +51,25 @@ void CLabels::init()
 void CLabels::add_subset(SGVector<index_t> subset)
 {
 	m_subset_stack->add_subset(subset);
+	subset_changed_post();
 }
 
 void CLabels::add_subset_in_place(SGVector<index_t> subset)
 {
 	m_subset_stack->add_subset_in_place(subset);
+	subset_changed_post();
 }
 
 void CLabels::remove_subset()
 {
 	m_subset_stack->remove_subset();
+	subset_changed_post();
 }
 
 void CLabels::remove_all_subsets()
 {
 	m_subset_stack->remove_all_subsets();
+	subset_changed_post();
 }
 
 CSubsetStack* CLabels::get_subset_stack()
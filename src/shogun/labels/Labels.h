@@ -107,6 +107,12 @@ namespace shogun
 		 * Calls subset_changed_post() afterwards */
 		virtual void remove_all_subsets();
 
+		/** method may be overwritten to update things that depend on subset
+		 */
+		virtual void subset_changed_post()
+		{
+		}
+
 		/**
 		 * @return subset stack
 		 */
@@ -61,6 +61,17 @@ void CMulticlassLabels::set_multiclass_confidences(int32_t i,
 	m_multiclass_confidences.set_column(i, confidences);
 }
 
+void CMulticlassLabels::set_multiclass_confidences(
+		SGMatrix<float64_t> confidences)
+{
+	REQUIRE(confidences.num_cols==get_num_labels(),
+			"%s::set_multiclass_confidences(): Number of columns (%d) should "
+			"match number of labels (%d)\n", get_name(), confidences.num_cols,
+			get_num_labels());
+
+	m_multiclass_confidences=confidences;
+}
+
 SGVector<float64_t> CMulticlassLabels::get_multiclass_confidences(int32_t i)
 {
 	SGVector<float64_t> confs(m_multiclass_confidences.num_rows);
@@ -126,6 +126,13 @@ class CMulticlassLabels : public CDenseLabels
 		 */
 		void set_multiclass_confidences(int32_t i, SGVector<float64_t> confidences);
 
+		/** sets the multiclass confidences of all results at once
+		 *
+		 * @param confidences num_classes x num_labels matrix, whose i-th
+		 * column holds the confidences of the ith result
+		 */
+		void set_multiclass_confidences(SGMatrix<float64_t> confidences);
+
 		/** allocates matrix to store confidences. should always
 		 * be called before setting confidences with
 		 * @ref set_multiclass_confidences
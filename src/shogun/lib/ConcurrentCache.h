@@ -0,0 +1,348 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ */
+
+#ifndef _CONCURRENT_CACHE_H__
+#define _CONCURRENT_CACHE_H__
+
+#include <shogun/lib/config.h>
+
+#include <shogun/base/SGObject.h>
+#include <shogun/io/SGIO.h>
+#include <shogun/lib/Lock.h>
+#include <shogun/lib/Tracer.h>
+#include <shogun/lib/common.h>
+
+#include <algorithm>
+#include <memory>
+#include <new>
+
+namespace shogun
+{
+/** @brief Template class ConcurrentCache implements a cache that can be
+ * accessed from several threads at the same time.
+ *
+ * Objects are distributed over a number of shards (object number modulo the
+ * number of shards), each of which owns a fixed set of cache lines and is
+ * guarded by its own lock, so threads working on different objects rarely
+ * contend. Shards are aligned to cache lines so that their locks do not
+ * share one. The least recently used unpinned line of a shard is replaced,
+ * all operations take constant time.
+ *
+ * Entries are pinned with a reference count: lock_entry() and set_entry()
+ * pin the returned entry, which stays valid until the matching
+ * unlock_entry(). Pinned entries are never evicted. An entry obtained by
+ * set_entry() must be written before it is unlocked and is not returned by
+ * lock_entry() to other threads in the meantime.
+ */
+template<class T> class CConcurrentCache : public CSGObject
+{
+	/** cache line */
+	struct TLine
+	{
+		/** number of the cached object, -1 if the line is free */
+		int64_t number;
+		/** previous unpinned line in LRU order, -1 if none */
+		int64_t prev;
+		/** next unpinned line in LRU order, -1 if none */
+		int64_t next;
+		/** number of users holding the entry */
+		int32_t pin_count;
+		/** whether the object has been written */
+		bool valid;
+	};
+
+	/** set of cache lines guarded by one lock */
+	struct alignas(CPU_CACHE_LINE_SIZE) TShard
+	{
+		/** lock of the shard */
+		CLock lock;
+		/** index of the first line of the shard */
+		int64_t first_line;
+		/** number of lines of the shard */
+		int64_t num_lines;
+		/** least recently used unpinned line, -1 if all are pinned */
+		int64_t lru_head;
+		/** most recently used unpinned line, -1 if all are pinned */
+		int64_t lru_tail;
+	};
+
+	public:
+	/** default constructor */
+	CConcurrentCache() : CSGObject()
+	{
+		SG_UNSTABLE("CConcurrentCache::CConcurrentCache()", "\n")
+
+		init();
+		set_generic<T>();
+	}
+
+	/** constructor
+	 *
+	 * create a cache in which num_entries objects can be cached
+	 * whose lookup table of sizeof(int64_t)*num_entries
+	 * must fit into memory
+	 *
+	 * @param cache_size cache size in Megabytes
+	 * @param obj_size object size
+	 * @param num_entries number of cached objects
+	 * @param num_shards number of independently locked shards, 0 picks a
+	 * default
+	 */
+	CConcurrentCache(
+		int64_t cache_size, int64_t obj_size, int64_t num_entries,
+		int32_t num_shards = 0)
+		: CSGObject()
+	{
+		init();
+		set_generic<T>();
+
+		if (cache_size==0 || obj_size==0 || num_entries==0)
+		{
+			SG_INFO("doing without cache.\n")
+			return;
+		}
+
+		entry_size = obj_size;
+		nr_cache_lines = std::min(
+			(int64_t)(cache_size * 1024 * 1024 / obj_size / sizeof(T)),
+			num_entries);
+		if (nr_cache_lines == 0)
+		{
+			SG_INFO("doing without cache.\n")
+			return;
+		}
+
+		if (num_shards <= 0)
+			num_shards = DEFAULT_NUM_SHARDS;
+		nr_shards = std::min<int64_t>(num_shards, nr_cache_lines);
+
+		SG_INFO(
+			"creating %d cache lines in %d shards (total size: %ld byte)\n",
+			nr_cache_lines, nr_shards, nr_cache_lines * obj_size * sizeof(T))
+		cache_block = SG_MALLOC(T, obj_size * nr_cache_lines);
+		lookup_table = SG_MALLOC(int64_t, num_entries);
+		lines = SG_MALLOC(TLine, nr_cache_lines);
+
+		// new[] does not honour the alignment of TShard before C++17
+		shard_memory.reset(
+			new char[sizeof(TShard) * nr_shards + CPU_CACHE_LINE_SIZE]);
+		auto offset = (CPU_CACHE_LINE_SIZE -
+			(uintptr_t)shard_memory.get() % CPU_CACHE_LINE_SIZE) %
+			CPU_CACHE_LINE_SIZE;
+		shards = reinterpret_cast<TShard*>(shard_memory.get() + offset);
+
+		std::fill_n(lookup_table, num_entries, -1);
+		for (int64_t i = 0; i < nr_shards; i++)
+		{
+			auto& shard = *new (&shards[i]) TShard();
+			shard.first_line = i * nr_cache_lines / nr_shards;
+			shard.num_lines =
+				(i + 1) * nr_cache_lines / nr_shards - shard.first_line;
+			shard.lru_head = -1;
+			shard.lru_tail = -1;
+
+			for (int64_t j = 0; j < shard.num_lines; j++)
+			{
+				auto idx = shard.first_line + j;
+				lines[idx].number = -1;
+				lines[idx].pin_count = 0;
+				lines[idx].valid = false;
+				push_back(shard, idx);
+			}
+		}
+	}
+
+	virtual ~CConcurrentCache()
+	{
+		SG_FREE(cache_block);
+		SG_FREE(lookup_table);
+		SG_FREE(lines);
+	}
+
+	/** checks if an object is cached
+	 *
+	 * @param number number of object to check for
+	 * @return if an object is cached
+	 */
+	bool is_cached(int64_t number)
+	{
+		if (!lookup_table)
+			return false;
+
+		auto& shard = get_shard(number);
+		shard.lock.lock();
+		auto line = lookup_table[number];
+		bool cached = line >= 0 && lines[line].valid;
+		shard.lock.unlock();
+
+		return cached;
+	}
+
+	/** checks if memory belongs to a cache entry
+	 *
+	 * @param ptr address to check
+	 * @return whether ptr points into the cache
+	 */
+	bool is_entry(const T* ptr) const
+	{
+		return cache_block && ptr >= cache_block &&
+			ptr < cache_block + entry_size * nr_cache_lines;
+	}
+
+	/** pin and get a cache entry
+	 *
+	 * @param number number of object to lock and get
+	 * @return cache entry or NULL when not cached
+	 */
+	T* lock_entry(int64_t number)
+	{
+		if (!lookup_table)
+			return NULL;
+
+		T* result = NULL;
+		auto& shard = get_shard(number);
+		shard.lock.lock();
+		auto line = lookup_table[number];
+		if (line >= 0 && lines[line].valid)
+		{
+			if (lines[line].pin_count++ == 0)
+				unlink(shard, line);
+			result = &cache_block[entry_size * line];
+		}
+		shard.lock.unlock();
+
+		SG_TRACE_COUNT(result ? TC_CACHE_HITS : TC_CACHE_MISSES, 1);
+		return result;
+	}
+
+	/** unpin a cache entry, an entry obtained by set_entry() becomes
+	 * visible to lock_entry() afterwards
+	 *
+	 * @param number number of object to unlock
+	 */
+	void unlock_entry(int64_t number)
+	{
+		if (!lookup_table)
+			return;
+
+		auto& shard = get_shard(number);
+		shard.lock.lock();
+		auto line = lookup_table[number];
+		if (line >= 0 && lines[line].pin_count > 0)
+		{
+			lines[line].valid = true;
+			if (--lines[line].pin_count == 0)
+				push_back(shard, line);
+		}
+		shard.lock.unlock();
+	}
+
+	/** returns the address of a free cache entry to where the data of size
+	 * obj_size has to be written. The entry is pinned.
+	 *
+	 * @param number number of object to store
+	 * @return address of a free cache entry, NULL if the object is already
+	 * (being) cached or all lines of its shard are pinned
+	 */
+	T* set_entry(int64_t number)
+	{
+		if (!lookup_table)
+			return NULL;
+
+		T* result = NULL;
+		auto& shard = get_shard(number);
+		shard.lock.lock();
+		auto idx = shard.lru_head;
+		if (lookup_table[number] < 0 && idx >= 0)
+		{
+			unlink(shard, idx);
+
+			auto& line = lines[idx];
+			if (line.number >= 0)
+				lookup_table[line.number] = -1;
+
+			line.number = number;
+			line.pin_count = 1;
+			line.valid = false;
+			lookup_table[number] = idx;
+			result = &cache_block[entry_size * idx];
+		}
+		shard.lock.unlock();
+
+		return result;
+	}
+
+	/** @return object name */
+	virtual const char* get_name() const { return "ConcurrentCache"; }
+
+	protected:
+	/** @return shard responsible for an object */
+	TShard& get_shard(int64_t number) const
+	{
+		return shards[number % nr_shards];
+	}
+
+	/** remove an unpinned line from the LRU list of its shard */
+	void unlink(TShard& shard, int64_t idx)
+	{
+		auto& line = lines[idx];
+		if (line.prev >= 0)
+			lines[line.prev].next = line.next;
+		else
+			shard.lru_head = line.next;
+
+		if (line.next >= 0)
+			lines[line.next].prev = line.prev;
+		else
+			shard.lru_tail = line.prev;
+	}
+
+	/** append a line that became unpinned to the LRU list of its shard */
+	void push_back(TShard& shard, int64_t idx)
+	{
+		auto& line = lines[idx];
+		line.prev = shard.lru_tail;
+		line.next = -1;
+		if (shard.lru_tail >= 0)
+			lines[shard.lru_tail].next = idx;
+		else
+			shard.lru_head = idx;
+		shard.lru_tail = idx;
+	}
+
+	private:
+	void init()
+	{
+		cache_block = NULL;
+		lookup_table = NULL;
+		lines = NULL;
+		shards = NULL;
+		nr_cache_lines = 0;
+		nr_shards = 0;
+		entry_size = 0;
+	}
+
+	protected:
+	/** default number of shards */
+	static constexpr int32_t DEFAULT_NUM_SHARDS = 64;
+
+	/** size of one entry */
+	int64_t entry_size;
+	/** number of cache lines */
+	int64_t nr_cache_lines;
+	/** number of shards */
+	int64_t nr_shards;
+	/** line index of each object, -1 if not cached */
+	int64_t* lookup_table;
+	/** cache lines */
+	TLine* lines;
+	/** memory of the shards */
+	std::unique_ptr<char[]> shard_memory;
+	/** shards, aligned to cache lines */
+	TShard* shards;
+	/** cache block */
+	T* cache_block;
+};
+}
+#endif
@@ -0,0 +1,179 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ */
+
+#include <shogun/lib/MemoryArena.h>
+#include <shogun/lib/Tracer.h>
+#include <shogun/lib/memory.h>
+
+#include <cstring>
+#include <new>
+
+using namespace shogun;
+
+namespace
+{
+std::atomic<int64_t> num_heap_allocs(0);
+std::atomic<int64_t> heap_bytes(0);
+std::atomic<int64_t> num_arena_allocs(0);
+std::atomic<int64_t> arena_bytes(0);
+
+thread_local MemoryArena* active_arena = NULL;
+
+size_t align_up(size_t size, size_t alignment)
+{
+	return (size + alignment - 1) / alignment * alignment;
+}
+}
+
+namespace shogun
+{
+
+SGAllocationCounters get_allocation_counters()
+{
+	SGAllocationCounters counters;
+	counters.num_heap_allocs = num_heap_allocs.load(std::memory_order_relaxed);
+	counters.heap_bytes = heap_bytes.load(std::memory_order_relaxed);
+	counters.num_arena_allocs =
+		num_arena_allocs.load(std::memory_order_relaxed);
+	counters.arena_bytes = arena_bytes.load(std::memory_order_relaxed);
+	return counters;
+}
+
+void reset_allocation_counters()
+{
+	num_heap_allocs.store(0, std::memory_order_relaxed);
+	heap_bytes.store(0, std::memory_order_relaxed);
+	num_arena_allocs.store(0, std::memory_order_relaxed);
+	arena_bytes.store(0, std::memory_order_relaxed);
+}
+
+/** header of a block, followed by its allocations */
+struct MemoryArena::Block
+{
+	/** live allocations plus one while the block is used by the arena */
+	std::atomic<int64_t> num_refs;
+	/** bytes used, including this header */
+	size_t used;
+	/** bytes available, including this header */
+	size_t capacity;
+};
+
+/** header of an allocation, right in front of its aligned data */
+struct Allocation
+{
+	RefCount refcount;
+	void* block;
+};
+
+static const size_t ALLOCATION_HEADER_SIZE = align_up(sizeof(Allocation), 16);
+
+MemoryArena::MemoryArena(size_t block_size)
+	: m_block(NULL), m_block_size(block_size), m_num_blocks(0)
+{
+}
+
+MemoryArena::~MemoryArena()
+{
+	if (m_block)
+		release_block(m_block);
+}
+
+/** @return offset of the next allocation's data in the block */
+static size_t next_data_offset(void* block, size_t used)
+{
+	size_t data = align_up(
+		(uintptr_t)block + used + ALLOCATION_HEADER_SIZE,
+		MemoryArena::ALIGNMENT);
+	return data - (uintptr_t)block;
+}
+
+RefCount* MemoryArena::allocate(size_t size)
+{
+	const size_t block_header_size = sizeof(Block);
+	if (ALLOCATION_HEADER_SIZE + ALIGNMENT + size > m_block_size / 4)
+		return NULL;
+
+	if (m_block &&
+	    next_data_offset(m_block, m_block->used) + size > m_block->capacity)
+	{
+		// nothing of the block is alive anymore, start over
+		if (m_block->num_refs.load(std::memory_order_acquire) == 1)
+			m_block->used = block_header_size;
+		else
+		{
+			release_block(m_block);
+			m_block = NULL;
+		}
+	}
+
+	if (!m_block)
+	{
+		void* memory = SG_MALLOC(char, m_block_size);
+		m_block = new (memory) Block();
+		m_block->num_refs.store(1, std::memory_order_relaxed);
+		m_block->used = block_header_size;
+		m_block->capacity = m_block_size;
+		m_num_blocks++;
+	}
+
+	size_t offset = next_data_offset(m_block, m_block->used);
+	char* data = (char*)m_block + offset;
+	m_block->used = offset + size;
+	m_block->num_refs.fetch_add(1, std::memory_order_relaxed);
+
+	auto allocation = new (data - ALLOCATION_HEADER_SIZE) Allocation();
+	allocation->block = m_block;
+	std::memset(data, 0, size);
+
+	num_arena_allocs.fetch_add(1, std::memory_order_relaxed);
+	arena_bytes.fetch_add(size, std::memory_order_relaxed);
+	SG_TRACE_COUNT(TC_ALLOCATIONS, 1);
+
+	return &allocation->refcount;
+}
+
+MemoryArena* MemoryArena::current()
+{
+	return active_arena;
+}
+
+void MemoryArena::count_heap_allocation(size_t size)
+{
+	num_heap_allocs.fetch_add(1, std::memory_order_relaxed);
+	heap_bytes.fetch_add(size, std::memory_order_relaxed);
+	SG_TRACE_COUNT(TC_ALLOCATIONS, 1);
+}
+
+void* MemoryArena::data(RefCount* refcount)
+{
+	return (char*)refcount + ALLOCATION_HEADER_SIZE;
+}
+
+void MemoryArena::release(RefCount* refcount)
+{
+	auto allocation = reinterpret_cast<Allocation*>(refcount);
+	auto block = (Block*)allocation->block;
+	allocation->~Allocation();
+	release_block(block);
+}
+
+void MemoryArena::release_block(Block* block)
+{
+	if (block->num_refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+	{
+		block->~Block();
+		SG_FREE((char*)block);
+	}
+}
+
+ArenaScope::ArenaScope(MemoryArena& arena) : m_previous(active_arena)
+{
+	active_arena = &arena;
+}
+
+ArenaScope::~ArenaScope()
+{
+	active_arena = m_previous;
+}
+}
@@ -0,0 +1,150 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ */
+
+#ifndef __MEMORY_ARENA_H__
+#define __MEMORY_ARENA_H__
+
+#include <shogun/lib/config.h>
+
+#include <shogun/lib/RefCount.h>
+#include <shogun/lib/common.h>
+#include <shogun/lib/memory.h>
+
+#include <atomic>
+
+namespace shogun
+{
+/** @brief Counters of the data allocations of reference counted containers
+ * (SGVector, SGMatrix), to find code that creates many temporaries.
+ */
+struct SGAllocationCounters
+{
+	/** number of allocations from the heap */
+	int64_t num_heap_allocs;
+	/** number of bytes allocated from the heap */
+	int64_t heap_bytes;
+	/** number of allocations from a memory arena */
+	int64_t num_arena_allocs;
+	/** number of bytes allocated from a memory arena */
+	int64_t arena_bytes;
+};
+
+/** @return counters of all container allocations so far */
+SGAllocationCounters get_allocation_counters();
+
+/** resets the allocation counters to zero */
+void reset_allocation_counters();
+
+/** @brief MemoryArena serves short-lived SGVector and SGMatrix data while it
+ * is activated on a thread with ArenaScope.
+ *
+ * Memory is handed out sequentially from large blocks, the reference counter
+ * of each allocation is stored in front of its data, so a container costs
+ * no call to the heap at all. A block is returned to the heap once the arena
+ * moved on and all of its allocations have been released, so containers may
+ * outlive both the scope and the arena. If all allocations of the current
+ * block have been released when it runs full, the block is reused.
+ *
+ * Allocations may be released from any thread, but an arena must only be
+ * active on one thread at a time. Data allocated from an arena must not be
+ * passed to SG_FREE or SG_REALLOC.
+ */
+class MemoryArena
+{
+public:
+	/** default size of a block */
+	static constexpr size_t DEFAULT_BLOCK_SIZE = 256 * 1024;
+
+	/** alignment of allocated data */
+	static constexpr size_t ALIGNMENT = SG_DATA_ALIGNMENT;
+
+	/** constructor
+	 *
+	 * @param block_size size of the blocks to allocate from, allocations
+	 * larger than a quarter of it are left to the heap
+	 */
+	MemoryArena(size_t block_size = DEFAULT_BLOCK_SIZE);
+
+	/** destructor, releases the current block */
+	~MemoryArena();
+
+	MemoryArena(const MemoryArena&) = delete;
+	MemoryArena& operator=(const MemoryArena&) = delete;
+
+	/** allocates a reference counter with size bytes of data behind it
+	 *
+	 * @param size size of the data in bytes
+	 * @return reference counter starting at zero, or NULL if the data is
+	 * too large for the arena
+	 */
+	RefCount* allocate(size_t size);
+
+	/** @return number of blocks allocated from the heap so far */
+	int64_t get_num_blocks() const
+	{
+		return m_num_blocks;
+	}
+
+	/** @return arena that is active on the calling thread, or NULL */
+	static MemoryArena* current();
+
+	/** counts an allocation of container data from the heap
+	 *
+	 * @param size size of the data in bytes
+	 */
+	static void count_heap_allocation(size_t size);
+
+	/** @return data allocated together with a reference counter */
+	static void* data(RefCount* refcount);
+
+	/** releases a reference counter and its data
+	 *
+	 * @param refcount reference counter returned by allocate()
+	 */
+	static void release(RefCount* refcount);
+
+private:
+	struct Block;
+
+	/** releases one reference to a block, frees it when it was the last */
+	static void release_block(Block* block);
+
+	/** block to allocate from */
+	Block* m_block;
+
+	/** size of new blocks */
+	size_t m_block_size;
+
+	/** number of blocks allocated */
+	int64_t m_num_blocks;
+
+	friend class ArenaScope;
+};
+
+/** @brief ArenaScope activates a MemoryArena on the calling thread for its
+ * lifetime: SGVector and SGMatrix instances created by this thread in the
+ * meantime take their memory from the arena. Scopes may be nested.
+ */
+class ArenaScope
+{
+public:
+	/** constructor
+	 *
+	 * @param arena arena to activate
+	 */
+	ArenaScope(MemoryArena& arena);
+
+	/** destructor, reactivates the previous arena */
+	~ArenaScope();
+
+	ArenaScope(const ArenaScope&) = delete;
+	ArenaScope& operator=(const ArenaScope&) = delete;
+
+private:
+	/** arena active before this scope */
+	MemoryArena* m_previous;
+};
+}
+
+#endif // __MEMORY_ARENA_H__
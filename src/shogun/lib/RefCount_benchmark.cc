@@ -6,7 +6,13 @@
 
 #include <benchmark/benchmark.h>
 
+#include "shogun/lib/MemoryArena.h"
 #include "shogun/lib/RefCount.h"
+#include "shogun/lib/SGVector.h"
+#include "shogun/lib/SGVectorView.h"
+
+#include <numeric>
+#include <utility>
 
 namespace shogun
 {
@@ -18,6 +24,77 @@ static void BM_RefCount(benchmark::State& state)
 		rf.ref();
 }
 
+static void BM_SGVector_create(benchmark::State& state)
+{
+	for (auto _ : state)
+	{
+		SGVector<float64_t> vec(state.range(0));
+		benchmark::DoNotOptimize(vec.vector);
+	}
+}
+
+static void BM_SGVector_create_arena(benchmark::State& state)
+{
+	MemoryArena arena;
+	ArenaScope scope(arena);
+	for (auto _ : state)
+	{
+		SGVector<float64_t> vec(state.range(0));
+		benchmark::DoNotOptimize(vec.vector);
+	}
+}
+
+static void BM_SGVector_copy(benchmark::State& state)
+{
+	SGVector<float64_t> vec(16);
+	for (auto _ : state)
+	{
+		SGVector<float64_t> copy(vec);
+		benchmark::DoNotOptimize(copy.vector);
+	}
+}
+
+static void BM_SGVector_move(benchmark::State& state)
+{
+	SGVector<float64_t> vec(16);
+	for (auto _ : state)
+	{
+		SGVector<float64_t> moved(std::move(vec));
+		benchmark::DoNotOptimize(moved.vector);
+		vec = std::move(moved);
+	}
+}
+
+static float64_t sum_by_value(SGVector<float64_t> vec)
+{
+	return std::accumulate(vec.begin(), vec.end(), 0.0);
+}
+
+static float64_t sum_by_view(SGVectorView<float64_t> vec)
+{
+	return std::accumulate(vec.begin(), vec.end(), 0.0);
+}
+
+static void BM_SGVector_pass_by_value(benchmark::State& state)
+{
+	SGVector<float64_t> vec(16);
+	for (auto _ : state)
+		benchmark::DoNotOptimize(sum_by_value(vec));
+}
+
+static void BM_SGVectorView_pass(benchmark::State& state)
+{
+	SGVector<float64_t> vec(16);
+	for (auto _ : state)
+		benchmark::DoNotOptimize(sum_by_view(vec));
+}
+
 BENCHMARK(BM_RefCount);
+BENCHMARK(BM_SGVector_create)->Range(8, 8 << 10);
+BENCHMARK(BM_SGVector_create_arena)->Range(8, 8 << 10);
+BENCHMARK(BM_SGVector_copy);
+BENCHMARK(BM_SGVector_move);
+BENCHMARK(BM_SGVector_pass_by_value);
+BENCHMARK(BM_SGVectorView_pass);
 
 }
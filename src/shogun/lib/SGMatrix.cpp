@@ -51,9 +51,12 @@ SGMatrix<T>::SGMatrix(T* m, index_t nrows, index_t ncols, index_t offset)
 
 template <class T>
 SGMatrix<T>::SGMatrix(index_t nrows, index_t ncols, bool ref_counting)
-	: SGReferencedData(ref_counting), num_rows(nrows), num_cols(ncols), gpu_ptr(nullptr)
+	: SGReferencedData(ref_counting, sizeof(T)*int64_t(nrows)*ncols),
+	num_rows(nrows), num_cols(ncols), gpu_ptr(nullptr)
 {
-	matrix=SG_CALLOC(T, ((int64_t) nrows)*ncols);
+	matrix=(T*) colocated_data();
+	if (!matrix)
+		matrix=SG_CALLOC(T, ((int64_t) nrows)*ncols);
 	m_on_gpu.store(false, std::memory_order_release);
 }
 
@@ -115,6 +118,27 @@ SGMatrix<T>::operator EigenMatrixXtMap() const
 	return EigenMatrixXtMap(matrix, num_rows, num_cols);
 }
 
+template <class T>
+SGMatrix<T>::SGMatrix(SGMatrix&& orig) noexcept
+: SGReferencedData(std::move(orig))
+{
+	copy_data(orig);
+	orig.init_data();
+}
+
+template<class T>
+SGMatrix<T>& SGMatrix<T>::operator=(SGMatrix<T>&& other) noexcept
+{
+	if(&other == this)
+	return *this;
+
+	unref();
+	copy_data(other);
+	move_refcount(other);
+	other.init_data();
+	return *this;
+}
+
 template<class T>
 SGMatrix<T>& SGMatrix<T>::operator=(const SGMatrix<T>& other)
 {
@@ -338,11 +362,16 @@ SGMatrix<T> SGMatrix<T>::clone() const
 		return SGMatrix<T>(gpu_ptr->clone_vector(gpu_ptr.get(),
 						   num_rows*num_cols), num_rows, num_cols);
 	}
-	else
+	else if (!matrix || !num_rows || !num_cols)
 	{
 		return SGMatrix<T>(clone_matrix(matrix, num_rows, num_cols),
 						   num_rows, num_cols);
 	}
+
+	/* fresh containers have aligned data */
+	SGMatrix<T> result(num_rows, num_cols);
+	sg_memcpy(result.matrix, matrix, sizeof(T)*int64_t(num_rows)*num_cols);
+	return result;
 }
 
 template <class T>
@@ -906,7 +935,9 @@ void SGMatrix<T>::init_data()
 template<class T>
 void SGMatrix<T>::free_data()
 {
-	SG_FREE(matrix);
+	/* colocated data is released with the reference counter */
+	if (!is_data_colocated())
+		SG_FREE(matrix);
 	matrix=NULL;
 	num_rows=0;
 	num_cols=0;
@@ -124,6 +124,14 @@ template<class T> class SGMatrix : public SGReferencedData
 
 		/** Copy assign operator */
 		SGMatrix<T>& operator=(const SGMatrix<T>&);
+
+		/** Move assign operator, leaves other empty */
+		SGMatrix<T>& operator=(SGMatrix<T>&& other) noexcept;
+
+		/** Move constructor, leaves orig empty without touching the
+		 * reference counter
+		 */
+		SGMatrix(SGMatrix&& orig) noexcept;
 #endif // SWIG
 
 		/** Copy constructor */
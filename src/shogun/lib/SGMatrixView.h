@@ -0,0 +1,92 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ */
+
+#ifndef __SGMATRIXVIEW_H__
+#define __SGMATRIXVIEW_H__
+
+#include <shogun/lib/config.h>
+
+#include <shogun/lib/SGMatrix.h>
+#include <shogun/lib/SGVectorView.h>
+#include <shogun/lib/common.h>
+
+namespace shogun
+{
+/** @brief Read-only view of the data of an SGMatrix, stored in column-major
+ * order.
+ *
+ * Like SGVectorView, a view does not keep the data alive and must not
+ * outlive the matrix it was created from.
+ */
+template <class T>
+class SGMatrixView
+{
+public:
+	/** default constructor, creates an empty view */
+	SGMatrixView() : m_data(nullptr), m_num_rows(0), m_num_cols(0)
+	{
+	}
+
+	/** constructor
+	 *
+	 * @param data pointer to the viewed data
+	 * @param num_rows number of rows
+	 * @param num_cols number of columns
+	 */
+	SGMatrixView(const T* data, index_t num_rows, index_t num_cols)
+		: m_data(data), m_num_rows(num_rows), m_num_cols(num_cols)
+	{
+	}
+
+	/** constructor
+	 *
+	 * @param matrix matrix to view
+	 */
+	SGMatrixView(const SGMatrix<T>& matrix)
+		: m_data(matrix.data()), m_num_rows(matrix.num_rows),
+		  m_num_cols(matrix.num_cols)
+	{
+	}
+
+	/** @return number of rows */
+	SG_FORCED_INLINE index_t num_rows() const
+	{
+		return m_num_rows;
+	}
+
+	/** @return number of columns */
+	SG_FORCED_INLINE index_t num_cols() const
+	{
+		return m_num_cols;
+	}
+
+	/** @return pointer to the data */
+	SG_FORCED_INLINE const T* data() const
+	{
+		return m_data;
+	}
+
+	/** @return element in given row and column */
+	SG_FORCED_INLINE const T& operator()(index_t row, index_t col) const
+	{
+		return m_data[col * int64_t(m_num_rows) + row];
+	}
+
+	/** @return view of a column */
+	SG_FORCED_INLINE SGVectorView<T> get_column(index_t col) const
+	{
+		return SGVectorView<T>(m_data + col * int64_t(m_num_rows), m_num_rows);
+	}
+
+private:
+	/** viewed data */
+	const T* m_data;
+	/** number of rows */
+	index_t m_num_rows;
+	/** number of columns */
+	index_t m_num_cols;
+};
+}
+
+#endif // __SGMATRIXVIEW_H__
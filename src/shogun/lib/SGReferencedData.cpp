@@ -1,11 +1,31 @@
+#include <shogun/lib/MemoryArena.h>
 #include <shogun/lib/SGReferencedData.h>
 #include <shogun/lib/RefCount.h>
+#include <shogun/lib/memory.h>
+
+#include <new>
 
 using namespace shogun;
 
+namespace
+{
+/** header right in front of colocated heap data */
+struct HeapAllocation
+{
+	RefCount refcount;
+	/** start of the allocation, before the padding that aligns the data */
+	char* memory;
+};
+
+const size_t HEAP_HEADER_SIZE = 16;
+static_assert(sizeof(HeapAllocation) <= HEAP_HEADER_SIZE,
+	"Reference counter does not fit in front of the data");
+}
+
 namespace shogun {
 
-SGReferencedData::SGReferencedData(bool ref_counting) : m_refcount(NULL)
+SGReferencedData::SGReferencedData(bool ref_counting)
+	: m_refcount(NULL), m_colocation(COLOCATION_NONE)
 {
 	if (ref_counting)
 	{
@@ -15,12 +35,52 @@ SGReferencedData::SGReferencedData(bool ref_counting) : m_refcount(NULL)
 	ref();
 }
 
+SGReferencedData::SGReferencedData(bool ref_counting, size_t size)
+	: m_refcount(NULL), m_colocation(COLOCATION_NONE)
+{
+	if (ref_counting)
+	{
+		auto arena = MemoryArena::current();
+		if (arena)
+		{
+			m_refcount = arena->allocate(size);
+			if (m_refcount)
+				m_colocation = COLOCATION_ARENA;
+		}
+
+		if (!m_refcount)
+		{
+			MemoryArena::count_heap_allocation(size);
+			/* pad, so that the data behind the header is aligned */
+			char* memory =
+				SG_CALLOC(char, HEAP_HEADER_SIZE + SG_DATA_ALIGNMENT + size);
+			size_t padding = (SG_DATA_ALIGNMENT -
+				(uintptr_t)(memory + HEAP_HEADER_SIZE) % SG_DATA_ALIGNMENT) %
+				SG_DATA_ALIGNMENT;
+			auto allocation = new (memory + padding) HeapAllocation();
+			allocation->memory = memory;
+			m_refcount = &allocation->refcount;
+			m_colocation = COLOCATION_HEAP;
+		}
+	}
+	else
+		MemoryArena::count_heap_allocation(size);
+
+	ref();
+}
+
 SGReferencedData::SGReferencedData(const SGReferencedData &orig)
 {
 	copy_refcount(orig);
 	ref();
 }
 
+SGReferencedData::SGReferencedData(SGReferencedData&& orig) noexcept
+	: m_refcount(NULL), m_colocation(COLOCATION_NONE)
+{
+	move_refcount(orig);
+}
+
 SGReferencedData& SGReferencedData::operator= (const SGReferencedData &orig)
 {
 	if (this == &orig)
@@ -35,7 +95,7 @@ SGReferencedData& SGReferencedData::operator= (const SGReferencedData &orig)
 
 SGReferencedData::~SGReferencedData()
 {
-	delete m_refcount;
+	release_refcount();
 }
 
 int32_t SGReferencedData::ref_count()
@@ -55,25 +115,51 @@ int32_t SGReferencedData::ref_count()
 void SGReferencedData::copy_refcount(const SGReferencedData &orig)
 {
 	m_refcount =  orig.m_refcount;
+	m_colocation = orig.m_colocation;
 }
 
-/** increase reference counter
- *
- * @return reference count
- */
-int32_t SGReferencedData::ref()
+void SGReferencedData::move_refcount(SGReferencedData& orig)
 {
-	if (m_refcount == NULL)
+	m_refcount = orig.m_refcount;
+	m_colocation = orig.m_colocation;
+	orig.m_refcount = NULL;
+	orig.m_colocation = COLOCATION_NONE;
+}
+
+void* SGReferencedData::colocated_data() const
+{
+	switch (m_colocation)
 	{
-		return -1;
+	case COLOCATION_HEAP:
+		return (char*)m_refcount + HEAP_HEADER_SIZE;
+	case COLOCATION_ARENA:
+		return MemoryArena::data(m_refcount);
+	default:
+		return NULL;
 	}
+}
 
-	int32_t c = m_refcount->ref();
+void SGReferencedData::release_refcount()
+{
+	switch (m_colocation)
+	{
+	case COLOCATION_HEAP:
+	{
+		auto allocation = reinterpret_cast<HeapAllocation*>(m_refcount);
+		char* memory = allocation->memory;
+		allocation->~HeapAllocation();
+		SG_FREE(memory);
+		break;
+	}
+	case COLOCATION_ARENA:
+		MemoryArena::release(m_refcount);
+		break;
+	default:
+		delete m_refcount;
+	}
 
-#ifdef DEBUG_SGVECTOR
-	SG_SGCDEBUG("ref() refcount %ld data %p increased\n", c, this)
-#endif
-	return c;
+	m_refcount = NULL;
+	m_colocation = COLOCATION_NONE;
 }
 
 /** decrement reference counter and deallocate object if refcount is zero
@@ -98,8 +184,7 @@ int32_t SGReferencedData::unref()
 		SG_SGCDEBUG("unref() refcount %d data %p destroying\n", c, this)
 #endif
 		free_data();
-		delete m_refcount;
-		m_refcount=NULL;
+		release_refcount();
 		return 0;
 	}
 	else
@@ -109,6 +194,7 @@ int32_t SGReferencedData::unref()
 #endif
 		init_data();
 		m_refcount=NULL;
+		m_colocation=COLOCATION_NONE;
 		return c;
 	}
 }
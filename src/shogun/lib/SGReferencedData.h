@@ -10,21 +10,47 @@
 #include <shogun/lib/config.h>
 
 #include <shogun/lib/common.h>
+#include <shogun/lib/RefCount.h>
 
 namespace shogun
 {
-class RefCount;
 
-/** @brief shogun reference count managed data */
+/** @brief shogun reference count managed data
+ *
+ * Containers that allocate their data on construction keep the reference
+ * counter in the same allocation, right in front of the data, either on the
+ * heap or in the MemoryArena active on the calling thread. Such data is
+ * released together with the counter and must not be freed or reallocated
+ * by other means.
+ */
 class SGReferencedData
 {
 	public:
 		/** default constructor */
 		SGReferencedData(bool ref_counting=true);
 
+		/** constructor for containers that allocate size bytes of data
+		 * right away. If reference counting is enabled, the zero-initialised
+		 * data is allocated together with the reference counter, from the
+		 * MemoryArena active on the calling thread if there is one, and is
+		 * available through colocated_data(), aligned to SG_DATA_ALIGNMENT
+		 * bytes.
+		 *
+		 * @param ref_counting whether to use reference counting
+		 * @param size size of the data in bytes
+		 */
+		SGReferencedData(bool ref_counting, size_t size);
+
 		/** copy constructor */
 		SGReferencedData(const SGReferencedData &orig);
 
+#ifndef SWIG // SWIG should skip this part
+		/** move constructor, takes over the reference of orig without
+		 * touching the counter
+		 */
+		SGReferencedData(SGReferencedData&& orig) noexcept;
+#endif
+
 		/** override assignment operator to increase refcount on assignments */
 		SGReferencedData& operator= (const SGReferencedData &orig);
 
@@ -45,11 +71,35 @@ class SGReferencedData
 		/** copy refcount */
 		void copy_refcount(const SGReferencedData &orig);
 
+		/** take over the reference of orig, which is left without one */
+		void move_refcount(SGReferencedData& orig);
+
+		/** @return data allocated together with the reference counter, NULL
+		 * if the data is allocated separately
+		 */
+		void* colocated_data() const;
+
+		/** @return whether the data is allocated together with the
+		 * reference counter and released with it
+		 */
+		bool is_data_colocated() const
+		{
+			return m_colocation != COLOCATION_NONE;
+		}
+
 		/** increase reference counter
 		 *
 		 * @return reference count
 		 */
-		int32_t ref();
+		SG_FORCED_INLINE int32_t ref()
+		{
+			if (m_refcount == NULL)
+			{
+				return -1;
+			}
+
+			return m_refcount->ref();
+		}
 
 		/** decrement reference counter and deallocate object if refcount is zero
 		 * before or after decrementing it
@@ -68,9 +118,25 @@ class SGReferencedData
 		virtual void free_data()=0;
 
 	private:
+		/** where the data is allocated relative to the reference counter */
+		enum EColocation
+		{
+			/** data is allocated separately */
+			COLOCATION_NONE,
+			/** data follows the counter in a heap allocation */
+			COLOCATION_HEAP,
+			/** data follows the counter in a memory arena */
+			COLOCATION_ARENA
+		};
+
+		/** releases the reference counter */
+		void release_refcount();
 
 		/** reference counter */
 		RefCount* m_refcount;
+
+		/** where the data is allocated */
+		EColocation m_colocation;
 };
 }
 #endif // __SGREFERENCED_DATA_H__
@@ -86,9 +86,11 @@ SGVector<T>::SGVector(T* m, index_t len, index_t offset)
 
 template<class T>
 SGVector<T>::SGVector(index_t len, bool ref_counting)
-: SGReferencedData(ref_counting), vlen(len), gpu_ptr(NULL)
+: SGReferencedData(ref_counting, sizeof(T)*len), vlen(len), gpu_ptr(NULL)
 {
-	vector=SG_CALLOC(T, len);
+	vector=(T*) colocated_data();
+	if (!vector)
+		vector=SG_CALLOC(T, len);
 	m_on_gpu.store(false, std::memory_order_release);
 }
 
@@ -122,6 +124,27 @@ SGVector<T>::SGVector(const SGVector &orig) : SGReferencedData(orig)
 	copy_data(orig);
 }
 
+template<class T>
+SGVector<T>::SGVector(SGVector&& orig) noexcept
+: SGReferencedData(std::move(orig))
+{
+	copy_data(orig);
+	orig.init_data();
+}
+
+template<class T>
+SGVector<T>& SGVector<T>::operator=(SGVector<T>&& other) noexcept
+{
+	if(&other == this)
+	return *this;
+
+	unref();
+	copy_data(other);
+	move_refcount(other);
+	other.init_data();
+	return *this;
+}
+
 template<class T>
 SGVector<T>& SGVector<T>::operator=(const SGVector<T>& other)
 {
@@ -259,8 +282,13 @@ SGVector<T> SGVector<T>::clone() const
 {
 	if (on_gpu())
 		return SGVector<T>(gpu_ptr->clone_vector(gpu_ptr.get(), vlen), vlen);
-	else
+	else if (!vector || !vlen)
 		return SGVector<T>(clone_vector(vector, vlen), vlen);
+
+	/* fresh containers have aligned data */
+	SGVector<T> result(vlen);
+	sg_memcpy(result.vector, vector, sizeof(T)*vlen);
+	return result;
 }
 
 template<class T>
@@ -302,7 +330,15 @@ template<class T>
 void SGVector<T>::resize_vector(int32_t n)
 {
 	assert_on_cpu();
-	vector=SG_REALLOC(T, vector, vlen, n);
+	if (is_data_colocated())
+	{
+		/* data that lives with the reference counter cannot be reallocated */
+		T* data=SG_MALLOC(T, n);
+		sg_memcpy(data, vector, CMath::min(n, vlen)*sizeof(T));
+		*this=SGVector<T>(data, vlen);
+	}
+	else
+		vector=SG_REALLOC(T, vector, vlen, n);
 
 	if (n > vlen)
 		memset(&vector[vlen], 0, (n-vlen)*sizeof(T));
@@ -386,7 +422,9 @@ void SGVector<T>::init_data()
 template<class T>
 void SGVector<T>::free_data()
 {
-	SG_FREE(vector);
+	/* colocated data is released with the reference counter */
+	if (!is_data_colocated())
+		SG_FREE(vector);
 	vector=NULL;
 	vlen=0;
 	gpu_ptr=NULL;
@@ -82,6 +82,13 @@ template<class T> class SGVector : public SGReferencedData
 		/** Copy constructor */
 		SGVector(const SGVector &orig);
 
+#ifndef SWIG // SWIG should skip this part
+		/** Move constructor, leaves orig empty without touching the
+		 * reference counter
+		 */
+		SGVector(SGVector&& orig) noexcept;
+#endif
+
 		/** Check whether data is stored on GPU
 		 *
 		 * @return true if vector is on GPU
@@ -102,11 +109,13 @@ template<class T> class SGVector : public SGReferencedData
 		/** Construct SGVector from InputIterator list */
 		template<typename InputIt>
 		SGVector(InputIt beginIt, InputIt endIt):
-			SGReferencedData(true),
+			SGReferencedData(true, sizeof(T) * std::distance(beginIt, endIt)),
 			vlen(std::distance(beginIt, endIt)),
 			gpu_ptr(nullptr)
 		{
-			vector = SG_MALLOC(T, vlen);
+			vector = (T*)colocated_data();
+			if (!vector)
+				vector = SG_MALLOC(T, vlen);
 			std::copy(beginIt, endIt, vector);
 			m_on_gpu.store(false, std::memory_order_release);
 		}
@@ -180,6 +189,9 @@ template<class T> class SGVector : public SGReferencedData
 
 		SGVector<T>& operator=(const SGVector<T>&);
 
+		/** Move assign operator, leaves other empty */
+		SGVector<T>& operator=(SGVector<T>&& other) noexcept;
+
 		/** Check for pointer identity */
 		SG_FORCED_INLINE bool operator==(const SGVector<T>& other) const
 		{
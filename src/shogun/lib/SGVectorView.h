@@ -0,0 +1,88 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ */
+
+#ifndef __SGVECTORVIEW_H__
+#define __SGVECTORVIEW_H__
+
+#include <shogun/lib/config.h>
+
+#include <shogun/lib/SGVector.h>
+#include <shogun/lib/common.h>
+
+namespace shogun
+{
+/** @brief Read-only view of the data of an SGVector.
+ *
+ * Unlike SGVector, a view has no reference counter and no virtual
+ * methods: copying and passing it around is as cheap as passing a pointer
+ * and a length, which makes it the type of choice for inner loops. The
+ * viewed data is not kept alive, so a view must not outlive the vector it
+ * was created from.
+ */
+template <class T>
+class SGVectorView
+{
+public:
+	/** default constructor, creates an empty view */
+	SGVectorView() : m_data(nullptr), m_size(0)
+	{
+	}
+
+	/** constructor
+	 *
+	 * @param data pointer to the viewed data
+	 * @param size number of elements
+	 */
+	SGVectorView(const T* data, index_t size) : m_data(data), m_size(size)
+	{
+	}
+
+	/** constructor
+	 *
+	 * @param vector vector to view
+	 */
+	SGVectorView(const SGVector<T>& vector)
+		: m_data(vector.data()), m_size(vector.vlen)
+	{
+	}
+
+	/** @return number of elements */
+	SG_FORCED_INLINE index_t size() const
+	{
+		return m_size;
+	}
+
+	/** @return pointer to the data */
+	SG_FORCED_INLINE const T* data() const
+	{
+		return m_data;
+	}
+
+	/** @return element at given index */
+	SG_FORCED_INLINE const T& operator[](index_t index) const
+	{
+		return m_data[index];
+	}
+
+	/** @return iterator to the first element */
+	SG_FORCED_INLINE const T* begin() const
+	{
+		return m_data;
+	}
+
+	/** @return iterator past the last element */
+	SG_FORCED_INLINE const T* end() const
+	{
+		return m_data + m_size;
+	}
+
+private:
+	/** viewed data */
+	const T* m_data;
+	/** number of elements */
+	index_t m_size;
+};
+}
+
+#endif // __SGVECTORVIEW_H__
@@ -15,6 +15,7 @@ using namespace shogun;
 using namespace rxcpp;
 
 bool CSignal::m_active = true;
+std::atomic<int64_t> CSignal::m_num_cancellations(0);
 CSignal::SGSubjectS* CSignal::m_subject = new rxcpp::subjects::subject<int>();
 
 CSignal::SGObservableS* CSignal::m_observable =
@@ -57,7 +58,7 @@ void CSignal::handler(int signal)
 			SG_SPRINT(
 			    "[ShogunSignalHandler] Terminating"
 			    " prematurely current algorithm...\n");
-			m_subscriber->on_next(SG_BLOCK_COMP);
+			cancel_computations();
 			break;
 		case 'P':
 			SG_SPRINT("[ShogunSignalHandler] Pausing current computation...")
@@ -74,6 +75,12 @@ void CSignal::handler(int signal)
 	}
 }
 
+void CSignal::cancel_computations()
+{
+	m_num_cancellations.fetch_add(1, std::memory_order_relaxed);
+	m_subscriber->on_next(SG_BLOCK_COMP);
+}
+
 void CSignal::reset_handler()
 {
 	delete m_subject;
@@ -10,6 +10,8 @@
 
 #include <shogun/base/SGObject.h>
 
+#include <atomic>
+
 namespace shogun
 {
 	/**
@@ -83,6 +85,20 @@ namespace shogun
 		 */
 		static void reset_handler();
 
+		/** Prematurely finish the running computations, like answering 'C'
+		 * to the signal handler: notifies the subscribed algorithms and
+		 * cancels the parallel loops that check PRange::cancelled().
+		 */
+		static void cancel_computations();
+
+		/** @return number of cancellation requests so far. This is a relaxed
+		 * atomic load, so that parallel loops can poll it in every iteration.
+		 */
+		static int64_t get_num_cancellations()
+		{
+			return m_num_cancellations.load(std::memory_order_relaxed);
+		}
+
 		/** @return object name */
 		virtual const char* get_name() const { return "Signal"; }
 
@@ -90,6 +106,9 @@ namespace shogun
 		/** Active signal */
 		static bool m_active;
 
+		/** Number of cancellation requests */
+		static std::atomic<int64_t> m_num_cancellations;
+
 	public:
 		/** Observable */
 		static SGSubjectS* m_subject;
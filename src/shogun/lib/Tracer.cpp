@@ -0,0 +1,244 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ */
+
+#include <shogun/io/SGIO.h>
+#include <shogun/lib/Tracer.h>
+
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <vector>
+
+using namespace shogun;
+
+namespace
+{
+/** timed scope of a thread */
+struct TraceEvent
+{
+	const char* name;
+	int64_t begin;
+	int64_t end;
+};
+
+/** recordings of one thread */
+struct ThreadTrace
+{
+	ThreadTrace(int32_t thread_id) : id(thread_id), num_dropped(0)
+	{
+		for (auto& counter : counters)
+			counter.store(0, std::memory_order_relaxed);
+	}
+
+	/** sequential number of the thread */
+	int32_t id;
+	/** counters, only written by the owning thread */
+	std::array<std::atomic<int64_t>, TC_NUM_COUNTERS> counters;
+	/** guards events against concurrent readers, never contended while
+	 * recording
+	 */
+	std::mutex lock;
+	std::vector<TraceEvent> events;
+	int64_t num_dropped;
+};
+
+/** traces of all threads that recorded something, kept after the threads
+ * exited
+ */
+struct TraceRegistry
+{
+	std::mutex lock;
+	std::vector<std::shared_ptr<ThreadTrace>> threads;
+};
+
+TraceRegistry& registry()
+{
+	static TraceRegistry instance;
+	return instance;
+}
+
+const std::chrono::steady_clock::time_point start_time =
+    std::chrono::steady_clock::now();
+
+thread_local std::shared_ptr<ThreadTrace> local_trace;
+
+ThreadTrace& get_local_trace()
+{
+	if (!local_trace)
+	{
+		auto& reg = registry();
+		std::lock_guard<std::mutex> guard(reg.lock);
+		local_trace = std::make_shared<ThreadTrace>(reg.threads.size());
+		reg.threads.push_back(local_trace);
+	}
+	return *local_trace;
+}
+
+void write_json_string(std::ostream& out, const char* str)
+{
+	out << '"';
+	for (; *str; ++str)
+	{
+		if (*str == '"' || *str == '\\')
+			out << '\\';
+		out << *str;
+	}
+	out << '"';
+}
+}
+
+namespace shogun
+{
+
+std::atomic<bool> Tracer::m_enabled(false);
+
+std::atomic<int64_t>* Tracer::local_counters()
+{
+	return get_local_trace().counters.data();
+}
+
+void Tracer::record(const char* name, int64_t begin, int64_t end)
+{
+	auto& trace = get_local_trace();
+	std::lock_guard<std::mutex> guard(trace.lock);
+	if (int64_t(trace.events.size()) < MAX_EVENTS_PER_THREAD)
+		trace.events.push_back({name, begin, end});
+	else
+		trace.num_dropped++;
+}
+
+int64_t Tracer::now()
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(
+	           std::chrono::steady_clock::now() - start_time)
+	    .count();
+}
+
+TraceCounters Tracer::get_counters()
+{
+	TraceCounters result;
+	result.fill(0);
+
+	auto& reg = registry();
+	std::lock_guard<std::mutex> guard(reg.lock);
+	for (const auto& thread : reg.threads)
+	{
+		for (auto i = 0; i < TC_NUM_COUNTERS; i++)
+			result[i] += thread->counters[i].load(std::memory_order_relaxed);
+	}
+	return result;
+}
+
+int64_t Tracer::get_num_events()
+{
+	int64_t result = 0;
+
+	auto& reg = registry();
+	std::lock_guard<std::mutex> guard(reg.lock);
+	for (const auto& thread : reg.threads)
+	{
+		std::lock_guard<std::mutex> thread_guard(thread->lock);
+		result += thread->events.size();
+	}
+	return result;
+}
+
+const char* Tracer::get_counter_name(ETraceCounter counter)
+{
+	switch (counter)
+	{
+	case TC_KERNEL_EVALUATIONS:
+		return "kernel_evaluations";
+	case TC_CACHE_HITS:
+		return "cache_hits";
+	case TC_CACHE_MISSES:
+		return "cache_misses";
+	case TC_SOLVER_ITERATIONS:
+		return "solver_iterations";
+	case TC_BYTES_PARSED:
+		return "bytes_parsed";
+	case TC_ALLOCATIONS:
+		return "allocations";
+	default:
+		return "unknown";
+	}
+}
+
+void Tracer::reset()
+{
+	auto& reg = registry();
+	std::lock_guard<std::mutex> guard(reg.lock);
+	for (const auto& thread : reg.threads)
+	{
+		/* counters of running threads may be lost while resetting */
+		for (auto& counter : thread->counters)
+			counter.store(0, std::memory_order_relaxed);
+
+		std::lock_guard<std::mutex> thread_guard(thread->lock);
+		thread->events.clear();
+		thread->num_dropped = 0;
+	}
+}
+
+std::string Tracer::to_chrome_trace()
+{
+	std::ostringstream out;
+	out << std::fixed << std::setprecision(3);
+	int64_t num_dropped = 0;
+
+	out << "{\"traceEvents\":[";
+	bool first = true;
+	{
+		auto& reg = registry();
+		std::lock_guard<std::mutex> guard(reg.lock);
+		for (const auto& thread : reg.threads)
+		{
+			std::lock_guard<std::mutex> thread_guard(thread->lock);
+			num_dropped += thread->num_dropped;
+			for (const auto& event : thread->events)
+			{
+				if (!first)
+					out << ",";
+				first = false;
+
+				/* complete events, times in microseconds */
+				out << "{\"name\":";
+				write_json_string(out, event.name);
+				out << ",\"cat\":\"shogun\",\"ph\":\"X\",\"pid\":0"
+				    << ",\"tid\":" << thread->id << ",\"ts\":"
+				    << event.begin / 1000.0
+				    << ",\"dur\":" << (event.end - event.begin) / 1000.0
+				    << "}";
+			}
+		}
+	}
+
+	auto counters = get_counters();
+	auto timestamp = now() / 1000.0;
+	for (auto i = 0; i < TC_NUM_COUNTERS; i++)
+	{
+		if (!first)
+			out << ",";
+		first = false;
+
+		out << "{\"name\":\"" << get_counter_name(ETraceCounter(i))
+		    << "\",\"ph\":\"C\",\"pid\":0,\"ts\":" << timestamp
+		    << ",\"args\":{\"value\":" << counters[i] << "}}";
+	}
+	out << "],\"displayTimeUnit\":\"ms\",\"otherData\":{\"dropped_events\":"
+	    << num_dropped << "}}";
+
+	return out.str();
+}
+
+void Tracer::write_chrome_trace(const std::string& filename)
+{
+	std::ofstream out(filename);
+	REQUIRE(out.good(), "Could not open %s for writing\n", filename.c_str());
+	out << to_chrome_trace();
+}
+}
@@ -0,0 +1,189 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ */
+
+#ifndef __TRACER_H__
+#define __TRACER_H__
+
+#include <shogun/lib/config.h>
+
+#include <shogun/lib/common.h>
+
+#include <array>
+#include <atomic>
+#include <string>
+
+namespace shogun
+{
+
+/** counters of hot paths, recorded by SG_TRACE_COUNT */
+enum ETraceCounter
+{
+	/** evaluations of CKernel::kernel() */
+	TC_KERNEL_EVALUATIONS = 0,
+	/** lookups answered by a kernel or feature cache */
+	TC_CACHE_HITS,
+	/** lookups that missed a kernel or feature cache */
+	TC_CACHE_MISSES,
+	/** iterations of iterative solvers */
+	TC_SOLVER_ITERATIONS,
+	/** bytes read by line based file readers */
+	TC_BYTES_PARSED,
+	/** data allocations of SGVector and SGMatrix */
+	TC_ALLOCATIONS,
+	/** number of counters */
+	TC_NUM_COUNTERS
+};
+
+/** values of all counters, indexed by ETraceCounter */
+typedef std::array<int64_t, TC_NUM_COUNTERS> TraceCounters;
+
+/** @brief Tracer records scoped timers (SG_TRACE_SCOPE) and counters
+ * (SG_TRACE_COUNT) of hot paths, to see where the time of a long train()
+ * goes and to tune cache sizes and thread counts.
+ *
+ * Recording is off until enable() is called, the instrumentation then costs
+ * a check of a flag. Each thread records into its own buffer without
+ * synchronisation, buffers are only merged when the results are read, so
+ * the instrumentation scales with the number of threads. The results can be
+ * written as a Chrome trace (chrome://tracing, Perfetto), and
+ * CMachine::train() emits the counters of each training to the parameter
+ * observers, e.g. to TensorBoard. Configuring with -DUSE_TRACING=OFF removes
+ * the instrumentation at compile time.
+ */
+class Tracer
+{
+public:
+	/** maximum number of timed scopes recorded per thread, later ones are
+	 * dropped
+	 */
+	static constexpr int64_t MAX_EVENTS_PER_THREAD = 1 << 20;
+
+	/** starts or stops recording
+	 *
+	 * @param enabled whether to record
+	 */
+	static void enable(bool enabled = true)
+	{
+		m_enabled.store(enabled, std::memory_order_relaxed);
+	}
+
+	/** @return whether recording is enabled, always false if configured
+	 * without USE_TRACING
+	 */
+	static bool is_enabled()
+	{
+#ifdef USE_TRACING
+		return m_enabled.load(std::memory_order_relaxed);
+#else
+		return false;
+#endif
+	}
+
+	/** adds to a counter of the calling thread if recording is enabled
+	 *
+	 * @param counter counter to add to
+	 * @param n amount to add
+	 */
+	static void count(ETraceCounter counter, int64_t n = 1)
+	{
+		if (is_enabled())
+		{
+			/* only the owning thread writes, no atomic increment needed */
+			auto& value = local_counters()[counter];
+			value.store(
+			    value.load(std::memory_order_relaxed) + n,
+			    std::memory_order_relaxed);
+		}
+	}
+
+	/** records a timed scope of the calling thread
+	 *
+	 * @param name name of the scope, must outlive the tracer, e.g. a literal
+	 * @param begin start time in nanoseconds, see now()
+	 * @param end end time in nanoseconds
+	 */
+	static void record(const char* name, int64_t begin, int64_t end);
+
+	/** @return nanoseconds since the start of the program */
+	static int64_t now();
+
+	/** @return sums of the counters of all threads */
+	static TraceCounters get_counters();
+
+	/** @return number of timed scopes recorded by all threads */
+	static int64_t get_num_events();
+
+	/** @return name of a counter, e.g. "kernel_evaluations" */
+	static const char* get_counter_name(ETraceCounter counter);
+
+	/** discards all recorded counters and scopes */
+	static void reset();
+
+	/** @return recorded scopes and counters in the Chrome trace event
+	 * format
+	 */
+	static std::string to_chrome_trace();
+
+	/** writes to_chrome_trace() to a file
+	 *
+	 * @param filename name of the file to write
+	 */
+	static void write_chrome_trace(const std::string& filename);
+
+private:
+	/** @return counters of the calling thread */
+	static std::atomic<int64_t>* local_counters();
+
+	/** whether recording is enabled */
+	static std::atomic<bool> m_enabled;
+};
+
+/** @brief TraceScope records the time from its construction to its
+ * destruction as a named scope, if recording is enabled at construction.
+ */
+class TraceScope
+{
+public:
+	/** constructor
+	 *
+	 * @param name name of the scope, must outlive the tracer, e.g. a literal
+	 */
+	TraceScope(const char* name)
+	    : m_name(name), m_begin(Tracer::is_enabled() ? Tracer::now() : -1)
+	{
+	}
+
+	/** destructor, records the scope */
+	~TraceScope()
+	{
+		if (m_begin >= 0)
+			Tracer::record(m_name, m_begin, Tracer::now());
+	}
+
+	TraceScope(const TraceScope&) = delete;
+	TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+	/** name of the scope */
+	const char* m_name;
+	/** start time, negative if not recording */
+	int64_t m_begin;
+};
+}
+
+#define SG_TRACE_CONCAT_(a, b) a##b
+#define SG_TRACE_CONCAT(a, b) SG_TRACE_CONCAT_(a, b)
+
+#ifdef USE_TRACING
+/** times the enclosing scope under the given name */
+#define SG_TRACE_SCOPE(name)                                                   \
+	shogun::TraceScope SG_TRACE_CONCAT(sg_trace_scope_, __LINE__)(name)
+/** adds n to the given ETraceCounter */
+#define SG_TRACE_COUNT(counter, n) shogun::Tracer::count(counter, n)
+#else
+#define SG_TRACE_SCOPE(name)
+#define SG_TRACE_COUNT(counter, n)
+#endif // USE_TRACING
+
+#endif // __TRACER_H__
@@ -39,8 +39,10 @@
 #include <shogun/base/progress.h>
 #include <shogun/io/SGIO.h>
 #include <shogun/kernel/Kernel.h>
+#include <shogun/kernel/KernelRowCache.h>
 #include <shogun/lib/Signal.h>
 #include <shogun/lib/Time.h>
+#include <shogun/lib/Tracer.h>
 #include <shogun/lib/common.h>
 #include <shogun/lib/external/shogun_libsvm.h>
 #include <shogun/mathematics/Math.h>
@@ -234,17 +236,22 @@ public:
 
 	void compute_Q_parallel(Qfloat* data, float64_t* lab, int32_t i, int32_t start, int32_t len) const
 	{
+		// rows shared with other trainings on the same features
+		KernelRowCache::Row row;
+		if (row_cache)
+			row = row_cache->get_row(kernel, x[i]->index);
+
 		if (lab) // two class
 		{
 			#pragma omp parallel for
 			for(int32_t j=start;j<len;j++)
-				data[j] = (Qfloat) lab[i]*lab[j]*this->kernel_function(i,j);
+				data[j] = (Qfloat) lab[i]*lab[j]*this->kernel_function(i,j,row);
 		}
 		else // one class, eps svr
 		{
 			#pragma omp parallel for
 			for(int32_t j=start;j<len;j++)
-				data[j] = (Qfloat) this->kernel_function(i,j);
+				data[j] = (Qfloat) this->kernel_function(i,j,row);
 		}
 	}
 
@@ -253,8 +260,25 @@ public:
 		return kernel->kernel(x[i]->index,x[j]->index);
 	}
 
+	inline float64_t kernel_function(int32_t i, int32_t j, const KernelRowCache::Row& row) const
+	{
+		if (row)
+			return row.kernel(x[j]->index);
+
+		return kernel_function(i,j);
+	}
+
+	inline float64_t kernel_diagonal(int32_t i) const
+	{
+		if (row_cache)
+			return row_cache->diagonal(kernel, x[i]->index);
+
+		return kernel_function(i,i);
+	}
+
 private:
 	CKernel* kernel;
+	KernelRowCache* row_cache;
 	const svm_node **x;
 	float64_t *x_square;
 };
@@ -264,6 +288,7 @@ LibSVMKernel::LibSVMKernel(int32_t l, svm_node * const * x_, const svm_parameter
 	clone(x,x_,l);
 	x_square = 0;
 	kernel=param.kernel;
+	row_cache=kernel->get_row_cache();
 	max_train_time=param.max_train_time;
 }
 
@@ -546,6 +571,7 @@ void Solver::Solve(
 			gap, -CMath::log10(gap), -CMath::log10(1), -CMath::log10(eps));
 
 		++iter;
+		SG_TRACE_COUNT(TC_SOLVER_ITERATIONS, 1);
 
 		// update alpha[i] and alpha[j], handle bounds carefully
 
@@ -1293,7 +1319,7 @@ public:
 		QD = SG_MALLOC(Qfloat, prob.l);
 		for(int32_t i=0;i<prob.l;i++)
 		{
-			QD[i]= factor*(nr_class-1)*kernel_function(i,i);
+			QD[i]= factor*(nr_class-1)*kernel_diagonal(i);
 		}
 	}
 
@@ -1672,7 +1698,7 @@ public:
 		cache = new Cache(prob.l,(int64_t)(param.cache_size*(1l<<20)));
 		QD = SG_MALLOC(Qfloat, prob.l);
 		for(int32_t i=0;i<prob.l;i++)
-			QD[i]= (Qfloat)kernel_function(i,i);
+			QD[i]= (Qfloat)kernel_diagonal(i);
 	}
 
 	Qfloat *get_Q(int32_t i, int32_t len) const
@@ -1720,7 +1746,7 @@ public:
 		cache = new Cache(prob.l,(int64_t)(param.cache_size*(1l<<20)));
 		QD = SG_MALLOC(Qfloat, prob.l);
 		for(int32_t i=0;i<prob.l;i++)
-			QD[i]= (Qfloat)kernel_function(i,i);
+			QD[i]= (Qfloat)kernel_diagonal(i);
 	}
 
 	Qfloat *get_Q(int32_t i, int32_t len) const
@@ -1772,7 +1798,7 @@ public:
 			sign[k+l] = -1;
 			index[k] = k;
 			index[k+l] = k;
-			QD[k]= (Qfloat)kernel_function(k,k);
+			QD[k]= (Qfloat)kernel_diagonal(k);
 			QD[k+l]=QD[k];
 		}
 		buffer[0] = SG_MALLOC(Qfloat, 2*l);
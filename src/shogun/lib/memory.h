@@ -30,6 +30,15 @@ SG_FORCED_INLINE void* sg_memcpy(InputIt dest, OutputIt src, size_t count)
 	return std::memcpy(static_cast<void*>(dest), static_cast<const void*>(src), count);
 }
 
+/* alignment of the data of newly allocated SGVector and SGMatrix instances,
+ * a cache line and the width of an AVX-512 register */
+#define SG_DATA_ALIGNMENT 64
+
+SG_FORCED_INLINE bool sg_is_aligned(const void* ptr, size_t al = SG_DATA_ALIGNMENT)
+{
+	return (reinterpret_cast<uintptr_t>(ptr) & (al - 1)) == 0;
+}
+
 }  // namespace shogun
 
 /* wrappers for malloc, free, realloc, calloc */
@@ -9,10 +9,13 @@
 #include <shogun/ensemble/CombinationRule.h>
 #include <shogun/ensemble/MeanRule.h>
 #include <shogun/machine/BaggingMachine.h>
+#include <shogun/mathematics/RandomStream.h>
 #include <shogun/mathematics/linalg/LinalgNamespace.h>
 
 #include <shogun/evaluation/Evaluation.h>
 
+#include <vector>
+
 using namespace shogun;
 
 CBaggingMachine::CBaggingMachine()
@@ -175,8 +178,15 @@ bool CBaggingMachine::train_machine(CFeatures* data)
 	m_oob_indices = new CDynamicObjectArray();
 
 	SGMatrix<index_t> rnd_indicies(m_bag_size, m_num_bags);
-	for (index_t i = 0; i < m_num_bags*m_bag_size; ++i)
-		rnd_indicies.matrix[i] = CMath::random(0, m_bag_size-1);
+	if (!m_rand_seed_set)
+	{
+		for (index_t i = 0; i < m_num_bags*m_bag_size; ++i)
+			rnd_indicies.matrix[i] = CMath::random(0, m_bag_size-1);
+	}
+
+	// bags are stored in the order of their index, not of completion
+	std::vector<CMachine*> bags(m_num_bags);
+	std::vector<CDynamicArray<index_t>*> oob_indices(m_num_bags);
 
 	auto pb = SG_PROGRESS(range(m_num_bags));
 #pragma omp parallel for
@@ -185,6 +195,13 @@ bool CBaggingMachine::train_machine(CFeatures* data)
 		CMachine* c=dynamic_cast<CMachine*>(m_machine->clone());
 		ASSERT(c != NULL);
 		SGVector<index_t> idx(rnd_indicies.get_column_vector(i), m_bag_size, false);
+		if (m_rand_seed_set)
+		{
+			RandomStream stream(m_rand_seed, i);
+			for (index_t j = 0; j < m_bag_size; ++j)
+				idx[j] = stream.random(0, m_bag_size-1);
+			set_machine_rand_seed(c, stream.random_64());
+		}
 
 		CFeatures* features;
 		CLabels* labels;
@@ -227,12 +244,9 @@ bool CBaggingMachine::train_machine(CFeatures* data)
 		#pragma omp critical
 		{
 		// get out of bag indexes
-		CDynamicArray<index_t>* oob = get_oob_indices(idx);
-		m_oob_indices->push_back(oob);
-
-		// add trained machine to bag array
-		m_bags->push_back(c);
+		oob_indices[i] = get_oob_indices(idx);
 		}
+		bags[i] = c;
 
 		if (get_global_parallel()->get_num_threads()!=1)
 		{
@@ -240,11 +254,17 @@ bool CBaggingMachine::train_machine(CFeatures* data)
 			SG_UNREF(labels);
 		}
 
-		SG_UNREF(c);
 		pb.print_progress();
 	}
 	pb.complete();
 
+	for (int32_t i = 0; i < m_num_bags; ++i)
+	{
+		m_oob_indices->push_back(oob_indices[i]);
+		m_bags->push_back(bags[i]);
+		SG_UNREF(bags[i]);
+	}
+
 	return true;
 }
 
@@ -252,6 +272,10 @@ void CBaggingMachine::set_machine_parameters(CMachine* m, SGVector<index_t> idx)
 {
 }
 
+void CBaggingMachine::set_machine_rand_seed(CMachine* m, uint64_t seed)
+{
+}
+
 void CBaggingMachine::register_parameters()
 {
 	SG_ADD(
@@ -265,6 +289,10 @@ void CBaggingMachine::register_parameters()
 	SG_ADD(&m_all_oob_idx, "all_oob_idx", "Indices of all oob vectors");
 	SG_ADD(
 	    &m_oob_indices, "oob_indices", "OOB indices for each machine");
+	SG_ADD(&m_rand_seed, "rand_seed", "Seed of the random streams of the bags");
+	SG_ADD(
+	    &m_rand_seed_set, "rand_seed_set",
+	    "Whether the bags use random streams");
 }
 
 void CBaggingMachine::set_num_bags(int32_t num_bags)
@@ -287,6 +315,17 @@ int32_t CBaggingMachine::get_bag_size() const
 	return m_bag_size;
 }
 
+void CBaggingMachine::set_rand_seed(uint64_t seed)
+{
+	m_rand_seed = seed;
+	m_rand_seed_set = true;
+}
+
+uint64_t CBaggingMachine::get_rand_seed() const
+{
+	return m_rand_seed;
+}
+
 CMachine* CBaggingMachine::get_machine() const
 {
 	SG_REF(m_machine);
@@ -312,6 +351,8 @@ void CBaggingMachine::init()
 	m_bag_size = 0;
 	m_all_oob_idx = SGVector<bool>();
 	m_oob_indices = NULL;
+	m_rand_seed = 0;
+	m_rand_seed_set = false;
 }
 
 void CBaggingMachine::set_combination_rule(CCombinationRule* rule)
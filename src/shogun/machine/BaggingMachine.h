@@ -115,6 +115,28 @@ namespace shogun
 			 */
 			float64_t get_oob_error(CEvaluation* eval) const;
 
+			/** set seed of the random streams of the bags. Bag i draws its
+			 * bootstrap sample, and the seed of its machine, from the
+			 * RandomStream of this seed and stream index i, so the trained
+			 * bags do not depend on the number of threads. Without a seed,
+			 * the global generator is used.
+			 *
+			 * @param seed seed of the random streams
+			 */
+			void set_rand_seed(uint64_t seed);
+
+			/** get seed of the random streams of the bags
+			 *
+			 * @return seed
+			 */
+			uint64_t get_rand_seed() const;
+
+			/** @return whether the seed of the random streams is set */
+			bool has_rand_seed() const
+			{
+				return m_rand_seed_set;
+			}
+
 			/** name **/
 			virtual const char* get_name() const { return "BaggingMachine"; }
 
@@ -129,6 +151,15 @@ namespace shogun
 			 */
 			virtual void set_machine_parameters(CMachine* m, SGVector<index_t> idx);
 
+			/**
+			 * sets the seed of the random stream of a bag's machine, if the
+			 * machine has one - does nothing by default
+			 *
+			 * @param m machine
+			 * @param seed seed drawn from the random stream of the bag
+			 */
+			virtual void set_machine_rand_seed(CMachine* m, uint64_t seed);
+
 			/** helper function for the apply_{regression,..} functions that
 			 * computes the output
 			 *
@@ -186,6 +217,12 @@ namespace shogun
 
 			/** array of oob indices */
 			CDynamicObjectArray* m_oob_indices;
+
+			/** seed of the random streams of the bags */
+			uint64_t m_rand_seed;
+
+			/** whether the bags use random streams */
+			bool m_rand_seed_set;
 	};
 }
 
@@ -9,10 +9,48 @@
 #include <shogun/machine/KernelMulticlassMachine.h>
 #include <shogun/features/Features.h>
 #include <shogun/kernel/Kernel.h>
+#include <shogun/kernel/KernelRowCache.h>
 #include <shogun/machine/KernelMachine.h>
+#include <shogun/base/progress.h>
+
+#include <algorithm>
+#include <vector>
 
 using namespace shogun;
 
+namespace
+{
+/** gives the features a kernel has on construction back to it, and the
+ * kernel back to its machine, on destruction
+ */
+class KernelFeaturesGuard
+{
+public:
+	KernelFeaturesGuard(CKernel* kernel, CKernelMachine* machine)
+		: m_kernel(kernel), m_machine(machine),
+		  m_lhs(kernel->get_lhs()), m_rhs(kernel->get_rhs())
+	{
+	}
+
+	~KernelFeaturesGuard()
+	{
+		m_kernel->init(m_lhs, m_rhs);
+		m_machine->set_kernel(m_kernel);
+		SG_UNREF(m_lhs);
+		SG_UNREF(m_rhs);
+	}
+
+	KernelFeaturesGuard(const KernelFeaturesGuard&) = delete;
+	KernelFeaturesGuard& operator=(const KernelFeaturesGuard&) = delete;
+
+private:
+	CKernel* m_kernel;
+	CKernelMachine* m_machine;
+	CFeatures* m_lhs;
+	CFeatures* m_rhs;
+};
+}
+
 void CKernelMulticlassMachine::store_model_features()
 {
 	CKernel *kernel= m_kernel;
@@ -79,9 +117,132 @@ void CKernelMulticlassMachine::store_model_features()
 	SG_UNREF(rhs);
 }
 
-CKernelMulticlassMachine::CKernelMulticlassMachine() : CMulticlassMachine(), m_kernel(NULL)
+SGMatrix<float64_t> CKernelMulticlassMachine::get_all_submachine_outputs()
+{
+	int32_t num_machines=m_machines->get_num_elements();
+	if (!m_kernel || !m_kernel->get_num_vec_rhs())
+		return CMulticlassMachine::get_all_submachine_outputs();
+
+	/* machines that evaluate their own way are applied one by one */
+	std::vector<CKernelMachine*> machines;
+	bool shared=true;
+	for (int32_t i=0; i<num_machines; ++i)
+	{
+		auto machine=dynamic_cast<CKernelMachine*>(get_machine(i));
+		if (!machine)
+		{
+			shared=false;
+			break;
+		}
+		machines.push_back(machine);
+
+		CKernel* kernel=machine->get_kernel();
+		shared&=kernel==m_kernel;
+		SG_UNREF(kernel);
+		shared&=!(m_kernel->has_property(KP_BATCHEVALUATION) &&
+				machine->get_batch_computation_enabled());
+		shared&=!(m_kernel->has_property(KP_LINADD) &&
+				m_kernel->get_is_initialized());
+	}
+
+	if (!shared)
+	{
+		for (auto machine : machines)
+			SG_UNREF(machine);
+		return CMulticlassMachine::get_all_submachine_outputs();
+	}
+
+	/* union of the support vectors */
+	std::vector<index_t> svs;
+	for (auto machine : machines)
+	{
+		for (int32_t j=0; j<machine->get_num_support_vectors(); ++j)
+			svs.push_back(machine->get_support_vector(j));
+	}
+	std::sort(svs.begin(), svs.end());
+	svs.erase(std::unique(svs.begin(), svs.end()), svs.end());
+	int32_t num_svs=svs.size();
+
+	/* alphas of each support vector in the union, as a sparse matrix with
+	 * a column per support vector and a row per machine */
+	SGVector<index_t> sv_begin(num_svs+1);
+	sv_begin.zero();
+	SGVector<float64_t> biases(num_machines);
+	for (int32_t i=0; i<num_machines; ++i)
+	{
+		biases[i]=machines[i]->get_bias();
+		for (int32_t j=0; j<machines[i]->get_num_support_vectors(); ++j)
+		{
+			auto sv=std::lower_bound(svs.begin(), svs.end(),
+					machines[i]->get_support_vector(j))-svs.begin();
+			sv_begin[sv+1]++;
+		}
+	}
+	for (int32_t k=0; k<num_svs; ++k)
+		sv_begin[k+1]+=sv_begin[k];
+
+	SGVector<index_t> coef_machine(sv_begin[num_svs]);
+	SGVector<float64_t> coef_alpha(sv_begin[num_svs]);
+	SGVector<index_t> sv_end=sv_begin.clone();
+	for (int32_t i=0; i<num_machines; ++i)
+	{
+		for (int32_t j=0; j<machines[i]->get_num_support_vectors(); ++j)
+		{
+			auto sv=std::lower_bound(svs.begin(), svs.end(),
+					machines[i]->get_support_vector(j))-svs.begin();
+			coef_machine[sv_end[sv]]=i;
+			coef_alpha[sv_end[sv]]=machines[i]->get_alpha(j);
+			sv_end[sv]++;
+		}
+		SG_UNREF(machines[i]);
+	}
+
+	/* see CKernelMachine::apply_get_outputs for the number of vectors */
+	CFeatures* rhs=m_kernel->get_rhs();
+	int32_t num_vectors=rhs ? rhs->get_num_vectors() : m_kernel->get_num_vec_rhs();
+	SG_UNREF(rhs);
+
+	SGMatrix<float64_t> outputs(num_vectors, num_machines);
+	auto pb=SG_PROGRESS(range(num_vectors));
+#pragma omp parallel
+	{
+		SGVector<float64_t> kernel_row(num_svs);
+		auto batch=pb.batch();
+
+#pragma omp for
+		for (int32_t vec=0; vec<num_vectors; ++vec)
+		{
+			if (pb.cancelled())
+				continue;
+
+			for (int32_t k=0; k<num_svs; ++k)
+				kernel_row[k]=m_kernel->kernel(svs[k], vec);
+
+			for (int32_t i=0; i<num_machines; ++i)
+				outputs(vec, i)=biases[i];
+
+			for (int32_t k=0; k<num_svs; ++k)
+			{
+				for (index_t c=sv_begin[k]; c<sv_begin[k+1]; ++c)
+					outputs(vec, coef_machine[c])+=coef_alpha[c]*kernel_row[k];
+			}
+			batch.step();
+		}
+	}
+	pb.complete();
+
+	if (pb.cancelled())
+		SG_ERROR("Computation of the sub-machine outputs was cancelled\n")
+
+	return outputs;
+}
+
+CKernelMulticlassMachine::CKernelMulticlassMachine() : CMulticlassMachine(), m_kernel(NULL),
+	m_shared_kernel_cache(true)
 {
 	SG_ADD(&m_kernel,"kernel", "The kernel to be used", ParameterProperties::HYPER);
+	SG_ADD(&m_shared_kernel_cache, "shared_kernel_cache",
+		"Whether sub-machines share a cache of kernel rows");
 }
 
 /** standard constructor
@@ -91,10 +252,13 @@ CKernelMulticlassMachine::CKernelMulticlassMachine() : CMulticlassMachine(), m_k
  * @param labs labels
  */
 CKernelMulticlassMachine::CKernelMulticlassMachine(CMulticlassStrategy *strategy, CKernel* kernel, CMachine* machine, CLabels* labs) :
-	CMulticlassMachine(strategy,machine,labs), m_kernel(NULL)
+	CMulticlassMachine(strategy,machine,labs), m_kernel(NULL),
+	m_shared_kernel_cache(true)
 {
 	set_kernel(kernel);
 	SG_ADD(&m_kernel,"kernel", "The kernel to be used", ParameterProperties::HYPER);
+	SG_ADD(&m_shared_kernel_cache, "shared_kernel_cache",
+		"Whether sub-machines share a cache of kernel rows");
 }
 
 /** destructor */
@@ -121,6 +285,18 @@ CKernel* CKernelMulticlassMachine::get_kernel() const
 	return m_kernel;
 }
 
+bool CKernelMulticlassMachine::train_machine(CFeatures* data)
+{
+	/* sub-machines trained concurrently get the cache installed on their
+	 * copies of the kernel, see set_submachine_data() */
+	if (!m_shared_kernel_cache || !m_kernel ||
+		m_kernel->get_kernel_type()==K_CUSTOM)
+		return CMulticlassMachine::train_machine(data);
+
+	KernelRowCache row_cache(m_kernel, m_kernel->get_cache_size());
+	return CMulticlassMachine::train_machine(data);
+}
+
 bool CKernelMulticlassMachine::init_machine_for_train(CFeatures* data)
 {
 	if (data)
@@ -162,7 +338,44 @@ bool CKernelMulticlassMachine::is_ready()
 
 CMachine* CKernelMulticlassMachine::get_machine_from_trained(CMachine* machine) const
 {
-	return new CKernelMachine(machine->as<CKernelMachine>());
+	auto trained=new CKernelMachine(machine->as<CKernelMachine>());
+
+	/* sub-machines trained one after another on a subset, see
+	 * add_machine_subset(), index their support vectors in the subset */
+	if (m_machine_subset.vlen)
+	{
+		for (int32_t j=0; j<trained->get_num_support_vectors(); ++j)
+		{
+			trained->set_support_vector(j,
+				m_machine_subset[trained->get_support_vector(j)]);
+		}
+	}
+
+	/* sub-machines trained on a subset view of the features, see
+	 * set_submachine_data(), index their support vectors in the view */
+	CKernel* kernel=trained->get_kernel();
+	if (kernel && kernel!=m_kernel)
+	{
+		CFeatures* lhs=kernel->get_lhs();
+		CFeatures* shared_lhs=m_kernel->get_lhs();
+		if (lhs && lhs!=shared_lhs)
+		{
+			CSubsetStack* subsets=lhs->get_subset_stack();
+			for (int32_t j=0; j<trained->get_num_support_vectors(); ++j)
+			{
+				trained->set_support_vector(j,
+					subsets->subset_idx_conversion(
+						trained->get_support_vector(j)));
+			}
+			SG_UNREF(subsets);
+		}
+		SG_UNREF(lhs);
+		SG_UNREF(shared_lhs);
+		trained->set_kernel(m_kernel);
+	}
+	SG_UNREF(kernel);
+
+	return trained;
 }
 
 int32_t CKernelMulticlassMachine::get_num_rhs_vectors() const
@@ -172,12 +385,84 @@ int32_t CKernelMulticlassMachine::get_num_rhs_vectors() const
 
 void CKernelMulticlassMachine::add_machine_subset(SGVector<index_t> subset)
 {
-	SG_NOTIMPLEMENTED
+	CFeatures* lhs=m_kernel->get_lhs();
+	CFeatures* rhs=m_kernel->get_rhs();
+	SG_UNREF(lhs);
+	SG_UNREF(rhs);
+	REQUIRE(lhs && lhs==rhs, "Training on a subset of the vectors needs the "
+		"kernel to be initialised with the same features on both sides\n");
+
+	/* the features stay the same object, so that a cache of kernel rows
+	 * keeps its rows, see KernelRowCache */
+	lhs->add_subset(subset);
+	m_kernel->init(lhs, rhs);
+	m_machine_subset=subset;
 }
 
 void CKernelMulticlassMachine::remove_machine_subset()
 {
-	SG_NOTIMPLEMENTED
+	CFeatures* lhs=m_kernel->get_lhs();
+	CFeatures* rhs=m_kernel->get_rhs();
+	lhs->remove_subset();
+	m_kernel->init(lhs, rhs);
+	m_machine_subset=SGVector<index_t>();
+	SG_UNREF(lhs);
+	SG_UNREF(rhs);
 }
 
+CMachine* CKernelMulticlassMachine::create_submachine_prototype()
+{
+	if (!m_kernel || !m_kernel->has_features() ||
+	    m_kernel->get_kernel_type() == K_CUSTOM)
+		return NULL;
+
+	/* the features are not copied into the prototype, they are given back
+	 * to the kernel even if cloning fails */
+	auto machine=m_machine->as<CKernelMachine>();
+	KernelFeaturesGuard guard(m_kernel, machine);
+	m_kernel->remove_lhs_and_rhs();
+	machine->set_kernel(NULL);
+
+	auto prototype=machine->clone()->as<CKernelMachine>();
+	auto kernel=m_kernel->clone()->as<CKernel>();
+	prototype->set_kernel(kernel);
+	SG_UNREF(kernel);
+
+	return prototype;
+}
 
+void CKernelMulticlassMachine::set_submachine_data(
+    CMachine* machine, SGVector<index_t> subset)
+{
+	CFeatures* lhs=m_kernel->get_lhs();
+	CFeatures* rhs=m_kernel->get_rhs();
+	CKernel* kernel=machine->as<CKernelMachine>()->get_kernel();
+
+	if (subset.vlen)
+	{
+		REQUIRE(lhs==rhs, "Training on a subset of the vectors needs the "
+			"kernel to be initialised with the same features on both "
+			"sides\n");
+		CSubsetStack* subsets=lhs->get_subset_stack();
+		bool has_subsets=subsets->has_subsets();
+		SG_UNREF(subsets);
+		REQUIRE(!has_subsets, "Training on a subset of the vectors is not "
+			"possible with features that already have a subset\n");
+
+		/* shares the features, see get_machine_from_trained() for the
+		 * support vector indices */
+		CFeatures* view=lhs->shallow_subset_copy();
+		view->add_subset(subset);
+		kernel->init(view, view);
+		SG_UNREF(view);
+	}
+	else
+		kernel->init(lhs, rhs);
+
+	/* the rows are shared with the other sub-machines */
+	kernel->set_row_cache(m_kernel->get_row_cache());
+
+	SG_UNREF(kernel);
+	SG_UNREF(lhs);
+	SG_UNREF(rhs);
+}
@@ -55,6 +55,36 @@ class CKernelMulticlassMachine : public CMulticlassMachine
 		 */
 		CKernel* get_kernel() const;
 
+		/** set whether sub-machines share a cache of kernel rows, see
+		 * KernelRowCache. Its size is the cache size of the kernel. Sub-machines
+		 * trained concurrently, see set_max_concurrent_submachines(), share it
+		 * through their copies of the kernel. Custom kernels do not use it.
+		 *
+		 * @param shared whether to share kernel rows, on by default
+		 */
+		void set_shared_kernel_cache(bool shared)
+		{
+			m_shared_kernel_cache = shared;
+		}
+
+		/** @return whether sub-machines share a cache of kernel rows */
+		bool get_shared_kernel_cache() const
+		{
+			return m_shared_kernel_cache;
+		}
+
+		/** get outputs of all submachines. If all submachines are kernel
+		 * machines on this machine's kernel, the kernel values of each test
+		 * vector are computed once for the union of their support vectors,
+		 * which one-vs-one submachines largely share, and all outputs are
+		 * then accumulated from the alphas of the support vectors. Raises an
+		 * error if the computation is cancelled.
+		 *
+		 * @return num_vectors x num_machines matrix, whose i-th column holds
+		 * the outputs of the i-th submachine
+		 */
+		virtual SGMatrix<float64_t> get_all_submachine_outputs();
+
 		/** Stores feature data of underlying model.
 		 *
 		 * Need to store the SVs for all sub-machines. We make a union of the
@@ -65,6 +95,11 @@ class CKernelMulticlassMachine : public CMulticlassMachine
 
 	protected:
 
+		/** train machine, sharing a cache of kernel rows between the
+		 * sub-machines if enabled
+		 */
+		virtual bool train_machine(CFeatures* data = NULL);
+
 		/** init machine for training with kernel init */
 		virtual bool init_machine_for_train(CFeatures* data);
 
@@ -74,26 +109,50 @@ class CKernelMulticlassMachine : public CMulticlassMachine
 		/** check kernel availability */
 		virtual bool is_ready();
 
-		/** construct kernel machine from given kernel machine */
+		/** construct kernel machine from given kernel machine, support
+		 * vectors of a machine trained on a subset or a subset view are
+		 * mapped to the indices of the training features
+		 */
 		virtual CMachine* get_machine_from_trained(CMachine* machine) const;
 
 		/** return number of rhs feature vectors */
 		virtual int32_t get_num_rhs_vectors() const;
 
-		/** set subset to the features of the machine, deletes old one
+		/** adds a subset to the features of the kernel, which needs to be
+		 * initialised with the same features on both sides
 		 *
 		 * @param subset subset indices to set
 		 */
 		virtual void add_machine_subset(SGVector<index_t> subset);
 
-		/** deletes any subset set to the features of the machine */
+		/** removes the subset added by add_machine_subset() */
 		virtual void remove_machine_subset();
 
+		/** the prototype holds a copy of the kernel without features, custom
+		 * kernels are trained one after another as they hold their matrix
+		 */
+		virtual CMachine* create_submachine_prototype();
+
+		/** initialises the kernel of the sub-machine with the training
+		 * features. For a subset, e.g. a one-vs-one problem, the kernel gets
+		 * a view of the features that shares their data, which needs
+		 * features that support CFeatures::shallow_subset_copy() and have no
+		 * subset of their own.
+		 */
+		virtual void set_submachine_data(
+		    CMachine* machine, SGVector<index_t> subset);
+
 	protected:
 
 		/** kernel */
 		CKernel* m_kernel;
 
+		/** whether sub-machines share a cache of kernel rows */
+		bool m_shared_kernel_cache;
+
+		/** subset of the sub-machine trained, see add_machine_subset() */
+		SGVector<index_t> m_machine_subset;
+
 };
 }
 #endif
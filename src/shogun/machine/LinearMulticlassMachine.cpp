@@ -0,0 +1,92 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ */
+
+#include <shogun/features/DenseFeatures.h>
+#include <shogun/machine/LinearMulticlassMachine.h>
+#include <shogun/mathematics/eigen3.h>
+
+#include <algorithm>
+#include <typeinfo>
+
+using namespace shogun;
+using namespace Eigen;
+
+SGMatrix<float64_t> CLinearMulticlassMachine::get_all_submachine_outputs()
+{
+	int32_t num_machines = m_machines->get_num_elements();
+	if (!m_features || !num_machines)
+		return CMulticlassMachine::get_all_submachine_outputs();
+
+	/* normal vectors of all machines, machines that apply their own way are
+	 * applied one by one */
+	int32_t dim = m_features->get_dim_feature_space();
+	SGMatrix<float64_t> w(dim, num_machines);
+	SGVector<float64_t> biases(num_machines);
+	for (int32_t i = 0; i < num_machines; ++i)
+	{
+		CMachine* machine = get_machine(i);
+		bool linear = machine && typeid(*machine) == typeid(CLinearMachine);
+		SGVector<float64_t> w_i;
+		if (linear)
+		{
+			w_i = machine->as<CLinearMachine>()->get_w();
+			biases[i] = machine->as<CLinearMachine>()->get_bias();
+		}
+		SG_UNREF(machine);
+
+		if (!linear || w_i.vlen != dim)
+			return CMulticlassMachine::get_all_submachine_outputs();
+		w.set_column(i, w_i);
+	}
+
+	int32_t num_vectors = m_features->get_num_vectors();
+	SGMatrix<float64_t> outputs(num_vectors, num_machines);
+	const int32_t block_size = 256;
+
+	/* dense features without a subset are multiplied as a matrix */
+	SGMatrix<float64_t> feature_matrix;
+	CSubsetStack* subsets = m_features->get_subset_stack();
+	if (m_features->get_feature_class() == C_DENSE &&
+	    m_features->get_feature_type() == F_DREAL && !subsets->has_subsets())
+	{
+		feature_matrix =
+		    m_features->as<CDenseFeatures<float64_t>>()->get_feature_matrix();
+		if (feature_matrix.num_rows != dim ||
+		    feature_matrix.num_cols != num_vectors)
+			feature_matrix = SGMatrix<float64_t>();
+	}
+	SG_UNREF(subsets);
+
+	if (feature_matrix.matrix)
+	{
+		Map<MatrixXd> X(feature_matrix.matrix, dim, num_vectors);
+		Map<MatrixXd> W(w.matrix, dim, num_machines);
+		Map<MatrixXd> O(outputs.matrix, num_vectors, num_machines);
+		Map<VectorXd> b(biases.vector, num_machines);
+
+#pragma omp parallel for
+		for (int32_t begin = 0; begin < num_vectors; begin += block_size)
+		{
+			int32_t len = std::min(num_vectors - begin, block_size);
+			O.middleRows(begin, len).noalias() =
+			    X.middleCols(begin, len).transpose() * W;
+			O.middleRows(begin, len).rowwise() += b.transpose();
+		}
+	}
+	else
+	{
+#pragma omp parallel for
+		for (int32_t vec = 0; vec < num_vectors; ++vec)
+		{
+			for (int32_t i = 0; i < num_machines; ++i)
+			{
+				outputs(vec, i) =
+				    m_features->dense_dot(vec, w.get_column_vector(i), dim) +
+				    biases[i];
+			}
+		}
+	}
+
+	return outputs;
+}
@@ -160,6 +160,45 @@ class CLinearMulticlassMachine : public CMulticlassMachine
 			m_features->remove_subset();
 		}
 
+		/** the prototype shares dense features through subset views, other
+		 * features are trained one after another
+		 */
+		virtual CMachine* create_submachine_prototype()
+		{
+			if (!m_features || m_features->get_feature_class() != C_DENSE)
+				return NULL;
+
+			auto machine = m_machine->as<CLinearMachine>();
+			machine->set_features(NULL);
+			auto prototype = machine->clone()->as<CMachine>();
+			machine->set_features(m_features);
+
+			return prototype;
+		}
+
+		virtual void set_submachine_data(
+		    CMachine* machine, SGVector<index_t> subset)
+		{
+			/* shares the feature matrix */
+			auto features = m_features->shallow_subset_copy();
+			if (subset.vlen)
+				features->add_subset(subset);
+
+			machine->as<CLinearMachine>()->set_features(
+			    features->as<CDotFeatures>());
+			SG_UNREF(features);
+		}
+
+		/** get outputs of all submachines. If all submachines are linear
+		 * machines, the outputs are computed for blocks of vectors against
+		 * all normal vectors at once, as a matrix product for dense
+		 * features.
+		 *
+		 * @return num_vectors x num_machines matrix, whose i-th column holds
+		 * the outputs of the i-th submachine
+		 */
+		virtual SGMatrix<float64_t> get_all_submachine_outputs();
+
 		/** Stores feature data of underlying model. Does nothing because
 		 * Linear machines store the normal vector of the separating hyperplane
 		 * and therefore the model anyway
@@ -9,6 +9,7 @@
 #include <rxcpp/rx-lite.hpp>
 #include <shogun/base/init.h>
 #include <shogun/lib/Signal.h>
+#include <shogun/lib/parameter_observers/ObservedValueTemplated.h>
 #include <shogun/machine/Machine.h>
 
 using namespace shogun;
@@ -56,6 +57,12 @@ bool CMachine::train(CFeatures* data)
 		m_labels->ensure_valid(get_name());
 	}
 
+	SG_TRACE_SCOPE(get_name());
+	TraceCounters counters_before;
+	bool traced = Tracer::is_enabled();
+	if (traced)
+		counters_before = Tracer::get_counters();
+
 	auto sub = connect_to_signal_handler();
 	bool result = false;
 
@@ -86,6 +93,9 @@ bool CMachine::train(CFeatures* data)
 	if (m_store_model_features)
 		store_model_features();
 
+	if (traced)
+		observe_trace_counters(counters_before);
+
 	return result;
 }
 
@@ -96,13 +106,36 @@ bool CMachine::train_locked()
 	    is_data_locked(),
 	    "Data needs to be locked for training, call data_lock()\n")
 
+	SG_TRACE_SCOPE(get_name());
+	TraceCounters counters_before;
+	bool traced = Tracer::is_enabled();
+	if (traced)
+		counters_before = Tracer::get_counters();
+
 	auto sub = connect_to_signal_handler();
 	bool result = train_machine();
 	sub.unsubscribe();
 	reset_computation_variables();
+
+	if (traced)
+		observe_trace_counters(counters_before);
+
 	return result;
 }
 
+void CMachine::observe_trace_counters(const TraceCounters& before)
+{
+	auto counters = Tracer::get_counters();
+	for (auto i = 0; i < TC_NUM_COUNTERS; i++)
+	{
+		observe(ObservedValue::make_observation<int64_t>(
+		    0, std::string("trace_") +
+		           Tracer::get_counter_name(ETraceCounter(i)),
+		    "Change of a performance counter during training",
+		    counters[i] - before[i]));
+	}
+}
+
 void CMachine::set_labels(CLabels* lab)
 {
     if (lab != NULL)
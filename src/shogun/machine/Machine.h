@@ -19,6 +19,7 @@
 #include <shogun/labels/RegressionLabels.h>
 #include <shogun/labels/StructuredLabels.h>
 #include <shogun/lib/StoppableSGObject.h>
+#include <shogun/lib/Tracer.h>
 #include <shogun/lib/common.h>
 #include <shogun/lib/config.h>
 
@@ -411,6 +412,15 @@ class CMachine : public CStoppableSGObject
 			return true;
 		}
 
+		/** emits the change of each Tracer counter since a training started
+		 * to the parameter observers, as "trace_<counter name>". Counters
+		 * are shared by all threads, so trainings running concurrently are
+		 * included.
+		 *
+		 * @param before counters when the training started
+		 */
+		void observe_trace_counters(const TraceCounters& before);
+
 	protected:
 		/** maximum training time */
 		float64_t m_max_train_time;
@@ -0,0 +1,137 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ */
+
+#include <shogun/util/benchmark_utilities.h>
+
+#include <shogun/classifier/svm/LibLinear.h>
+#include <shogun/classifier/svm/LibSVM.h>
+#include <shogun/clustering/KMeans.h>
+#include <shogun/distance/EuclideanDistance.h>
+#include <shogun/kernel/GaussianKernel.h>
+#include <shogun/machine/gp/ExactInferenceMethod.h>
+#include <shogun/machine/gp/GaussianLikelihood.h>
+#include <shogun/machine/gp/ZeroMean.h>
+#include <shogun/multiclass/tree/CARTree.h>
+#include <shogun/regression/GaussianProcessRegression.h>
+
+#include <functional>
+
+namespace shogun
+{
+
+/** dimension of the features */
+static const index_t NUM_DIM = 16;
+
+/** creates an untrained machine with labels for the given training data */
+typedef std::function<CMachine*(CDenseFeatures<float64_t>*)> MachineFactory;
+
+/** @brief machine with the range of training set sizes to benchmark */
+struct MachineBenchmark
+{
+	std::string name;
+	MachineFactory create;
+	int64_t min_size;
+	int64_t max_size;
+};
+
+static std::vector<MachineBenchmark> machines()
+{
+	return {
+	    {"LibSVM",
+	     [](CDenseFeatures<float64_t>* feats) -> CMachine* {
+		     return new CLibSVM(
+		         1.0, new CGaussianKernel(10, 2.0),
+		         create_binary_labels(feats));
+	     },
+	     256, 2048},
+	    {"LibLinear",
+	     [](CDenseFeatures<float64_t>* feats) -> CMachine* {
+		     return new CLibLinear(1.0, feats, create_binary_labels(feats));
+	     },
+	     1024, 16384},
+	    {"CARTree",
+	     [](CDenseFeatures<float64_t>* feats) -> CMachine* {
+		     SGVector<bool> nominal(NUM_DIM);
+		     nominal.set_const(false);
+		     auto tree = new CCARTree(nominal, PT_MULTICLASS);
+		     tree->set_labels(create_multiclass_labels(feats, 4));
+		     return tree;
+	     },
+	     1024, 16384},
+	    {"KMeans",
+	     [](CDenseFeatures<float64_t>* feats) -> CMachine* {
+		     auto distance = new CEuclideanDistance(feats, feats);
+		     return new CKMeans(8, distance);
+	     },
+	     1024, 16384},
+	    {"GaussianProcessRegression",
+	     [](CDenseFeatures<float64_t>* feats) -> CMachine* {
+		     auto inference = new CExactInferenceMethod(
+		         new CGaussianKernel(10, 2.0), feats, new CZeroMean(),
+		         create_regression_labels(feats), new CGaussianLikelihood());
+		     return new CGaussianProcessRegression(inference);
+	     },
+	     128, 1024},
+	};
+}
+
+/** trains a machine on n vectors */
+static void BM_Machine_train(benchmark::State& state, MachineFactory create)
+{
+	auto feats = create_random_features(NUM_DIM, state.range(0));
+	ScopedNumThreads num_threads(state.range(1));
+
+	for (auto _ : state)
+	{
+		state.PauseTiming();
+		auto machine = wrap(create(feats));
+		state.ResumeTiming();
+
+		machine->train(feats);
+	}
+
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+/** applies a machine trained on n vectors to n other vectors */
+static void BM_Machine_apply(benchmark::State& state, MachineFactory create)
+{
+	auto feats = create_random_features(NUM_DIM, state.range(0));
+	auto machine = wrap(create(feats));
+	machine->train(feats);
+
+	auto test_feats = create_random_features(NUM_DIM, state.range(0));
+	ScopedNumThreads num_threads(state.range(1));
+
+	for (auto _ : state)
+	{
+		auto labels = wrap(machine->apply(test_feats));
+		benchmark::DoNotOptimize(labels.get());
+	}
+
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static bool register_machine_benchmarks()
+{
+	for (const auto& machine : machines())
+	{
+		auto train = benchmark::RegisterBenchmark(
+		    ("BM_Machine_train/" + machine.name).c_str(), BM_Machine_train,
+		    machine.create);
+		add_size_and_thread_args(train, machine.min_size, machine.max_size);
+		train->Unit(benchmark::kMillisecond)->UseRealTime();
+
+		auto apply = benchmark::RegisterBenchmark(
+		    ("BM_Machine_apply/" + machine.name).c_str(), BM_Machine_apply,
+		    machine.create);
+		add_size_and_thread_args(apply, machine.min_size, machine.max_size);
+		apply->Unit(benchmark::kMillisecond)->UseRealTime();
+	}
+	return true;
+}
+
+static const bool machine_benchmarks_registered =
+    register_machine_benchmarks();
+}
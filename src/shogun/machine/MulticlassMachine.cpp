@@ -13,6 +13,12 @@
 #include <shogun/labels/MulticlassLabels.h>
 #include <shogun/mathematics/Statistics.h>
 #include <shogun/labels/MultilabelLabels.h>
+#include <shogun/base/range.h>
+#include <shogun/base/some.h>
+#include <shogun/mathematics/Math.h>
+
+#include <exception>
+#include <vector>
 
 using namespace shogun;
 
@@ -52,6 +58,11 @@ void CMulticlassMachine::register_parameters()
 {
 	SG_ADD(&m_multiclass_strategy,"multiclass_strategy", "Multiclass strategy");
 	SG_ADD(&m_machine, "machine", "The base machine");
+
+	m_max_concurrent_submachines = 0;
+	SG_ADD(
+	    &m_max_concurrent_submachines, "max_concurrent_submachines",
+	    "Maximum number of sub-machines trained at the same time");
 }
 
 void CMulticlassMachine::init_strategy()
@@ -69,6 +80,25 @@ CBinaryLabels* CMulticlassMachine::get_submachine_outputs(int32_t i)
 	return output;
 }
 
+SGMatrix<float64_t> CMulticlassMachine::get_all_submachine_outputs()
+{
+	int32_t num_machines=m_machines->get_num_elements();
+	SGMatrix<float64_t> outputs;
+
+	for (int32_t i=0; i<num_machines; ++i)
+	{
+		CBinaryLabels* machine_outputs=get_submachine_outputs(i);
+		SGVector<float64_t> values=machine_outputs->get_values();
+		if (!outputs.matrix)
+			outputs=SGMatrix<float64_t>(values.vlen, num_machines);
+
+		outputs.set_column(i, values);
+		SG_UNREF(machine_outputs);
+	}
+
+	return outputs;
+}
+
 float64_t CMulticlassMachine::get_submachine_output(int32_t i, int32_t num)
 {
 	CMachine *machine = get_machine(i);
@@ -104,74 +134,62 @@ CMulticlassLabels* CMulticlassMachine::apply_multiclass(CFeatures* data)
 		if (num_machines <= 0)
 			SG_ERROR("num_machines = %d, did you train your machine?", num_machines)
 
-		CMulticlassLabels* result=new CMulticlassLabels(num_vectors);
-
 		// if outputs are prob, only one confidence for each class
 		int32_t num_classes=m_multiclass_strategy->get_num_classes();
 		EProbHeuristicType heuris = get_prob_heuris();
 
-		if (heuris!=PROB_HEURIS_NONE)
-			result->allocate_confidences_for(num_classes);
-		else
-			result->allocate_confidences_for(num_machines);
-
-		CBinaryLabels** outputs=SG_MALLOC(CBinaryLabels*, num_machines);
-		SGVector<float64_t> As(num_machines);
-		SGVector<float64_t> Bs(num_machines);
+		SGMatrix<float64_t> outputs=get_all_submachine_outputs();
+		ASSERT(outputs.num_rows==num_vectors && outputs.num_cols==num_machines)
 
-		for (int32_t i=0; i<num_machines; ++i)
+		if (heuris!=PROB_HEURIS_NONE)
 		{
-			outputs[i] = (CBinaryLabels*) get_submachine_outputs(i);
-
+			SGVector<float64_t> As;
+			SGVector<float64_t> Bs;
 			if (heuris==OVA_SOFTMAX)
 			{
-				CStatistics::SigmoidParamters params = CStatistics::fit_sigmoid(outputs[i]->get_values());
-				As[i] = params.a;
-				Bs[i] = params.b;
+				As=SGVector<float64_t>(num_machines);
+				Bs=SGVector<float64_t>(num_machines);
 			}
 
-			if (heuris!=PROB_HEURIS_NONE && heuris!=OVA_SOFTMAX)
-				outputs[i]->scores_to_probabilities(0,0);
-		}
-
-		SGVector<float64_t> output_for_i(num_machines);
-		SGVector<float64_t> r_output_for_i(num_machines);
-		if (heuris!=PROB_HEURIS_NONE)
-			r_output_for_i.resize_vector(num_classes);
-
-		for (int32_t i=0; i<num_vectors; i++)
-		{
-			for (int32_t j=0; j<num_machines; j++)
-				output_for_i[j] = outputs[j]->get_value(i);
-
-			if (heuris==PROB_HEURIS_NONE)
-			{
-				r_output_for_i = output_for_i;
-			}
-			else
+			for (int32_t i=0; i<num_machines; ++i)
 			{
+				SGVector<float64_t> column(
+						outputs.get_column_vector(i), num_vectors, false);
+
 				if (heuris==OVA_SOFTMAX)
-					m_multiclass_strategy->rescale_outputs(output_for_i,As,Bs);
+				{
+					CStatistics::SigmoidParamters params = CStatistics::fit_sigmoid(column);
+					As[i] = params.a;
+					Bs[i] = params.b;
+				}
 				else
-					m_multiclass_strategy->rescale_outputs(output_for_i);
-
-				// only first num_classes are returned
-				for (int32_t r=0; r<num_classes; r++)
-					r_output_for_i[r] = output_for_i[r];
-
-				SG_DEBUG("%s::apply_multiclass(): sum(r_output_for_i) = %f\n",
-					get_name(), SGVector<float64_t>::sum(r_output_for_i.vector,num_classes));
+				{
+					auto machine_outputs=some<CBinaryLabels>(column.clone());
+					machine_outputs->scores_to_probabilities(0,0);
+					sg_memcpy(column.vector, machine_outputs->get_values().vector,
+							sizeof(float64_t)*num_vectors);
+				}
 			}
 
-			// use rescaled outputs for label decision
-			result->set_label(i, m_multiclass_strategy->decide_label(r_output_for_i));
-			result->set_multiclass_confidences(i, r_output_for_i);
+			// only first num_classes are returned
+			outputs=m_multiclass_strategy->rescale_all_outputs(outputs, As, Bs);
+			ASSERT(outputs.num_cols==num_classes)
 		}
 
-		for (int32_t i=0; i < num_machines; ++i)
-			SG_UNREF(outputs[i]);
+		// use rescaled outputs for label decision
+		SGVector<int32_t> labels=m_multiclass_strategy->decide_labels(outputs);
+
+		CMulticlassLabels* result=new CMulticlassLabels(num_vectors);
+		result->set_int_labels(labels);
 
-		SG_FREE(outputs);
+		SGMatrix<float64_t> confidences(outputs.num_cols, num_vectors);
+#pragma omp parallel for
+		for (int32_t i=0; i<num_vectors; i++)
+		{
+			for (int32_t j=0; j<outputs.num_cols; j++)
+				confidences(j, i)=outputs(i, j);
+		}
+		result->set_multiclass_confidences(confidences);
 
 		return_labels=result;
 	}
@@ -205,25 +223,17 @@ CMultilabelLabels* CMulticlassMachine::apply_multilabel_output(CFeatures* data,
 		REQUIRE(n_outputs<=num_machines,"You request more outputs than machines available")
 
 		CMultilabelLabels* result=new CMultilabelLabels(num_vectors, n_outputs);
-		CBinaryLabels** outputs=SG_MALLOC(CBinaryLabels*, num_machines);
-
-		for (int32_t i=0; i < num_machines; ++i)
-			outputs[i] = (CBinaryLabels*) get_submachine_outputs(i);
+		SGMatrix<float64_t> outputs=get_all_submachine_outputs();
 
 		SGVector<float64_t> output_for_i(num_machines);
 		for (int32_t i=0; i<num_vectors; i++)
 		{
 			for (int32_t j=0; j<num_machines; j++)
-				output_for_i[j] = outputs[j]->get_value(i);
+				output_for_i[j] = outputs(i, j);
 
 			result->set_label(i, m_multiclass_strategy->decide_label_multiple_output(output_for_i, n_outputs));
 		}
 
-		for (int32_t i=0; i < num_machines; ++i)
-			SG_UNREF(outputs[i]);
-
-		SG_FREE(outputs);
-
 		return_labels=result;
 	}
 	else
@@ -245,10 +255,47 @@ bool CMulticlassMachine::train_machine(CFeatures* data)
 	m_machines->reset_array();
 	CBinaryLabels* train_labels = new CBinaryLabels(get_num_rhs_vectors());
 	SG_REF(train_labels);
-	m_machine->set_labels(train_labels);
+
+	int32_t max_concurrent = m_max_concurrent_submachines > 0
+	                             ? m_max_concurrent_submachines
+	                             : parallel->get_num_threads();
+	CMachine* prototype = NULL;
+	if (max_concurrent > 1)
+	{
+		/* the prototype must not hold the labels of a previous training */
+		m_machine->set_labels(NULL);
+		prototype = create_submachine_prototype();
+	}
 
 	m_multiclass_strategy->train_start(
 	    multiclass_labels(m_labels), train_labels);
+	try
+	{
+		if (prototype)
+			train_submachines_concurrently(
+			    train_labels, prototype, max_concurrent);
+		else
+			train_submachines(train_labels);
+	}
+	catch (...)
+	{
+		m_multiclass_strategy->train_stop();
+		SG_UNREF(prototype);
+		SG_UNREF(train_labels);
+		throw;
+	}
+
+	m_multiclass_strategy->train_stop();
+	SG_UNREF(prototype);
+	SG_UNREF(train_labels);
+
+	return true;
+}
+
+void CMulticlassMachine::train_submachines(CBinaryLabels* train_labels)
+{
+	m_machine->set_labels(train_labels);
+
 	while (m_multiclass_strategy->train_has_more())
 	{
 		SGVector<index_t> subset=m_multiclass_strategy->train_prepare_next();
@@ -267,11 +314,74 @@ bool CMulticlassMachine::train_machine(CFeatures* data)
 			remove_machine_subset();
 		}
 	}
+}
 
-	m_multiclass_strategy->train_stop();
-	SG_UNREF(train_labels);
+void CMulticlassMachine::train_submachines_concurrently(
+    CBinaryLabels* train_labels, CMachine* prototype, int32_t max_concurrent)
+{
+	int32_t num_threads =
+	    CMath::min(max_concurrent, parallel->get_num_threads());
+	std::vector<CMachine*> machines;
+	std::exception_ptr error;
 
-	return true;
+	while (!error && m_multiclass_strategy->train_has_more())
+	{
+		/* the strategy prepares the problems one after another, each gets
+		 * its own labels and clone of the prototype */
+		try
+		{
+			while (int32_t(machines.size()) < max_concurrent &&
+			       m_multiclass_strategy->train_has_more())
+			{
+				SGVector<index_t> subset =
+				    m_multiclass_strategy->train_prepare_next();
+				SGVector<float64_t> all_labels = train_labels->get_labels();
+				SGVector<float64_t> labels(
+				    subset.vlen ? subset.vlen : all_labels.vlen);
+				for (auto i : range(labels.vlen))
+					labels[i] = all_labels[subset.vlen ? subset[i] : i];
+
+				auto machine = prototype->clone()->as<CMachine>();
+				machines.push_back(machine);
+				auto binary_labels = new CBinaryLabels(labels.vlen);
+				binary_labels->set_labels(labels);
+				machine->set_labels(binary_labels);
+				set_submachine_data(machine, subset);
+			}
+		}
+		catch (...)
+		{
+			error = std::current_exception();
+		}
+
+		if (!error)
+		{
+#pragma omp parallel for schedule(dynamic) num_threads(num_threads)
+			for (int32_t i = 0; i < int32_t(machines.size()); i++)
+			{
+				try
+				{
+					machines[i]->train();
+				}
+				catch (...)
+				{
+#pragma omp critical
+					error = std::current_exception();
+				}
+			}
+		}
+
+		for (auto machine : machines)
+		{
+			if (!error)
+				m_machines->push_back(get_machine_from_trained(machine));
+			SG_UNREF(machine);
+		}
+		machines.clear();
+	}
+
+	if (error)
+		std::rethrow_exception(error);
 }
 
 float64_t CMulticlassMachine::apply_one(int32_t vec_idx)
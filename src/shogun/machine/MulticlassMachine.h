@@ -78,6 +78,14 @@ class CMulticlassMachine : public CBaseMulticlassMachine
 		 */
 		virtual CBinaryLabels* get_submachine_outputs(int32_t i);
 
+		/** get outputs of all submachines, by default the outputs of
+		 * get_submachine_outputs() one after another
+		 *
+		 * @return num_vectors x num_machines matrix, whose i-th column holds
+		 * the outputs of the i-th submachine
+		 */
+		virtual SGMatrix<float64_t> get_all_submachine_outputs();
+
 		/** get output of i-th submachine for num-th vector
 		 * @param i number of submachine
 		 * @param num number of feature vector
@@ -137,6 +145,32 @@ class CMulticlassMachine : public CBaseMulticlassMachine
 			return "MulticlassMachine";
 		}
 
+		/** set the maximum number of binary sub-machines that are trained
+		 * at the same time. Each of them holds its own labels and copy of the
+		 * machine while training, so this bounds the memory. Machines that do
+		 * not support concurrent training are trained one after another.
+		 *
+		 * @param max_concurrent_submachines maximum number of sub-machines,
+		 * 0 for the number of threads, 1 to train them one after another
+		 */
+		void set_max_concurrent_submachines(int32_t max_concurrent_submachines)
+		{
+			REQUIRE(
+			    max_concurrent_submachines >= 0,
+			    "Maximum number of concurrent sub-machines (%d) must not be "
+			    "negative\n",
+			    max_concurrent_submachines)
+			m_max_concurrent_submachines = max_concurrent_submachines;
+		}
+
+		/** @return maximum number of sub-machines trained at the same time,
+		 * 0 for the number of threads
+		 */
+		int32_t get_max_concurrent_submachines() const
+		{
+			return m_max_concurrent_submachines;
+		}
+
 		/** get prob output heuristic of multiclass strategy */
 		inline EProbHeuristicType get_prob_heuris()
 		{
@@ -185,6 +219,30 @@ class CMulticlassMachine : public CBaseMulticlassMachine
 		/** deletes any subset set to the features of the machine */
 		virtual void remove_machine_subset() = 0;
 
+		/** create an untrained copy of m_machine without training data and
+		 * labels, which is cloned for each binary sub-problem to train them
+		 * concurrently
+		 *
+		 * @return the prototype, or NULL if the machine cannot be trained
+		 * concurrently
+		 */
+		virtual CMachine* create_submachine_prototype()
+		{
+			return NULL;
+		}
+
+		/** give a clone of the prototype a view of the training data, which
+		 * shares the data read-only with all other sub-machines
+		 *
+		 * @param machine clone of the prototype
+		 * @param subset subset of the training vectors, empty for all of them
+		 */
+		virtual void set_submachine_data(
+		    CMachine* machine, SGVector<index_t> subset)
+		{
+			SG_NOTIMPLEMENTED
+		}
+
 		/** whether the machine is acceptable in set_machine */
 		virtual bool is_acceptable_machine(CMachine *machine)
 		{
@@ -196,12 +254,31 @@ class CMulticlassMachine : public CBaseMulticlassMachine
 		/** register parameters */
 		void register_parameters();
 
+		/** train the sub-machines one after another on m_machine
+		 *
+		 * @param train_labels labels the strategy writes to
+		 */
+		void train_submachines(CBinaryLabels* train_labels);
+
+		/** train up to max_concurrent sub-machines at the same time
+		 *
+		 * @param train_labels labels the strategy writes to
+		 * @param prototype see create_submachine_prototype()
+		 * @param max_concurrent maximum number of concurrent sub-machines
+		 */
+		void train_submachines_concurrently(
+		    CBinaryLabels* train_labels, CMachine* prototype,
+		    int32_t max_concurrent);
+
 	protected:
 		/** type of multiclass strategy */
 		CMulticlassStrategy *m_multiclass_strategy;
 
 		/** machine */
 		CMachine* m_machine;
+
+		/** maximum number of sub-machines trained at the same time */
+		int32_t m_max_concurrent_submachines;
 };
 }
 #endif
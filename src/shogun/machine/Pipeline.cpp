@@ -4,8 +4,12 @@
  * Authors: Wuwei Lin
  */
 
+#include <shogun/base/Parallel.h>
+#include <shogun/features/DenseFeatures.h>
 #include <shogun/lib/exception/InvalidStateException.h>
 #include <shogun/machine/Pipeline.h>
+#include <shogun/preprocessor/DensePreprocessor.h>
+#include <algorithm>
 #include <sstream>
 #include <stdexcept>
 #include <string>
@@ -13,6 +17,11 @@
 
 namespace shogun
 {
+	/** Size in bytes of a block of vectors that is pushed through all fused
+	 * stages at once, chosen to fit in the per-core cache.
+	 */
+	static constexpr int64_t FUSED_BLOCK_BYTES = 256 * 1024;
+
 	CPipelineBuilder::~CPipelineBuilder()
 	{
 		for (auto&& stage : m_stages)
@@ -156,15 +165,27 @@ namespace shogun
 	CLabels* CPipeline::apply(CFeatures* data)
 	{
 		auto current_data = wrap(data);
+		std::vector<CDensePreprocessor<float64_t>*> fused;
 		for (auto&& stage : m_stages)
 		{
 			if (holds_alternative<CTransformer*>(stage.second))
 			{
 				auto transformer = shogun::get<CTransformer*>(stage.second);
+				auto preprocessor =
+				    dynamic_cast<CDensePreprocessor<float64_t>*>(transformer);
+				if (preprocessor && preprocessor->is_columnwise())
+				{
+					fused.push_back(preprocessor);
+					continue;
+				}
+
+				current_data = apply_fused(current_data, fused);
+				fused.clear();
 				current_data = wrap(transformer->transform(current_data));
 			}
 			else
 			{
+				current_data = apply_fused(current_data, fused);
 				auto machine = shogun::get<CMachine*>(stage.second);
 				return machine->apply(current_data);
 			}
@@ -173,6 +194,89 @@ namespace shogun
 		return nullptr; // unreachable
 	}
 
+	Some<CFeatures> CPipeline::apply_fused(
+	    CFeatures* features,
+	    const std::vector<CDensePreprocessor<float64_t>*>& stages) const
+	{
+		auto current_data = wrap(features);
+		if (stages.empty())
+			return current_data;
+
+		auto dense = features->get_feature_class() == C_DENSE &&
+		                     features->get_feature_type() == F_DREAL
+		                 ? features->as<CDenseFeatures<float64_t>>()
+		                 : nullptr;
+
+		int32_t num_rows = 0;
+		int32_t num_all_vectors = 0;
+		auto source = dense
+		                  ? dense->get_feature_matrix(num_rows, num_all_vectors)
+		                  : nullptr;
+		auto num_vectors = dense ? dense->get_num_vectors() : 0;
+
+		// nothing to gain from fusing a single stage, and features without a
+		// feature matrix are computed on the fly
+		if (stages.size() == 1 || !source || num_vectors == 0)
+		{
+			for (auto stage : stages)
+				current_data = wrap(stage->transform(current_data));
+
+			return current_data;
+		}
+
+		auto subset_stack = features->get_subset_stack();
+
+		auto gather = [&](SGMatrix<float64_t>& block, index_t first) {
+			for (auto i : range(block.num_cols))
+			{
+				auto real_idx = subset_stack->subset_idx_conversion(first + i);
+				std::copy_n(
+				    source + int64_t(real_idx) * num_rows, num_rows,
+				    block.get_column_vector(i));
+			}
+		};
+
+		auto push_through = [&stages](SGMatrix<float64_t> block) {
+			for (auto stage : stages)
+				block = stage->apply_to_columns(block);
+			return block;
+		};
+
+		// the output dimension is only known after applying all stages
+		SGMatrix<float64_t> probe(num_rows, 1);
+		gather(probe, 0);
+		auto num_output_rows = push_through(probe).num_rows;
+
+		SGMatrix<float64_t> result(num_output_rows, num_vectors);
+		index_t block_size = std::max<int64_t>(
+		    1, FUSED_BLOCK_BYTES / (int64_t(num_rows) * sizeof(float64_t)));
+		index_t num_blocks = (num_vectors + block_size - 1) / block_size;
+
+#pragma omp parallel num_threads(parallel->get_num_threads())
+		{
+			SGMatrix<float64_t> scratch(num_rows, block_size);
+
+#pragma omp for schedule(dynamic)
+			for (index_t b = 0; b < num_blocks; b++)
+			{
+				index_t first = b * block_size;
+				index_t num_cols = std::min(block_size, num_vectors - first);
+				SGMatrix<float64_t> block(
+				    scratch.matrix, num_rows, num_cols, false);
+				gather(block, first);
+
+				auto transformed = push_through(block);
+				std::copy_n(
+				    transformed.matrix, int64_t(num_output_rows) * num_cols,
+				    result.get_column_vector(first));
+			}
+		}
+
+		SG_UNREF(subset_stack);
+
+		return wrap<CFeatures>(new CDenseFeatures<float64_t>(result));
+	}
+
 	bool CPipeline::train_require_labels() const
 	{
 		bool require_labels = false;
@@ -7,6 +7,7 @@
 #ifndef _PIPELINE_H_
 #define _PIPELINE_H_
 
+#include <shogun/base/some.h>
 #include <shogun/base/variant.h>
 #include <shogun/machine/Machine.h>
 #include <shogun/transformer/Transformer.h>
@@ -15,6 +16,8 @@
 namespace shogun
 {
 	class CPipeline;
+	template <class ST>
+	class CDensePreprocessor;
 
 	/** @brief Builder of pipeline. */
 	class CPipelineBuilder : public CSGObject
@@ -84,6 +87,12 @@ namespace shogun
 	 * consists of a sequence of transformers as intermediate stages of training
 	 * or testing and a machine as the final stage. Features are transformed by
 	 * transformers and fed into the next stage sequentially.
+	 *
+	 * When applying the pipeline, consecutive columnwise dense preprocessors
+	 * (see CDensePreprocessor::is_columnwise) are fused: the feature matrix
+	 * is processed in cache sized blocks of vectors which pass through all
+	 * fused stages before being written to the result, and blocks are
+	 * processed in parallel.
 	 */
 	class CPipeline : public CMachine
 	{
@@ -133,6 +142,18 @@ namespace shogun
 		    m_stages;
 		virtual bool train_require_labels() const override;
 
+		/** Apply a run of columnwise dense preprocessors in a single pass
+		 * over the features. Falls back to applying the stages one after
+		 * another if the features are not a dense real valued matrix.
+		 *
+		 * @param features the input features
+		 * @param stages the preprocessors to apply, in order
+		 * @return the transformed features
+		 */
+		Some<CFeatures> apply_fused(
+		    CFeatures* features,
+		    const std::vector<CDensePreprocessor<float64_t>*>& stages) const;
+
 		/** Stores feature data of underlying model. This will be forwarded to
 		 * `store_model_features` of underlying machines.
 		 */
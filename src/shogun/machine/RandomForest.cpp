@@ -164,6 +164,12 @@ void CRandomForest::set_machine_parameters(CMachine* m, SGVector<index_t> idx)
 	tree->set_machine_problem_type(dynamic_cast<CRandomCARTree*>(m_machine)->get_machine_problem_type());
 }
 
+void CRandomForest::set_machine_rand_seed(CMachine* m, uint64_t seed)
+{
+	REQUIRE(m,"Machine supplied is NULL\n")
+	dynamic_cast<CRandomCARTree*>(m)->set_rand_seed(seed);
+}
+
 bool CRandomForest::train_machine(CFeatures* data)
 {
 	if (data)
@@ -148,6 +148,14 @@ protected:
 	 */
 	virtual void set_machine_parameters(CMachine* m, SGVector<index_t> idx);
 
+	/** sets the seed of the random stream of a bag's CARTree, which draws
+	 * the random feature subsets from it
+	 *
+	 * @param m machine
+	 * @param seed seed drawn from the random stream of the bag
+	 */
+	virtual void set_machine_rand_seed(CMachine* m, uint64_t seed);
+
 private:
 	/** initialize parameters */
 	void init();
@@ -33,6 +33,7 @@
 #include <shogun/lib/View.h>
 #include <shogun/machine/StochasticGBMachine.h>
 #include <shogun/mathematics/Math.h>
+#include <shogun/optimization/FirstOrderSumCostFunction.h>
 #include <shogun/optimization/lbfgs/lbfgs.h>
 
 using namespace shogun;
@@ -303,6 +304,76 @@ void CStochasticGBMachine::initialize_learners()
 	SG_REF(m_gamma);
 }
 
+namespace
+{
+/** loss of the labels as a function of the step size gamma of the weak
+ * learner, summed over the samples in parallel
+ */
+class GammaCostFunction : public FirstOrderSumCostFunction
+{
+public:
+	GammaCostFunction(
+	    SGVector<float64_t> labels, SGVector<float64_t> f,
+	    SGVector<float64_t> hm, CLossFunction* loss, float64_t* gamma)
+	    : FirstOrderSumCostFunction(), m_labels(labels), m_f(f), m_hm(hm),
+	      m_loss(loss), m_gamma(gamma)
+	{
+	}
+
+	virtual index_t get_sample_size()
+	{
+		return m_labels.vlen;
+	}
+
+	virtual SGVector<float64_t> obtain_variable_reference()
+	{
+		return SGVector<float64_t>(m_gamma, 1, false);
+	}
+
+	virtual const char* get_name() const
+	{
+		return "GammaCostFunction";
+	}
+
+protected:
+	virtual float64_t get_block_cost(index_t begin, index_t end)
+	{
+		float64_t cost = 0;
+		for (index_t i = begin; i < end; i++)
+			cost += m_loss->loss(prediction(i), m_labels[i]);
+		return cost;
+	}
+
+	virtual float64_t add_block_cost_and_gradient(
+	    index_t begin, index_t end, SGVector<float64_t> gradient)
+	{
+		float64_t cost = 0;
+		for (index_t i = begin; i < end; i++)
+		{
+			float64_t prediction_i = prediction(i);
+			gradient[0] += m_loss->first_derivative(prediction_i, m_labels[i]);
+			cost += m_loss->loss(prediction_i, m_labels[i]);
+		}
+		return cost;
+	}
+
+private:
+	/** gamma alone if there is no weak learner yet */
+	float64_t prediction(index_t i) const
+	{
+		if (!m_hm.vlen)
+			return *m_gamma;
+		return (*m_gamma) * m_hm[i] + m_f[i];
+	}
+
+	SGVector<float64_t> m_labels;
+	SGVector<float64_t> m_f;
+	SGVector<float64_t> m_hm;
+	CLossFunction* m_loss;
+	float64_t* m_gamma;
+};
+}
+
 float64_t CStochasticGBMachine::get_gamma(void* instance)
 {
 	lbfgs_parameter_t lbfgs_param;
@@ -336,13 +407,11 @@ float64_t CStochasticGBMachine::lbfgs_evaluate(void *obj, const float64_t *param
 		REQUIRE(element,"1 index element of objects is NULL\n")
 		CLossFunction* lossf=dynamic_cast<CLossFunction*>(element);
 
-		*gradient=0;
-		float64_t ret=0;
-		for (int32_t i=0;i<labels.vlen;i++)
-		{
-			*gradient+=lossf->first_derivative((*parameters),labels[i]);
-			ret+=lossf->loss((*parameters),labels[i]);
-		}
+		GammaCostFunction fun(
+			labels, SGVector<float64_t>(), SGVector<float64_t>(), lossf,
+			const_cast<float64_t*>(parameters));
+		float64_t ret=
+			fun.get_cost_and_gradient(SGVector<float64_t>(gradient, 1, false));
 
 		SG_UNREF(lab);
 		SG_UNREF(lossf);
@@ -372,13 +441,10 @@ float64_t CStochasticGBMachine::lbfgs_evaluate(void *obj, const float64_t *param
 	REQUIRE(element,"3 index element of objects is NULL\n")
 	CLossFunction* lossf=dynamic_cast<CLossFunction*>(element);
 
-	*gradient=0;
-	float64_t ret=0;
-	for (int32_t i=0;i<labels.vlen;i++)
-	{
-		*gradient+=lossf->first_derivative((*parameters)*hm[i]+f[i],labels[i]);
-		ret+=lossf->loss((*parameters)*hm[i]+f[i],labels[i]);
-	}
+	GammaCostFunction fun(
+		labels, f, hm, lossf, const_cast<float64_t*>(parameters));
+	float64_t ret=
+		fun.get_cost_and_gradient(SGVector<float64_t>(gradient, 1, false));
 
 	SG_UNREF(lab);
 	SG_UNREF(delta);
@@ -16,6 +16,7 @@
 #include <shogun/lib/common.h>
 #include <shogun/base/Parallel.h>
 #include <shogun/mathematics/Random.h>
+#include <shogun/mathematics/RandomStream.h>
 #include <shogun/lib/SGVector.h>
 #include <algorithm>
 #include <numeric>
@@ -820,6 +821,18 @@ class CMath : public CSGObject
 				}
 			}
 
+		/** Permute randomly the elements of the vector with a random stream,
+		 * e.g. one of a parallel task.
+		 * @param v the vector to permute.
+		 * @param rand random stream to generate the permutation.
+		 */
+		template <class T>
+			static void permute(SGVector<T> v, RandomStream& rand)
+			{
+				for (index_t i=0; i<v.vlen; ++i)
+					swap(v[i], v[rand.random(i, v.vlen-1)]);
+			}
+
 		/** Computes sum of non-zero elements
 		 * @param vec vector
 		 * @param len length
@@ -0,0 +1,151 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ */
+
+#include <shogun/mathematics/RandomStream.h>
+
+#include <cmath>
+
+using namespace shogun;
+
+namespace
+{
+const uint32_t PHILOX_M0 = 0xD2511F53;
+const uint32_t PHILOX_M1 = 0xCD9E8D57;
+const uint32_t PHILOX_W0 = 0x9E3779B9;
+const uint32_t PHILOX_W1 = 0xBB67AE85;
+const float64_t TWO_PI = 6.283185307179586476925286766559;
+
+inline float64_t to_half_open(uint32_t low, uint32_t high)
+{
+	uint64_t bits = uint64_t(low) | (uint64_t(high) << 32);
+	return (bits >> 11) * (1.0 / 9007199254740992.0);
+}
+
+/* Box-Muller transform of a block, the first uniform is mapped to (0,1] */
+inline void box_muller(const uint32_t block[4], float64_t& z0, float64_t& z1)
+{
+	float64_t u1 = 1.0 - to_half_open(block[0], block[1]);
+	float64_t u2 = to_half_open(block[2], block[3]);
+	float64_t r = std::sqrt(-2.0 * std::log(u1));
+	z0 = r * std::cos(TWO_PI * u2);
+	z1 = r * std::sin(TWO_PI * u2);
+}
+}
+
+RandomStream::RandomStream(uint64_t seed, uint64_t stream)
+    : m_stream(stream), m_counter(0), m_buffer_pos(4), m_has_normal(false),
+      m_normal(0)
+{
+	m_key[0] = uint32_t(seed);
+	m_key[1] = uint32_t(seed >> 32);
+}
+
+void RandomStream::philox(
+    uint64_t counter, uint64_t stream, const uint32_t key[2],
+    uint32_t result[4])
+{
+	uint32_t c0 = uint32_t(counter);
+	uint32_t c1 = uint32_t(counter >> 32);
+	uint32_t c2 = uint32_t(stream);
+	uint32_t c3 = uint32_t(stream >> 32);
+	uint32_t k0 = key[0];
+	uint32_t k1 = key[1];
+
+	for (int32_t round = 0; round < 10; round++)
+	{
+		uint64_t p0 = uint64_t(PHILOX_M0) * c0;
+		uint64_t p1 = uint64_t(PHILOX_M1) * c2;
+		uint32_t n0 = uint32_t(p1 >> 32) ^ c1 ^ k0;
+		uint32_t n2 = uint32_t(p0 >> 32) ^ c3 ^ k1;
+		c1 = uint32_t(p1);
+		c3 = uint32_t(p0);
+		c0 = n0;
+		c2 = n2;
+		k0 += PHILOX_W0;
+		k1 += PHILOX_W1;
+	}
+
+	result[0] = c0;
+	result[1] = c1;
+	result[2] = c2;
+	result[3] = c3;
+}
+
+void RandomStream::refill()
+{
+	philox(m_counter++, m_stream, m_key, m_buffer);
+	m_buffer_pos = 0;
+}
+
+void RandomStream::discard(uint64_t num_blocks)
+{
+	align();
+	m_counter += num_blocks;
+}
+
+float64_t RandomStream::std_normal_distrib()
+{
+	if (m_has_normal)
+	{
+		m_has_normal = false;
+		return m_normal;
+	}
+
+	uint32_t block[4];
+	for (int32_t i = 0; i < 4; i++)
+		block[i] = random_32();
+
+	float64_t z0;
+	box_muller(block, z0, m_normal);
+	m_has_normal = true;
+	return z0;
+}
+
+void RandomStream::fill_array(uint32_t* array, index_t size)
+{
+	align();
+	index_t num_full = size / 4;
+	for (index_t i = 0; i < num_full; i++)
+		philox(m_counter + i, m_stream, m_key, array + 4 * i);
+
+	m_counter += num_full;
+	for (index_t i = 4 * num_full; i < size; i++)
+		array[i] = random_32();
+	align();
+}
+
+void RandomStream::fill_array_co(float64_t* array, index_t size)
+{
+	align();
+	index_t num_full = size / 2;
+	for (index_t i = 0; i < num_full; i++)
+	{
+		uint32_t block[4];
+		philox(m_counter + i, m_stream, m_key, block);
+		array[2 * i] = to_half_open(block[0], block[1]);
+		array[2 * i + 1] = to_half_open(block[2], block[3]);
+	}
+
+	m_counter += num_full;
+	if (size % 2)
+		array[size - 1] = random_half_open();
+	align();
+}
+
+void RandomStream::fill_array_normal(float64_t* array, index_t size)
+{
+	align();
+	index_t num_full = size / 2;
+	for (index_t i = 0; i < num_full; i++)
+	{
+		uint32_t block[4];
+		philox(m_counter + i, m_stream, m_key, block);
+		box_muller(block, array[2 * i], array[2 * i + 1]);
+	}
+
+	m_counter += num_full;
+	if (size % 2)
+		array[size - 1] = std_normal_distrib();
+	align();
+}
@@ -0,0 +1,247 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ */
+
+#ifndef __RANDOMSTREAM_H__
+#define __RANDOMSTREAM_H__
+
+#include <shogun/lib/config.h>
+
+#include <shogun/lib/common.h>
+
+namespace shogun
+{
+
+/** @brief RandomStream is a counter-based pseudo random number generator,
+ * Philox4x32-10, for reproducible parallel computations.
+ *
+ * A stream is identified by a seed and a stream index, e.g. the index of a
+ * task of a parallel loop. The n-th block of 128 random bits of a stream is
+ * a function of the seed, the stream index and n only, so tasks that
+ * derive their streams from a common seed draw independent numbers that do
+ * not depend on the number of threads or the order of execution. Each
+ * stream has \f$2^{64}\f$ blocks, the counter can be advanced without
+ * generating with discard().
+ *
+ * Unlike CRandom, a stream is a small value type without locking, so it
+ * must not be shared by threads.
+ *
+ * Please see the following paper for more details.
+ *
+ * @code
+ * @inproceedings{salmon2011parallel,
+ *   title={Parallel random numbers: as easy as 1, 2, 3},
+ *   author={Salmon, J. and Moraes, M. and Dror, R. and Shaw, D.},
+ *   booktitle={Proceedings of the International Conference for High Performance Computing, Networking, Storage and Analysis},
+ *   year={2011}
+ * }
+ * @endcode
+ */
+class RandomStream
+{
+public:
+	/** constructor
+	 *
+	 * @param seed seed of the family of streams
+	 * @param stream index of the stream
+	 */
+	RandomStream(uint64_t seed=0, uint64_t stream=0);
+
+	/** @return seed of the family of streams */
+	uint64_t get_seed() const
+	{
+		return uint64_t(m_key[0]) | (uint64_t(m_key[1]) << 32);
+	}
+
+	/** @return index of the stream */
+	uint64_t get_stream() const
+	{
+		return m_stream;
+	}
+
+	/** @return index of the next block of the stream */
+	uint64_t get_position() const
+	{
+		return m_counter;
+	}
+
+	/** skip blocks of the stream, including the rest of the current one
+	 *
+	 * @param num_blocks number of blocks to skip
+	 */
+	void discard(uint64_t num_blocks);
+
+	/** @return random unsigned 32-bit integer */
+	uint32_t random_32()
+	{
+		if (m_buffer_pos == 4)
+			refill();
+		return m_buffer[m_buffer_pos++];
+	}
+
+	/** @return random unsigned 64-bit integer */
+	uint64_t random_64()
+	{
+		uint64_t low = random_32();
+		return low | (uint64_t(random_32()) << 32);
+	}
+
+	/** generate an unsigned 64bit integer in the range
+	 * [min_value, max_value] (closed interval!)
+	 *
+	 * @param min_value minimum value
+	 * @param max_value maximum value
+	 * @return random number
+	 */
+	uint64_t random(uint64_t min_value, uint64_t max_value)
+	{
+		return min_value + random_64() % (max_value - min_value + 1);
+	}
+
+	/** generate a signed 64bit integer in the range
+	 * [min_value, max_value] (closed interval!)
+	 *
+	 * @param min_value minimum value
+	 * @param max_value maximum value
+	 * @return random number
+	 */
+	int64_t random(int64_t min_value, int64_t max_value)
+	{
+		return min_value +
+		       int64_t(random_64() % uint64_t(max_value - min_value + 1));
+	}
+
+	/** generate an unsigned 32bit integer in the range
+	 * [min_value, max_value] (closed interval!)
+	 *
+	 * @param min_value minimum value
+	 * @param max_value maximum value
+	 * @return random number
+	 */
+	uint32_t random(uint32_t min_value, uint32_t max_value)
+	{
+		return min_value + random_32() % (max_value - min_value + 1);
+	}
+
+	/** generate a signed 32bit integer in the range
+	 * [min_value, max_value] (closed interval!)
+	 *
+	 * @param min_value minimum value
+	 * @param max_value maximum value
+	 * @return random number
+	 */
+	int32_t random(int32_t min_value, int32_t max_value)
+	{
+		return min_value +
+		       int32_t(random_32() % uint32_t(max_value - min_value + 1));
+	}
+
+	/** generate a 64bit floating point number in the range
+	 * [min_value, max_value)
+	 *
+	 * @param min_value minimum value
+	 * @param max_value maximum value
+	 * @return random number
+	 */
+	float64_t random(float64_t min_value, float64_t max_value)
+	{
+		return min_value + (max_value - min_value) * random_half_open();
+	}
+
+	/** @return random float64_t from the [0,1) interval */
+	float64_t random_half_open()
+	{
+		return (random_64() >> 11) * (1.0 / 9007199254740992.0);
+	}
+
+	/** @return random float64_t from the (0,1) interval */
+	float64_t random_open()
+	{
+		return ((random_64() >> 12) + 0.5) * (1.0 / 4503599627370496.0);
+	}
+
+	/** sample a normal distribution
+	 *
+	 * @param mu mean
+	 * @param sigma standard deviation
+	 * @return sample
+	 */
+	float64_t normal_distrib(float64_t mu, float64_t sigma)
+	{
+		return mu + sigma * std_normal_distrib();
+	}
+
+	/** sample a standard normal distribution with the Box-Muller
+	 * transform, the second sample of a pair is kept for the next call
+	 *
+	 * @return sample
+	 */
+	float64_t std_normal_distrib();
+
+	/** fill an array with random unsigned 32-bit integers, starting at the
+	 * next block of the stream; blocks are generated independently of each
+	 * other so that the loop vectorises
+	 *
+	 * @param array array to fill
+	 * @param size size of the array
+	 */
+	void fill_array(uint32_t* array, index_t size);
+
+	/** fill an array with randoms from the [0,1) interval, starting at the
+	 * next block of the stream
+	 *
+	 * @param array array to fill
+	 * @param size size of the array
+	 */
+	void fill_array_co(float64_t* array, index_t size);
+
+	/** fill an array with samples of the standard normal distribution,
+	 * starting at the next block of the stream; each block gives a pair by
+	 * the Box-Muller transform
+	 *
+	 * @param array array to fill
+	 * @param size size of the array
+	 */
+	void fill_array_normal(float64_t* array, index_t size);
+
+	/** compute a block of the Philox4x32-10 generator
+	 *
+	 * @param counter index of the block in the stream
+	 * @param stream index of the stream
+	 * @param key key, i.e. the seed
+	 * @param result the four 32-bit words of the block
+	 */
+	static void philox(
+	    uint64_t counter, uint64_t stream, const uint32_t key[2],
+	    uint32_t result[4]);
+
+private:
+	/** generate the next block into the buffer */
+	void refill();
+
+	/** end the current block so that the next draw starts a new one */
+	void align()
+	{
+		m_buffer_pos = 4;
+		m_has_normal = false;
+	}
+
+private:
+	/** key of the generator, i.e. the seed */
+	uint32_t m_key[2];
+	/** index of the stream */
+	uint64_t m_stream;
+	/** index of the next block */
+	uint64_t m_counter;
+	/** current block */
+	uint32_t m_buffer[4];
+	/** next unused word of the current block, 4 if it is used up */
+	int32_t m_buffer_pos;
+	/** whether the second normal sample of a pair is kept */
+	bool m_has_normal;
+	/** kept normal sample */
+	float64_t m_normal;
+};
+}
+
+#endif /* __RANDOMSTREAM_H__ */
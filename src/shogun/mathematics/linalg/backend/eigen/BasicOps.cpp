@@ -198,16 +198,67 @@ DEFINE_FOR_ALL_PTYPE(BACKEND_GENERIC_IN_PLACE_SCALE, SGMatrix)
 #undef DEFINE_FOR_NON_INTEGER_PTYPE
 #undef DEFINE_FOR_NUMERIC_PTYPE
 
+namespace
+{
+	static_assert(
+	    SG_DATA_ALIGNMENT == Eigen::Aligned64,
+	    "Aligned maps assume the data alignment of SGVector and SGMatrix");
+
+	/* maps of data aligned to SG_DATA_ALIGNMENT */
+	template <typename T>
+	using AlignedVectorMap =
+	    Eigen::Map<typename SGVector<T>::EigenVectorXt, Eigen::Aligned64>;
+	template <typename T>
+	using AlignedMatrixMap =
+	    Eigen::Map<typename SGMatrix<T>::EigenMatrixXt, Eigen::Aligned64>;
+
+	bool all_aligned()
+	{
+		return true;
+	}
+
+	template <typename Container, typename... Containers>
+	bool all_aligned(const Container& a, const Containers&... others)
+	{
+		return sg_is_aligned(a.data()) && all_aligned(others...);
+	}
+
+	/* Calls operation with an Eigen map of each vector. The maps are declared
+	 * aligned if all vectors start at an aligned address, which is the case
+	 * for freshly allocated ones, so Eigen neither checks the alignment nor
+	 * peels off leading elements. Views into other data use plain maps. */
+	template <typename Operation, typename... T>
+	auto with_eigen_maps(Operation operation, const SGVector<T>&... vectors)
+	{
+		if (all_aligned(vectors...))
+			return operation(AlignedVectorMap<T>(
+			    vectors.data(), vectors.vlen)...);
+
+		return operation(typename SGVector<T>::EigenVectorXtMap(vectors)...);
+	}
+
+	/* Same as above for matrices */
+	template <typename Operation, typename... T>
+	auto with_eigen_maps(Operation operation, const SGMatrix<T>&... matrices)
+	{
+		if (all_aligned(matrices...))
+			return operation(AlignedMatrixMap<T>(
+			    matrices.data(), matrices.num_rows, matrices.num_cols)...);
+
+		return operation(typename SGMatrix<T>::EigenMatrixXtMap(matrices)...);
+	}
+}
+
 template <typename T>
 void LinalgBackendEigen::add_impl(
     const SGVector<T>& a, const SGVector<T>& b, T alpha, T beta,
     SGVector<T>& result) const
 {
-	typename SGVector<T>::EigenVectorXtMap a_eig = a;
-	typename SGVector<T>::EigenVectorXtMap b_eig = b;
-	typename SGVector<T>::EigenVectorXtMap result_eig = result;
-
-	result_eig = alpha * a_eig + beta * b_eig;
+	with_eigen_maps(
+	    [alpha, beta](auto a_eig, auto b_eig, auto result_eig) {
+		    result_eig = alpha * a_eig + beta * b_eig;
+	    },
+	    a, b, result);
 }
 
 template <typename T>
@@ -215,11 +266,11 @@ void LinalgBackendEigen::add_impl(
     const SGMatrix<T>& a, const SGMatrix<T>& b, T alpha, T beta,
     SGMatrix<T>& result) const
 {
-	typename SGMatrix<T>::EigenMatrixXtMap a_eig = a;
-	typename SGMatrix<T>::EigenMatrixXtMap b_eig = b;
-	typename SGMatrix<T>::EigenMatrixXtMap result_eig = result;
-
-	result_eig = alpha * a_eig + beta * b_eig;
+	with_eigen_maps(
+	    [alpha, beta](auto a_eig, auto b_eig, auto result_eig) {
+		    result_eig = alpha * a_eig + beta * b_eig;
+	    },
+	    a, b, result);
 }
 
 template <typename T>
@@ -337,22 +388,20 @@ void LinalgBackendEigen::add_vector_impl(
 template <typename T>
 void LinalgBackendEigen::add_scalar_impl(SGVector<T>& a, T b) const
 {
-	typename SGVector<T>::EigenVectorXtMap a_eig = a;
-	a_eig = a_eig.array() + b;
+	with_eigen_maps([b](auto a_eig) { a_eig = a_eig.array() + b; }, a);
 }
 
 template <typename T>
 void LinalgBackendEigen::add_scalar_impl(SGMatrix<T>& a, T b) const
 {
-	typename SGMatrix<T>::EigenMatrixXtMap a_eig = a;
-	a_eig = a_eig.array() + b;
+	with_eigen_maps([b](auto a_eig) { a_eig = a_eig.array() + b; }, a);
 }
 
 template <typename T>
 T LinalgBackendEigen::dot_impl(const SGVector<T>& a, const SGVector<T>& b) const
 {
-	return (typename SGVector<T>::EigenVectorXtMap(a))
-	    .dot(typename SGVector<T>::EigenVectorXtMap(b));
+	return with_eigen_maps(
+	    [](auto a_eig, auto b_eig) { return a_eig.dot(b_eig); }, a, b);
 }
 
 /* Helper method to compute elementwise product with Eigen */
@@ -405,11 +454,11 @@ template <typename T>
 void LinalgBackendEigen::element_prod_impl(
     const SGVector<T>& a, const SGVector<T>& b, SGVector<T>& result) const
 {
-	typename SGVector<T>::EigenVectorXtMap a_eig = a;
-	typename SGVector<T>::EigenVectorXtMap b_eig = b;
-	typename SGVector<T>::EigenVectorXtMap result_eig = result;
-
-	result_eig = a_eig.array() * b_eig.array();
+	with_eigen_maps(
+	    [](auto a_eig, auto b_eig, auto result_eig) {
+		    result_eig = a_eig.array() * b_eig.array();
+	    },
+	    a, b, result);
 }
 
 template <typename T>
@@ -471,18 +520,16 @@ template <typename T>
 void LinalgBackendEigen::scale_impl(
     const SGVector<T>& a, T alpha, SGVector<T>& result) const
 {
-	typename SGVector<T>::EigenVectorXtMap a_eig = a;
-	typename SGVector<T>::EigenVectorXtMap result_eig = result;
-
-	result_eig = alpha * a_eig;
+	with_eigen_maps(
+	    [alpha](auto a_eig, auto result_eig) { result_eig = alpha * a_eig; },
+	    a, result);
 }
 
 template <typename T>
 void LinalgBackendEigen::scale_impl(
     const SGMatrix<T>& a, T alpha, SGMatrix<T>& result) const
 {
-	typename SGMatrix<T>::EigenMatrixXtMap a_eig = a;
-	typename SGMatrix<T>::EigenMatrixXtMap result_eig = result;
-
-	result_eig = alpha * a_eig;
+	with_eigen_maps(
+	    [alpha](auto a_eig, auto result_eig) { result_eig = alpha * a_eig; },
+	    a, result);
 }
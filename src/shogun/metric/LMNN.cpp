@@ -85,20 +85,63 @@ void CLMNN::train(SGMatrix<float64_t> init_transform)
 	// Make space for the training statistics
 	m_statistics->resize(m_maxiter);
 
+	// With minibatches, the pull part of the gradient is kept and the push part
+	// is estimated at every iteration from the impostors of the minibatch
+	int32_t num_vectors = x->get_num_vectors();
+	int32_t minibatch_size = CMath::min(m_minibatch_size, num_vectors);
+	SGMatrix<float64_t> pull_gradient;
+	SGVector<index_t> order;
+	index_t position = num_vectors;
+	// Scale of the push part estimated from a minibatch
+	float64_t scale = 1.0;
+	if (minibatch_size > 0)
+	{
+		pull_gradient = gradient.clone();
+		order = SGVector<index_t>(num_vectors);
+		order.range_fill();
+		scale = float64_t(num_vectors) / minibatch_size;
+	}
+
 	// Progress bar
 	auto pb = SG_PROGRESS(range(m_maxiter));
 
 	// Main loop
 	while (!stop)
 	{
-		// Find current set of impostors
-		SG_DEBUG("Finding impostors.\n")
-		cur_impostors = CLMNNImpl::find_impostors(x,y,L,target_nn,iter,m_correction);
-		SG_DEBUG("Found %d impostors in the current set.\n", cur_impostors.size())
-
-		// (Sub-) gradient computation
-		SG_DEBUG("Updating gradient.\n")
-		CLMNNImpl::update_gradient(x, gradient, cur_impostors, prev_impostors, m_regularization);
+		if (minibatch_size > 0)
+		{
+			// Take the next minibatch, the examples are visited in a random
+			// order that changes every time all of them have been used
+			if (position + minibatch_size > num_vectors)
+			{
+				CMath::permute(order);
+				position = 0;
+			}
+			SGVector<index_t> minibatch(minibatch_size);
+			sg_memcpy(minibatch.vector, order.vector + position,
+					minibatch_size * sizeof(index_t));
+			position += minibatch_size;
+
+			SG_DEBUG("Finding impostors of the minibatch.\n")
+			cur_impostors = CLMNNImpl::find_impostors_minibatch(x, y, L, target_nn, minibatch);
+			SG_DEBUG("Found %d impostors in the minibatch.\n", cur_impostors.size())
+
+			SG_DEBUG("Estimating gradient.\n")
+			gradient = pull_gradient.clone();
+			CLMNNImpl::update_gradient(x, gradient, cur_impostors,
+					ImpostorsSetType(), m_regularization * scale);
+		}
+		else
+		{
+			// Find current set of impostors
+			SG_DEBUG("Finding impostors.\n")
+			cur_impostors = CLMNNImpl::find_impostors(x,y,L,target_nn,iter,m_correction);
+			SG_DEBUG("Found %d impostors in the current set.\n", cur_impostors.size())
+
+			// (Sub-) gradient computation
+			SG_DEBUG("Updating gradient.\n")
+			CLMNNImpl::update_gradient(x, gradient, cur_impostors, prev_impostors, m_regularization);
+		}
 		// Take gradient step
 		SG_DEBUG("Taking gradient step.\n")
 		CLMNNImpl::gradient_step(L, gradient, stepsize, m_diagonal);
@@ -106,12 +149,13 @@ void CLMNN::train(SGMatrix<float64_t> init_transform)
 		// Compute the objective, trace of Mahalanobis distance matrix (L squared) times the gradient
 		// plus the number of current impostors to account for the margin
 		SG_DEBUG("Computing objective.\n")
-		obj[iter] = m_regularization * cur_impostors.size();
+		obj[iter] = m_regularization * scale * cur_impostors.size();
 		obj[iter] +=
 		    linalg::trace_dot(linalg::matrix_prod(L, L, true, false), gradient);
 
-		// Correct step size
-		CLMNNImpl::correct_stepsize(stepsize, obj, iter);
+		// Correct step size, the objective of a minibatch is too noisy for it
+		if (minibatch_size == 0)
+			CLMNNImpl::correct_stepsize(stepsize, obj, iter);
 
 		// Check termination criterion
 		stop = CLMNNImpl::check_termination(stepsize, obj, iter, m_maxiter, m_stepsize_threshold, m_obj_threshold);
@@ -249,6 +293,17 @@ void CLMNN::set_diagonal(const bool diagonal)
 	m_diagonal = diagonal;
 }
 
+int32_t CLMNN::get_minibatch_size() const
+{
+	return m_minibatch_size;
+}
+
+void CLMNN::set_minibatch_size(const int32_t minibatch_size)
+{
+	REQUIRE(minibatch_size>=0, "The number of examples per minibatch must not be negative\n")
+	m_minibatch_size = minibatch_size;
+}
+
 CLMNNStatistics* CLMNN::get_statistics() const
 {
 	SG_REF(m_statistics);
@@ -271,6 +326,8 @@ void CLMNN::init()
 			"Iterations between exact impostors search");
 	SG_ADD(&m_obj_threshold, "obj_threshold", "Objective threshold");
 	SG_ADD(&m_diagonal, "m_diagonal", "Diagonal transformation");
+	SG_ADD(&m_minibatch_size, "minibatch_size",
+			"Number of examples per minibatch, zero for full batch");
 	SG_ADD((CSGObject**) &m_statistics, "statistics", "Training statistics");
 
 	m_features = NULL;
@@ -283,6 +340,7 @@ void CLMNN::init()
 	m_correction = 15;
 	m_obj_threshold = 1e-9;
 	m_diagonal = false;
+	m_minibatch_size = 0;
 	m_statistics = NULL;
 }
 
@@ -168,6 +168,21 @@ class CLMNN : public CSGObject
 		 */
 		void set_diagonal(const bool diagonal);
 
+		/** get number of examples per minibatch, zero for full batch training
+		 *
+		 * @return number of examples per minibatch
+		 */
+		int32_t get_minibatch_size() const;
+
+		/** set number of examples per minibatch; with a positive size, every
+		 * iteration takes a step along an estimate of the gradient computed
+		 * from the impostors of a random minibatch of examples, and the step
+		 * size is kept constant. Zero trains on all the examples.
+		 *
+		 * @param minibatch_size number of examples per minibatch
+		 */
+		void set_minibatch_size(const int32_t minibatch_size);
+
 		/** get LMNN training statistics
 		 *
 		 * @return LMNN training statistics
@@ -233,6 +248,12 @@ class CLMNN : public CSGObject
 		 */
 		bool m_diagonal;
 
+		/**
+		 * number of examples whose impostors are used at every iteration,
+		 * zero to use all of them. Its default value is 0.
+		 */
+		int32_t m_minibatch_size;
+
 		/** training statistics, @see CLMNNStatistics */
 		CLMNNStatistics* m_statistics;
 
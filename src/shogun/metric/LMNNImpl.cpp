@@ -10,14 +10,17 @@
 #include <iterator>
 #include <unordered_map>
 
-#include <shogun/lib/View.h>
 #include <shogun/mathematics/linalg/LinalgNamespace.h>
-#include <shogun/multiclass/KNN.h>
+#include <shogun/multiclass/tree/BallTree.h>
 #include <shogun/preprocessor/PCA.h>
 #include <shogun/preprocessor/PruneVarSubMean.h>
 
 using namespace shogun;
 
+const int32_t CLMNNImpl::LEAF_SIZE;
+const index_t CLMNNImpl::BLOCK_SIZE;
+const index_t CLMNNImpl::MAX_PARTIAL_SUMS;
+
 CImpostorNode::CImpostorNode(index_t ex, index_t tar, index_t imp)
 : example(ex), target(tar), impostor(imp)
 {
@@ -113,46 +116,40 @@ SGMatrix<index_t> CLMNNImpl::find_target_nn(CDenseFeatures<float64_t>* x,
 	int32_t d = x->get_num_features();
 	SGMatrix<index_t> target_neighbors(k, x->get_num_vectors());
 	SGVector<float64_t> unique_labels = y->get_unique_labels();
-	SGVector<index_t> idxsmap(x->get_num_vectors());
+	auto X = x->get_feature_matrix();
 
+	// the neighbors of the examples of each class are searched in a ball tree
+	// of the class, the classes are independent of each other
+#pragma omp parallel for schedule(dynamic)
 	for (index_t i = 0; i < unique_labels.vlen; ++i)
 	{
-		int32_t slice_size = 0;
-		for (int32_t j = 0; j < y->get_num_labels(); ++j)
-		{
-			if (y->get_label(j)==unique_labels[i])
-			{
-				idxsmap[slice_size] = j;
-				++slice_size;
-			}
-		}
+		std::vector<index_t> idxsmap = CLMNNImpl::get_examples_label(y, unique_labels[i]);
+		int32_t slice_size = idxsmap.size();
 
 		SGMatrix<float64_t> slice_mat(d, slice_size);
 		for (int32_t j = 0; j < slice_size; ++j)
-			slice_mat.set_column(j, x->get_feature_vector(idxsmap[j]));
-
-
-		//FIXME the labels are not actually necessary to get the nearest neighbors, the
-		//features suffice. The labels are needed when we want to classify.
-		SGVector<float64_t> labels_vec(slice_size);
-		labels_vec.set_const(unique_labels[i]);
+		{
+			sg_memcpy(slice_mat.get_column_vector(j),
+					X.get_column_vector(idxsmap[j]), d*sizeof(float64_t));
+		}
 
 		auto features_slice = some<CDenseFeatures<float64_t>>(slice_mat);
-		auto labels_slice = some<CMulticlassLabels>(labels_vec);
-
-		CKNN* knn = new CKNN(k+1, new CEuclideanDistance(features_slice, features_slice), labels_slice);
-		SGMatrix<int32_t> target_slice = knn->nearest_neighbors();
-		// sanity check
-		ASSERT(target_slice.num_rows==k+1 && target_slice.num_cols==slice_size)
+		auto tree = some<CBallTree>(LEAF_SIZE);
+		tree->build_tree(features_slice);
+		// check_maximum_k ensures that every class has more than k examples
+		tree->query_knn(features_slice, k+1);
+		SGMatrix<index_t> target_slice = tree->get_knn_indices();
 
 		for (index_t j = 0; j < target_slice.num_cols; ++j)
 		{
-			for (index_t l = 1; l < target_slice.num_rows; ++l)
-				target_neighbors(l-1, idxsmap[j]) = idxsmap[ target_slice(l,j) ];
+			// skip the example itself, with duplicates it may not come first
+			index_t l = 0;
+			for (index_t m = 0; m < target_slice.num_rows && l < k; ++m)
+			{
+				if (target_slice(m,j) != j)
+					target_neighbors(l++, idxsmap[j]) = idxsmap[ target_slice(m,j) ];
+			}
 		}
-
-		// clean up knn
-		SG_UNREF(knn)
 	}
 
 	SG_SDEBUG("Leaving CLMNNImpl::find_target_nn().\n")
@@ -167,19 +164,25 @@ SGMatrix<float64_t> CLMNNImpl::sum_outer_products(
 	int32_t d = x->get_num_features();
 	// initialize the sum of outer products (sop)
 	SGMatrix<float64_t> sop(d, d);
-
-	auto X = x->get_feature_matrix();
-
-	// sum the outer products stored in C using the indices specified in target_nn
+	sop.zero();
+
+	// sum the outer products of the differences between the examples and the
+	// target neighbors specified in target_nn
+	std::vector<index_t> a, b;
+	std::vector<float64_t> weights;
+	a.reserve(target_nn.num_rows*target_nn.num_cols);
+	b.reserve(target_nn.num_rows*target_nn.num_cols);
 	for (index_t i = 0; i < target_nn.num_cols; ++i)
 	{
 		for (index_t j = 0; j < target_nn.num_rows; ++j)
 		{
-			auto dx = linalg::add(
-			    X.get_column(i), X.get_column(target_nn(j, i)), 1.0, -1.0);
-			linalg::rank_update(sop, dx);
+			a.push_back(i);
+			b.push_back(target_nn(j, i));
 		}
 	}
+	weights.assign(a.size(), 1.0);
+
+	CLMNNImpl::add_outer_products(x->get_feature_matrix(), a, b, weights, sop);
 
 	return sop;
 }
@@ -191,9 +194,6 @@ ImpostorsSetType CLMNNImpl::find_impostors(
 {
 	SG_SDEBUG("Entering CLMNNImpl::find_impostors().\n")
 
-	// get the number of neighbors
-	int32_t k = target_nn.num_rows;
-
 	auto X = x->get_feature_matrix();
 	// transform the feature vectors
 	auto LX = linalg::matrix_prod(L, X);
@@ -211,8 +211,10 @@ ImpostorsSetType CLMNNImpl::find_impostors(
 			"impostors set must be greater than 0\n")
 	if ((iter % correction)==0)
 	{
+		SGVector<index_t> examples(X.num_cols);
+		examples.range_fill();
 		Nexact = CLMNNImpl::find_impostors_exact(
-		    SGMatrix<float64_t>(LX), sqdists, y, target_nn, k);
+		    SGMatrix<float64_t>(LX), sqdists, y, target_nn, examples);
 		N = Nexact;
 	}
 	else
@@ -226,42 +228,59 @@ ImpostorsSetType CLMNNImpl::find_impostors(
 	return N;
 }
 
+ImpostorsSetType CLMNNImpl::find_impostors_minibatch(
+    CDenseFeatures<float64_t>* x, CMulticlassLabels* y,
+    const SGMatrix<float64_t>& L, const SGMatrix<index_t>& target_nn,
+    const SGVector<index_t>& examples)
+{
+	auto X = x->get_feature_matrix();
+	// transform the feature vectors
+	auto LX = linalg::matrix_prod(L, X);
+
+	// compute square distances plus margin from examples to target neighbors
+	auto sqdists = CLMNNImpl::compute_sqdists(LX, target_nn);
+
+	return CLMNNImpl::find_impostors_exact(
+	    SGMatrix<float64_t>(LX), sqdists, y, target_nn, examples);
+}
+
 void CLMNNImpl::update_gradient(
     CDenseFeatures<float64_t>* x, SGMatrix<float64_t>& G,
     const ImpostorsSetType& Nc, const ImpostorsSetType& Np,
     float64_t regularization)
 {
-	// compute the difference sets
-	ImpostorsSetType Np_Nc, Nc_Np;
-	set_difference(Np.begin(), Np.end(), Nc.begin(), Nc.end(), inserter(Np_Nc, Np_Nc.begin()));
-	set_difference(Nc.begin(), Nc.end(), Np.begin(), Np.end(), inserter(Nc_Np, Nc_Np.begin()));
-
-	auto X = x->get_feature_matrix();
-
-	// remove the gradient contributions of the impostors that were in the previous
-	// set but disappeared in the current
-	for (ImpostorsSetType::iterator it = Np_Nc.begin(); it != Np_Nc.end(); ++it)
+	// the impostors that were in the previous set but disappeared in the
+	// current remove their gradient contributions, the new impostors add them;
+	// G += regularization*(dx1*dx1' - dx2*dx2') for each new impostor
+	std::vector<index_t> a, b;
+	std::vector<float64_t> weights;
+	auto add_triplet = [&](const CImpostorNode& node, float64_t weight)
 	{
-		// G -= regularization*(dx1*dx1' - dx2*dx2');
-		auto dx1 = linalg::add(
-		    X.get_column(it->example), X.get_column(it->target), 1.0, -1.0);
-		auto dx2 = linalg::add(
-		    X.get_column(it->example), X.get_column(it->impostor), 1.0, -1.0);
-		linalg::rank_update(G, dx1, -regularization);
-		linalg::rank_update(G, dx2, regularization);
-	}
-
-	// add the gradient contributions of the new impostors
-	for (ImpostorsSetType::iterator it = Nc_Np.begin(); it != Nc_Np.end(); ++it)
+		a.push_back(node.example);
+		b.push_back(node.target);
+		weights.push_back(weight);
+		a.push_back(node.example);
+		b.push_back(node.impostor);
+		weights.push_back(-weight);
+	};
+
+	// walk both ordered sets at once to find the difference sets
+	auto it_c = Nc.begin();
+	auto it_p = Np.begin();
+	while (it_c != Nc.end() || it_p != Np.end())
 	{
-		// G += regularization*(dx1*dx1' - dx2*dx2');
-		auto dx1 = linalg::add(
-		    X.get_column(it->example), X.get_column(it->target), 1.0, -1.0);
-		auto dx2 = linalg::add(
-		    X.get_column(it->example), X.get_column(it->impostor), 1.0, -1.0);
-		linalg::rank_update(G, dx1, regularization);
-		linalg::rank_update(G, dx2, -regularization);
+		if (it_p == Np.end() || (it_c != Nc.end() && *it_c < *it_p))
+			add_triplet(*it_c++, regularization);
+		else if (it_c == Nc.end() || *it_p < *it_c)
+			add_triplet(*it_p++, -regularization);
+		else
+		{
+			++it_c;
+			++it_p;
+		}
 	}
+
+	CLMNNImpl::add_outer_products(x->get_feature_matrix(), a, b, weights, G);
 }
 
 void CLMNNImpl::gradient_step(
@@ -377,83 +396,78 @@ SGMatrix<float64_t> CLMNNImpl::compute_sqdists(
 
 	/// compute square distances to target neighbors plus margin
 
-	// create Shogun features from LX to later apply subset
-	CDenseFeatures<float64_t>* lx = new CDenseFeatures<float64_t>(LX);
-
 	// initialize distances
 	SGMatrix<float64_t> sqdists(k, n);
 
-	for (int32_t i = 0; i < k; ++i)
+#pragma omp parallel for
+	for (int32_t j = 0; j < n; ++j)
 	{
-		//FIXME avoid copying the rows of target_nn and access them directly. Maybe
-		//find_target_nn should be changed to return the output transposed wrt how it is
-		//done atm.
-		SGVector<index_t> subset_vec = target_nn.get_row_vector(i);
-		auto lx_subset = view(lx, subset_vec);
-		// after the subset, there are still n columns, i.e. the subset is used to
-		// modify the order of the columns in x according to the target neighbors
-		auto diff = linalg::add(LX, lx_subset->get_feature_matrix(), 1.0, -1.0);
-		auto sum = linalg::colwise_sum(linalg::element_prod(diff, diff));
-		for (int j = 0; j < sum.vlen; j++)
-			sqdists(i, j) = sum[j] + 1;
+		for (int32_t i = 0; i < k; ++i)
+			sqdists(i, j) = CLMNNImpl::sqdist(LX, j, target_nn(i, j)) + 1;
 	}
 
-	// clean up features used to apply subset
-	SG_UNREF(lx);
-
 	return sqdists;
 }
 
 ImpostorsSetType CLMNNImpl::find_impostors_exact(
     const SGMatrix<float64_t>& LX, const SGMatrix<float64_t>& sqdists,
-    CMulticlassLabels* y, const SGMatrix<index_t>& target_nn, int32_t k)
+    CMulticlassLabels* y, const SGMatrix<index_t>& target_nn,
+    const SGVector<index_t>& examples)
 {
 	SG_SDEBUG("Entering CLMNNImpl::find_impostors_exact().\n")
 
-	// initialize empty impostors set
-	ImpostorsSetType N = ImpostorsSetType();
+	// get the number of neighbors
+	int32_t k = target_nn.num_rows;
+	SGVector<float64_t> labels = y->get_labels();
 
-	// create Shogun features from LX to later apply subset
-	CDenseFeatures<float64_t>* lx = new CDenseFeatures<float64_t>(LX);
+	// index the transformed examples, the impostors of an example are the
+	// examples with a different label that are within the largest distance
+	// plus margin to its target neighbors
+	auto lx = some<CDenseFeatures<float64_t>>(LX);
+	auto tree = some<CBallTree>(LEAF_SIZE);
+	tree->build_tree(lx);
 
-	// get a vector with unique label values
-	SGVector<float64_t> unique = y->get_unique_labels();
+	std::vector<CImpostorNode> impostors;
 
-	// for each label except from the largest one
-	for (index_t i = 0; i < unique.vlen-1; ++i)
+#pragma omp parallel
 	{
-		// get the indices of the examples labelled as unique[i]
-		std::vector<index_t> iidxs = CLMNNImpl::get_examples_label(y,unique[i]);
-		// get the indices of the examples that have a larger label value, so that
-		// pairwise distances are computed once
-		std::vector<index_t> gtidxs = CLMNNImpl::get_examples_gtlabel(y,unique[i]);
-
-		// get distance with features indexed by iidxs and gtidxs separated
-		CEuclideanDistance* euclidean = CLMNNImpl::setup_distance(lx,iidxs,gtidxs);
-		euclidean->set_disable_sqrt(true);
+		std::vector<CImpostorNode> local_impostors;
 
-		for (int32_t j = 0; j < k; ++j)
+#pragma omp for schedule(dynamic, 64) nowait
+		for (index_t ii = 0; ii < examples.vlen; ++ii)
 		{
-			for (std::size_t ii = 0; ii < iidxs.size(); ++ii)
+			index_t i = examples[ii];
+			float64_t max_sqdist = 0;
+			for (int32_t j = 0; j < k; ++j)
+				max_sqdist = CMath::max(max_sqdist, sqdists(j,i));
+
+			// the search radius is enlarged slightly so that rounding in the
+			// tree does not drop impostors on the boundary
+			SGVector<float64_t> point(LX.get_column_vector(i), LX.num_rows, false);
+			SGVector<index_t> candidates = tree->query_radius(point,
+					std::sqrt(max_sqdist)*(1+1e-10));
+
+			for (auto c : candidates)
 			{
-				for (std::size_t jj = 0; jj < gtidxs.size(); ++jj)
-				{
-					// FIXME study if using upper bounded distances can be an improvement
-					float64_t distance = euclidean->distance(ii,jj);
-
-					if (distance <= sqdists(j,iidxs[ii]))
-						N.insert( CImpostorNode(iidxs[ii], target_nn(j,iidxs[ii]), gtidxs[jj]) );
+				if (labels[c] == labels[i])
+					continue;
 
-					if (distance <= sqdists(j,gtidxs[jj]))
-						N.insert( CImpostorNode(gtidxs[jj], target_nn(j,gtidxs[jj]), iidxs[ii]) );
+				float64_t distance = CLMNNImpl::sqdist(LX, i, c);
+				for (int32_t j = 0; j < k; ++j)
+				{
+					if (distance <= sqdists(j,i))
+						local_impostors.emplace_back(i, target_nn(j,i), c);
 				}
 			}
 		}
 
-		SG_UNREF(euclidean);
+#pragma omp critical
+		impostors.insert(impostors.end(), local_impostors.begin(), local_impostors.end());
 	}
 
-	SG_UNREF(lx);
+	// a sorted sequence is inserted into the set in linear time
+	std::sort(impostors.begin(), impostors.end());
+	ImpostorsSetType N(impostors.begin(), impostors.end());
 
 	SG_SDEBUG("Leaving CLMNNImpl::find_impostors_exact().\n")
 
@@ -466,27 +480,39 @@ ImpostorsSetType CLMNNImpl::find_impostors_approx(
 {
 	SG_SDEBUG("Entering CLMNNImpl::find_impostors_approx().\n")
 
-	// initialize empty impostors set
-	ImpostorsSetType N = ImpostorsSetType();
-
 	// compute square distances from examples to impostors
 	SGVector<float64_t> impostors_sqdists = CLMNNImpl::compute_impostors_sqdists(LX,Nexact);
 
 	// find in the exact set of impostors computed last, the triplets that remain impostors
-	index_t i = 0;
-	for (ImpostorsSetType::iterator it = Nexact.begin(); it != Nexact.end(); ++it)
+	std::vector<CImpostorNode> nodes(Nexact.begin(), Nexact.end());
+	std::vector<char> remains(nodes.size());
+	bool target_found = true;
+
+#pragma omp parallel for reduction(&&:target_found)
+	for (index_t i = 0; i < index_t(nodes.size()); ++i)
 	{
-		// find in target_nn(:,it->example) the position of the target neighbor it->target
+		const auto& node = nodes[i];
+		// find in target_nn(:,node.example) the position of the target neighbor node.target
 		index_t target_idx = 0;
-		while (target_nn(target_idx, it->example)!=it->target && target_idx<target_nn.num_rows)
+		while (target_idx<target_nn.num_rows && target_nn(target_idx, node.example)!=node.target)
 			++target_idx;
 
-		REQUIRE(target_idx<target_nn.num_rows, "The index of the target neighbour in the "
-				"impostors set was not found in the target neighbours matrix. "
-				"There must be a bug in find_impostors_exact.\n")
+		if (target_idx<target_nn.num_rows)
+			remains[i] = impostors_sqdists[i] <= sqdists(target_idx, node.example);
+		else
+			target_found = false;
+	}
+
+	REQUIRE(target_found, "The index of the target neighbour in the "
+			"impostors set was not found in the target neighbours matrix. "
+			"There must be a bug in find_impostors_exact.\n")
 
-		if ( impostors_sqdists[i++] <= sqdists(target_idx, it->example) )
-			N.insert(*it);
+	// the nodes are still in order
+	ImpostorsSetType N;
+	for (std::size_t i = 0; i < nodes.size(); ++i)
+	{
+		if (remains[i])
+			N.insert(N.end(), nodes[i]);
 	}
 
 	SG_SDEBUG("Leaving CLMNNImpl::find_impostors_approx().\n")
@@ -501,66 +527,92 @@ SGVector<float64_t> CLMNNImpl::compute_impostors_sqdists(
 	size_t num_impostors = Nexact.size();
 
 	/// compute square distances to impostors
-
-	// create Shogun features from LX and distance
-	CDenseFeatures<float64_t>* lx = new CDenseFeatures<float64_t>(LX);
-	CEuclideanDistance* euclidean = new CEuclideanDistance(lx,lx);
-	euclidean->set_disable_sqrt(true);
+	std::vector<CImpostorNode> nodes(Nexact.begin(), Nexact.end());
 
 	// initialize vector of square distances
 	SGVector<float64_t> sqdists(num_impostors);
 	// compute square distances
-	index_t i = 0;
-	for (ImpostorsSetType::iterator it = Nexact.begin(); it != Nexact.end(); ++it)
-		sqdists[i++] = euclidean->distance(it->example,it->impostor);
-
-	// clean up distance
-	SG_UNREF(euclidean);
+#pragma omp parallel for
+	for (index_t i = 0; i < index_t(num_impostors); ++i)
+		sqdists[i] = CLMNNImpl::sqdist(LX, nodes[i].example, nodes[i].impostor);
 
 	return sqdists;
 }
 
-std::vector<index_t> CLMNNImpl::get_examples_label(CMulticlassLabels* y,
-		float64_t yi)
+float64_t CLMNNImpl::sqdist(const SGMatrix<float64_t>& X, index_t i, index_t j)
 {
-	// indices of the examples with label equal to yi
-	std::vector<index_t> idxs;
+	const float64_t* xi = X.get_column_vector(i);
+	const float64_t* xj = X.get_column_vector(j);
+	float64_t result = 0;
+	for (index_t l = 0; l < X.num_rows; ++l)
+		result += (xi[l]-xj[l])*(xi[l]-xj[l]);
 
-	for (index_t i = 0; i < index_t(y->get_num_labels()); ++i)
+	return result;
+}
+
+void CLMNNImpl::add_outer_products(
+    const SGMatrix<float64_t>& X, const std::vector<index_t>& a,
+    const std::vector<index_t>& b, const std::vector<float64_t>& weights,
+    SGMatrix<float64_t>& G)
+{
+	int32_t d = X.num_rows;
+	index_t num_pairs = a.size();
+	if (!num_pairs)
+		return;
+
+	// the differences are gathered in blocks of columns, each block adds
+	// D*W*D' to the partial sum of its range of blocks
+	index_t num_blocks = (num_pairs + BLOCK_SIZE - 1) / BLOCK_SIZE;
+	index_t num_partials = CMath::min(num_blocks, MAX_PARTIAL_SUMS);
+	std::vector<SGMatrix<float64_t>> partial(num_partials);
+
+#pragma omp parallel for schedule(dynamic)
+	for (index_t k = 0; k < num_partials; ++k)
 	{
-		if (y->get_label(i) == yi)
-			idxs.push_back(i);
+		SGMatrix<float64_t> local_G(d, d);
+		local_G.zero();
+
+		index_t first = int64_t(num_blocks) * k / num_partials;
+		index_t last = int64_t(num_blocks) * (k + 1) / num_partials;
+		for (index_t block = first; block < last; ++block)
+		{
+			index_t start = block * BLOCK_SIZE;
+			index_t size = CMath::min(BLOCK_SIZE, num_pairs - start);
+			SGMatrix<float64_t> D(d, size);
+			SGMatrix<float64_t> DW(d, size);
+			for (index_t p = 0; p < size; ++p)
+			{
+				const float64_t* xa = X.get_column_vector(a[start+p]);
+				const float64_t* xb = X.get_column_vector(b[start+p]);
+				float64_t weight = weights[start+p];
+				for (int32_t l = 0; l < d; ++l)
+				{
+					D(l, p) = xa[l]-xb[l];
+					DW(l, p) = weight*D(l, p);
+				}
+			}
+
+			linalg::dgemm(1.0, DW, D, false, true, 1.0, local_G);
+		}
+		partial[k] = local_G;
 	}
 
-	return idxs;
+	// summed in the order of the blocks for reproducible results
+	for (index_t k = 0; k < num_partials; ++k)
+		linalg::add(G, partial[k], G);
 }
 
-std::vector<index_t> CLMNNImpl::get_examples_gtlabel(CMulticlassLabels* y,
+std::vector<index_t> CLMNNImpl::get_examples_label(CMulticlassLabels* y,
 		float64_t yi)
 {
-	// indices of the examples with label equal greater than yi
+	// indices of the examples with label equal to yi
 	std::vector<index_t> idxs;
 
 	for (index_t i = 0; i < index_t(y->get_num_labels()); ++i)
 	{
-		if (y->get_label(i) > yi)
+		if (y->get_label(i) == yi)
 			idxs.push_back(i);
 	}
 
 	return idxs;
 }
-
-CEuclideanDistance* CLMNNImpl::setup_distance(CDenseFeatures<float64_t>* x,
-		std::vector<index_t>& a, std::vector<index_t>& b)
-{
-	// create new features only containing examples whose indices are in a
-	auto afeats = view(x, SGVector<index_t>(a.data(), a.size(), false));
-
-	// create new features only containing examples whose indices are in b
-	auto bfeats = view(x, SGVector<index_t>(b.data(), b.size(), false));
-
-	// create and return distance
-	CEuclideanDistance* euclidean = new CEuclideanDistance(afeats,bfeats);
-	return euclidean;
-}
-
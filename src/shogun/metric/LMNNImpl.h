@@ -14,7 +14,6 @@
 #include <shogun/lib/SGMatrix.h>
 #include <shogun/features/DenseFeatures.h>
 #include <shogun/labels/MulticlassLabels.h>
-#include <shogun/distance/EuclideanDistance.h>
 
 #include <set>
 #include <vector>
@@ -98,6 +97,15 @@ class CLMNNImpl
 		    const SGMatrix<float64_t>& L, const SGMatrix<index_t>& target_nn,
 		    const int32_t iter, const int32_t correction);
 
+		/**
+		 * find the impostors of the examples in a minibatch after applying the
+		 * transformation L, always computed exactly
+		 */
+		static ImpostorsSetType find_impostors_minibatch(
+		    CDenseFeatures<float64_t>* x, CMulticlassLabels* y,
+		    const SGMatrix<float64_t>& L, const SGMatrix<index_t>& target_nn,
+		    const SGVector<index_t>& examples);
+
 		/** update the gradient using the last transition in the impostors sets */
 		static void update_gradient(
 		    CDenseFeatures<float64_t>* x, SGMatrix<float64_t>& G,
@@ -126,6 +134,16 @@ class CLMNNImpl
 
 	private:
 
+		/** leaf size of the ball trees used in the neighbors searches */
+		static const int32_t LEAF_SIZE = 16;
+
+		/** number of vector differences gathered for a matrix product */
+		static const index_t BLOCK_SIZE = 256;
+
+		/** maximum number of partial sums of outer products, each one sums
+		 * a fixed range of blocks */
+		static const index_t MAX_PARTIAL_SUMS = 64;
+
 		/** initial default transform given by PCA */
 		static SGMatrix<float64_t> compute_pca_transform(CDenseFeatures<float64_t>* features);
 
@@ -143,29 +161,36 @@ class CLMNNImpl
 		static SGVector<float64_t> compute_impostors_sqdists(
 		    const SGMatrix<float64_t>& L, const ImpostorsSetType& Nexact);
 
-		/** find impostors; variant computing the impostors exactly, using all the data */
+		/**
+		 * find impostors; variant computing the impostors exactly of the given
+		 * examples, searching the transformed examples in a ball tree
+		 */
 		static ImpostorsSetType find_impostors_exact(
 		    const SGMatrix<float64_t>& LX, const SGMatrix<float64_t>& sqdists,
 		    CMulticlassLabels* y, const SGMatrix<index_t>& target_nn,
-		    int32_t k);
+		    const SGVector<index_t>& examples);
 
 		/** find impostors; approximate variant, using the last exact set of impostors */
 		static ImpostorsSetType find_impostors_approx(
 		    const SGMatrix<float64_t>& LX, const SGMatrix<float64_t>& sqdists,
 		    const ImpostorsSetType& Nexact, const SGMatrix<index_t>& target_nn);
 
-		/** get the indices of the examples whose label is equal to yi */
-		static std::vector<index_t> get_examples_label(CMulticlassLabels* y, float64_t yi);
-
-		/** get the indices of the examples whose label is greater than yi */
-		static std::vector<index_t> get_examples_gtlabel(CMulticlassLabels* y, float64_t yi);
+		/** square Euclidean distance between the columns i and j of X */
+		static float64_t sqdist(const SGMatrix<float64_t>& X, index_t i, index_t j);
 
 		/**
-		 * create Euclidean distance where the lhs features are the features in x indexed
-		 * by the elements in a, and the rhs features are the ones indexed by b; caller
-		 * is responsible of releasing memory
+		 * add to G the outer products of the differences between the columns of X
+		 * indexed by a and b, each weighted by the corresponding element of
+		 * weights; the products are summed in blocks and in parallel, in an
+		 * order that does not depend on the number of threads
 		 */
-		static CEuclideanDistance* setup_distance(CDenseFeatures<float64_t>* x, std::vector<index_t>& a, std::vector<index_t>& b);
+		static void add_outer_products(
+		    const SGMatrix<float64_t>& X, const std::vector<index_t>& a,
+		    const std::vector<index_t>& b, const std::vector<float64_t>& weights,
+		    SGMatrix<float64_t>& G);
+
+		/** get the indices of the examples whose label is equal to yi */
+		static std::vector<index_t> get_examples_label(CMulticlassLabels* y, float64_t yi);
 
 		/**
 		 * check that k is less than the minimum number of examples in any
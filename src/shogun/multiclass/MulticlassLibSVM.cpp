@@ -9,6 +9,9 @@
 #include <shogun/multiclass/MulticlassOneVsOneStrategy.h>
 #include <shogun/labels/MulticlassLabels.h>
 #include <shogun/io/SGIO.h>
+#include <shogun/kernel/KernelRowCache.h>
+
+#include <memory>
 
 using namespace shogun;
 
@@ -103,7 +106,14 @@ bool CMulticlassLibSVM::train_machine(CFeatures* data)
 	if(error_msg)
 		SG_ERROR("Error: %s\n",error_msg)
 
-	model = svm_train(&problem, &param);
+	{
+		/* the one-vs-one sub-problems share the rows of their classes */
+		std::unique_ptr<KernelRowCache> row_cache;
+		if (get_shared_kernel_cache() && m_kernel->get_kernel_type()!=K_CUSTOM)
+			row_cache.reset(new KernelRowCache(m_kernel, param.cache_size));
+
+		model = svm_train(&problem, &param);
+	}
 
 	if (model)
 	{
@@ -10,6 +10,8 @@
 #include <shogun/labels/MulticlassLabels.h>
 #include <shogun/mathematics/Math.h>
 
+#include <algorithm>
+
 using namespace shogun;
 
 CMulticlassOneVsOneStrategy::CMulticlassOneVsOneStrategy()
@@ -90,7 +92,7 @@ int32_t CMulticlassOneVsOneStrategy::decide_label(SGVector<float64_t> outputs)
 
 	int32_t s=0;
 	SGVector<int32_t> votes(m_num_classes);
-    SGVector<int32_t> dec_vals(m_num_classes);
+    SGVector<float64_t> dec_vals(m_num_classes);
 	votes.zero();
     dec_vals.zero();
 
@@ -137,6 +139,90 @@ int32_t CMulticlassOneVsOneStrategy::decide_label(SGVector<float64_t> outputs)
     return i_max;
 }
 
+SGVector<int32_t> CMulticlassOneVsOneStrategy::decide_labels(SGMatrix<float64_t> outputs)
+{
+	// if OVO with prob outputs, find max posterior
+	if (outputs.num_cols==m_num_classes)
+		return decide_labels_arg_max(outputs);
+
+	REQUIRE(outputs.num_cols==m_num_classes*(m_num_classes-1)/2,
+			"%s::decide_labels(): Number of outputs (%d) must match the number "
+			"of machines (%d)\n", get_name(), outputs.num_cols,
+			m_num_classes*(m_num_classes-1)/2);
+
+	int32_t num_vectors=outputs.num_rows;
+	SGVector<int32_t> labels(num_vectors);
+
+#pragma omp parallel
+	{
+		/* votes and decision values of a block, a column per class */
+		SGMatrix<int32_t> votes(DECISION_BLOCK_SIZE, m_num_classes);
+		SGMatrix<float64_t> dec_vals(DECISION_BLOCK_SIZE, m_num_classes);
+
+#pragma omp for
+		for (int32_t begin=0; begin<num_vectors; begin+=DECISION_BLOCK_SIZE)
+		{
+			int32_t len=std::min(num_vectors-begin, DECISION_BLOCK_SIZE);
+			votes.zero();
+			dec_vals.zero();
+
+			int32_t s=0;
+			for (int32_t i=0; i<m_num_classes; i++)
+			{
+				for (int32_t j=i+1; j<m_num_classes; j++)
+				{
+					const float64_t* column=outputs.get_column_vector(s)+begin;
+					int32_t* votes_i=votes.get_column_vector(i);
+					int32_t* votes_j=votes.get_column_vector(j);
+					float64_t* dec_vals_i=dec_vals.get_column_vector(i);
+					float64_t* dec_vals_j=dec_vals.get_column_vector(j);
+
+					for (int32_t r=0; r<len; r++)
+					{
+						if (column[r]>0)
+						{
+							votes_i[r]++;
+							dec_vals_i[r] += CMath::abs(column[r]);
+						}
+						else
+						{
+							votes_j[r]++;
+							dec_vals_j[r] += CMath::abs(column[r]);
+						}
+					}
+					s++;
+				}
+			}
+
+			// the most votes win, ties go to the larger decision value
+			for (int32_t r=0; r<len; r++)
+			{
+				int32_t i_max=0;
+				int32_t vote_max=-1;
+				float64_t dec_val_max=-1;
+
+				for (int32_t i=0; i<m_num_classes; i++)
+				{
+					if (votes(r, i) > vote_max)
+					{
+						i_max = i;
+						vote_max = votes(r, i);
+						dec_val_max = dec_vals(r, i);
+					}
+					else if (votes(r, i) == vote_max && dec_vals(r, i) > dec_val_max)
+					{
+						i_max = i;
+						dec_val_max = dec_vals(r, i);
+					}
+				}
+				labels[begin+r]=i_max;
+			}
+		}
+	}
+
+	return labels;
+}
+
 void CMulticlassOneVsOneStrategy::rescale_outputs(SGVector<float64_t> outputs)
 {
 	if (m_num_machines < 1)
@@ -46,11 +46,21 @@ public:
 	 */
 	virtual SGVector<int32_t> train_prepare_next();
 
-	/** decide the final label.
+	/** decide the final label. The class with the most votes wins, a tie
+	 * goes to the class with the larger sum of absolute outputs of the
+	 * machines that voted for it.
 	 * @param outputs a vector of output from each machine (in that order)
 	 */
 	virtual int32_t decide_label(SGVector<float64_t> outputs);
 
+	/** decide the final labels of many vectors at once, voting over
+	 * blocks of vectors machine by machine, same as decide_label()
+	 * @param outputs num_vectors x num_machines matrix of outputs, or
+	 * num_vectors x num_classes posteriors
+	 * @return label of each vector
+	 */
+	virtual SGVector<int32_t> decide_labels(SGMatrix<float64_t> outputs);
+
 	/** get number of machines used in this strategy.
 	 */
 	virtual int32_t get_num_machines()
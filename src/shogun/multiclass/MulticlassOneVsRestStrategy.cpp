@@ -10,6 +10,8 @@
 #include <shogun/labels/MulticlassLabels.h>
 #include <shogun/mathematics/Math.h>
 
+#include <algorithm>
+
 using namespace shogun;
 
 CMulticlassOneVsRestStrategy::CMulticlassOneVsRestStrategy()
@@ -46,6 +48,14 @@ int32_t CMulticlassOneVsRestStrategy::decide_label(SGVector<float64_t> outputs)
 	return CMath::arg_max(outputs.vector, 1, outputs.vlen);
 }
 
+SGVector<int32_t> CMulticlassOneVsRestStrategy::decide_labels(SGMatrix<float64_t> outputs)
+{
+	if (m_rejection_strategy)
+		return CMulticlassStrategy::decide_labels(outputs);
+
+	return decide_labels_arg_max(outputs);
+}
+
 SGVector<index_t> CMulticlassOneVsRestStrategy::decide_label_multiple_output(SGVector<float64_t> outputs, int32_t n_outputs)
 {
 	float64_t* outputs_ = SG_MALLOC(float64_t, outputs.vlen);
@@ -91,6 +101,57 @@ void CMulticlassOneVsRestStrategy::rescale_outputs(SGVector<float64_t> outputs,
 		rescale_outputs(outputs);
 }
 
+SGMatrix<float64_t> CMulticlassOneVsRestStrategy::rescale_all_outputs(
+		SGMatrix<float64_t> outputs, const SGVector<float64_t> As,
+		const SGVector<float64_t> Bs)
+{
+	bool softmax=get_prob_heuris_type()==OVA_SOFTMAX;
+	if (!softmax && get_prob_heuris_type()!=OVA_NORM)
+		return CMulticlassStrategy::rescale_all_outputs(outputs, As, Bs);
+
+	if (m_num_classes != outputs.num_cols)
+	{
+		SG_ERROR("%s::rescale_all_outputs(): number of outputs = %d != m_num_classes = %d\n",
+				get_name(), outputs.num_cols, m_num_classes);
+	}
+
+	int32_t num_vectors=outputs.num_rows;
+
+	/* column by column over blocks of vectors, which vectorizes */
+#pragma omp parallel for
+	for (int32_t begin=0; begin<num_vectors; begin+=DECISION_BLOCK_SIZE)
+	{
+		int32_t len=std::min(num_vectors-begin, DECISION_BLOCK_SIZE);
+		float64_t norms[DECISION_BLOCK_SIZE];
+		std::fill_n(norms, len, 0.0);
+
+		for (int32_t j=0; j<outputs.num_cols; j++)
+		{
+			float64_t* column=outputs.get_column_vector(j)+begin;
+			if (softmax)
+			{
+				for (int32_t i=0; i<len; i++)
+					column[i] = std::exp(-As[j] * column[i] - Bs[j]);
+			}
+
+			for (int32_t i=0; i<len; i++)
+				norms[i] += column[i];
+		}
+
+		for (int32_t i=0; i<len; i++)
+			norms[i] += 1E-10;
+
+		for (int32_t j=0; j<outputs.num_cols; j++)
+		{
+			float64_t* column=outputs.get_column_vector(j)+begin;
+			for (int32_t i=0; i<len; i++)
+				column[i] /= norms[i];
+		}
+	}
+
+	return outputs;
+}
+
 void CMulticlassOneVsRestStrategy::rescale_heuris_norm(SGVector<float64_t> outputs)
 {
 	if (m_num_classes != outputs.vlen)
@@ -62,6 +62,13 @@ public:
 	 */
 	virtual int32_t decide_label(SGVector<float64_t> outputs);
 
+	/** decide the final labels of many vectors at once, the maximum
+	 * output of each vector unless there is a rejection strategy
+	 * @param outputs num_vectors x num_machines matrix of outputs
+	 * @return label of each vector
+	 */
+	virtual SGVector<int32_t> decide_labels(SGMatrix<float64_t> outputs);
+
 	/** decide the final label.
 	 * @param outputs a vector of output from each machine (in that order)
 	 * @param n_outputs number of outputs
@@ -95,6 +102,18 @@ public:
 	virtual void rescale_outputs(SGVector<float64_t> outputs,
 			const SGVector<float64_t> As, const SGVector<float64_t> Bs);
 
+	/** rescale the outputs of many vectors at once, column by column
+	 * @param outputs num_vectors x num_machines matrix of outputs, rescaled
+	 * in place
+	 * @param As fitted sigmoid parameters a one for each machine, only used
+	 * with OVA_SOFTMAX
+	 * @param Bs fitted sigmoid parameters b one for each machine, only used
+	 * with OVA_SOFTMAX
+	 * @return the rescaled outputs
+	 */
+	virtual SGMatrix<float64_t> rescale_all_outputs(SGMatrix<float64_t> outputs,
+			const SGVector<float64_t> As, const SGVector<float64_t> Bs);
+
 protected:
 	/** OVA normalization heuristic
 	 * @param outputs a vector of output from each machine (in that order)
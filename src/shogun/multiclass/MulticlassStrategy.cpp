@@ -8,8 +8,11 @@
 #include <shogun/multiclass/MulticlassStrategy.h>
 #include <shogun/mathematics/Math.h>
 
+#include <algorithm>
+
 using namespace shogun;
 
+const int32_t CMulticlassStrategy::DECISION_BLOCK_SIZE;
 
 CMulticlassStrategy::CMulticlassStrategy()
 	: CSGObject()
@@ -69,3 +72,114 @@ void CMulticlassStrategy::train_stop()
     m_train_labels = NULL;
     m_orig_labels = NULL;
 }
+
+SGVector<int32_t> CMulticlassStrategy::decide_labels(SGMatrix<float64_t> outputs)
+{
+	int32_t num_vectors=outputs.num_rows;
+	SGVector<int32_t> labels(num_vectors);
+	if (!num_vectors)
+		return labels;
+
+	/* errors of the configuration surface on the first vector, outside of
+	 * the parallel region */
+	SGVector<float64_t> outputs_for_first=outputs.get_row_vector(0);
+	labels[0]=decide_label(outputs_for_first);
+
+#pragma omp parallel
+	{
+		SGVector<float64_t> outputs_for_i(outputs.num_cols);
+
+#pragma omp for
+		for (int32_t i=1; i<num_vectors; i++)
+		{
+			for (int32_t j=0; j<outputs.num_cols; j++)
+				outputs_for_i[j]=outputs(i, j);
+
+			labels[i]=decide_label(outputs_for_i);
+		}
+	}
+
+	return labels;
+}
+
+SGMatrix<float64_t> CMulticlassStrategy::rescale_all_outputs(
+		SGMatrix<float64_t> outputs, const SGVector<float64_t> As,
+		const SGVector<float64_t> Bs)
+{
+	int32_t num_vectors=outputs.num_rows;
+	SGMatrix<float64_t> result(num_vectors, m_num_classes);
+	bool softmax=get_prob_heuris_type()==OVA_SOFTMAX;
+
+	auto rescale_vector=[&](SGVector<float64_t> outputs_for_i, int32_t i)
+	{
+		for (int32_t j=0; j<outputs.num_cols; j++)
+			outputs_for_i[j]=outputs(i, j);
+
+		if (softmax)
+			rescale_outputs(outputs_for_i, As, Bs);
+		else
+			rescale_outputs(outputs_for_i);
+
+		/* only the first num_classes are returned */
+		for (int32_t j=0; j<m_num_classes; j++)
+			result(i, j)=outputs_for_i[j];
+	};
+
+	if (!num_vectors)
+		return result;
+
+	/* errors of the configuration surface on the first vector, outside of
+	 * the parallel region */
+	rescale_vector(SGVector<float64_t>(outputs.num_cols), 0);
+
+#pragma omp parallel
+	{
+		SGVector<float64_t> outputs_for_i(outputs.num_cols);
+
+#pragma omp for
+		for (int32_t i=1; i<num_vectors; i++)
+			rescale_vector(outputs_for_i, i);
+	}
+
+	return result;
+}
+
+SGVector<int32_t> CMulticlassStrategy::decide_labels_arg_max(
+		SGMatrix<float64_t> outputs)
+{
+	int32_t num_vectors=outputs.num_rows;
+	SGVector<int32_t> labels(num_vectors);
+	if (!outputs.num_cols)
+		return labels;
+
+	/* column by column over blocks of vectors, which vectorizes */
+#pragma omp parallel for
+	for (int32_t begin=0; begin<num_vectors; begin+=DECISION_BLOCK_SIZE)
+	{
+		int32_t len=std::min(num_vectors-begin, DECISION_BLOCK_SIZE);
+		int32_t* block_labels=labels.vector+begin;
+		float64_t max_outputs[DECISION_BLOCK_SIZE];
+
+		const float64_t* first=outputs.get_column_vector(0)+begin;
+		for (int32_t i=0; i<len; i++)
+		{
+			max_outputs[i]=first[i];
+			block_labels[i]=0;
+		}
+
+		for (int32_t j=1; j<outputs.num_cols; j++)
+		{
+			const float64_t* column=outputs.get_column_vector(j)+begin;
+			for (int32_t i=0; i<len; i++)
+			{
+				if (column[i]>max_outputs[i])
+				{
+					max_outputs[i]=column[i];
+					block_labels[i]=j;
+				}
+			}
+		}
+	}
+
+	return labels;
+}
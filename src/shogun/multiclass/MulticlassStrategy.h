@@ -108,6 +108,16 @@ public:
 	 */
 	virtual int32_t decide_label(SGVector<float64_t> outputs)=0;
 
+	/** decide the final labels of many vectors at once, by default with
+	 * decide_label() for each vector in parallel. Strategies whose
+	 * decide_label() is not safe to call from several threads at once must
+	 * override this method.
+	 * @param outputs num_vectors x num_outputs matrix, whose i-th row holds
+	 * the outputs of the i-th vector as passed to decide_label()
+	 * @return label of each vector
+	 */
+	virtual SGVector<int32_t> decide_labels(SGMatrix<float64_t> outputs);
+
 	/** decide the final label.
 	 * @param outputs a vector of output from each machine (in that order)
 	 * @param n_outputs number of outputs
@@ -159,6 +169,32 @@ public:
 		SG_NOTIMPLEMENTED
 	}
 
+	/** rescale the outputs of many vectors at once according to the
+	 * selected heuristic, by default with rescale_outputs() for each vector
+	 * in parallel. Strategies whose rescale_outputs() is not safe to call
+	 * from several threads at once must override this method.
+	 * @param outputs num_vectors x num_machines matrix, whose i-th row holds
+	 * the outputs of the i-th vector, may be overwritten
+	 * @param As fitted sigmoid parameters a one for each machine, only used
+	 * with OVA_SOFTMAX
+	 * @param Bs fitted sigmoid parameters b one for each machine, only used
+	 * with OVA_SOFTMAX
+	 * @return num_vectors x num_classes matrix of rescaled outputs
+	 */
+	virtual SGMatrix<float64_t> rescale_all_outputs(SGMatrix<float64_t> outputs,
+			const SGVector<float64_t> As, const SGVector<float64_t> Bs);
+
+protected:
+	/** the index of the maximum output of each vector, the first one if
+	 * several are maximal
+	 * @param outputs num_vectors x num_outputs matrix of outputs
+	 * @return index of the maximum output of each vector
+	 */
+	SGVector<int32_t> decide_labels_arg_max(SGMatrix<float64_t> outputs);
+
+	/** number of vectors whose outputs are processed together */
+	static const int32_t DECISION_BLOCK_SIZE=256;
+
 private:
 	/** initialize variables which will be called by all constructors */
 	void init();
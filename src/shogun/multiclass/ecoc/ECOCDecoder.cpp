@@ -9,6 +9,35 @@
 
 using namespace shogun;
 
+SGVector<int32_t> CECOCDecoder::decide_labels(const SGMatrix<float64_t> outputs, const SGMatrix<int32_t> codebook)
+{
+    int32_t num_vectors = outputs.num_rows;
+    SGVector<int32_t> labels(num_vectors);
+    if (!num_vectors)
+        return labels;
+
+    /* the first vector is decided outside of the parallel region, errors
+     * are raised there and state computed on first use, e.g. by
+     * CECOCIHDDecoder, is only read by the threads */
+    labels[0] = decide_label(outputs.get_row_vector(0), codebook);
+
+#pragma omp parallel
+    {
+        SGVector<float64_t> query(outputs.num_cols);
+
+#pragma omp for
+        for (int32_t i=1; i < num_vectors; ++i)
+        {
+            for (int32_t j=0; j < outputs.num_cols; ++j)
+                query[j] = outputs(i, j);
+
+            labels[i] = decide_label(query, codebook);
+        }
+    }
+
+    return labels;
+}
+
 SGVector<float64_t> CECOCDecoder::binarize(const SGVector<float64_t> query)
 {
     SGVector<float64_t> bquery(query.vlen);
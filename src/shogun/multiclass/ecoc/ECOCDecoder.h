@@ -43,6 +43,17 @@ public:
      */
     virtual int32_t decide_label(const SGVector<float64_t> outputs, const SGMatrix<int32_t> codebook)=0;
 
+    /** decide the labels of many vectors at once, by default with
+     * decide_label() for each vector in parallel. The first vector is
+     * decided alone, decoders that compute state on first use may do so,
+     * otherwise decide_label() must be safe to call from several threads
+     * at once or this method be overridden.
+     * @param outputs num_vectors x num_machines outputs by classifiers
+     * @param codebook ECOC codebook
+     * @return label of each vector
+     */
+    virtual SGVector<int32_t> decide_labels(const SGMatrix<float64_t> outputs, const SGMatrix<int32_t> codebook);
+
 protected:
     /** turn 2-class labels into binary */
     SGVector<float64_t> binarize(const SGVector<float64_t> query);
@@ -23,3 +23,35 @@ int32_t CECOCSimpleDecoder::decide_label(const SGVector<float64_t> outputs, cons
     int32_t result = CMath::arg_min(distances.vector, 1, distances.vlen);
     return result;
 }
+
+SGVector<int32_t> CECOCSimpleDecoder::decide_labels(const SGMatrix<float64_t> outputs, const SGMatrix<int32_t> codebook)
+{
+    int32_t num_vectors = outputs.num_rows;
+    SGVector<int32_t> labels(num_vectors);
+    bool binary = binary_decoding();
+
+#pragma omp parallel
+    {
+        SGVector<float64_t> query(outputs.num_cols);
+        SGVector<float64_t> distances(codebook.num_cols);
+
+#pragma omp for
+        for (int32_t i=0; i < num_vectors; ++i)
+        {
+            for (int32_t j=0; j < outputs.num_cols; ++j)
+            {
+                if (binary)
+                    query[j] = outputs(i, j) >= 0 ? +1.0 : -1.0;
+                else
+                    query[j] = outputs(i, j);
+            }
+
+            for (int32_t k=0; k < distances.vlen; ++k)
+                distances[k] = compute_distance(query, codebook.get_column_vector(k));
+
+            labels[i] = CMath::arg_min(distances.vector, 1, distances.vlen);
+        }
+    }
+
+    return labels;
+}
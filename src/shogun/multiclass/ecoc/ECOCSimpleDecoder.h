@@ -37,6 +37,14 @@ public:
      */
     virtual int32_t decide_label(const SGVector<float64_t> outputs, const SGMatrix<int32_t> codebook);
 
+    /** decide the labels of many vectors at once, in parallel and with
+     * the query and distances held per thread
+     * @param outputs num_vectors x num_machines outputs by classifiers
+     * @param codebook ECOC codebook
+     * @return label of each vector
+     */
+    virtual SGVector<int32_t> decide_labels(const SGMatrix<float64_t> outputs, const SGMatrix<int32_t> codebook);
+
 protected:
     /** whether to turn the output into binary before decoding */
     virtual bool binary_decoding()=0;
@@ -84,6 +84,11 @@ int32_t CECOCStrategy::decide_label(SGVector<float64_t> outputs)
     return m_decoder->decide_label(outputs, m_codebook);
 }
 
+SGVector<int32_t> CECOCStrategy::decide_labels(SGMatrix<float64_t> outputs)
+{
+    return m_decoder->decide_labels(outputs, m_codebook);
+}
+
 int32_t CECOCStrategy::get_num_machines()
 {
     return m_codebook.num_cols;
@@ -29,91 +29,98 @@
  */
 
 #include <shogun/multiclass/tree/BallTree.h>
+#include <shogun/base/Parameter.h>
+
+#include <algorithm>
 
 using namespace shogun;
 
 CBallTree::CBallTree(int32_t leaf_size, EDistanceType d)
 : CNbodyTree(leaf_size,d)
 {
+	init();
+}
+
+NbodyTreeNodeData CBallTree::get_node_data(index_t node) const
+{
+	NbodyTreeNodeData data=CNbodyTree::get_node_data(node);
+	data.center=SGVector<float64_t>(m_dim);
+	std::copy_n(m_node_center.get_column_vector(node),m_dim,data.center.vector);
+	return data;
 }
 
-float64_t CBallTree::min_dist(bnode_t* node,float64_t* feat, int32_t dim)
+float64_t CBallTree::min_dist(index_t node, const float64_t* feat) const
 {
-	float64_t dist=0;
-	SGVector<float64_t> center=node->data.center;
-	for (int32_t i=0;i<dim;i++)
-		dist+=add_dim_dist(center[i]-feat[i]);
+	float64_t dist=distance(m_node_center.get_column_vector(node),feat);
+	return CMath::max(0.0,dist-m_node_radius[node]);
+}
 
-	dist=actual_dists(dist);
-	return CMath::max(0.0,dist-node->data.radius);
+float64_t CBallTree::center_dist(const CBallTree* query_tree, index_t nodeq, index_t noder) const
+{
+	return distance(query_tree->m_node_center.get_column_vector(nodeq),m_node_center.get_column_vector(noder));
 }
 
-float64_t CBallTree::min_dist_dual(bnode_t* nodeq, bnode_t* noder)
+float64_t CBallTree::min_dist_dual(const CNbodyTree* query_tree, index_t nodeq, index_t noder) const
 {
-	float64_t dist=0;
-	SGVector<float64_t> center1=nodeq->data.center;
-	SGVector<float64_t> center2=noder->data.center;
-	for (int32_t i=0;i<center1.vlen;i++)
-		dist+=add_dim_dist(center1[i]-center2[i]);
-
-	dist=actual_dists(dist);
-	return CMath::max(0.0,dist-nodeq->data.radius-noder->data.radius);
+	const CBallTree* qtree=static_cast<const CBallTree*>(query_tree);
+	float64_t dist=center_dist(qtree,nodeq,noder);
+	return CMath::max(0.0,dist-qtree->m_node_radius[nodeq]-m_node_radius[noder]);
 }
 
-float64_t CBallTree::max_dist_dual(bnode_t* nodeq, bnode_t* noder)
+float64_t CBallTree::max_dist_dual(const CNbodyTree* query_tree, index_t nodeq, index_t noder) const
 {
-	float64_t dist=0;
-	SGVector<float64_t> center1=nodeq->data.center;
-	SGVector<float64_t> center2=noder->data.center;
-	for (int32_t i=0;i<center1.vlen;i++)
-		dist+=add_dim_dist(center1[i]-center2[i]);
-
-	dist=actual_dists(dist);
-	return (dist+nodeq->data.radius+noder->data.radius);
+	const CBallTree* qtree=static_cast<const CBallTree*>(query_tree);
+	float64_t dist=center_dist(qtree,nodeq,noder);
+	return (dist+qtree->m_node_radius[nodeq]+m_node_radius[noder]);
 }
 
-void CBallTree::min_max_dist(float64_t* pt, bnode_t* node, float64_t &lower,float64_t &upper, int32_t dim)
+void CBallTree::min_max_dist(const float64_t* pt, index_t node, float64_t &lower,float64_t &upper) const
 {
-	float64_t dist=0;
-	SGVector<float64_t> center=node->data.center;
-	for (int32_t i=0;i<dim;i++)
-		dist+=add_dim_dist(center[i]-pt[i]);
-
-	dist=actual_dists(dist);
-	lower=CMath::max(0.0,dist-node->data.radius);
-	upper=dist+node->data.radius;
+	float64_t dist=distance(m_node_center.get_column_vector(node),pt);
+	lower=CMath::max(0.0,dist-m_node_radius[node]);
+	upper=dist+m_node_radius[node];
 }
 
-void CBallTree::init_node(bnode_t* node, index_t start, index_t end)
+void CBallTree::allocate_nodes(index_t num_nodes)
 {
-	SGVector<float64_t> upper_bounds(m_data.num_rows);
-	SGVector<float64_t> lower_bounds(m_data.num_rows);
+	CNbodyTree::allocate_nodes(num_nodes);
+	m_node_center=SGMatrix<float64_t>(m_dim,num_nodes);
+}
 
-	SGVector<float64_t> center(m_data.num_rows);
-	for (int32_t i=0;i<m_data.num_rows;i++)
+void CBallTree::init_node(const SGMatrix<float64_t>& data, index_t node, index_t start, index_t end)
+{
+	float64_t* upper_bounds=m_node_upper.get_column_vector(node);
+	float64_t* lower_bounds=m_node_lower.get_column_vector(node);
+	float64_t* center=m_node_center.get_column_vector(node);
+
+	const float64_t* first=data.get_column_vector(m_vec_id[start]);
+	std::copy_n(first,m_dim,center);
+	std::copy_n(first,m_dim,upper_bounds);
+	std::copy_n(first,m_dim,lower_bounds);
+	for (index_t j=start+1;j<=end;j++)
 	{
-		center[i]=m_data(i,m_vec_id[start]);
-		upper_bounds[i]=m_data(i,m_vec_id[start]);
-		lower_bounds[i]=m_data(i,m_vec_id[start]);
-		for (int32_t j=start+1;j<=end;j++)
+		const float64_t* vec=data.get_column_vector(m_vec_id[j]);
+		for (int32_t i=0;i<m_dim;i++)
 		{
-			float64_t data_pt=m_data(i,m_vec_id[j]);
-			upper_bounds[i]=CMath::max(upper_bounds[i],data_pt);
-			lower_bounds[i]=CMath::min(lower_bounds[i],data_pt);
-			center[i]+=data_pt;
+			upper_bounds[i]=CMath::max(upper_bounds[i],vec[i]);
+			lower_bounds[i]=CMath::min(lower_bounds[i],vec[i]);
+			center[i]+=vec[i];
 		}
+	}
 
+	for (int32_t i=0;i<m_dim;i++)
 		center[i]/=(end-start+1.f);
-	}
 
 	float64_t radius=0;
-	for (int32_t i=start;i<=end;i++)
-		radius=CMath::max(distance(m_vec_id[i],center.vector,center.vlen),radius);
-
-	node->data.radius=radius;
-	node->data.center=center;
-	node->data.start_idx=start;
-	node->data.bbox_upper=upper_bounds;
-	node->data.bbox_lower=lower_bounds;
-	node->data.end_idx=end;
-}
\ No newline at end of file
+	for (index_t i=start;i<=end;i++)
+		radius=CMath::max(distance(data.get_column_vector(m_vec_id[i]),center),radius);
+
+	m_node_radius[node]=radius;
+}
+
+void CBallTree::init()
+{
+	m_node_center=SGMatrix<float64_t>();
+
+	SG_ADD(&m_node_center,"m_node_center","center of nodes");
+}
@@ -60,31 +60,39 @@ public:
 	 */
 	virtual const char* get_name() const { return "BallTree"; }
 
+	/** get data of a node, including its center
+	 *
+	 * @param node index of the node, 0 is the root
+	 * @return copy of the node data
+	 */
+	virtual NbodyTreeNodeData get_node_data(index_t node) const;
+
 private:
 	/** find minimum distance between node and a query vector
 	 *
 	 * @param node present node
 	 * @param feat query vector
-	 * @param dim dimensions of query vector
 	 * @return min distance
 	 */
-	float64_t min_dist(bnode_t* node,float64_t* feat, int32_t dim);
+	virtual float64_t min_dist(index_t node, const float64_t* feat) const;
 
 	/** find minimum distance between 2 nodes
 	 *
+	 * @param query_tree tree of the query node, a ball tree
 	 * @param nodeq node containing active query vectors
 	 * @param noder node containing active training vectors
 	 * @return min distance between 2 nodes
 	 */
-	virtual float64_t min_dist_dual(bnode_t* nodeq, bnode_t* noder);
+	virtual float64_t min_dist_dual(const CNbodyTree* query_tree, index_t nodeq, index_t noder) const;
 
 	/** find max distance between 2 nodes
 	 *
+	 * @param query_tree tree of the query node, a ball tree
 	 * @param nodeq node containing active query vectors
 	 * @param noder node containing active training vectors
 	 * @return max distance between 2 nodes
 	 */
-	virtual float64_t max_dist_dual(bnode_t* nodeq, bnode_t* noder);
+	virtual float64_t max_dist_dual(const CNbodyTree* query_tree, index_t nodeq, index_t noder) const;
 
 	/** get min as well as max distance of a node from a point
 	 *
@@ -92,18 +100,39 @@ private:
 	 * @param node node from which distances are to be calculated
 	 * @param lower lower bound of distance
 	 * @param upper upper bound of distance
-	 * @param dim dimension of point vector
 	 */
-	void min_max_dist(float64_t* pt, bnode_t* node, float64_t &lower,float64_t &upper, int32_t dim);
+	virtual void min_max_dist(const float64_t* pt, index_t node, float64_t &lower,float64_t &upper) const;
+
+	/** allocate the arrays of the nodes, including the centers
+	 *
+	 * @param num_nodes number of nodes
+	 */
+	virtual void allocate_nodes(index_t num_nodes);
 
 	/** initialize node
 	 *
+	 * @param data data matrix the tree is built on
 	 * @param node node to be initialized
 	 * @param start start index of index vector
 	 * @param end end index of index vector
 	 */
-	void init_node(bnode_t* node, index_t start, index_t end);
+	virtual void init_node(const SGMatrix<float64_t>& data, index_t node, index_t start, index_t end);
 
+	/** distance between the centers of 2 nodes
+	 *
+	 * @param query_tree tree of the query node
+	 * @param nodeq node containing active query vectors
+	 * @param noder node containing active training vectors
+	 * @return distance between the centers
+	 */
+	float64_t center_dist(const CBallTree* query_tree, index_t nodeq, index_t noder) const;
+
+	/** initialize parameters */
+	void init();
+
+private:
+	/** center of each node, one column per node */
+	SGMatrix<float64_t> m_node_center;
 };
 } /* namespace shogun */
 
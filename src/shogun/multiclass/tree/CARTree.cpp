@@ -238,6 +238,17 @@ void CCARTree::set_min_node_size(int32_t nsize)
 	m_min_node_size=nsize;
 }
 
+void CCARTree::set_rand_seed(uint64_t seed)
+{
+	m_rand_seed=seed;
+	m_rand_seed_set=true;
+}
+
+uint64_t CCARTree::get_rand_seed() const
+{
+	return m_rand_seed;
+}
+
 void CCARTree::set_label_epsilon(float64_t ep)
 {
 	REQUIRE(ep>=0,"Input epsilon value is expected to be greater than or equal to 0\n")
@@ -282,6 +293,9 @@ bool CCARTree::train_machine(CFeatures* data)
 		linalg::set_const(m_nominal, false);
 	}
 
+	if (m_rand_seed_set)
+		m_rand_stream=RandomStream(m_rand_seed);
+
 	auto dense_labels = m_labels->as<CDenseLabels>();
 	set_root(CARTtrain(dense_features,m_weights,dense_labels,0));
 
@@ -568,7 +582,10 @@ index_t CCARTree::compute_best_attribute(const SGMatrix<float64_t>& mat, const S
 	if (subset_size)
 	{
 		num_feats=subset_size;
-		CMath::permute(idx);
+		if (m_rand_seed_set)
+			CMath::permute(idx, m_rand_stream);
+		else
+			CMath::permute(idx);
 	}
 
 	float64_t max_gain=MIN_SPLIT_GAIN;
@@ -1178,7 +1195,13 @@ void CCARTree::prune_by_cross_validation(CDenseFeatures<float64_t>* data, int32_
 
 	// divide data into V folds randomly
 	SGVector<index_t> subid(num_vecs);
-	subid.random_vector(subid.vector,subid.vlen,0,folds-1);
+	if (m_rand_seed_set)
+	{
+		for (index_t i=0;i<num_vecs;++i)
+			subid[i]=m_rand_stream.random(0,folds-1);
+	}
+	else
+		subid.random_vector(subid.vector,subid.vlen,0,folds-1);
 
 	// for each fold subset
 	std::vector<float64_t> r_cv;
@@ -1486,6 +1509,8 @@ void CCARTree::init()
 	m_max_depth=0;
 	m_min_node_size=0;
 	m_label_epsilon=1e-7;
+	m_rand_seed=0;
+	m_rand_seed_set=false;
 	m_sorted_features=SGMatrix<float64_t>();
 	m_sorted_indices=SGMatrix<index_t>();
 
@@ -1503,6 +1528,8 @@ void CCARTree::init()
 	SG_ADD(&m_max_depth, "max_depth", "max allowed tree depth");
 	SG_ADD(&m_min_node_size, "min_node_size", "min allowed node size");
 	SG_ADD(&m_label_epsilon, "label_epsilon", "epsilon for labels");
+	SG_ADD(&m_rand_seed, "rand_seed", "seed of the random stream");
+	SG_ADD(&m_rand_seed_set, "rand_seed_set", "whether the random stream is used");
 	SG_ADD_OPTIONS(
 	    (machine_int_t*)&m_mode, "mode",
 	    "problem type (multiclass or regression)", ParameterProperties::NONE,
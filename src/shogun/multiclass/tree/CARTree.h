@@ -37,6 +37,7 @@
 #include <shogun/multiclass/tree/TreeMachine.h>
 #include <shogun/multiclass/tree/CARTreeNodeData.h>
 #include <shogun/features/DenseFeatures.h>
+#include <shogun/mathematics/RandomStream.h>
 
 namespace shogun
 {
@@ -228,6 +229,27 @@ public:
 	 */
 	void set_label_epsilon(float64_t epsilon);
 
+	/** set seed of a random stream for the random feature subsets and the
+	 * cross validation folds, which are drawn from the global generator
+	 * otherwise. A seeded tree is trained reproducibly, also while other
+	 * trees are trained in parallel.
+	 *
+	 * @param seed seed of the random stream
+	 */
+	void set_rand_seed(uint64_t seed);
+
+	/** get seed of the random stream
+	 *
+	 * @return seed
+	 */
+	uint64_t get_rand_seed() const;
+
+	/** @return whether the seed of a random stream is set */
+	bool has_rand_seed() const
+	{
+		return m_rand_seed_set;
+	}
+
 	void pre_sort_features(CFeatures* data, SGMatrix<float64_t>& sorted_feats, SGMatrix<index_t>& sorted_indices);
 
 	void set_sorted_features(SGMatrix<float64_t>& sorted_feats, SGMatrix<index_t>& sorted_indices);
@@ -464,6 +486,15 @@ protected:
 
 	/** minimum number of feature vectors required in a node **/
 	int32_t m_min_node_size;
+
+	/** seed of the random stream **/
+	uint64_t m_rand_seed;
+
+	/** whether the random stream is used instead of the global generator **/
+	bool m_rand_seed_set;
+
+	/** random stream of the current training **/
+	RandomStream m_rand_stream;
 };
 } /* namespace shogun */
 
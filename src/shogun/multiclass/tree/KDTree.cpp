@@ -30,6 +30,8 @@
 
 #include <shogun/multiclass/tree/KDTree.h>
 
+#include <algorithm>
+
 using namespace shogun;
 
 CKDTree::CKDTree(int32_t leaf_size, EDistanceType d)
@@ -41,27 +43,30 @@ CKDTree::~CKDTree()
 {
 }
 
-float64_t CKDTree::min_dist(bnode_t* node,float64_t* feat, int32_t dim)
+float64_t CKDTree::min_dist(index_t node, const float64_t* feat) const
 {
+	const float64_t* lower=m_node_lower.get_column_vector(node);
+	const float64_t* upper=m_node_upper.get_column_vector(node);
 	float64_t dist=0;
-	for (int32_t i=0;i<dim;i++)
+	for (int32_t i=0;i<m_dim;i++)
 	{
-		float64_t dim_dist=(node->data.bbox_lower[i]-feat[i])+CMath::abs(feat[i]-node->data.bbox_lower[i]);
-		dim_dist+=(feat[i]-node->data.bbox_upper[i])+CMath::abs(feat[i]-node->data.bbox_upper[i]);
+		float64_t dim_dist=(lower[i]-feat[i])+CMath::abs(feat[i]-lower[i]);
+		dim_dist+=(feat[i]-upper[i])+CMath::abs(feat[i]-upper[i]);
 		dist+=add_dim_dist(0.5*dim_dist);
 	}
 
 	return actual_dists(dist);
 }
 
-float64_t CKDTree::min_dist_dual(bnode_t* nodeq, bnode_t* noder)
+float64_t CKDTree::min_dist_dual(const CNbodyTree* query_tree, index_t nodeq, index_t noder) const
 {
-	SGVector<float64_t> nodeq_lower=nodeq->data.bbox_lower;
-	SGVector<float64_t> nodeq_upper=nodeq->data.bbox_upper;
-	SGVector<float64_t> noder_lower=noder->data.bbox_lower;
-	SGVector<float64_t> noder_upper=noder->data.bbox_upper;
+	const CKDTree* qtree=static_cast<const CKDTree*>(query_tree);
+	const float64_t* nodeq_lower=qtree->m_node_lower.get_column_vector(nodeq);
+	const float64_t* nodeq_upper=qtree->m_node_upper.get_column_vector(nodeq);
+	const float64_t* noder_lower=m_node_lower.get_column_vector(noder);
+	const float64_t* noder_upper=m_node_upper.get_column_vector(noder);
 	float64_t dist=0;
-	for(int32_t i=0;i<noder_lower.vlen;i++)
+	for(int32_t i=0;i<m_dim;i++)
 	{
 		float64_t d1=nodeq_lower[i]-noder_upper[i];
 		float64_t d2=noder_lower[i]-nodeq_upper[i];
@@ -71,14 +76,15 @@ float64_t CKDTree::min_dist_dual(bnode_t* nodeq, bnode_t* noder)
 	return actual_dists(dist);
 }
 
-float64_t CKDTree::max_dist_dual(bnode_t* nodeq, bnode_t* noder)
+float64_t CKDTree::max_dist_dual(const CNbodyTree* query_tree, index_t nodeq, index_t noder) const
 {
-	SGVector<float64_t> nodeq_lower=nodeq->data.bbox_lower;
-	SGVector<float64_t> nodeq_upper=nodeq->data.bbox_upper;
-	SGVector<float64_t> noder_lower=noder->data.bbox_lower;
-	SGVector<float64_t> noder_upper=noder->data.bbox_upper;
+	const CKDTree* qtree=static_cast<const CKDTree*>(query_tree);
+	const float64_t* nodeq_lower=qtree->m_node_lower.get_column_vector(nodeq);
+	const float64_t* nodeq_upper=qtree->m_node_upper.get_column_vector(nodeq);
+	const float64_t* noder_lower=m_node_lower.get_column_vector(noder);
+	const float64_t* noder_upper=m_node_upper.get_column_vector(noder);
 	float64_t dist=0;
-	for(int32_t i=0;i<noder_lower.vlen;i++)
+	for(int32_t i=0;i<m_dim;i++)
 	{
 		float64_t d1=CMath::abs(nodeq_lower[i]-noder_upper[i]);
 		float64_t d2=CMath::abs(noder_lower[i]-nodeq_upper[i]);
@@ -88,14 +94,16 @@ float64_t CKDTree::max_dist_dual(bnode_t* nodeq, bnode_t* noder)
 	return actual_dists(dist);
 }
 
-void CKDTree::min_max_dist(float64_t* pt, bnode_t* node, float64_t &lower,float64_t &upper, int32_t dim)
+void CKDTree::min_max_dist(const float64_t* pt, index_t node, float64_t &lower,float64_t &upper) const
 {
+	const float64_t* node_lower=m_node_lower.get_column_vector(node);
+	const float64_t* node_upper=m_node_upper.get_column_vector(node);
 	lower=0;
 	upper=0;
-	for(int32_t i=0;i<dim;i++)
+	for(int32_t i=0;i<m_dim;i++)
 	{
-		float64_t low_dist=node->data.bbox_lower[i]-pt[i];
-		float64_t high_dist=pt[i]-node->data.bbox_upper[i];
+		float64_t low_dist=node_lower[i]-pt[i];
+		float64_t high_dist=pt[i]-node_upper[i];
 		lower+=add_dim_dist(0.5*(low_dist+CMath::abs(low_dist)+high_dist+CMath::abs(high_dist)));
 		upper+=add_dim_dist(CMath::max(CMath::abs(low_dist),CMath::abs(high_dist)));
 	}
@@ -104,29 +112,27 @@ void CKDTree::min_max_dist(float64_t* pt, bnode_t* node, float64_t &lower,float6
 	upper=actual_dists(upper);
 }
 
-void CKDTree::init_node(bnode_t* node, index_t start, index_t end)
+void CKDTree::init_node(const SGMatrix<float64_t>& data, index_t node, index_t start, index_t end)
 {
-	SGVector<float64_t> upper_bounds(m_data.num_rows);
-	SGVector<float64_t> lower_bounds(m_data.num_rows);
+	float64_t* upper_bounds=m_node_upper.get_column_vector(node);
+	float64_t* lower_bounds=m_node_lower.get_column_vector(node);
 
-	for (int32_t i=0;i<m_data.num_rows;i++)
+	const float64_t* first=data.get_column_vector(m_vec_id[start]);
+	std::copy_n(first,m_dim,upper_bounds);
+	std::copy_n(first,m_dim,lower_bounds);
+	for (index_t j=start+1;j<=end;j++)
 	{
-		upper_bounds[i]=m_data(i,m_vec_id[start]);
-		lower_bounds[i]=m_data(i,m_vec_id[start]);
-		for (int32_t j=start+1;j<=end;j++)
+		const float64_t* vec=data.get_column_vector(m_vec_id[j]);
+		for (int32_t i=0;i<m_dim;i++)
 		{
-			upper_bounds[i]=CMath::max(upper_bounds[i],m_data(i,m_vec_id[j]));
-			lower_bounds[i]=CMath::min(lower_bounds[i],m_data(i,m_vec_id[j]));
+			upper_bounds[i]=CMath::max(upper_bounds[i],vec[i]);
+			lower_bounds[i]=CMath::min(lower_bounds[i],vec[i]);
 		}
 	}
 
 	float64_t radius=0;
-	for (int32_t i=0;i<m_data.num_rows;i++)
+	for (int32_t i=0;i<m_dim;i++)
 		radius=CMath::max(radius,upper_bounds[i]-lower_bounds[i]);
 
-	node->data.bbox_upper=upper_bounds;
-	node->data.bbox_lower=lower_bounds;
-	node->data.radius=0.5*radius;
-	node->data.start_idx=start;
-	node->data.end_idx=end;
-}
\ No newline at end of file
+	m_node_radius[node]=0.5*radius;
+}
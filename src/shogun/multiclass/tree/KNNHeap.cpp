@@ -48,6 +48,20 @@ CKNNHeap::CKNNHeap(int32_t k)
 	}
 }
 
+CKNNHeap::CKNNHeap(int32_t k, float64_t* dists, index_t* indices)
+{
+	m_capacity=k;
+	m_dists=SGVector<float64_t>(dists,m_capacity,false);
+	m_inds=SGVector<index_t>(indices,m_capacity,false);
+	m_sorted=false;
+
+	for (int32_t i=0;i<m_capacity;i++)
+	{
+		m_dists[i]=CMath::MAX_REAL_NUMBER;
+		m_inds[i]=0;
+	}
+}
+
 void CKNNHeap::push(index_t index, float64_t dist)
 {
 	if (dist>m_dists[0])
@@ -55,6 +69,13 @@ void CKNNHeap::push(index_t index, float64_t dist)
 
 	m_dists[0]=dist;
 	m_inds[0]=index;
+	sift_down(m_capacity);
+}
+
+void CKNNHeap::sift_down(int32_t size)
+{
+	float64_t dist=m_dists[0];
+	index_t index=m_inds[0];
 
 	index_t i_swap;
 	index_t i=0;
@@ -62,11 +83,11 @@ void CKNNHeap::push(index_t index, float64_t dist)
 	{
 		index_t l=2*i+1;
 		index_t r=l+1;
-		if (l>=m_capacity)
+		if (l>=size)
 		{
 			break;
 		}
-		else if (r>=m_capacity)
+		else if (r>=size)
 		{
 			if (m_dists[l]>dist)
 				i_swap=l;
@@ -97,48 +118,30 @@ void CKNNHeap::push(index_t index, float64_t dist)
 	}
 }
 
-SGVector<float64_t> CKNNHeap::get_dists()
+void CKNNHeap::sort()
 {
 	if (m_sorted)
-		return m_dists;
+		return;
 
 	m_sorted=true;
-	SGVector<float64_t> new_dists(m_capacity);
-	SGVector<index_t> new_inds(m_capacity);
 
-	// O(nlogn) heap-sort
-	for (int32_t i=m_capacity-1;i>-1;i--)
+	// in-place heap-sort, the max is moved behind the shrinking heap
+	for (int32_t i=m_capacity-1;i>0;i--)
 	{
-		new_dists[i]=m_dists[0];
-		new_inds[i]=m_inds[0];
-		push(0,-1);
+		CMath::swap(m_dists[0],m_dists[i]);
+		CMath::swap(m_inds[0],m_inds[i]);
+		sift_down(i);
 	}
+}
 
-	m_dists=new_dists;
-	m_inds=new_inds;
-
+SGVector<float64_t> CKNNHeap::get_dists()
+{
+	sort();
 	return m_dists;
 }
 
 SGVector<index_t> CKNNHeap::get_indices()
 {
-	if (m_sorted)
-		return m_inds;
-
-	m_sorted=true;
-	SGVector<float64_t> new_dists(m_capacity);
-	SGVector<index_t> new_inds(m_capacity);
-
-	// O(nlogn) heap-sort
-	for (int32_t i=m_capacity-1;i>-1;i--)
-	{
-		new_dists[i]=m_dists[0];
-		new_inds[i]=m_inds[0];
-		push(0,-1);
-	}
-
-	m_dists=new_dists;
-	m_inds=new_inds;
-
+	sort();
 	return m_inds;
 }
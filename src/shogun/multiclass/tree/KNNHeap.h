@@ -53,6 +53,15 @@ public:
 	 */
 	CKNNHeap(int32_t k=1);
 
+	/** constructor on memory of the caller, which avoids allocations when
+	 * many queries are answered
+	 *
+	 * @param k heap capacity i.e. the number of least distance values to be stored
+	 * @param dists memory for k distances
+	 * @param indices memory for k indices
+	 */
+	CKNNHeap(int32_t k, float64_t* dists, index_t* indices);
+
 	/** destructor */
 	~CKNNHeap() { };
 
@@ -75,6 +84,11 @@ public:
 	 */
 	index_t get_max_index() { return m_inds[0]; }
 
+	/** sort the stored distances in increasing order in place, after
+	 * which nothing can be pushed
+	 */
+	void sort();
+
 	/** get distances
 	 *
 	 * @return distances stored in the heap
@@ -87,6 +101,13 @@ public:
 	 */
 	SGVector<index_t> get_indices();
 
+private:
+	/** move the root down to its place
+	 *
+	 * @param size number of elements of the heap
+	 */
+	void sift_down(int32_t size);
+
 private:
 	/** distance heap */
 	SGVector<float64_t> m_dists;
@@ -30,11 +30,25 @@
 
 #include <shogun/multiclass/tree/NbodyTree.h>
 #include <shogun/distributions/KernelDensity.h>
+#include <shogun/base/Parameter.h>
+
+#include <algorithm>
 
 using namespace shogun;
 
+/** the top of the tree is built sequentially until about this many subtrees remain */
+#define NBODY_MAX_BUILD_SUBTREES 64
+/** subtrees of at most this many vectors are built by one thread */
+#define NBODY_MIN_BUILD_SUBTREE_SIZE 1024
+/** query vectors are distributed to the threads in blocks of this size */
+#define NBODY_QUERY_BLOCK_SIZE 64
+/** the dual tree KDE traverses at most about this many query subtrees */
+#define KDE_MAX_QUERY_SUBTREES 256
+/** query subtrees are not split below this many vectors */
+#define KDE_MIN_QUERY_SUBTREE_SIZE 256
+
 CNbodyTree::CNbodyTree(int32_t leaf_size, EDistanceType d)
-: CTreeMachine<NbodyTreeNodeData>()
+: CSGObject()
 {
 	init();
 
@@ -42,107 +56,186 @@ CNbodyTree::CNbodyTree(int32_t leaf_size, EDistanceType d)
 	m_dist=d;
 }
 
+NbodyTreeNodeData CNbodyTree::get_node_data(index_t node) const
+{
+	REQUIRE(node>=0 && node<get_num_nodes(),"Node index (%d) out of range [0, %d)\n",node,get_num_nodes())
+
+	NbodyTreeNodeData data;
+	data.start_idx=m_node_start[node];
+	data.end_idx=m_node_end[node];
+	data.is_leaf=is_leaf(node);
+	data.radius=m_node_radius[node];
+	data.bbox_lower=SGVector<float64_t>(m_dim);
+	data.bbox_upper=SGVector<float64_t>(m_dim);
+	std::copy_n(m_node_lower.get_column_vector(node),m_dim,data.bbox_lower.vector);
+	std::copy_n(m_node_upper.get_column_vector(node),m_dim,data.bbox_upper.vector);
+	return data;
+}
+
 void CNbodyTree::build_tree(CDenseFeatures<float64_t>* data)
 {
 	REQUIRE(data,"data not set\n");
 	REQUIRE(m_leaf_size>0,"Leaf size should be greater than 0\n");
 
-	m_knn_done=false;
-	m_data=data->get_feature_matrix();
+	SGMatrix<float64_t> feats=data->get_feature_matrix();
+	index_t num_vectors=feats.num_cols;
+	REQUIRE(num_vectors>0,"No vectors to build the tree on\n");
 
-	m_vec_id=SGVector<index_t>(m_data.num_cols);
+	m_knn_done=false;
+	m_dim=feats.num_rows;
+	m_vec_id=SGVector<index_t>(num_vectors);
 	m_vec_id.range_fill(0);
+	allocate_nodes(count_nodes(num_vectors));
 
-	set_root(recursive_build(0,m_data.num_cols-1));
+	// the shape of the tree only depends on the number of vectors, so the
+	// subtrees below the top levels can be built independently
+	std::vector<index_t> subtrees;
+	index_t max_size=CMath::max(num_vectors/NBODY_MAX_BUILD_SUBTREES,NBODY_MIN_BUILD_SUBTREE_SIZE);
+	recursive_build(feats,0,0,num_vectors-1,max_size,&subtrees);
+
+	#pragma omp parallel for schedule(dynamic)
+	for (index_t i=0;i<(index_t)subtrees.size();i++)
+	{
+		index_t node=subtrees[i];
+		recursive_build(feats,node,m_node_start[node],m_node_end[node],0,NULL);
+	}
+
+	m_data=SGMatrix<float64_t>(num_vectors,m_dim);
+	#pragma omp parallel for
+	for (index_t i=0;i<num_vectors;i++)
+	{
+		for (int32_t j=0;j<m_dim;j++)
+			m_data(i,j)=feats(j,m_vec_id[i]);
+	}
 }
 
 void CNbodyTree::query_knn(CDenseFeatures<float64_t>* data, int32_t k)
 {
 	REQUIRE(data,"Query data not supplied\n")
-	REQUIRE(data->get_num_features()==m_data.num_rows,"query data dimension should be same as training data dimension\n")
+	REQUIRE(data->get_num_features()==m_dim,"query data dimension should be same as training data dimension\n")
+	REQUIRE(k>0,"K (%d) should be greater than 0\n",k)
+	REQUIRE(get_num_nodes()>0,"Tree is not built\n")
 
 	m_knn_done=true;
 	SGMatrix<float64_t> qfeats=data->get_feature_matrix();
 	m_knn_dists=SGMatrix<float64_t>(k,qfeats.num_cols);
 	m_knn_indices=SGMatrix<index_t>(k,qfeats.num_cols);
-	int32_t dim=qfeats.num_rows;
 
-	for (int32_t i=0;i<qfeats.num_cols;i++)
+	#pragma omp parallel
 	{
-		CKNNHeap* heap=new CKNNHeap(k);
-		bnode_t* root=NULL;
-		if (m_root)
-			root=dynamic_cast<bnode_t*>(m_root);
+		SGVector<float64_t> dists(2*m_leaf_size);
 
-		float64_t mdist=min_dist(root,qfeats.matrix+i*dim,dim);
-		query_knn_single(heap,mdist,root,qfeats.matrix+i*dim,dim);
-		sg_memcpy(m_knn_dists.matrix+i*k,heap->get_dists(),k*sizeof(float64_t));
-		sg_memcpy(m_knn_indices.matrix+i*k,heap->get_indices(),k*sizeof(index_t));
+		#pragma omp for schedule(dynamic, NBODY_QUERY_BLOCK_SIZE)
+		for (index_t i=0;i<qfeats.num_cols;i++)
+		{
+			float64_t* knn_dists=m_knn_dists.get_column_vector(i);
+			CKNNHeap heap(k,knn_dists,m_knn_indices.get_column_vector(i));
+			const float64_t* point=qfeats.get_column_vector(i);
+			query_knn_single(heap,min_dist(0,point),0,point,dists.vector);
+
+			heap.sort();
+			for (int32_t j=0;j<k;j++)
+				knn_dists[j]=actual_dists(knn_dists[j]);
+		}
+	}
+}
 
-		delete(heap);
+SGVector<index_t> CNbodyTree::query_radius(SGVector<float64_t> point, float64_t radius)
+{
+	REQUIRE(point.vlen==m_dim,"query vector dimension should be same as training data dimension\n")
+
+	std::vector<index_t> result;
+	if (get_num_nodes()>0)
+	{
+		SGVector<float64_t> dists(2*m_leaf_size);
+		query_radius_single(0,point.vector,radius,result,dists.vector);
 	}
+
+	SGVector<index_t> indices(result.size());
+	std::copy(result.begin(),result.end(),indices.vector);
+	return indices;
 }
 
-SGVector<float64_t> CNbodyTree::log_kernel_density(SGMatrix<float64_t> test, EKernelType kernel, float64_t h, float64_t atol, float64_t rtol)
+SGVector<float64_t> CNbodyTree::log_kernel_density(SGMatrix<float64_t> test, EKDEKernelType kernel, float64_t h, float64_t atol, float64_t rtol)
 {
-	int32_t dim=m_data.num_rows;
-	REQUIRE(test.num_rows==dim,"dimensions of training data and test data should be the same\n")
+	REQUIRE(test.num_rows==m_dim,"dimensions of training data and test data should be the same\n")
+	REQUIRE(get_num_nodes()>0,"Tree is not built\n")
 
-	float64_t log_atol = std::log(atol * m_data.num_cols);
+	index_t num_vectors=m_vec_id.vlen;
+	float64_t log_atol = std::log(atol * num_vectors);
 	float64_t log_rtol = std::log(rtol);
-	float64_t log_kernel_norm=CKernelDensity::log_norm(kernel,h,dim);
+	float64_t log_kernel_norm=CKernelDensity::log_norm(kernel,h,m_dim);
 	SGVector<float64_t> log_density(test.num_cols);
-	for (int32_t i=0;i<test.num_cols;i++)
+
+	#pragma omp parallel
 	{
-		bnode_t* root=NULL;
-		if (m_root)
-			root=dynamic_cast<bnode_t*>(m_root);
-
-		float64_t lower_dist=0;
-		float64_t upper_dist=0;
-		min_max_dist(test.matrix+i*dim,root,lower_dist,upper_dist,dim);
-
-		float64_t min_bound = std::log(m_data.num_cols) +
-		                      CKernelDensity::log_kernel(kernel, upper_dist, h);
-		float64_t max_bound = std::log(m_data.num_cols) +
-		                      CKernelDensity::log_kernel(kernel, lower_dist, h);
-		float64_t spread=logdiffexp(max_bound,min_bound);
-
-		get_kde_single(root,test.matrix+i*dim,kernel,h,log_atol,log_rtol,log_kernel_norm,min_bound,spread,min_bound,spread);
-		log_density[i] = logsumexp(min_bound, spread - std::log(2)) +
-		                 log_kernel_norm - std::log(m_data.num_cols);
+		SGVector<float64_t> dists(2*m_leaf_size);
+
+		#pragma omp for schedule(dynamic, NBODY_QUERY_BLOCK_SIZE)
+		for (index_t i=0;i<test.num_cols;i++)
+		{
+			const float64_t* point=test.get_column_vector(i);
+			float64_t lower_dist=0;
+			float64_t upper_dist=0;
+			min_max_dist(point,0,lower_dist,upper_dist);
+
+			float64_t min_bound = std::log(num_vectors) +
+			                      CKernelDensity::log_kernel(kernel, upper_dist, h);
+			float64_t max_bound = std::log(num_vectors) +
+			                      CKernelDensity::log_kernel(kernel, lower_dist, h);
+			float64_t spread=logdiffexp(max_bound,min_bound);
+
+			get_kde_single(0,point,kernel,h,log_atol,log_rtol,log_kernel_norm,min_bound,spread,min_bound,spread,dists.vector);
+			log_density[i] = logsumexp(min_bound, spread - std::log(2)) +
+			                 log_kernel_norm - std::log(num_vectors);
+		}
 	}
 
 	return log_density;
 }
 
-SGVector<float64_t> CNbodyTree::log_kernel_density_dual(SGMatrix<float64_t> test, SGVector<index_t> qid, bnode_t* qroot, EKernelType kernel, float64_t h, float64_t atol, float64_t rtol)
+SGVector<float64_t> CNbodyTree::log_kernel_density_dual(CNbodyTree* query_tree, EKDEKernelType kernel, float64_t h, float64_t atol, float64_t rtol)
 {
-	int32_t dim=m_data.num_rows;
-	REQUIRE(test.num_rows==dim,"dimensions of training data and test data should be the same\n")
+	REQUIRE(query_tree,"Query tree not supplied\n")
+	REQUIRE(!strcmp(query_tree->get_name(),get_name()),"Query tree (%s) should be of the same type as the reference tree (%s)\n",
+		query_tree->get_name(),get_name())
+	REQUIRE(query_tree->m_dim==m_dim,"dimensions of training data and test data should be the same\n")
+	REQUIRE(get_num_nodes()>0 && query_tree->get_num_nodes()>0,"Trees are not built\n")
 
-	float64_t log_atol = std::log(atol * m_data.num_cols * test.num_cols);
+	index_t num_vectors=m_vec_id.vlen;
 	float64_t log_rtol = std::log(rtol);
-	float64_t log_kernel_norm=CKernelDensity::log_norm(kernel,h,dim);
-	SGVector<float64_t> log_density(test.num_cols);
+	float64_t log_kernel_norm=CKernelDensity::log_norm(kernel,h,m_dim);
+	SGVector<float64_t> log_density(query_tree->m_vec_id.vlen);
 	log_density.fill_vector(log_density.vector,log_density.vlen,-CMath::INFTY);
 
-	bnode_t* rroot=NULL;
-	if (m_root)
-		rroot=dynamic_cast<bnode_t*>(m_root);
+	// subtrees are fixed by the size of the query tree, not by the number of threads
+	std::vector<index_t> subtrees;
+	index_t max_size=CMath::max(log_density.vlen/KDE_MAX_QUERY_SUBTREES,KDE_MIN_QUERY_SUBTREE_SIZE);
+	query_tree->collect_subtrees(0,max_size,subtrees);
 
-	float64_t upper_dist=max_dist_dual(rroot,qroot);
-	float64_t lower_dist=min_dist_dual(rroot,qroot);
-	float64_t min_bound = std::log(test.num_cols) + std::log(m_data.num_cols) +
-	                      CKernelDensity::log_kernel(kernel, upper_dist, h);
-	float64_t max_bound = std::log(test.num_cols) + std::log(m_data.num_cols) +
-	                      CKernelDensity::log_kernel(kernel, lower_dist, h);
-	float64_t spread=logdiffexp(max_bound,min_bound);
+	// each subtree writes the densities of its own query vectors only
+	#pragma omp parallel
+	{
+		SGVector<float64_t> point(m_dim);
+		SGVector<float64_t> dists(2*m_leaf_size);
 
-	kde_dual(rroot,qroot,qid,test,log_density,kernel,h,log_atol,log_rtol,log_kernel_norm,min_bound,spread,min_bound,spread);
+		#pragma omp for schedule(dynamic)
+		for (index_t i=0;i<(index_t)subtrees.size();i++)
+		{
+			index_t qnode=subtrees[i];
+			float64_t log_num_pairs=std::log(query_tree->node_size(qnode))+std::log(num_vectors);
+			float64_t log_atol=std::log(atol)+log_num_pairs;
+
+			float64_t min_bound=0;
+			float64_t spread=0;
+			kde_dual_bounds(query_tree,qnode,0,kernel,h,min_bound,spread);
+			kde_dual(query_tree,0,qnode,log_density,kernel,h,log_atol,log_rtol,log_kernel_norm,log_num_pairs,min_bound,spread,
+				min_bound,spread,point.vector,dists.vector);
+		}
+	}
 
-	float64_t log_n = std::log(m_data.num_cols);
-	for (int32_t i=0;i<test.num_cols;i++)
+	float64_t log_n = std::log(num_vectors);
+	for (index_t i=0;i<log_density.vlen;i++)
 		log_density[i]=log_density[i]+log_kernel_norm-log_n;
 
 	return log_density;
@@ -166,83 +259,164 @@ SGMatrix<index_t> CNbodyTree::get_knn_indices()
 	return SGMatrix<index_t>();
 }
 
-void CNbodyTree::query_knn_single(CKNNHeap* heap, float64_t mdist, bnode_t* node, float64_t* arr, int32_t dim)
+void CNbodyTree::allocate_nodes(index_t num_nodes)
 {
-	if (mdist>heap->get_max_dist())
-		return;
+	m_node_start=SGVector<index_t>(num_nodes);
+	m_node_end=SGVector<index_t>(num_nodes);
+	m_node_right=SGVector<index_t>(num_nodes);
+	m_node_radius=SGVector<float64_t>(num_nodes);
+	m_node_lower=SGMatrix<float64_t>(m_dim,num_nodes);
+	m_node_upper=SGMatrix<float64_t>(m_dim,num_nodes);
+}
 
-	if (node->data.is_leaf)
+void CNbodyTree::range_dists(index_t start, index_t end, const float64_t* point, float64_t* dists) const
+{
+	// one pass per dimension over contiguous memory
+	index_t n=end-start+1;
+	std::fill_n(dists,n,0.0);
+	for (int32_t j=0;j<m_dim;j++)
 	{
-		index_t start=node->data.start_idx;
-		index_t end=node->data.end_idx;
+		const float64_t* vec=m_data.get_column_vector(j)+start;
+		float64_t p=point[j];
+		if (m_dist==D_MANHATTAN)
+		{
+			for (index_t i=0;i<n;i++)
+				dists[i]+=std::abs(vec[i]-p);
+		}
+		else
+		{
+			for (index_t i=0;i<n;i++)
+			{
+				float64_t d=vec[i]-p;
+				dists[i]+=d*d;
+			}
+		}
+	}
+}
 
-		for (int32_t i=start;i<=end;i++)
-			heap->push(m_vec_id[i],distance(m_vec_id[i],arr,dim));
+void CNbodyTree::query_knn_single(CKNNHeap& heap, float64_t mdist, index_t node, const float64_t* arr, float64_t* dists) const
+{
+	if (mdist>actual_dists(heap.get_max_dist()))
+		return;
+
+	if (is_leaf(node))
+	{
+		index_t start=m_node_start[node];
+		index_t end=m_node_end[node];
+		range_dists(start,end,arr,dists);
+		for (index_t i=start;i<=end;i++)
+			heap.push(m_vec_id[i],dists[i-start]);
 
 		return;
 	}
 
-	bnode_t* cleft=node->left();
-	bnode_t* cright=node->right();
+	index_t cleft=node+1;
+	index_t cright=m_node_right[node];
 
-	float64_t min_dist_left=min_dist(cleft,arr,dim);
-	float64_t min_dist_right=min_dist(cright,arr,dim);
+	float64_t min_dist_left=min_dist(cleft,arr);
+	float64_t min_dist_right=min_dist(cright,arr);
 
 	if (min_dist_left<=min_dist_right)
 	{
-		query_knn_single(heap,min_dist_left,cleft,arr,dim);
-		query_knn_single(heap,min_dist_right,cright,arr,dim);
+		query_knn_single(heap,min_dist_left,cleft,arr,dists);
+		query_knn_single(heap,min_dist_right,cright,arr,dists);
 	}
 	else
 	{
-		query_knn_single(heap,min_dist_right,cright,arr,dim);
-		query_knn_single(heap,min_dist_left,cleft,arr,dim);
+		query_knn_single(heap,min_dist_right,cright,arr,dists);
+		query_knn_single(heap,min_dist_left,cleft,arr,dists);
+	}
+}
+
+void CNbodyTree::query_radius_single(index_t node, const float64_t* arr, float64_t radius, std::vector<index_t>& result, float64_t* dists) const
+{
+	if (min_dist(node,arr)>radius)
+		return;
+
+	if (is_leaf(node))
+	{
+		index_t start=m_node_start[node];
+		index_t end=m_node_end[node];
+		range_dists(start,end,arr,dists);
+		for (index_t i=start;i<=end;i++)
+		{
+			if (actual_dists(dists[i-start])<=radius)
+				result.push_back(m_vec_id[i]);
+		}
+
+		return;
 	}
 
-	SG_UNREF(cleft);
-	SG_UNREF(cright);
+	query_radius_single(node+1,arr,radius,result,dists);
+	query_radius_single(m_node_right[node],arr,radius,result,dists);
 }
 
-float64_t CNbodyTree::distance(index_t vec, float64_t* arr, int32_t dim)
+float64_t CNbodyTree::distance(const float64_t* a, const float64_t* b) const
 {
 	float64_t ret=0;
-	for (int32_t i=0;i<dim;i++)
-		ret+=add_dim_dist(m_data(i,vec)-arr[i]);
+	for (int32_t i=0;i<m_dim;i++)
+		ret+=add_dim_dist(a[i]-b[i]);
 
 	return actual_dists(ret);
 }
 
-CBinaryTreeMachineNode<NbodyTreeNodeData>* CNbodyTree::recursive_build(index_t start, index_t end)
+index_t CNbodyTree::count_nodes(index_t num_vectors) const
+{
+	if (num_vectors<m_leaf_size*2)
+		return 1;
+
+	return 1+count_nodes((num_vectors+1)/2)+count_nodes(num_vectors/2);
+}
+
+void CNbodyTree::recursive_build(const SGMatrix<float64_t>& data, index_t node, index_t start, index_t end, index_t max_size,
+	std::vector<index_t>* deferred)
 {
-	bnode_t* node=new bnode_t();
-	init_node(node,start,end);
+	m_node_start[node]=start;
+	m_node_end[node]=end;
+	if (deferred && end-start+1<=max_size)
+	{
+		deferred->push_back(node);
+		return;
+	}
+
+	init_node(data,node,start,end);
 
 	// stopping critertia
 	if (end-start+1<m_leaf_size*2)
 	{
-		node->data.is_leaf=true;
-		return node;
+		m_node_right[node]=-1;
+		return;
 	}
 
-	node->data.is_leaf=false;
 	index_t dim=find_split_dim(node);
 	index_t mid=(end+start)/2;
-	partition(dim,start,end,mid);
+	partition(data,dim,start,end,mid);
 
-	bnode_t* child_left=recursive_build(start,mid);
-	bnode_t* child_right=recursive_build(mid+1,end);
+	// the left child follows its parent, the right child follows the left subtree
+	index_t right=node+1+count_nodes(mid-start+1);
+	m_node_right[node]=right;
 
-	node->left(child_left);
-	node->right(child_right);
+	recursive_build(data,node+1,start,mid,max_size,deferred);
+	recursive_build(data,right,mid+1,end,max_size,deferred);
+}
 
-	return node;
+void CNbodyTree::collect_subtrees(index_t node, index_t max_size, std::vector<index_t>& subtrees) const
+{
+	if (is_leaf(node) || node_size(node)<=max_size)
+	{
+		subtrees.push_back(node);
+		return;
+	}
+
+	collect_subtrees(node+1,max_size,subtrees);
+	collect_subtrees(m_node_right[node],max_size,subtrees);
 }
 
-void CNbodyTree::get_kde_single(bnode_t* node,float64_t* data, EKernelType kernel, float64_t h, float64_t log_atol, float64_t log_rtol,
-	float64_t log_norm, float64_t min_bound_node, float64_t spread_node, float64_t &min_bound_global, float64_t &spread_global)
+void CNbodyTree::get_kde_single(index_t node, const float64_t* data, EKDEKernelType kernel, float64_t h, float64_t log_atol, float64_t log_rtol,
+	float64_t log_norm, float64_t min_bound_node, float64_t spread_node, float64_t &min_bound_global, float64_t &spread_global, float64_t* dists) const
 {
-	int32_t n_node = std::log(node->data.end_idx - node->data.start_idx + 1);
-	int32_t n_total = std::log(m_data.num_cols);
+	float64_t n_node = std::log(node_size(node));
+	float64_t n_total = std::log(m_vec_id.vlen);
 
 	// local bound criterion met
 	if ((log_norm+spread_node+n_total-n_node)<=logsumexp(log_atol,log_rtol+log_norm+min_bound_node))
@@ -253,37 +427,40 @@ void CNbodyTree::get_kde_single(bnode_t* node,float64_t* data, EKernelType kerne
 		return;
 
 	// node is leaf
-	if (node->data.is_leaf)
+	if (is_leaf(node))
 	{
 		min_bound_global=logdiffexp(min_bound_global,min_bound_node);
 		spread_global=logdiffexp(spread_global,spread_node);
 
-		for (int32_t i=node->data.start_idx;i<=node->data.end_idx;i++)
+		index_t start=m_node_start[node];
+		index_t end=m_node_end[node];
+		range_dists(start,end,data,dists);
+		for (index_t i=0;i<=end-start;i++)
 		{
-			float64_t pt_eval=CKernelDensity::log_kernel(kernel,distance(m_vec_id[i],data,m_data.num_rows),h);
+			float64_t pt_eval=CKernelDensity::log_kernel(kernel,actual_dists(dists[i]),h);
 			min_bound_global=logsumexp(pt_eval,min_bound_global);
 		}
 
 		return;
 	}
 
-	bnode_t* lchild=node->left();
-	bnode_t* rchild=node->right();
+	index_t lchild=node+1;
+	index_t rchild=m_node_right[node];
 
 	float64_t lower_dist=0;
 	float64_t upper_dist=0;
-	min_max_dist(data,lchild,lower_dist,upper_dist,m_data.num_rows);
+	min_max_dist(data,lchild,lower_dist,upper_dist);
 
-	int32_t n_l=lchild->data.end_idx-lchild->data.start_idx+1;
+	float64_t n_l=std::log(node_size(lchild));
 	float64_t lower_bound_childl =
-	    std::log(n_l) + CKernelDensity::log_kernel(kernel, upper_dist, h);
-	float64_t spread_childl=logdiffexp(log(n_l)+CKernelDensity::log_kernel(kernel,lower_dist,h),lower_bound_childl);
+	    n_l + CKernelDensity::log_kernel(kernel, upper_dist, h);
+	float64_t spread_childl=logdiffexp(n_l+CKernelDensity::log_kernel(kernel,lower_dist,h),lower_bound_childl);
 
-	min_max_dist(data,rchild,lower_dist,upper_dist,m_data.num_rows);
-	int32_t n_r=rchild->data.end_idx-rchild->data.start_idx+1;
+	min_max_dist(data,rchild,lower_dist,upper_dist);
+	float64_t n_r=std::log(node_size(rchild));
 	float64_t lower_bound_childr =
-	    std::log(n_r) + CKernelDensity::log_kernel(kernel, upper_dist, h);
-	float64_t spread_childr=logdiffexp(log(n_r)+CKernelDensity::log_kernel(kernel,lower_dist,h),lower_bound_childr);
+	    n_r + CKernelDensity::log_kernel(kernel, upper_dist, h);
+	float64_t spread_childr=logdiffexp(n_r+CKernelDensity::log_kernel(kernel,lower_dist,h),lower_bound_childr);
 
 	// update global bounds
 	min_bound_global=logdiffexp(min_bound_global,min_bound_node);
@@ -294,274 +471,146 @@ void CNbodyTree::get_kde_single(bnode_t* node,float64_t* data, EKernelType kerne
 	spread_global=logsumexp(spread_global,spread_childl);
 	spread_global=logsumexp(spread_global,spread_childr);
 
-	get_kde_single(lchild,data,kernel,h,log_atol,log_rtol,log_norm,lower_bound_childl,spread_childl,min_bound_global,spread_global);
-	get_kde_single(rchild,data,kernel,h,log_atol,log_rtol,log_norm,lower_bound_childr,spread_childr,min_bound_global,spread_global);
+	get_kde_single(lchild,data,kernel,h,log_atol,log_rtol,log_norm,lower_bound_childl,spread_childl,min_bound_global,spread_global,dists);
+	get_kde_single(rchild,data,kernel,h,log_atol,log_rtol,log_norm,lower_bound_childr,spread_childr,min_bound_global,spread_global,dists);
+}
+
+void CNbodyTree::kde_dual_bounds(const CNbodyTree* query_tree, index_t querynode, index_t refnode, EKDEKernelType kernel_type, float64_t h,
+	float64_t &min_bound, float64_t &spread) const
+{
+	float64_t lower_dist=min_dist_dual(query_tree,querynode,refnode);
+	float64_t upper_dist=max_dist_dual(query_tree,querynode,refnode);
+	float64_t n_pairs=std::log(query_tree->node_size(querynode))+std::log(node_size(refnode));
 
-	SG_UNREF(lchild);
-	SG_UNREF(rchild);
+	min_bound=n_pairs+CKernelDensity::log_kernel(kernel_type,upper_dist,h);
+	spread=logdiffexp(n_pairs+CKernelDensity::log_kernel(kernel_type,lower_dist,h),min_bound);
 }
 
-void CNbodyTree::kde_dual(bnode_t* refnode, bnode_t* querynode, SGVector<index_t> qid, SGMatrix<float64_t> qdata, SGVector<float64_t> log_density, EKernelType kernel_type, float64_t h, float64_t log_atol, float64_t log_rtol, float64_t log_norm, float64_t min_bound_node, float64_t spread_node, float64_t &min_bound_global, float64_t &spread_global)
+void CNbodyTree::kde_dual(const CNbodyTree* query_tree, index_t refnode, index_t querynode, SGVector<float64_t>& log_density,
+	EKDEKernelType kernel_type, float64_t h, float64_t log_atol, float64_t log_rtol, float64_t log_norm, float64_t log_num_pairs,
+	float64_t min_bound_node, float64_t spread_node, float64_t &min_bound_global, float64_t &spread_global, float64_t* point,
+	float64_t* dists) const
 {
-	int32_t dim=m_data.num_rows;
-	float64_t n_node =
-	    std::log(refnode->data.end_idx - refnode->data.start_idx + 1) +
-	    std::log(querynode->data.end_idx - querynode->data.start_idx + 1);
-	float64_t n_total = std::log(m_data.num_cols * qdata.num_cols);
+	index_t queryn=query_tree->node_size(querynode);
+	float64_t n_node=std::log(node_size(refnode))+std::log(queryn);
+	float64_t n_total=log_num_pairs;
 
 	bool global_criterion=(log_norm+spread_global)<=logsumexp(log_atol,log_rtol+log_norm+min_bound_global);
 	bool local_criterion=(log_norm+spread_node+n_total-n_node)<=logsumexp(log_atol,log_rtol+log_norm+min_bound_node);
 
+	index_t qstart=query_tree->m_node_start[querynode];
+	index_t qend=query_tree->m_node_end[querynode];
+
 	// global bound criterion met || local bound criterion met
 	if (global_criterion || local_criterion)
 	{
 		// log density of all query points in the node is increased by K(mean + spread/2)
 		float64_t center_density =
 		    logsumexp(min_bound_node, spread_node - std::log(2)) -
-		    std::log(querynode->data.end_idx - querynode->data.start_idx + 1);
-		for (int32_t i=querynode->data.start_idx;i<=querynode->data.end_idx;i++)
-			log_density[qid[i]]=logsumexp(log_density[qid[i]],center_density);
+		    std::log(queryn);
+		for (index_t i=qstart;i<=qend;i++)
+		{
+			index_t q=query_tree->m_vec_id[i];
+			log_density[q]=logsumexp(log_density[q],center_density);
+		}
 
 		return;
 	}
 
+	bool ref_leaf=is_leaf(refnode);
+	bool query_leaf=query_tree->is_leaf(querynode);
+
 	// both are leaves
-	if (refnode->data.is_leaf && querynode->data.is_leaf)
+	if (ref_leaf && query_leaf)
 	{
 		min_bound_global=logdiffexp(min_bound_global,min_bound_node);
 		spread_global=logdiffexp(spread_global,spread_node);
 
-		// point by point evavuation of density
-		for (int32_t i=querynode->data.start_idx;i<=querynode->data.end_idx;i++)
+		// point by point evaluation of density
+		index_t rstart=m_node_start[refnode];
+		index_t rend=m_node_end[refnode];
+		for (index_t i=qstart;i<=qend;i++)
 		{
+			for (int32_t j=0;j<m_dim;j++)
+				point[j]=query_tree->m_data(i,j);
+
+			range_dists(rstart,rend,point,dists);
 			float64_t q=-CMath::INFTY;
-			for (int32_t j=refnode->data.start_idx;j<=refnode->data.end_idx;j++)
+			for (index_t j=0;j<=rend-rstart;j++)
 			{
-				float64_t pt_eval=CKernelDensity::log_kernel(kernel_type,distance(m_vec_id[j],qdata.matrix+dim*qid[i],dim),h);
+				float64_t pt_eval=CKernelDensity::log_kernel(kernel_type,actual_dists(dists[j]),h);
 				q=logsumexp(q,pt_eval);
 			}
 
+			index_t qid=query_tree->m_vec_id[i];
 			min_bound_global=logsumexp(min_bound_global,q);
-			log_density[qid[i]]=logsumexp(log_density[qid[i]],q);
+			log_density[qid]=logsumexp(log_density[qid],q);
 		}
 
 		return;
 	}
 
-	// if query node is leaf - just recurse on the reference tree
-	if (querynode->data.is_leaf)
+	// recurse on the reference tree if the query node is a leaf, on the
+	// query tree if the reference node is a leaf and on both otherwise
+	index_t refchildren[2]={refnode,refnode};
+	index_t num_ref=1;
+	if (!ref_leaf)
 	{
-		bnode_t* lchild=refnode->left();
-		bnode_t* rchild=refnode->right();
-		int32_t queryn=querynode->data.end_idx-querynode->data.start_idx+1;
-
-		// compute bounds for query node and left child of ref node
-		float64_t lower_dist=min_dist_dual(querynode,lchild);
-		float64_t upper_dist=max_dist_dual(querynode,lchild);
-		int32_t refn_l=lchild->data.end_idx-lchild->data.start_idx+1;
-		float64_t lower_bound_childl =
-		    std::log(queryn) + std::log(refn_l) +
-		    CKernelDensity::log_kernel(kernel_type, upper_dist, h);
-		float64_t spread_childl = logdiffexp(
-		    std::log(queryn) + std::log(refn_l) +
-		        CKernelDensity::log_kernel(kernel_type, lower_dist, h),
-		    lower_bound_childl);
-
-		// compute bounds for query node and right child of ref node
-		lower_dist=min_dist_dual(querynode,rchild);
-		upper_dist=max_dist_dual(querynode,rchild);
-		int32_t refn_r=rchild->data.end_idx-rchild->data.start_idx+1;
-		float64_t lower_bound_childr =
-		    std::log(queryn) + std::log(refn_r) +
-		    CKernelDensity::log_kernel(kernel_type, upper_dist, h);
-		float64_t spread_childr = logdiffexp(
-		    std::log(queryn) + std::log(refn_r) +
-		        CKernelDensity::log_kernel(kernel_type, lower_dist, h),
-		    lower_bound_childr);
-
-		// update global bounds
-		min_bound_global=logdiffexp(min_bound_global,min_bound_node);
-		min_bound_global=logsumexp(min_bound_global,lower_bound_childl);
-		min_bound_global=logsumexp(min_bound_global,lower_bound_childr);
-
-		spread_global=logdiffexp(spread_global,spread_node);
-		spread_global=logsumexp(spread_global,spread_childl);
-		spread_global=logsumexp(spread_global,spread_childr);
-
-		kde_dual(lchild,querynode,qid,qdata,log_density,kernel_type,h,log_atol,log_rtol,log_norm,lower_bound_childl,spread_childl, min_bound_global,spread_global);
-		kde_dual(rchild,querynode,qid,qdata,log_density,kernel_type,h,log_atol,log_rtol,log_norm,lower_bound_childr,spread_childr, min_bound_global,spread_global);
-
-		SG_UNREF(lchild);
-		SG_UNREF(rchild);
-		return;
+		refchildren[0]=refnode+1;
+		refchildren[1]=m_node_right[refnode];
+		num_ref=2;
 	}
 
-	// if reference node is leaf - just recurse on the query tree
-	if (refnode->data.is_leaf)
+	index_t querychildren[2]={querynode,querynode};
+	index_t num_query=1;
+	if (!query_leaf)
 	{
-		int32_t ref_n=refnode->data.end_idx-refnode->data.start_idx+1;
-		bnode_t* lchild=querynode->left();
-		bnode_t* rchild=querynode->right();
-
-		int32_t query_nl=lchild->data.end_idx-lchild->data.start_idx+1;
-		int32_t query_nr=rchild->data.end_idx-rchild->data.start_idx+1;
-
-		// compute bounds for left child of query node and ref node
-		float64_t lower_dist=min_dist_dual(refnode,lchild);
-		float64_t upper_dist=max_dist_dual(refnode,lchild);
-		float64_t lower_bound_childl =
-		    std::log(query_nl) + std::log(ref_n) +
-		    CKernelDensity::log_kernel(kernel_type, upper_dist, h);
-		float64_t spread_childl = logdiffexp(
-		    std::log(query_nl) + std::log(ref_n) +
-		        CKernelDensity::log_kernel(kernel_type, lower_dist, h),
-		    lower_bound_childl);
-
-		// compute bounds for right child of query node and ref node
-		lower_dist=min_dist_dual(querynode,rchild);
-		upper_dist=max_dist_dual(querynode,rchild);
-		float64_t lower_bound_childr =
-		    std::log(query_nr) + std::log(ref_n) +
-		    CKernelDensity::log_kernel(kernel_type, upper_dist, h);
-		float64_t spread_childr = logdiffexp(
-		    std::log(query_nr) + std::log(ref_n) +
-		        CKernelDensity::log_kernel(kernel_type, lower_dist, h),
-		    lower_bound_childr);
-
-		// update global bounds
-		min_bound_global=logdiffexp(min_bound_global,min_bound_node);
-		min_bound_global=logsumexp(min_bound_global,lower_bound_childl);
-		min_bound_global=logsumexp(min_bound_global,lower_bound_childr);
-
-		spread_global=logdiffexp(spread_global,spread_node);
-		spread_global=logsumexp(spread_global,spread_childl);
-		spread_global=logsumexp(spread_global,spread_childr);
-
-		kde_dual(refnode,lchild,qid,qdata,log_density,kernel_type,h,log_atol,log_rtol,log_norm,lower_bound_childl,spread_childl,min_bound_global,spread_global);
-		kde_dual(refnode,rchild,qid,qdata,log_density,kernel_type,h,log_atol,log_rtol,log_norm,lower_bound_childr,spread_childr,min_bound_global,spread_global);
-
-		SG_UNREF(lchild);
-		SG_UNREF(rchild);
-		return;
+		querychildren[0]=querynode+1;
+		querychildren[1]=query_tree->m_node_right[querynode];
+		num_query=2;
 	}
 
-	// if none of above -  apply 4 way recursion in both trees: left-left, left-right, right-left, right-right
-	bnode_t* refchildl=refnode->left();
-	bnode_t* refchildr=refnode->right();
-	bnode_t* querychildl=querynode->left();
-	bnode_t* querychildr=querynode->right();
-
-	float64_t refn_l=refchildl->data.end_idx-refchildl->data.start_idx+1;
-	float64_t refn_r=refchildr->data.end_idx-refchildr->data.start_idx+1;
-	float64_t queryn_l=querychildl->data.end_idx-querychildl->data.start_idx+1;
-	float64_t queryn_r=querychildr->data.end_idx-querychildr->data.start_idx+1;
-
-	// left child-left child bounds
-	float64_t lower_dist=min_dist_dual(querychildl,refchildl);
-	float64_t upper_dist=max_dist_dual(querychildl,refchildl);
-	float64_t lower_bound_ll =
-	    std::log(queryn_l) + std::log(refn_l) +
-	    CKernelDensity::log_kernel(kernel_type, upper_dist, h);
-	float64_t spread_ll = logdiffexp(
-	    std::log(queryn_l) + std::log(refn_l) +
-	        CKernelDensity::log_kernel(kernel_type, lower_dist, h),
-	    lower_bound_ll);
-
-	// left-right bounds
-	lower_dist=min_dist_dual(querychildl,refchildr);
-	upper_dist=max_dist_dual(querychildl,refchildr);
-	float64_t lower_bound_lr =
-	    std::log(queryn_l) + std::log(refn_r) +
-	    CKernelDensity::log_kernel(kernel_type, upper_dist, h);
-	float64_t spread_lr = logdiffexp(
-	    std::log(queryn_l) + std::log(refn_r) +
-	        CKernelDensity::log_kernel(kernel_type, lower_dist, h),
-	    lower_bound_lr);
-
-	// right-left bounds
-	lower_dist=min_dist_dual(querychildr,refchildl);
-	upper_dist=max_dist_dual(querychildr,refchildl);
-	float64_t lower_bound_rl =
-	    std::log(queryn_r) + std::log(refn_l) +
-	    CKernelDensity::log_kernel(kernel_type, upper_dist, h);
-	float64_t spread_rl = logdiffexp(
-	    std::log(queryn_r) + std::log(refn_l) +
-	        CKernelDensity::log_kernel(kernel_type, lower_dist, h),
-	    lower_bound_rl);
-
-	// right-right bounds
-	lower_dist=min_dist_dual(querychildr,refchildr);
-	upper_dist=max_dist_dual(querychildr,refchildr);
-	float64_t lower_bound_rr =
-	    std::log(queryn_r) + std::log(refn_r) +
-	    CKernelDensity::log_kernel(kernel_type, upper_dist, h);
-	float64_t spread_rr = logdiffexp(
-	    std::log(queryn_r) + std::log(refn_r) +
-	        CKernelDensity::log_kernel(kernel_type, lower_dist, h),
-	    lower_bound_rr);
-
-	// update global bound and spread
+	float64_t lower_bounds[2][2];
+	float64_t spreads[2][2];
 	min_bound_global=logdiffexp(min_bound_global,min_bound_node);
-	min_bound_global=logsumexp(min_bound_global,lower_bound_ll);
-	min_bound_global=logsumexp(min_bound_global,lower_bound_lr);
-	min_bound_global=logsumexp(min_bound_global,lower_bound_rl);
-	min_bound_global=logsumexp(min_bound_global,lower_bound_rr);
-
 	spread_global=logdiffexp(spread_global,spread_node);
-	spread_global=logsumexp(spread_global,spread_ll);
-	spread_global=logsumexp(spread_global,spread_lr);
-	spread_global=logsumexp(spread_global,spread_rl);
-	spread_global=logsumexp(spread_global,spread_rr);
-
-	// left-left and left-right recursions
-	kde_dual(refchildl,querychildl,qid,qdata,log_density,kernel_type,h,log_atol,log_rtol,log_norm,lower_bound_ll,spread_ll, min_bound_global,spread_global);
-	kde_dual(refchildr,querychildl,qid,qdata,log_density,kernel_type,h,log_atol,log_rtol,log_norm,lower_bound_lr,spread_lr, min_bound_global,spread_global);
-
-	// right-left and right-right recursions
-	kde_dual(refchildl,querychildr,qid,qdata,log_density,kernel_type,h,log_atol,log_rtol,log_norm,lower_bound_rl,spread_rl, min_bound_global,spread_global);
-	kde_dual(refchildr,querychildr,qid,qdata,log_density,kernel_type,h,log_atol,log_rtol,log_norm,lower_bound_rr,spread_rr, min_bound_global, spread_global);
-
-	SG_UNREF(refchildl);
-	SG_UNREF(refchildr);
-	SG_UNREF(querychildl);
-	SG_UNREF(querychildr);
-}
-
-void CNbodyTree::partition(index_t dim, index_t start, index_t end, index_t mid)
-{
-	// in-place partial quick-sort
-	index_t left=start;
-	index_t right=end;
-	while (true)
+	for (index_t i=0;i<num_query;i++)
 	{
-		index_t midindex=left;
-		for (int32_t i=left;i<right;i++)
+		for (index_t j=0;j<num_ref;j++)
 		{
-			if (m_data(dim,m_vec_id[i])<m_data(dim,m_vec_id[right]))
-			{
-				CMath::swap(*(m_vec_id.vector+i),*(m_vec_id.vector+midindex));
-				midindex+=1;
-			}
+			kde_dual_bounds(query_tree,querychildren[i],refchildren[j],kernel_type,h,lower_bounds[i][j],spreads[i][j]);
+
+			// update global bound and spread
+			min_bound_global=logsumexp(min_bound_global,lower_bounds[i][j]);
+			spread_global=logsumexp(spread_global,spreads[i][j]);
 		}
+	}
 
-		CMath::swap(*(m_vec_id.vector+midindex),*(m_vec_id.vector+right));
-		if (midindex==mid)
-			break;
-		else if (midindex<mid)
-			left=midindex+1;
-		else
-			right=midindex-1;
+	for (index_t i=0;i<num_query;i++)
+	{
+		for (index_t j=0;j<num_ref;j++)
+		{
+			kde_dual(query_tree,refchildren[j],querychildren[i],log_density,kernel_type,h,log_atol,log_rtol,log_norm,log_num_pairs,
+				lower_bounds[i][j],spreads[i][j],min_bound_global,spread_global,point,dists);
+		}
 	}
 }
 
-index_t CNbodyTree::find_split_dim(bnode_t* node)
+void CNbodyTree::partition(const SGMatrix<float64_t>& data, index_t dim, index_t start, index_t end, index_t mid)
+{
+	// in-place selection of the median
+	std::nth_element(m_vec_id.vector+start,m_vec_id.vector+mid,m_vec_id.vector+end+1,
+		[&data,dim](index_t a, index_t b) { return data(dim,a)<data(dim,b); });
+}
+
+index_t CNbodyTree::find_split_dim(index_t node) const
 {
-	SGVector<float64_t> upper_bounds=node->data.bbox_upper;
-	SGVector<float64_t> lower_bounds=node->data.bbox_lower;
+	const float64_t* upper_bounds=m_node_upper.get_column_vector(node);
+	const float64_t* lower_bounds=m_node_lower.get_column_vector(node);
 
 	index_t max_dim=0;
 	float64_t max_spread=-1;
-	for (int32_t i=0;i<m_data.num_rows;i++)
+	for (int32_t i=0;i<m_dim;i++)
 	{
 		float64_t spread=upper_bounds[i]-lower_bounds[i];
 		if (spread>max_spread)
@@ -578,6 +627,7 @@ void CNbodyTree::init()
 {
 	m_data=SGMatrix<float64_t>();
 	m_leaf_size=1;
+	m_dim=0;
 	m_vec_id=SGVector<index_t>();
 	m_dist=D_EUCLIDEAN;
 	m_knn_done=false;
@@ -587,7 +637,14 @@ void CNbodyTree::init()
 	SG_ADD(&m_data,"m_data","data matrix");
 	SG_ADD(&m_leaf_size,"m_leaf_size","leaf size");
 	SG_ADD(&m_vec_id,"m_vec_id","id of vectors");
+	SG_ADD(&m_dim,"m_dim","dimension of vectors");
+	SG_ADD(&m_node_start,"m_node_start","start index of nodes");
+	SG_ADD(&m_node_end,"m_node_end","end index of nodes");
+	SG_ADD(&m_node_right,"m_node_right","right child of nodes");
+	SG_ADD(&m_node_radius,"m_node_radius","radius of nodes");
+	SG_ADD(&m_node_lower,"m_node_lower","lower bounds of nodes");
+	SG_ADD(&m_node_upper,"m_node_upper","upper bounds of nodes");
 	SG_ADD(&m_knn_done,"knn_done","knn done or not");
 	SG_ADD(&m_knn_dists,"m_knn_dists","knn distances");
 	SG_ADD(&m_knn_indices,"knn_indices","knn indices");
-}
\ No newline at end of file
+}
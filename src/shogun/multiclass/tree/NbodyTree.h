@@ -34,20 +34,27 @@
 
 #include <shogun/lib/config.h>
 
-#include <shogun/multiclass/tree/TreeMachine.h>
-#include <shogun/kernel/Kernel.h>
+#include <shogun/base/SGObject.h>
+#include <shogun/distributions/KernelDensity.h>
 #include <shogun/distance/Distance.h>
 #include <shogun/multiclass/tree/NbodyTreeNodeData.h>
 #include <shogun/multiclass/tree/KNNHeap.h>
 #include <shogun/features/DenseFeatures.h>
 
+#include <vector>
+
 namespace shogun
 {
 
 /** @brief This class implements genaralized tree for N-body problems like k-NN, kernel density estimation, 2 point
  * correlation.
+ *
+ * The nodes are stored in arrays in depth-first order: node 0 is the root, the left child of a node directly
+ * follows it and the right child follows the subtree of the left child. The vectors are stored in tree order with
+ * each dimension contiguous, so that the vectors of a leaf are scanned in one pass per dimension. Subtrees are
+ * built in parallel and queries are answered in parallel over blocks of query vectors.
  */
-class CNbodyTree : public CTreeMachine<NbodyTreeNodeData>
+class CNbodyTree : public CSGObject
 {
 public:
 
@@ -71,20 +78,56 @@ public:
 	 */
 	SGVector<index_t> get_rearranged_vector_ids() const { return m_vec_id; }
 
+	/** get number of nodes of the built tree
+	 * @return number of nodes
+	 */
+	index_t get_num_nodes() const { return m_node_start.vlen; }
+
+	/** get left child of a node
+	 *
+	 * @param node index of the node
+	 * @return index of the left child, -1 for leaves
+	 */
+	index_t get_left_child(index_t node) const { return is_leaf(node) ? -1 : node+1; }
+
+	/** get right child of a node
+	 *
+	 * @param node index of the node
+	 * @return index of the right child, -1 for leaves
+	 */
+	index_t get_right_child(index_t node) const { return m_node_right[node]; }
+
+	/** get data of a node
+	 *
+	 * @param node index of the node, 0 is the root
+	 * @return copy of the node data
+	 */
+	virtual NbodyTreeNodeData get_node_data(index_t node) const;
+
 	/** build tree
 	 *
 	 * @param data data for tree formation
 	 */
 	void build_tree(CDenseFeatures<float64_t>* data);
 
-	/** apply knn
+	/** apply knn, the query vectors are processed in parallel
 	 *
 	 * @param data vectors whose KNNs are required
 	 * @param k K value in KNN
 	 */
 	void query_knn(CDenseFeatures<float64_t>* data, int32_t k);
 
-	/** get log of kernel density at query points
+	/** find the vectors within a distance of a query vector, may be called
+	 * concurrently once the tree is built
+	 *
+	 * @param point query vector
+	 * @param radius maximum distance
+	 * @return indices of the vectors at distance at most radius
+	 */
+	SGVector<index_t> query_radius(SGVector<float64_t> point, float64_t radius);
+
+	/** get log of kernel density at query points, the query points are
+	 * evaluated in parallel
 	 *
 	 * @param test query points at which kernel density is to be calculated
 	 * @param kernel kernel type
@@ -93,20 +136,21 @@ public:
 	 * @param rtol relative tolerance
 	 * @return log kernel density
 	 */
-	SGVector<float64_t> log_kernel_density(SGMatrix<float64_t> test, EKernelType kernel, float64_t h, float64_t atol, float64_t rtol);
+	SGVector<float64_t> log_kernel_density(SGMatrix<float64_t> test, EKDEKernelType kernel, float64_t h, float64_t atol, float64_t rtol);
 
-	/** get log of kernel density at query points
+	/** get log of kernel density at query points. The query tree is split
+	 * into subtrees that are traversed in parallel against the reference tree,
+	 * each with error bounds of its own; the split depends on the query tree
+	 * only, so the result does not depend on the number of threads.
 	 *
-	 * @param test query points at which kernel density is to be calculated
-	 * @param qid id vector of the query tree
-	 * @param qroot root of the query tree
+	 * @param query_tree tree of the query points, of the same type as this tree
 	 * @param kernel kernel type
 	 * @param h width of kernel
 	 * @param atol absolute tolerance
 	 * @param rtol relative tolerance
-	 * @return log kernel density
+	 * @return log kernel density, in the order of the query points
 	 */
-	SGVector<float64_t> log_kernel_density_dual(SGMatrix<float64_t> test, SGVector<index_t> qid, bnode_t* qroot, EKernelType kernel, float64_t h, float64_t atol, float64_t rtol);
+	SGVector<float64_t> log_kernel_density_dual(CNbodyTree* query_tree, EKDEKernelType kernel, float64_t h, float64_t atol, float64_t rtol);
 
 	/** distance b/w KNN vectors and query vectors
 	 *
@@ -125,34 +169,43 @@ protected:
 	 *
 	 * @param node present node
 	 * @param feat query vector
-	 * @param dim dimensions of query vector
 	 * @return min distance
 	 */
-	virtual float64_t min_dist(bnode_t* node,float64_t* feat, int32_t dim)=0;
+	virtual float64_t min_dist(index_t node, const float64_t* feat) const=0;
 
 	/** find minimum distance between 2 nodes
 	 *
+	 * @param query_tree tree of the query node, of the same type as this tree
 	 * @param nodeq node containing active query vectors
-	 * @param noder node containing active training vectors
+	 * @param noder node of this tree containing active training vectors
 	 * @return min distance between 2 nodes
 	 */
-	virtual float64_t min_dist_dual(bnode_t* nodeq, bnode_t* noder)=0;
+	virtual float64_t min_dist_dual(const CNbodyTree* query_tree, index_t nodeq, index_t noder) const=0;
 
 	/** find max distance between 2 nodes
 	 *
+	 * @param query_tree tree of the query node, of the same type as this tree
 	 * @param nodeq node containing active query vectors
-	 * @param noder node containing active training vectors
+	 * @param noder node of this tree containing active training vectors
 	 * @return max distance between 2 nodes
 	 */
-	virtual float64_t max_dist_dual(bnode_t* nodeq, bnode_t* noder)=0;
+	virtual float64_t max_dist_dual(const CNbodyTree* query_tree, index_t nodeq, index_t noder) const=0;
 
-	/** initialize node
+	/** allocate the arrays of the nodes
 	 *
+	 * @param num_nodes number of nodes
+	 */
+	virtual void allocate_nodes(index_t num_nodes);
+
+	/** initialize bounds of a node, may be called concurrently for
+	 * different nodes
+	 *
+	 * @param data data matrix the tree is built on
 	 * @param node node to be initialized
 	 * @param start start index of index vector
 	 * @param end end index of index vector
 	 */
-	virtual void init_node(bnode_t* node, index_t start, index_t end)=0;
+	virtual void init_node(const SGMatrix<float64_t>& data, index_t node, index_t start, index_t end)=0;
 
 	/** get min as well as max distance of a node from a point
 	 *
@@ -160,16 +213,35 @@ protected:
 	 * @param node node from which distances are to be calculated
 	 * @param lower lower bound of distance
 	 * @param upper upper bound of distance
-	 * @param dim dimension of point vector
 	 */
-	virtual void min_max_dist(float64_t* pt, bnode_t* node, float64_t &lower,float64_t &upper, int32_t dim)=0;
+	virtual void min_max_dist(const float64_t* pt, index_t node, float64_t &lower,float64_t &upper) const=0;
+
+	/** whether a node is a leaf
+	 *
+	 * @param node index of the node
+	 * @return whether the node is a leaf
+	 */
+	inline bool is_leaf(index_t node) const
+	{
+		return m_node_right[node]<0;
+	}
+
+	/** number of vectors in a node
+	 *
+	 * @param node index of the node
+	 * @return number of vectors
+	 */
+	inline index_t node_size(index_t node) const
+	{
+		return m_node_end[node]-m_node_start[node]+1;
+	}
 
 	/** convert squared distances to actual distances
 	 *
 	 * @param dists distance value
 	 * @return actual distance
 	 */
-	inline float64_t actual_dists(float64_t dists)
+	inline float64_t actual_dists(float64_t dists) const
 	{
 		if (m_dist==D_MANHATTAN)
 			return dists;
@@ -179,19 +251,18 @@ protected:
 
 	/** distance between 2 vectors
 	 *
-	 * @param vec index of training data vector
-	 * @param arr query vector
-	 * @param dim dimension of query vector
+	 * @param a first vector
+	 * @param b second vector
 	 * @return distance b/w vectors
 	 */
-	float64_t distance(index_t vec, float64_t* arr, int32_t dim);
+	float64_t distance(const float64_t* a, const float64_t* b) const;
 
 	/** compute distance component contributed by present dimension
 	 *
 	 * @param d displacement component at chosen dimension
 	 * @return distance component
 	 */
-	inline float64_t add_dim_dist(float64_t d)
+	inline float64_t add_dim_dist(float64_t d) const
 	{
 		if (m_dist==D_EUCLIDEAN)
 			return d*d;
@@ -205,15 +276,35 @@ protected:
 
 private:
 
+	/** compute the distances, before conversion by actual_dists, of a
+	 * point to the vectors in a range of the tree order
+	 *
+	 * @param start first position
+	 * @param end last position
+	 * @param point query vector
+	 * @param dists stores end-start+1 distances
+	 */
+	void range_dists(index_t start, index_t end, const float64_t* point, float64_t* dists) const;
+
 	/** apply knn on each query vector
 	 *
 	 * @param heap heap to store kNN distances and indices of corresponding vectors
 	 * @param min_dist minimum distance b/ query point and the current node
 	 * @param node current node
 	 * @param arr current query vector
-	 * @param dim dimension of query vector
+	 * @param dists buffer for the distances of a leaf
 	 */
-	void query_knn_single(CKNNHeap* heap, float64_t min_dist, bnode_t* node, float64_t* arr, int32_t dim);
+	void query_knn_single(CKNNHeap& heap, float64_t min_dist, index_t node, const float64_t* arr, float64_t* dists) const;
+
+	/** find the vectors within a distance of a query point recursively
+	 *
+	 * @param node current node
+	 * @param arr current query vector
+	 * @param radius maximum distance
+	 * @param result indices of the vectors found so far
+	 * @param dists buffer for the distances of a leaf
+	 */
+	void query_radius_single(index_t node, const float64_t* arr, float64_t radius, std::vector<index_t>& result, float64_t* dists) const;
 
 	/** find kde at each query point
 	 *
@@ -228,54 +319,92 @@ private:
 	 * @param spread_node spread of kernel values in node
 	 * @param min_bound_global stores the globally calculated min kernel density at query point
 	 * @param spread_global spread of kernel values accross entire tree
+	 * @param dists buffer for the distances of a leaf
 	 */
-	void get_kde_single(bnode_t* node,float64_t* data, EKernelType kernel, float64_t h, float64_t log_atol, float64_t log_rtol,
-	float64_t log_norm, float64_t min_bound_node, float64_t spread_node, float64_t &min_bound_global, float64_t &spread_global);
+	void get_kde_single(index_t node, const float64_t* data, EKDEKernelType kernel, float64_t h, float64_t log_atol, float64_t log_rtol,
+	float64_t log_norm, float64_t min_bound_node, float64_t spread_node, float64_t &min_bound_global, float64_t &spread_global, float64_t* dists) const;
 
 	/** depth-first traversal in dual trees for KDE
 	 *
+	 * @param query_tree query tree
 	 * @param refnode current node from reference tree
 	 * @param querynode current node from query tree
-	 * @param qid id vector of query tree
-	 * @param qdata query data matrix
 	 * @param log_density stores log of kernel density at each query point
 	 * @param kernel_type kernel type used
 	 * @param h kernel bandwidth
 	 * @param log_atol log absolute tolerance
 	 * @param log_rtol log relative tolerance
 	 * @param log_norm log of kernel norm
+	 * @param log_num_pairs log of number of query-reference pairs of the traversal
 	 * @param min_bound_node min evaluated kernel in node
 	 * @param spread_node spread of kernel values in node
 	 * @param min_bound_global stores the globally calculated min kernel density for all query points
 	 * @param spread_global spread of kernel values accross entire reference tree for all query points in query tree
+	 * @param point buffer for a query vector
+	 * @param dists buffer for the distances of a leaf
+	 */
+	void kde_dual(const CNbodyTree* query_tree, index_t refnode, index_t querynode, SGVector<float64_t>& log_density,
+	EKDEKernelType kernel_type, float64_t h, float64_t log_atol, float64_t log_rtol, float64_t log_norm, float64_t log_num_pairs,
+	float64_t min_bound_node, float64_t spread_node, float64_t &min_bound_global, float64_t &spread_global, float64_t* point,
+	float64_t* dists) const;
+
+	/** compute the bounds of the kernel sum over all pairs of a query node
+	 * and a reference node
+	 *
+	 * @param query_tree query tree
+	 * @param querynode node from query tree
+	 * @param refnode node from reference tree
+	 * @param kernel_type kernel type used
+	 * @param h kernel bandwidth
+	 * @param min_bound stores log of the min kernel sum
+	 * @param spread stores log of the spread of the kernel sum
 	 */
-	void kde_dual(bnode_t* refnode, bnode_t* querynode, SGVector<index_t> qid, SGMatrix<float64_t> qdata, SGVector<float64_t> log_density,
-	EKernelType kernel_type, float64_t h, float64_t log_atol, float64_t log_rtol, float64_t log_norm, float64_t min_bound_node,
-	float64_t spread_node, float64_t &min_bound_global, float64_t &spread_global);
+	void kde_dual_bounds(const CNbodyTree* query_tree, index_t querynode, index_t refnode, EKDEKernelType kernel_type, float64_t h,
+	float64_t &min_bound, float64_t &spread) const;
+
+	/** collect the subtrees of a tree that are processed in parallel
+	 *
+	 * @param node current node
+	 * @param max_size max number of vectors of a subtree
+	 * @param subtrees stores the roots of the subtrees
+	 */
+	void collect_subtrees(index_t node, index_t max_size, std::vector<index_t>& subtrees) const;
+
+	/** number of nodes of a tree of a number of vectors
+	 *
+	 * @param num_vectors number of vectors
+	 * @return number of nodes
+	 */
+	index_t count_nodes(index_t num_vectors) const;
 
 	/** recursive build
 	 *
+	 * @param data data matrix the tree is built on
+	 * @param node index of the root of the subtree
 	 * @param start start index of index vector for building subtree
 	 * @param end index of index vector for building subtree
-	 * @return root of subtree built
+	 * @param max_size subtrees of at most this many vectors are not built but deferred
+	 * @param deferred stores the deferred subtrees, NULL to build the complete subtree
 	 */
-	CBinaryTreeMachineNode<NbodyTreeNodeData>* recursive_build(index_t start, index_t end);
+	void recursive_build(const SGMatrix<float64_t>& data, index_t node, index_t start, index_t end, index_t max_size,
+	std::vector<index_t>* deferred);
 
 	/** rearrange vec_idx between start and end to enable partitioning
 	 *
+	 * @param data data matrix the tree is built on
 	 * @param dim the chosen dimension of split
 	 * @param start start index of index vector
 	 * @param end end index of index vector
 	 * @param mid the mid index about which split is to be carried out
 	 */
-	void partition(index_t dim, index_t start, index_t end, index_t mid);
+	void partition(const SGMatrix<float64_t>& data, index_t dim, index_t start, index_t end, index_t mid);
 
 	/** find dim with max spread for split
 	 *
 	 * @param node node which is to be split
 	 * @return split dimension
 	 */
-	index_t find_split_dim(bnode_t* node);
+	index_t find_split_dim(index_t node) const;
 
 	/** log-sum-exp trick for 2 numbers
 	 *
@@ -283,7 +412,7 @@ private:
 	 * @param y number 2
 	 * @return log of sum of exp of numbers
 	 */
-	inline float64_t logsumexp(float64_t x, float64_t y)
+	inline float64_t logsumexp(float64_t x, float64_t y) const
 	{
 		float64_t a=CMath::max(x,y);
 		if (a==-CMath::INFTY)
@@ -298,7 +427,7 @@ private:
 	 * @param y number 2
 	 * @return log of difference of exp of numbers
 	 */
-	inline float64_t logdiffexp(float64_t x, float64_t y)
+	inline float64_t logdiffexp(float64_t x, float64_t y) const
 	{
 		if (x<=y)
 			return -CMath::INFTY;
@@ -310,12 +439,33 @@ private:
 	void init();
 
 protected:
-	/** data matrix */
+	/** vectors in tree order, one column per dimension */
 	SGMatrix<float64_t> m_data;
 
 	/** vector id */
 	SGVector<index_t> m_vec_id;
 
+	/** dimension of the vectors */
+	int32_t m_dim;
+
+	/** start index of each node */
+	SGVector<index_t> m_node_start;
+
+	/** end index of each node */
+	SGVector<index_t> m_node_end;
+
+	/** right child of each node, -1 for leaves */
+	SGVector<index_t> m_node_right;
+
+	/** radius of the point cloud of each node */
+	SGVector<float64_t> m_node_radius;
+
+	/** lower bounds of the bounding box of each node, one column per node */
+	SGMatrix<float64_t> m_node_lower;
+
+	/** upper bounds of the bounding box of each node, one column per node */
+	SGMatrix<float64_t> m_node_upper;
+
 private:
 	/** leaf size */
 	int32_t m_leaf_size;
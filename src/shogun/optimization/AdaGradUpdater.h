@@ -102,6 +102,18 @@ public:
 		SGVector<float64_t> raw_negative_descend_direction,
 		float64_t learning_rate);
 
+	/** Update the target variable based on a sparse negative descend direction
+	 *
+	 * Only the given coordinates are updated, the accumulated squared gradients of the
+	 * others do not change.
+	 *
+	 * @param variable_reference a reference of the target variable
+	 * @param raw_negative_descend_direction the negative descend direction given the current value
+	 * @param learning_rate learning rate
+	 */
+	virtual void update_variable_sparse(SGVector<float64_t> variable_reference,
+		SGSparseVector<float64_t> raw_negative_descend_direction, float64_t learning_rate);
+
 protected:
 	/** Get the negative descend direction given current variable  and gradient 
 	 *
@@ -118,6 +130,12 @@ protected:
 	virtual float64_t get_negative_descend_direction(float64_t variable,
 		float64_t gradient, index_t idx, float64_t learning_rate);
 
+	/** Does the updater support lazy sparse updates?
+	 *
+	 * @return true
+	 */
+	virtual bool supports_lazy_update() { return true; }
+
 	/** learning_rate \f$ \alpha \f$ at iteration */
 	float64_t m_build_in_learning_rate;
 
@@ -129,6 +147,9 @@ protected:
 private:
 	/**  Init */
 	void init();
+
+	/** allocate the accumulated squared gradients */
+	void prepare_update(index_t len);
 };
 
 }
@@ -138,9 +138,38 @@ void AdamUpdater::update_variable(SGVector<float64_t> variable_reference,
 	SGVector<float64_t> raw_negative_descend_direction, float64_t learning_rate)
 {
 	REQUIRE(variable_reference.vlen==raw_negative_descend_direction.vlen, "");
+	prepare_update(variable_reference.vlen);
+	DescendUpdaterWithCorrection::update_variable(variable_reference, raw_negative_descend_direction,
+		learning_rate);
+}
+
+void AdamUpdater::update_variable_sparse(SGVector<float64_t> variable_reference,
+	SGSparseVector<float64_t> raw_negative_descend_direction, float64_t learning_rate)
+{
+	REQUIRE(variable_reference.vlen>0,"variable_reference must set\n");
+	/* the dense fallback advances the bias correction in update_variable() */
+	if(m_correction && !m_correction->supports_catch_up())
+	{
+		DescendUpdater::update_variable_sparse(variable_reference,
+			raw_negative_descend_direction, learning_rate);
+		return;
+	}
+	prepare_update(variable_reference.vlen);
+	DescendUpdaterWithCorrection::update_variable_sparse(variable_reference,
+		raw_negative_descend_direction, learning_rate);
+}
+
+void AdamUpdater::catch_up(index_t idx, int32_t num_steps)
+{
+	m_gradient_first_moment[idx]*=CMath::pow(m_decay_factor_first_moment, num_steps);
+	m_gradient_second_moment[idx]*=CMath::pow(m_decay_factor_second_moment, num_steps);
+}
+
+void AdamUpdater::prepare_update(index_t len)
+{
 	if(m_gradient_first_moment.vlen==0)
 	{
-		m_gradient_first_moment=SGVector<float64_t>(variable_reference.vlen);
+		m_gradient_first_moment=SGVector<float64_t>(len);
 		m_gradient_first_moment.set_const(0.0);
 
 		m_gradient_second_moment=SGVector<float64_t>(m_gradient_first_moment.vlen);
@@ -158,7 +187,4 @@ void AdamUpdater::update_variable(SGVector<float64_t> variable_reference,
 	        1.0 -
 	        CMath::pow(
 	            m_decay_factor_first_moment, (float64_t)m_iteration_counter));
-
-	DescendUpdaterWithCorrection::update_variable(variable_reference, raw_negative_descend_direction,
-		learning_rate);
 }
@@ -103,6 +103,20 @@ public:
 	virtual void update_variable(SGVector<float64_t> variable_reference,
 		SGVector<float64_t> raw_negative_descend_direction, float64_t learning_rate);
 
+	/** Update the target variable based on a sparse negative descend direction
+	 *
+	 * Only the given coordinates are updated. As in lazy variants of Adam, the
+	 * moments of the others are decayed when they are next updated, but the
+	 * steps the others would take in the meantime due to their first moments
+	 * are skipped.
+	 *
+	 * @param variable_reference a reference of the target variable
+	 * @param raw_negative_descend_direction the negative descend direction given the current value
+	 * @param learning_rate learning rate
+	 */
+	virtual void update_variable_sparse(SGVector<float64_t> variable_reference,
+		SGSparseVector<float64_t> raw_negative_descend_direction, float64_t learning_rate);
+
 protected:
 	/** Get the negative descend direction given current variable and gradient
 	 *
@@ -118,6 +132,20 @@ protected:
 	virtual float64_t get_negative_descend_direction(float64_t variable,
 		float64_t gradient, index_t idx, float64_t learning_rate);
 
+	/** Does the updater support lazy sparse updates?
+	 *
+	 * @return true
+	 */
+	virtual bool supports_lazy_update() { return true; }
+
+	/** Catch up on the state of a coordinate after several steps with zero
+	 * gradient, the moments decay
+	 *
+	 * @param idx the index of the variable
+	 * @param num_steps number of skipped steps
+	 */
+	virtual void catch_up(index_t idx, int32_t num_steps);
+
 	/* learning_rate at iteration */
 	float64_t m_log_learning_rate;
 
@@ -144,6 +172,9 @@ protected:
 private:
 	/*  Init */
 	void init();
+
+	/** allocate the moments and advance the bias correction */
+	void prepare_update(index_t len);
 };
 
 }
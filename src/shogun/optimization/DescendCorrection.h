@@ -79,6 +79,27 @@ public:
 	virtual DescendPair get_corrected_descend_direction(float64_t negative_descend_direction,
 		index_t idx)=0;
 
+	/** Does the correction support catching up on the steps of a coordinate
+	 * with zero negative descend direction at once?
+	 *
+	 * @return whether catch_up() is supported
+	 */
+	virtual bool supports_catch_up() { return false; }
+
+	/** Catch up on several steps of a coordinate with zero negative descend
+	 * direction, used for lazy updates of sparse descend directions
+	 *
+	 * @param idx the index of the variable
+	 * @param num_steps number of skipped steps
+	 *
+	 * @return the sum of the descend directions of the skipped steps
+	 */
+	virtual float64_t catch_up(index_t idx, int32_t num_steps)
+	{
+		SG_SNOTIMPLEMENTED
+		return 0.0;
+	}
+
 protected:
 	/**  weight of correction */
 	float64_t m_weight;
@@ -32,6 +32,7 @@
 #ifndef DESCENDUPDATER_H
 #define DESCENDUPDATER_H
 #include <shogun/lib/SGVector.h>
+#include <shogun/lib/SGSparseVector.h>
 #include <shogun/base/SGObject.h>
 namespace shogun
 {
@@ -62,6 +63,48 @@ public:
 	virtual void update_variable(SGVector<float64_t> variable_reference,
 		SGVector<float64_t> negative_descend_direction, float64_t learning_rate)=0;
 
+	/** Update the target variable based on a sparse negative descend direction
+	 *
+	 * Coordinates that are not in the direction have a zero negative descend
+	 * direction. Updaters that support it only touch the given coordinates
+	 * and catch up on the skipped steps of the others lazily, see
+	 * finish_sparse_update(). By default, the direction is scattered into a
+	 * dense workspace and passed to update_variable().
+	 *
+	 * @param variable_reference a reference of the target variable
+	 * @param negative_descend_direction the negative descend direction given
+	 * the current value, with unique indices
+	 * @param learning_rate learning rate
+	 */
+	virtual void update_variable_sparse(SGVector<float64_t> variable_reference,
+		SGSparseVector<float64_t> negative_descend_direction, float64_t learning_rate)
+	{
+		if(m_sparse_workspace.vlen!=variable_reference.vlen)
+		{
+			m_sparse_workspace=SGVector<float64_t>(variable_reference.vlen);
+			m_sparse_workspace.zero();
+		}
+		for(index_t i=0; i<negative_descend_direction.num_feat_entries; i++)
+		{
+			auto& entry=negative_descend_direction.features[i];
+			m_sparse_workspace[entry.feat_index]=entry.entry;
+		}
+		update_variable(variable_reference, m_sparse_workspace, learning_rate);
+		for(index_t i=0; i<negative_descend_direction.num_feat_entries; i++)
+			m_sparse_workspace[negative_descend_direction.features[i].feat_index]=0.0;
+	}
+
+	/** Apply the skipped steps of all coordinates after sparse updates
+	 *
+	 * This method is called by minimizers at the end of a pass over the data.
+	 *
+	 * @param variable_reference a reference of the target variable
+	 */
+	virtual void finish_sparse_update(SGVector<float64_t> variable_reference) {}
+
+protected:
+	/** dense negative descend direction for the default sparse update */
+	SGVector<float64_t> m_sparse_workspace;
 };
 
 }
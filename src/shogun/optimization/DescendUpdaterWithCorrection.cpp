@@ -86,9 +86,88 @@ void DescendUpdaterWithCorrection::update_variable(SGVector<float64_t> variable_
 	}
 }
 
+void DescendUpdaterWithCorrection::update_variable_sparse(SGVector<float64_t> variable_reference,
+	SGSparseVector<float64_t> raw_negative_descend_direction, float64_t learning_rate)
+{
+	REQUIRE(variable_reference.vlen>0,"variable_reference must set\n");
+	if(!supports_lazy_update() || (m_correction && !m_correction->supports_catch_up()))
+	{
+		DescendUpdater::update_variable_sparse(variable_reference,
+			raw_negative_descend_direction, learning_rate);
+		return;
+	}
+
+	if(m_correction)
+	{
+		MomentumCorrection* momentum_correction=dynamic_cast<MomentumCorrection *>(m_correction);
+		if(momentum_correction)
+		{
+			if(!momentum_correction->is_initialized())
+				momentum_correction->initialize_previous_direction(variable_reference.vlen);
+		}
+	}
+	if(m_last_sparse_step.vlen!=variable_reference.vlen)
+	{
+		m_last_sparse_step=SGVector<int32_t>(variable_reference.vlen);
+		m_last_sparse_step.set_const(m_sparse_step);
+	}
+
+	m_sparse_step++;
+	for(index_t i=0; i<raw_negative_descend_direction.num_feat_entries; i++)
+	{
+		index_t idx=raw_negative_descend_direction.features[i].feat_index;
+		REQUIRE(idx>=0 && idx<variable_reference.vlen,
+			"The index (%d) of the sparse direction is invalid\n", idx);
+		catch_up_coordinate(variable_reference, idx, m_sparse_step-1);
+		m_last_sparse_step[idx]=m_sparse_step;
+
+		float64_t negative_descend_direction=get_negative_descend_direction(
+			variable_reference[idx], raw_negative_descend_direction.features[i].entry,
+			idx, learning_rate);
+		if(m_correction)
+		{
+			DescendPair pair=m_correction->get_corrected_descend_direction(
+				negative_descend_direction, idx);
+			variable_reference[idx]+=pair.descend_direction;
+		}
+		else
+		{
+			variable_reference[idx]-=negative_descend_direction;
+		}
+	}
+}
+
+void DescendUpdaterWithCorrection::finish_sparse_update(SGVector<float64_t> variable_reference)
+{
+	if(m_last_sparse_step.vlen!=variable_reference.vlen)
+		return;
+
+	for(index_t idx=0; idx<variable_reference.vlen; idx++)
+		catch_up_coordinate(variable_reference, idx, m_sparse_step);
+}
+
+void DescendUpdaterWithCorrection::catch_up_coordinate(SGVector<float64_t> variable_reference,
+	index_t idx, int32_t step)
+{
+	int32_t num_steps=step-m_last_sparse_step[idx];
+	if(num_steps<=0)
+		return;
+
+	catch_up(idx, num_steps);
+	if(m_correction)
+		variable_reference[idx]+=m_correction->catch_up(idx, num_steps);
+	m_last_sparse_step[idx]=step;
+}
+
 void DescendUpdaterWithCorrection::init()
 {
 	m_correction=NULL;
+	m_sparse_step=0;
+	m_last_sparse_step=SGVector<int32_t>();
+	SG_ADD(&m_sparse_step, "DescendUpdaterWithCorrection__m_sparse_step",
+		"sparse_step in DescendUpdaterWithCorrection");
+	SG_ADD(&m_last_sparse_step, "DescendUpdaterWithCorrection__m_last_sparse_step",
+		"last_sparse_step in DescendUpdaterWithCorrection");
 	SG_ADD((CSGObject **)&m_correction, "DescendUpdaterWithCorrection__m_correction",
 		"correction in DescendUpdaterWithCorrection");
 }
@@ -51,6 +51,13 @@ namespace shogun
 class DescendUpdaterWithCorrection: public DescendUpdater
 {
 public:
+	/*  Constructor */
+	DescendUpdaterWithCorrection()
+		:DescendUpdater()
+	{
+		init();
+	}
+
 	/*  Destructor */
 	virtual ~DescendUpdaterWithCorrection();
 
@@ -66,6 +73,26 @@ public:
 	virtual void update_variable(SGVector<float64_t> variable_reference,
 		SGVector<float64_t> raw_negative_descend_direction, float64_t learning_rate);
 	
+	/** Update the target variable based on a sparse negative descend direction
+	 *
+	 * If the updater and the correction support it, only the given
+	 * coordinates are updated, after catching up on the steps they were
+	 * skipped in, see catch_up().
+	 *
+	 * @param variable_reference a reference of the target variable
+	 * @param raw_negative_descend_direction the negative descend direction
+	 * given the current value, with unique indices
+	 * @param learning_rate learning rate
+	 */
+	virtual void update_variable_sparse(SGVector<float64_t> variable_reference,
+		SGSparseVector<float64_t> raw_negative_descend_direction, float64_t learning_rate);
+
+	/** Catch up on the skipped steps of all coordinates after sparse updates
+	 *
+	 * @param variable_reference a reference of the target variable
+	 */
+	virtual void finish_sparse_update(SGVector<float64_t> variable_reference);
+
 	/** Set the type of descend correction
 	 *
 	 * @param correction the type of descend correction
@@ -95,13 +122,41 @@ protected:
 	virtual float64_t get_negative_descend_direction(float64_t variable,
 		float64_t raw_negative_descend_direction, index_t idx, float64_t learning_rate)=0;
 
+	/** Does the updater support lazy sparse updates?
+	 *
+	 * That is, does a coordinate with zero raw negative descend direction get
+	 * a zero negative descend direction, and can its state catch up on
+	 * several such steps at once with catch_up()?
+	 *
+	 * @return whether sparse updates are lazy
+	 */
+	virtual bool supports_lazy_update() { return false; }
+
+	/** Catch up on the state of a coordinate after several steps with zero
+	 * raw negative descend direction, for example decay its moving averages
+	 *
+	 * @param idx the index of the variable
+	 * @param num_steps number of skipped steps
+	 */
+	virtual void catch_up(index_t idx, int32_t num_steps) {}
+
 	/** descend correction object */
 	DescendCorrection* m_correction;
 
+	/** number of sparse updates */
+	int32_t m_sparse_step;
+
+	/** the sparse update in which each coordinate was last updated */
+	SGVector<int32_t> m_last_sparse_step;
+
 private:
 	/**  Init */
 	void init();
 
+	/** catch up on the skipped steps of a coordinate until the given
+	 * sparse update */
+	void catch_up_coordinate(SGVector<float64_t> variable_reference, index_t idx,
+		int32_t step);
 };
 
 }
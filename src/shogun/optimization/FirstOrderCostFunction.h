@@ -34,6 +34,10 @@
 #include <shogun/lib/config.h>
 #include <shogun/lib/SGVector.h>
 #include <shogun/base/SGObject.h>
+
+#include <algorithm>
+#include <cmath>
+
 namespace shogun
 {
 /** @brief The first order cost function base class.
@@ -82,6 +86,33 @@ public:
 	 * @return gradient of variables
 	 */
 	virtual SGVector<float64_t> get_gradient()=0;
+
+	/** Get the cost and the gradient wrt target variables in one call
+	 *
+	 * The default implementation calls get_cost() and get_gradient(), where
+	 * the gradient is skipped if the cost is not finite. Cost functions
+	 * which share work between the cost and the gradient should override
+	 * this method to compute both in one pass.
+	 *
+	 * This method will be called by CLBFGSMinimizer::minimize()
+	 *
+	 * @param gradient where the gradient is written to, of the length of
+	 * the target variables
+	 * @return cost
+	 */
+	virtual float64_t get_cost_and_gradient(SGVector<float64_t> gradient)
+	{
+		float64_t cost=get_cost();
+		if (!std::isfinite(cost))
+			return cost;
+
+		SGVector<float64_t> grad=get_gradient();
+		REQUIRE(grad.vlen==gradient.vlen,
+			"The length of gradient (%d) and the length of variable (%d) do not match\n",
+			grad.vlen,gradient.vlen);
+		std::copy(grad.vector,grad.vector+grad.vlen,gradient.vector);
+		return cost;
+	}
 };
 
 }
@@ -33,6 +33,7 @@
 #define FIRSTORDERSTOCHASTICCOSTFUNCTION_H
 #include <shogun/lib/config.h>
 #include <shogun/optimization/FirstOrderCostFunction.h>
+#include <shogun/lib/SGSparseVector.h>
 namespace shogun
 {
 /** @brief The first order stochastic cost function base class.
@@ -79,6 +80,65 @@ public:
 	 */
 	virtual SGVector<float64_t> get_gradient()=0;
 
+	/** Are the SAMPLE gradients sparse?
+	 *
+	 * If so, get_sparse_gradient() is implemented and minimizers only update
+	 * the coordinates of each sample gradient, which pays off when the
+	 * samples have far fewer non-zero gradients than there are variables
+	 * (eg, sparse or hashed features).
+	 *
+	 * @return whether the sample gradients are sparse
+	 */
+	virtual bool has_sparse_gradient() { return false; }
+
+	/** Get the SAMPLE gradient value wrt target variables as a sparse vector
+	 *
+	 * Like get_gradient(), for the sample obtained by next_sample(). Each
+	 * index must appear at most once.
+	 *
+	 * @return sparse sample gradient of variables
+	 */
+	virtual SGSparseVector<float64_t> get_sparse_gradient()
+	{
+		SG_SNOTIMPLEMENTED
+		return SGSparseVector<float64_t>();
+	}
+
+	/** Can sparse SAMPLE gradients be computed concurrently?
+	 *
+	 * If so, get_sample_size() and get_sparse_sample_gradient() are
+	 * implemented, which enables Hogwild style minimization, where several
+	 * threads update the target variables without locking.
+	 *
+	 * @return whether sample gradients can be computed concurrently
+	 */
+	virtual bool supports_concurrent_samples() { return false; }
+
+	/** Get the sample size
+	 *
+	 * @return the sample size
+	 */
+	virtual int32_t get_sample_size()
+	{
+		SG_SNOTIMPLEMENTED
+		return 0;
+	}
+
+	/** Get the sparse SAMPLE gradient of a given sample
+	 *
+	 * This method is called concurrently by several threads. It must not
+	 * change the state of the cost function and must tolerate that the
+	 * target variables are changed by other threads while it reads them.
+	 *
+	 * @param idx index of the sample, in [0, get_sample_size())
+	 * @return sparse sample gradient of variables
+	 */
+	virtual SGSparseVector<float64_t> get_sparse_sample_gradient(index_t idx)
+	{
+		SG_SNOTIMPLEMENTED
+		return SGSparseVector<float64_t>();
+	}
+
 	/** Get the cost given current target variables 
 	 *
 	 * For least squares, that is the value of \f$f(w)\f$.
@@ -84,6 +84,83 @@ void FirstOrderStochasticMinimizer::do_proximal_operation(SGVector<float64_t>var
 	}
 }
 
+void FirstOrderStochasticMinimizer::begin_sparse_step(index_t num_variables)
+{
+	if(m_last_penalty_step.vlen!=num_variables)
+	{
+		m_last_penalty_step=SGVector<int32_t>(num_variables);
+		m_last_penalty_step.set_const(m_sparse_step);
+		m_last_proximal_weight=SGVector<float64_t>(num_variables);
+		m_last_proximal_weight.set_const(m_cumulative_proximal_weight);
+	}
+	m_sparse_step++;
+
+	ProximalPenalty* proximal_penalty=dynamic_cast<ProximalPenalty*>(m_penalty_type);
+	if(proximal_penalty)
+	{
+		REQUIRE(dynamic_cast<SparsePenalty*>(m_penalty_type),
+			"Only sparse penalties (eg, L1) are supported as proximal penalties "
+			"for sparse gradients\n");
+		REQUIRE(m_learning_rate, "Learning rate must set when Sparse Penalty (eg, L1) is used\n");
+		m_cumulative_proximal_weight+=
+			m_penalty_weight*m_learning_rate->get_learning_rate(m_iter_counter);
+	}
+}
+
+void FirstOrderStochasticMinimizer::update_sparse_gradient(SGSparseVector<float64_t> gradient,
+	SGVector<float64_t> var)
+{
+	if(!m_penalty_type)
+		return;
+
+	REQUIRE(m_penalty_weight>0,"The weight of penalty must be set first\n");
+	for(index_t i=0; i<gradient.num_feat_entries; i++)
+	{
+		auto& entry=gradient.features[i];
+		index_t idx=entry.feat_index;
+		REQUIRE(idx>=0 && idx<var.vlen,
+			"The index (%d) of the sparse gradient is invalid\n", idx);
+		int32_t num_steps=m_sparse_step-m_last_penalty_step[idx];
+		m_last_penalty_step[idx]=m_sparse_step;
+		entry.entry+=num_steps*m_penalty_weight*
+			m_penalty_type->get_penalty_gradient(var[idx], entry.entry);
+	}
+}
+
+void FirstOrderStochasticMinimizer::do_sparse_proximal_operation(SGVector<float64_t> variable_reference,
+	SGSparseVector<float64_t> gradient)
+{
+	SparsePenalty* sparse_penalty=dynamic_cast<SparsePenalty*>(m_penalty_type);
+	if(!sparse_penalty)
+		return;
+
+	for(index_t i=0; i<gradient.num_feat_entries; i++)
+	{
+		index_t idx=gradient.features[i].feat_index;
+		variable_reference[idx]=sparse_penalty->get_sparse_variable(variable_reference[idx],
+			m_cumulative_proximal_weight-m_last_proximal_weight[idx]);
+		m_last_proximal_weight[idx]=m_cumulative_proximal_weight;
+	}
+}
+
+void FirstOrderStochasticMinimizer::finish_sparse_proximal_operation(SGVector<float64_t> variable_reference)
+{
+	SparsePenalty* sparse_penalty=dynamic_cast<SparsePenalty*>(m_penalty_type);
+	if(!sparse_penalty || m_last_proximal_weight.vlen!=variable_reference.vlen)
+		return;
+
+	for(index_t idx=0; idx<variable_reference.vlen; idx++)
+	{
+		float64_t proximal_weight=m_cumulative_proximal_weight-m_last_proximal_weight[idx];
+		if(proximal_weight>0)
+		{
+			variable_reference[idx]=sparse_penalty->get_sparse_variable(
+				variable_reference[idx], proximal_weight);
+			m_last_proximal_weight[idx]=m_cumulative_proximal_weight;
+		}
+	}
+}
+
 void FirstOrderStochasticMinimizer::init_minimization()
 {
 	REQUIRE(m_fun,"Cost function must set\n");
@@ -99,6 +176,10 @@ void FirstOrderStochasticMinimizer::init()
 	m_num_passes=0;
 	m_cur_passes=0;
 	m_iter_counter=0;
+	m_sparse_step=0;
+	m_last_penalty_step=SGVector<int32_t>();
+	m_cumulative_proximal_weight=0;
+	m_last_proximal_weight=SGVector<float64_t>();
 
 	SG_ADD((CSGObject **)&m_learning_rate, "FirstOrderMinimizer__m_learning_rate",
 		"learning_rate in FirstOrderStochasticMinimizer");
@@ -110,4 +191,12 @@ void FirstOrderStochasticMinimizer::init()
 		"cur_passes in FirstOrderStochasticMinimizer");
 	SG_ADD(&m_iter_counter, "FirstOrderMinimizer__m_iter_counter",
 		"m_iter_counter in FirstOrderStochasticMinimizer");
+	SG_ADD(&m_sparse_step, "FirstOrderMinimizer__m_sparse_step",
+		"sparse_step in FirstOrderStochasticMinimizer");
+	SG_ADD(&m_last_penalty_step, "FirstOrderMinimizer__m_last_penalty_step",
+		"last_penalty_step in FirstOrderStochasticMinimizer");
+	SG_ADD(&m_cumulative_proximal_weight, "FirstOrderMinimizer__m_cumulative_proximal_weight",
+		"cumulative_proximal_weight in FirstOrderStochasticMinimizer");
+	SG_ADD(&m_last_proximal_weight, "FirstOrderMinimizer__m_last_proximal_weight",
+		"last_proximal_weight in FirstOrderStochasticMinimizer");
 }
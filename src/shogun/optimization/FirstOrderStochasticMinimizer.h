@@ -146,6 +146,43 @@ protected:
 	/** init the minimization process*/
 	virtual void init_minimization();
 
+	/** Begin a step with a sparse sample gradient
+	 *
+	 * Penalties are applied to the coordinates of sparse sample gradients
+	 * just in time, that is when the coordinates are updated, for all steps
+	 * since their last update.
+	 *
+	 * @param num_variables number of target variables
+	 */
+	virtual void begin_sparse_step(index_t num_variables);
+
+	/** Add the penalty gradients of the steps since the last update of the
+	 * coordinates of a sparse sample gradient
+	 *
+	 * @param gradient sparse sample gradient
+	 * @param var the target variables
+	 */
+	virtual void update_sparse_gradient(SGSparseVector<float64_t> gradient,
+		SGVector<float64_t> var);
+
+	/** Do the proximal updates of the steps since the last update of the
+	 * coordinates of a sparse sample gradient in place
+	 *
+	 * The proximal weights of these steps add up, which is exact for the
+	 * soft-thresholding of SparsePenalty.
+	 *
+	 * @param variable_reference variable_reference to be updated
+	 * @param gradient sparse sample gradient
+	 */
+	virtual void do_sparse_proximal_operation(SGVector<float64_t> variable_reference,
+		SGSparseVector<float64_t> gradient);
+
+	/** Catch up on the proximal updates of all coordinates after sparse steps
+	 *
+	 * @param variable_reference variable_reference to be updated
+	 */
+	virtual void finish_sparse_proximal_operation(SGVector<float64_t> variable_reference);
+
 	/** the gradient update step */
 	DescendUpdater* m_gradient_updater;
 
@@ -160,6 +197,19 @@ protected:
 
 	/** learning_rate object */
 	LearningRate* m_learning_rate;
+
+	/** number of steps with sparse sample gradients */
+	int32_t m_sparse_step;
+
+	/** the sparse step in which the penalty gradient of each coordinate
+	 * was last applied */
+	SGVector<int32_t> m_last_penalty_step;
+
+	/** sum of the proximal weights of all sparse steps */
+	float64_t m_cumulative_proximal_weight;
+
+	/** sum of the proximal weights when each coordinate was last projected */
+	SGVector<float64_t> m_last_proximal_weight;
 	
 private:
 	/** Init */
@@ -0,0 +1,107 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ */
+
+#include <shogun/optimization/FirstOrderSumCostFunction.h>
+#include <shogun/base/Parameter.h>
+#include <shogun/lib/SGMatrix.h>
+#include <shogun/mathematics/Math.h>
+
+using namespace shogun;
+
+FirstOrderSumCostFunction::FirstOrderSumCostFunction()
+	:FirstOrderCostFunction()
+{
+	init();
+}
+
+void FirstOrderSumCostFunction::init()
+{
+	m_min_block_size=256;
+	m_max_num_blocks=64;
+
+	SG_ADD(&m_min_block_size, "FirstOrderSumCostFunction__m_min_block_size",
+		"minimum number of samples of a block");
+	SG_ADD(&m_max_num_blocks, "FirstOrderSumCostFunction__m_max_num_blocks",
+		"maximum number of blocks");
+}
+
+void FirstOrderSumCostFunction::set_min_block_size(index_t min_block_size)
+{
+	REQUIRE(min_block_size>0, "Minimum block size (%d) must be positive\n",
+		min_block_size);
+	m_min_block_size=min_block_size;
+}
+
+void FirstOrderSumCostFunction::set_max_num_blocks(index_t max_num_blocks)
+{
+	REQUIRE(max_num_blocks>0, "Maximum number of blocks (%d) must be positive\n",
+		max_num_blocks);
+	m_max_num_blocks=max_num_blocks;
+}
+
+index_t FirstOrderSumCostFunction::get_num_blocks(index_t num_samples) const
+{
+	index_t num_blocks=(num_samples+m_min_block_size-1)/m_min_block_size;
+	return CMath::max(CMath::min(num_blocks, m_max_num_blocks), 1);
+}
+
+float64_t FirstOrderSumCostFunction::get_cost()
+{
+	index_t num_samples=get_sample_size();
+	index_t num_blocks=get_num_blocks(num_samples);
+	SGVector<float64_t> costs(num_blocks);
+
+	#pragma omp parallel for schedule(dynamic)
+	for (index_t b=0; b<num_blocks; b++)
+	{
+		costs[b]=get_block_cost(int64_t(num_samples)*b/num_blocks,
+			int64_t(num_samples)*(b+1)/num_blocks);
+	}
+
+	/* summed in the order of the blocks for reproducible results */
+	float64_t cost=0;
+	for (index_t b=0; b<num_blocks; b++)
+		cost+=costs[b];
+	return cost;
+}
+
+SGVector<float64_t> FirstOrderSumCostFunction::get_gradient()
+{
+	SGVector<float64_t> gradient(obtain_variable_reference().vlen);
+	get_cost_and_gradient(gradient);
+	return gradient;
+}
+
+float64_t FirstOrderSumCostFunction::get_cost_and_gradient(
+	SGVector<float64_t> gradient)
+{
+	index_t dim=gradient.vlen;
+	index_t num_samples=get_sample_size();
+	index_t num_blocks=get_num_blocks(num_samples);
+	SGVector<float64_t> costs(num_blocks);
+	SGMatrix<float64_t> gradients(dim, num_blocks);
+	gradients.zero();
+
+	#pragma omp parallel for schedule(dynamic)
+	for (index_t b=0; b<num_blocks; b++)
+	{
+		SGVector<float64_t> block_gradient(gradients.get_column_vector(b),
+			dim, false);
+		costs[b]=add_block_cost_and_gradient(
+			int64_t(num_samples)*b/num_blocks,
+			int64_t(num_samples)*(b+1)/num_blocks, block_gradient);
+	}
+
+	/* summed in the order of the blocks for reproducible results */
+	float64_t cost=0;
+	gradient.zero();
+	for (index_t b=0; b<num_blocks; b++)
+	{
+		cost+=costs[b];
+		float64_t* block_gradient=gradients.get_column_vector(b);
+		for (index_t i=0; i<dim; i++)
+			gradient[i]+=block_gradient[i];
+	}
+	return cost;
+}
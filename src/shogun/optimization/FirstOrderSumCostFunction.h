@@ -0,0 +1,136 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ */
+
+#ifndef FIRSTORDERSUMCOSTFUNCTION_H
+#define FIRSTORDERSUMCOSTFUNCTION_H
+#include <shogun/lib/config.h>
+#include <shogun/optimization/FirstOrderCostFunction.h>
+namespace shogun
+{
+/** @brief The first order cost function base class for costs which are sums
+ * over samples.
+ *
+ * For example: least square cost function \f$f(w)\f$
+ * \f[
+ * f(w)=\sum_i{(y_i-w^T x_i)^2}
+ * \f]
+ *
+ * Sub-classes give the cost and the gradient of a block of consecutive
+ * samples. The samples are split into blocks which are evaluated in
+ * parallel, and the results of the blocks are summed in the order of the
+ * blocks. The blocks only depend on the number of samples, the minimum block
+ * size and the maximum number of blocks, so the cost and the gradient do not
+ * depend on the number of threads.
+ *
+ * get_cost_and_gradient() evaluates the cost and the gradient of a block in
+ * one pass, which is used by CLBFGSMinimizer.
+ */
+class FirstOrderSumCostFunction: public FirstOrderCostFunction
+{
+public:
+	/** default constructor */
+	FirstOrderSumCostFunction();
+
+	virtual ~FirstOrderSumCostFunction() {};
+
+	/** Get the number of samples
+	 *
+	 * @return the number of samples
+	 */
+	virtual index_t get_sample_size()=0;
+
+	/** Get the cost given current target variables
+	 *
+	 * @return the sum of the costs of all blocks
+	 */
+	virtual float64_t get_cost();
+
+	/** Get the gradient value wrt target variables
+	 *
+	 * @return the sum of the gradients of all blocks
+	 */
+	virtual SGVector<float64_t> get_gradient();
+
+	/** Get the cost and the gradient wrt target variables in one pass over
+	 * the samples
+	 *
+	 * @param gradient where the gradient is written to
+	 * @return cost
+	 */
+	virtual float64_t get_cost_and_gradient(SGVector<float64_t> gradient);
+
+	/** Set the minimum number of samples of a block
+	 *
+	 * @param min_block_size minimum number of samples (default 256)
+	 */
+	virtual void set_min_block_size(index_t min_block_size);
+
+	/** Get the minimum number of samples of a block
+	 *
+	 * @return minimum number of samples
+	 */
+	virtual index_t get_min_block_size() const { return m_min_block_size; }
+
+	/** Set the maximum number of blocks, which bounds the memory of the
+	 * partial gradients
+	 *
+	 * @param max_num_blocks maximum number of blocks (default 64)
+	 */
+	virtual void set_max_num_blocks(index_t max_num_blocks);
+
+	/** Get the maximum number of blocks
+	 *
+	 * @return maximum number of blocks
+	 */
+	virtual index_t get_max_num_blocks() const { return m_max_num_blocks; }
+
+	/** @return object name */
+	virtual const char* get_name() const { return "FirstOrderSumCostFunction"; }
+
+protected:
+	/** Get the cost of samples [begin, end)
+	 *
+	 * This method is called concurrently for different blocks, and must
+	 * not modify shared state.
+	 *
+	 * @param begin first sample of the block
+	 * @param end one past the last sample of the block
+	 * @return the cost of the block
+	 */
+	virtual float64_t get_block_cost(index_t begin, index_t end)=0;
+
+	/** Get the cost of samples [begin, end) and add their gradient
+	 *
+	 * This method is called concurrently for different blocks, and must
+	 * not modify shared state.
+	 *
+	 * @param begin first sample of the block
+	 * @param end one past the last sample of the block
+	 * @param gradient where the gradient of the block is added to
+	 * @return the cost of the block
+	 */
+	virtual float64_t add_block_cost_and_gradient(index_t begin, index_t end,
+		SGVector<float64_t> gradient)=0;
+
+	/** Get the number of blocks
+	 *
+	 * @param num_samples number of samples
+	 * @return number of blocks
+	 */
+	index_t get_num_blocks(index_t num_samples) const;
+
+private:
+	/** init */
+	void init();
+
+	/** minimum number of samples of a block */
+	index_t m_min_block_size;
+
+	/** maximum number of blocks */
+	index_t m_max_num_blocks;
+};
+
+}
+
+#endif
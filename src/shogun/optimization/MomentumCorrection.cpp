@@ -30,6 +30,7 @@
  */
 
 #include <shogun/optimization/MomentumCorrection.h>
+#include <shogun/mathematics/Math.h>
 #include <shogun/base/Parameter.h>
 using namespace shogun;
 
@@ -40,6 +41,19 @@ void MomentumCorrection::initialize_previous_direction(index_t len)
 	m_previous_descend_direction.set_const(0.0);
 }
 
+float64_t MomentumCorrection::decay_previous_descend_direction(index_t idx,
+	int32_t num_steps)
+{
+	REQUIRE(idx>=0 && idx<m_previous_descend_direction.vlen,"The index (%d) is invalid\n", idx);
+	float64_t velocity=m_previous_descend_direction[idx];
+	float64_t decay=CMath::pow(m_weight, num_steps);
+	m_previous_descend_direction[idx]=decay*velocity;
+	/* geometric series \sum_{k=1}^{num_steps} \mu^k */
+	if(m_weight==1.0)
+		return num_steps*velocity;
+	return m_weight*(1.0-decay)/(1.0-m_weight)*velocity;
+}
+
 float64_t MomentumCorrection::get_previous_descend_direction(index_t idx)
 {
 	REQUIRE(idx>=0 && idx<m_previous_descend_direction.vlen,
@@ -98,6 +98,16 @@ public:
 	}
 
 protected:
+	/** Decay the previous descend direction of a coordinate over several
+	 * steps with zero negative descend direction
+	 *
+	 * @param idx index of the previous descend direction
+	 * @param num_steps number of steps
+	 *
+	 * @return the sum of the decayed previous descend directions of the steps
+	 */
+	virtual float64_t decay_previous_descend_direction(index_t idx, int32_t num_steps);
+
 	/**  used in momentum methods */
 	SGVector<float64_t> m_previous_descend_direction;
 
@@ -45,6 +45,11 @@ DescendPair NesterovMomentumCorrection::get_corrected_descend_direction(float64_
 	return pair;
 }
 
+float64_t NesterovMomentumCorrection::catch_up(index_t idx, int32_t num_steps)
+{
+	return m_weight*decay_previous_descend_direction(idx, num_steps);
+}
+
 void NesterovMomentumCorrection::init()
 {
 	m_weight=0.9;
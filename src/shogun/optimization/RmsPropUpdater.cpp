@@ -110,10 +110,29 @@ void RmsPropUpdater::update_variable(SGVector<float64_t> variable_reference,
 	REQUIRE(variable_reference.vlen==raw_negative_descend_direction.vlen,
 		"The length of variable_reference (%d) and the length of gradient (%d) do not match\n",
 		variable_reference.vlen,raw_negative_descend_direction.vlen);
+	prepare_update(variable_reference.vlen);
+	DescendUpdaterWithCorrection::update_variable(variable_reference, raw_negative_descend_direction, learning_rate);
+}
+
+void RmsPropUpdater::update_variable_sparse(SGVector<float64_t> variable_reference,
+	SGSparseVector<float64_t> raw_negative_descend_direction, float64_t learning_rate)
+{
+	REQUIRE(variable_reference.vlen>0,"variable_reference must set\n");
+	prepare_update(variable_reference.vlen);
+	DescendUpdaterWithCorrection::update_variable_sparse(variable_reference,
+		raw_negative_descend_direction, learning_rate);
+}
+
+void RmsPropUpdater::catch_up(index_t idx, int32_t num_steps)
+{
+	m_gradient_accuracy[idx]*=CMath::pow(m_decay_factor, num_steps);
+}
+
+void RmsPropUpdater::prepare_update(index_t len)
+{
 	if(m_gradient_accuracy.vlen==0)
 	{
-		m_gradient_accuracy=SGVector<float64_t>(variable_reference.vlen);
+		m_gradient_accuracy=SGVector<float64_t>(len);
 		m_gradient_accuracy.set_const(0.0);
 	}
-	DescendUpdaterWithCorrection::update_variable(variable_reference, raw_negative_descend_direction, learning_rate);
 }
@@ -106,6 +106,18 @@ public:
 	 */
 	virtual void update_variable(SGVector<float64_t> variable_reference,
 		SGVector<float64_t> raw_negative_descend_direction, float64_t learning_rate);
+
+	/** Update the target variable based on a sparse negative descend direction
+	 *
+	 * Only the given coordinates are updated, the moving averages of the
+	 * others are decayed when they are next updated.
+	 *
+	 * @param variable_reference a reference of the target variable
+	 * @param raw_negative_descend_direction the negative descend direction given the current value
+	 * @param learning_rate learning rate
+	 */
+	virtual void update_variable_sparse(SGVector<float64_t> variable_reference,
+		SGSparseVector<float64_t> raw_negative_descend_direction, float64_t learning_rate);
 protected:
 	/** Get the negative descend direction given current variable  and gradient 
 	 *
@@ -121,6 +133,20 @@ protected:
 	virtual float64_t get_negative_descend_direction(float64_t variable,
 		float64_t gradient, index_t idx, float64_t learning_rate);
 
+	/** Does the updater support lazy sparse updates?
+	 *
+	 * @return true
+	 */
+	virtual bool supports_lazy_update() { return true; }
+
+	/** Catch up on the state of a coordinate after several steps with zero
+	 * gradient, the moving average of the squared gradients decays
+	 *
+	 * @param idx the index of the variable
+	 * @param num_steps number of skipped steps
+	 */
+	virtual void catch_up(index_t idx, int32_t num_steps);
+
 	/** learning_rate \f$\alpha\f$ at iteration */
 	float64_t m_build_in_learning_rate;
 
@@ -135,6 +161,9 @@ protected:
 private:
 	/**  Init */
 	void init();
+
+	/** allocate the moving average of the squared gradients */
+	void prepare_update(index_t len);
 };
 
 }
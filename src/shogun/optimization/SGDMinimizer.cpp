@@ -29,7 +29,10 @@
  *
  */
 #include <shogun/optimization/SGDMinimizer.h>
+#include <shogun/lib/MemoryArena.h>
 #include <shogun/optimization/GradientDescendUpdater.h>
+#include <shogun/optimization/ProximalPenalty.h>
+#include <shogun/base/Parameter.h>
 #include <shogun/lib/config.h>
 using namespace shogun;
 
@@ -56,8 +59,24 @@ float64_t SGDMinimizer::minimize()
 	SGVector<float64_t> variable_reference=m_fun->obtain_variable_reference();
 	FirstOrderStochasticCostFunction *fun=dynamic_cast<FirstOrderStochasticCostFunction *>(m_fun);
 	REQUIRE(fun,"the cost function must be a stochastic cost function\n");
+	if(m_hogwild)
+	{
+		minimize_hogwild(fun, variable_reference);
+		float64_t cost=m_fun->get_cost();
+		return cost+get_penalty(variable_reference);
+	}
+	if(fun->has_sparse_gradient())
+	{
+		minimize_sparse(fun, variable_reference);
+		float64_t cost=m_fun->get_cost();
+		return cost+get_penalty(variable_reference);
+	}
+
+	/* gradients are temporaries of a single sample */
+	MemoryArena arena;
 	for(;m_cur_passes<m_num_passes;m_cur_passes++)
 	{
+		ArenaScope arena_scope(arena);
 		fun->begin_sample();
 		while(fun->next_sample())
 		{
@@ -76,8 +95,96 @@ float64_t SGDMinimizer::minimize()
 	return cost+get_penalty(variable_reference);
 }
 
+void SGDMinimizer::minimize_sparse(FirstOrderStochasticCostFunction* fun,
+	SGVector<float64_t> variable_reference)
+{
+	MemoryArena arena;
+	for(;m_cur_passes<m_num_passes;m_cur_passes++)
+	{
+		ArenaScope arena_scope(arena);
+		fun->begin_sample();
+		while(fun->next_sample())
+		{
+			m_iter_counter++;
+			float64_t learning_rate=1.0;
+			if(m_learning_rate)
+				learning_rate=m_learning_rate->get_learning_rate(m_iter_counter);
+			begin_sparse_step(variable_reference.vlen);
+			SGSparseVector<float64_t> grad=fun->get_sparse_gradient();
+			update_sparse_gradient(grad,variable_reference);
+			m_gradient_updater->update_variable_sparse(variable_reference,grad,learning_rate);
+
+			do_sparse_proximal_operation(variable_reference,grad);
+		}
+		m_gradient_updater->finish_sparse_update(variable_reference);
+		finish_sparse_proximal_operation(variable_reference);
+	}
+}
+
+void SGDMinimizer::minimize_hogwild(FirstOrderStochasticCostFunction* fun,
+	SGVector<float64_t> variable_reference)
+{
+	REQUIRE(fun->supports_concurrent_samples(),
+		"The cost function must support concurrent samples in Hogwild mode\n");
+	GradientDescendUpdater* updater=dynamic_cast<GradientDescendUpdater*>(m_gradient_updater);
+	REQUIRE(updater && !updater->enables_descend_correction(),
+		"Hogwild mode requires a GradientDescendUpdater without correction\n");
+	REQUIRE(!dynamic_cast<ProximalPenalty*>(m_penalty_type),
+		"Proximal penalties are not supported in Hogwild mode\n");
+	REQUIRE(!m_penalty_type || m_penalty_weight>0,
+		"The weight of penalty must be set first\n");
+
+	index_t num_samples=fun->get_sample_size();
+	for(;m_cur_passes<m_num_passes;m_cur_passes++)
+	{
+		int32_t first_iter=m_iter_counter;
+		/* errors cannot be raised in the parallel region */
+		index_t invalid_index=-1;
+		#pragma omp parallel
+		{
+			/* gradients are temporaries of a single sample */
+			MemoryArena arena;
+			ArenaScope arena_scope(arena);
+
+			#pragma omp for schedule(dynamic, 64)
+			for(index_t i=0; i<num_samples; i++)
+			{
+				float64_t learning_rate=1.0;
+				if(m_learning_rate)
+					learning_rate=m_learning_rate->get_learning_rate(first_iter+i+1);
+
+				/* variables are read and written without locks */
+				SGSparseVector<float64_t> grad=fun->get_sparse_sample_gradient(i);
+				for(index_t k=0; k<grad.num_feat_entries; k++)
+				{
+					index_t idx=grad.features[k].feat_index;
+					if(idx<0 || idx>=variable_reference.vlen)
+					{
+						#pragma omp critical
+						invalid_index=idx;
+						continue;
+					}
+					float64_t gradient=grad.features[k].entry;
+					if(m_penalty_type)
+					{
+						gradient+=m_penalty_weight*m_penalty_type->get_penalty_gradient(
+							variable_reference[idx], gradient);
+					}
+					variable_reference[idx]-=learning_rate*gradient;
+				}
+			}
+		}
+		REQUIRE(invalid_index==-1,
+			"The index (%d) of the sparse gradient is invalid\n", invalid_index);
+		m_iter_counter+=num_samples;
+	}
+}
+
 void SGDMinimizer::init()
 {
+	m_hogwild=false;
+	SG_ADD(&m_hogwild, "SGDMinimizer__m_hogwild",
+		"hogwild in SGDMinimizer");
 }
 
 void SGDMinimizer::init_minimization()
@@ -40,6 +40,21 @@ namespace shogun
  *
  * A good introduction to SGD can be found at
  * http://cs231n.github.io/neural-networks-3/#sgd
+ *
+ * If the cost function has sparse sample gradients (see
+ * FirstOrderStochasticCostFunction::has_sparse_gradient()), each step only
+ * updates the coordinates of the sample gradient. Penalties and the state of
+ * the gradient updater catch up on the skipped steps of a coordinate when it
+ * is next updated, so a sample gradient sees the coordinates as of their
+ * last update.
+ *
+ * In Hogwild mode, the samples of a pass are distributed over threads, which
+ * do plain gradient steps on the sparse sample gradients without locking the
+ * target variables, see
+ *
+ * Niu, F., Recht, B., Re, C., & Wright, S. J. (2011).
+ * Hogwild!: A lock-free approach to parallelizing stochastic gradient descent.
+ * In Advances in Neural Information Processing Systems (pp. 693-701).
  */
 
 class SGDMinimizer: public FirstOrderStochasticMinimizer
@@ -69,10 +84,44 @@ public:
 	 */
 	virtual float64_t minimize();
 
+	/** Enable Hogwild mode, which requires a cost function that supports
+	 * concurrent samples, a GradientDescendUpdater without correction and no
+	 * proximal penalty. The penalty gradient is applied to the coordinates of
+	 * the sample gradients.
+	 *
+	 * @param hogwild whether to update the variables from several threads
+	 */
+	void set_hogwild(bool hogwild) { m_hogwild=hogwild; }
+
+	/** Is Hogwild mode enabled?
+	 *
+	 * @return whether to update the variables from several threads
+	 */
+	bool get_hogwild() const { return m_hogwild; }
+
 protected:
 	/*  init the minimization process */
 	virtual void init_minimization();
 
+	/** Do the passes with sparse sample gradients
+	 *
+	 * @param fun stochastic cost function
+	 * @param variable_reference the target variables
+	 */
+	virtual void minimize_sparse(FirstOrderStochasticCostFunction* fun,
+		SGVector<float64_t> variable_reference);
+
+	/** Do the passes in Hogwild mode
+	 *
+	 * @param fun stochastic cost function
+	 * @param variable_reference the target variables
+	 */
+	virtual void minimize_hogwild(FirstOrderStochasticCostFunction* fun,
+		SGVector<float64_t> variable_reference);
+
+	/** whether to update the variables from several threads */
+	bool m_hogwild;
+
 private:
 	  /* Init */
 	void init();
@@ -28,6 +28,7 @@
  *
  */
 #include <shogun/optimization/SMDMinimizer.h>
+#include <shogun/lib/MemoryArena.h>
 #include <shogun/base/Parameter.h>
 using namespace shogun;
 
@@ -56,8 +57,11 @@ float64_t SMDMinimizer::minimize()
 	SGVector<float64_t> dual_variable=m_mapping_fun->get_dual_variable(variable_reference);
 	FirstOrderStochasticCostFunction *fun=dynamic_cast<FirstOrderStochasticCostFunction *>(m_fun);
 	REQUIRE(fun,"the cost function must be a stochastic cost function\n");
+	/* gradients are temporaries of a single sample */
+	MemoryArena arena;
 	for(;m_cur_passes<m_num_passes;m_cur_passes++)
 	{
+		ArenaScope arena_scope(arena);
 		fun->begin_sample();
 		while(fun->next_sample())
 		{
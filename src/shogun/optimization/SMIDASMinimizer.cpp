@@ -29,6 +29,7 @@
  *
  */
 #include <shogun/optimization/SMIDASMinimizer.h>
+#include <shogun/lib/MemoryArena.h>
 #include <shogun/lib/config.h>
 #include <shogun/optimization/L1Penalty.h>
 #include <shogun/optimization/GradientDescendUpdater.h>
@@ -70,8 +71,11 @@ float64_t SMIDASMinimizer::minimize()
 
 	FirstOrderStochasticCostFunction *fun=dynamic_cast<FirstOrderStochasticCostFunction *>(m_fun);
 	REQUIRE(fun,"the cost function must be a stochastic cost function\n");
+	/* gradients are temporaries of a single sample */
+	MemoryArena arena;
 	for(;m_cur_passes<m_num_passes;m_cur_passes++)
 	{
+		ArenaScope arena_scope(arena);
 		fun->begin_sample();
 		while(fun->next_sample())
 		{
@@ -29,6 +29,7 @@
  *
  */
 #include <shogun/optimization/SVRGMinimizer.h>
+#include <shogun/lib/MemoryArena.h>
 #include <shogun/optimization/SGDMinimizer.h>
 #include <shogun/base/Parameter.h>
 using namespace shogun;
@@ -93,6 +94,10 @@ float64_t SVRGMinimizer::minimize()
 	SGVector<float64_t> variable_reference=m_fun->obtain_variable_reference();
 	FirstOrderSAGCostFunction *fun=dynamic_cast<FirstOrderSAGCostFunction *>(m_fun);
 	REQUIRE(fun,"the cost function must be a stochastic average gradient cost function\n");
+	/* gradients are temporaries of a single sample */
+	MemoryArena arena;
+	/* current variables while the gradient at the snapshot is computed */
+	SGVector<float64_t> var(variable_reference.vlen);
 	for(;m_cur_passes<(m_num_passes-m_num_sgd_passes);m_cur_passes++)
 	{
 		if(m_cur_passes%m_svrg_interval==0)
@@ -103,6 +108,7 @@ float64_t SVRGMinimizer::minimize()
 			std::copy(variable_reference.vector, variable_reference.vector+variable_reference.vlen, m_previous_variable.vector);
 			m_average_gradient=fun->get_average_gradient();
 		}
+		ArenaScope arena_scope(arena);
 		fun->begin_sample();
 		while(fun->next_sample())
 		{
@@ -112,7 +118,6 @@ float64_t SVRGMinimizer::minimize()
 				learning_rate=m_learning_rate->get_learning_rate(m_iter_counter);
 
 			SGVector<float64_t> grad_new=m_fun->get_gradient();
-			SGVector<float64_t> var(variable_reference.vlen);
 			std::copy(variable_reference.vector, variable_reference.vector+variable_reference.vlen, var.vector);
 
 			std::copy(m_previous_variable.vector, m_previous_variable.vector+m_previous_variable.vlen, variable_reference.vector);
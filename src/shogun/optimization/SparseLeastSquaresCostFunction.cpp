@@ -0,0 +1,97 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ */
+
+#include <shogun/optimization/SparseLeastSquaresCostFunction.h>
+
+using namespace shogun;
+
+SparseLeastSquaresCostFunction::SparseLeastSquaresCostFunction()
+	:FirstOrderStochasticCostFunction()
+{
+	init();
+}
+
+void SparseLeastSquaresCostFunction::init()
+{
+	m_idx=-1;
+	m_features=SGSparseMatrix<float64_t>();
+	m_labels=SGVector<float64_t>();
+	m_weight=SGVector<float64_t>();
+}
+
+void SparseLeastSquaresCostFunction::set_data(SGSparseMatrix<float64_t> features,
+	SGVector<float64_t> labels)
+{
+	REQUIRE(features.num_vectors==labels.vlen,
+		"The number of feature vectors (%d) and labels (%d) do not match\n",
+		features.num_vectors, labels.vlen);
+	m_features=features;
+	m_labels=labels;
+	m_weight=SGVector<float64_t>(features.num_features);
+	m_weight.set_const(0.0);
+	m_idx=-1;
+}
+
+float64_t SparseLeastSquaresCostFunction::get_cost()
+{
+	float64_t cost=0;
+	for(index_t i=0; i<m_labels.vlen; i++)
+	{
+		float64_t residual=m_features[i].dense_dot(1.0, m_weight.vector, m_weight.vlen, 0.0)-m_labels[i];
+		cost+=0.5*residual*residual;
+	}
+	return cost;
+}
+
+SGVector<float64_t> SparseLeastSquaresCostFunction::obtain_variable_reference()
+{
+	return m_weight;
+}
+
+SGVector<float64_t> SparseLeastSquaresCostFunction::get_gradient()
+{
+	SGVector<float64_t> result(m_weight.vlen);
+	result.set_const(0.0);
+	SGSparseVector<float64_t> grad=get_sparse_gradient();
+	for(index_t k=0; k<grad.num_feat_entries; k++)
+		result[grad.features[k].feat_index]=grad.features[k].entry;
+	return result;
+}
+
+SGSparseVector<float64_t> SparseLeastSquaresCostFunction::get_sparse_gradient()
+{
+	REQUIRE(m_idx>=0 && m_idx<m_labels.vlen,
+		"Call next_sample() before getting the sample gradient\n");
+	return get_sparse_sample_gradient(m_idx);
+}
+
+int32_t SparseLeastSquaresCostFunction::get_sample_size()
+{
+	return m_labels.vlen;
+}
+
+SGSparseVector<float64_t> SparseLeastSquaresCostFunction::get_sparse_sample_gradient(index_t idx)
+{
+	/* other threads may update the weights meanwhile in Hogwild mode */
+	SGSparseVector<float64_t>& x=m_features[idx];
+	float64_t residual=x.dense_dot(1.0, m_weight.vector, m_weight.vlen, 0.0)-m_labels[idx];
+	SGSparseVector<float64_t> result(x.num_feat_entries);
+	for(index_t k=0; k<x.num_feat_entries; k++)
+	{
+		result.features[k].feat_index=x.features[k].feat_index;
+		result.features[k].entry=residual*x.features[k].entry;
+	}
+	return result;
+}
+
+void SparseLeastSquaresCostFunction::begin_sample()
+{
+	m_idx=-1;
+}
+
+bool SparseLeastSquaresCostFunction::next_sample()
+{
+	m_idx++;
+	return m_idx<m_labels.vlen;
+}
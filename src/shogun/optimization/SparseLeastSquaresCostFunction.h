@@ -0,0 +1,120 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ */
+
+#ifndef SPARSELEASTSQUARESCOSTFUNCTION_H
+#define SPARSELEASTSQUARESCOSTFUNCTION_H
+#include <shogun/lib/config.h>
+#include <shogun/optimization/FirstOrderStochasticCostFunction.h>
+#include <shogun/lib/SGSparseMatrix.h>
+#include <shogun/lib/SGVector.h>
+namespace shogun
+{
+/** @brief The least squares cost function of a linear model on sparse
+ * features.
+ *
+ * \f[
+ * f(w)=\frac{ \sum_i{ (w^T x_i-y_i)^2 } }{2}
+ * \f]
+ * where \f$x_i\f$ is the i-th sparse feature vector and \f$y_i\f$ its label.
+ *
+ * A sample gradient \f$(w^T x_i-y_i) x_i\f$ only has the non-zero entries of
+ * \f$x_i\f$, so SGDMinimizer only updates those coordinates. The sample
+ * gradients can be computed concurrently, which enables the Hogwild mode of
+ * SGDMinimizer.
+ */
+class SparseLeastSquaresCostFunction: public FirstOrderStochasticCostFunction
+{
+public:
+	/** default constructor */
+	SparseLeastSquaresCostFunction();
+
+	virtual ~SparseLeastSquaresCostFunction() {}
+
+	/** Set the samples, the weights of the linear model start at zero
+	 *
+	 * @param features sparse feature vectors with unique indices
+	 * @param labels one label per feature vector
+	 */
+	void set_data(SGSparseMatrix<float64_t> features, SGVector<float64_t> labels);
+
+	/** Get the cost given current target variables
+	 *
+	 * @return cost
+	 */
+	virtual float64_t get_cost();
+
+	/** Obtain a reference of the weights of the linear model
+	 *
+	 * @return the weights
+	 */
+	virtual SGVector<float64_t> obtain_variable_reference();
+
+	/** Get the SAMPLE gradient value wrt target variables as a dense vector
+	 *
+	 * @return sample gradient of variables
+	 */
+	virtual SGVector<float64_t> get_gradient();
+
+	/** Are the SAMPLE gradients sparse?
+	 *
+	 * @return true
+	 */
+	virtual bool has_sparse_gradient() { return true; }
+
+	/** Get the SAMPLE gradient value wrt target variables as a sparse vector
+	 *
+	 * @return sparse sample gradient of variables
+	 */
+	virtual SGSparseVector<float64_t> get_sparse_gradient();
+
+	/** Can sparse SAMPLE gradients be computed concurrently?
+	 *
+	 * @return true
+	 */
+	virtual bool supports_concurrent_samples() { return true; }
+
+	/** Get the sample size
+	 *
+	 * @return the sample size
+	 */
+	virtual int32_t get_sample_size();
+
+	/** Get the sparse SAMPLE gradient of a given sample
+	 *
+	 * @param idx index of the sample
+	 * @return sparse sample gradient of variables
+	 */
+	virtual SGSparseVector<float64_t> get_sparse_sample_gradient(index_t idx);
+
+	/** Initialize to generate a sample sequence */
+	virtual void begin_sample();
+
+	/** Get next sample
+	 *
+	 * @return false if reach the end of the sample sequence
+	 */
+	virtual bool next_sample();
+
+	/** @return name of the SGSerializable */
+	virtual const char* get_name() const { return "SparseLeastSquaresCostFunction"; }
+
+private:
+	/** init */
+	void init();
+
+	/** index of the current sample */
+	index_t m_idx;
+
+	/** sparse feature vectors */
+	SGSparseMatrix<float64_t> m_features;
+
+	/** labels */
+	SGVector<float64_t> m_labels;
+
+	/** weights of the linear model */
+	SGVector<float64_t> m_weight;
+};
+
+}
+#endif
@@ -44,6 +44,11 @@ DescendPair StandardMomentumCorrection::get_corrected_descend_direction(float64_
 	return pair;
 }
 
+float64_t StandardMomentumCorrection::catch_up(index_t idx, int32_t num_steps)
+{
+	return decay_previous_descend_direction(idx, num_steps);
+}
+
 void StandardMomentumCorrection::init()
 {
 	m_weight=0.9;
@@ -85,6 +85,22 @@ public:
 	*/
 	virtual DescendPair get_corrected_descend_direction(float64_t negative_descend_direction,
 		index_t idx);
+
+	/** Does the correction support catching up on skipped steps?
+	 *
+	 * @return true
+	 */
+	virtual bool supports_catch_up() { return true; }
+
+	/** Catch up on several steps of a coordinate with zero negative descend
+	 * direction, where the velocity decays geometrically
+	 *
+	 * @param idx the index of the variable
+	 * @param num_steps number of skipped steps
+	 *
+	 * @return the sum of the descend directions of the skipped steps
+	 */
+	virtual float64_t catch_up(index_t idx, int32_t num_steps);
 private:
 	/*  Init */
 	void init();
@@ -185,18 +185,10 @@ float64_t CLBFGSMinimizer::evaluate(void *obj, const float64_t *variable,
 
 	REQUIRE(obj_prt, "The instance object passed to L-BFGS optimizer should not be NULL\n");
 
-	float64_t cost=obj_prt->m_fun->get_cost();
+	/* the gradient is only valid if the cost is finite */
+	SGVector<float64_t> grad(gradient, dim, false);
+	float64_t cost=obj_prt->m_fun->get_cost_and_gradient(grad);
 
-	if (CMath::is_nan(cost) || std::isinf(cost))
-		return cost;
-
-	//get the gradient wrt variable_new
-	SGVector<float64_t> grad=obj_prt->m_fun->get_gradient();
-	REQUIRE(grad.vlen==dim,
-		"The length of gradient (%d) and the length of variable (%d) do not match\n",
-		grad.vlen,dim);
-
-	std::copy(grad.vector,grad.vector+dim,gradient);
 	return cost;
 }
 
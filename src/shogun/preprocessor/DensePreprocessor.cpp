@@ -85,6 +85,22 @@ EPreprocessorType CDensePreprocessor<ST>::get_type() const
 	return P_UNKNOWN;
 }
 
+template <class ST>
+bool CDensePreprocessor<ST>::is_columnwise() const
+{
+	return false;
+}
+
+template <class ST>
+SGMatrix<ST> CDensePreprocessor<ST>::apply_to_columns(SGMatrix<ST> block)
+{
+	REQUIRE(
+	    is_columnwise(), "%s cannot be applied to blocks of columns!\n",
+	    get_name());
+
+	return apply_to_matrix(block);
+}
+
 template <class ST>
 CFeatures* CDensePreprocessor<ST>::transform(CFeatures* features, bool inplace)
 {
@@ -62,6 +62,24 @@ template <class ST> class CDensePreprocessor : public CPreprocessor
 		/// return a type of preprocessor
 		virtual EPreprocessorType get_type() const;
 
+		/** Whether apply_to_matrix() transforms every column independently
+		 * of all other columns. Such preprocessors can be applied to blocks
+		 * of columns, which allows CPipeline to fuse consecutive stages into
+		 * a single pass over the feature matrix.
+		 *
+		 * @return whether the preprocessor is columnwise
+		 */
+		virtual bool is_columnwise() const;
+
+		/** Apply preprocessor to a block of columns of a feature matrix. The
+		 * block is transformed in place when possible. Only valid for
+		 * columnwise preprocessors, see is_columnwise().
+		 *
+		 * @param block the columns to transform
+		 * @return the transformed columns
+		 */
+		SGMatrix<ST> apply_to_columns(SGMatrix<ST> block);
+
 	protected:
 		/** Apply preprocessor on matrix. Subclasses should try to apply in
 		 * place to avoid copying.
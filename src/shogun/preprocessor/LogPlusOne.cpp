@@ -45,10 +45,12 @@ bool CLogPlusOne::save(FILE* f)
 
 SGMatrix<float64_t> CLogPlusOne::apply_to_matrix(SGMatrix<float64_t> matrix)
 {
-	for (auto& v : matrix)
-	{
-		v = std::log(v + 1.0);
-	}
+	const int64_t num_elements = int64_t(matrix.num_rows) * matrix.num_cols;
+	auto data = matrix.matrix;
+
+#pragma omp parallel for
+	for (int64_t i = 0; i < num_elements; i++)
+		data[i] = std::log(data[i] + 1.0);
 
 	return matrix;
 }
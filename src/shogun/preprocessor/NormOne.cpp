@@ -8,12 +8,13 @@
 #include <shogun/base/range.h>
 #include <shogun/features/Features.h>
 #include <shogun/mathematics/Math.h>
-#include <shogun/mathematics/linalg/LinalgNamespace.h>
+#include <shogun/mathematics/eigen3.h>
 #include <shogun/mathematics/linalg/LinalgNamespace.h>
 #include <shogun/preprocessor/DensePreprocessor.h>
 #include <shogun/preprocessor/NormOne.h>
 
 using namespace shogun;
+using namespace Eigen;
 
 CNormOne::CNormOne()
 : CDensePreprocessor<float64_t>()
@@ -47,12 +48,12 @@ bool CNormOne::save(FILE* f)
 
 SGMatrix<float64_t> CNormOne::apply_to_matrix(SGMatrix<float64_t> matrix)
 {
-	for (auto i : range(matrix.num_cols))
-	{
-		auto vec = matrix.get_column(i);
-		auto norm = linalg::norm(vec);
-		linalg::scale(vec, vec, 1.0 / norm);
-	}
+	Map<MatrixXd> fmatrix(matrix.matrix, matrix.num_rows, matrix.num_cols);
+
+#pragma omp parallel for
+	for (index_t i = 0; i < matrix.num_cols; i++)
+		fmatrix.col(i) *= 1.0 / fmatrix.col(i).norm();
+
 	return matrix;
 }
 
@@ -7,6 +7,7 @@
 
 #include <shogun/features/Features.h>
 #include <shogun/mathematics/Math.h>
+#include <shogun/mathematics/eigen3.h>
 #include <shogun/mathematics/linalg/LinalgNamespace.h>
 #include <shogun/preprocessor/DensePreprocessor.h>
 #include <shogun/preprocessor/PNorm.h>
@@ -16,6 +17,7 @@
 #endif
 
 using namespace shogun;
+using namespace Eigen;
 
 CPNorm::CPNorm ()
 : CDensePreprocessor<float64_t>(),
@@ -59,11 +61,13 @@ bool CPNorm::save (FILE* f)
 
 SGMatrix<float64_t> CPNorm::apply_to_matrix(SGMatrix<float64_t> matrix)
 {
-	for (auto i : range(matrix.num_cols))
+	Map<MatrixXd> fmatrix(matrix.matrix, matrix.num_rows, matrix.num_cols);
+
+#pragma omp parallel for
+	for (index_t i = 0; i < matrix.num_cols; i++)
 	{
-		auto vec = matrix.get_column(i);
-		auto norm = get_pnorm(vec.vector, vec.vlen);
-		linalg::scale(vec, vec, 1.0 / norm);
+		auto norm = get_pnorm(fmatrix.col(i).data(), matrix.num_rows);
+		fmatrix.col(i) *= 1.0 / norm;
 	}
 	return matrix;
 }
@@ -57,6 +57,9 @@ class CPNorm : public CDensePreprocessor<float64_t>
 		/// return a type of preprocessor
 		virtual EPreprocessorType get_type () const { return P_PNORM; }
 
+		/// vectors are transformed independently of each other
+		virtual bool is_columnwise () const { return true; }
+
 		/**
 		 * Set norm
 		 * @param pnorm norm value
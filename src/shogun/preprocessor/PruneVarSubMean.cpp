@@ -8,11 +8,16 @@
 #include <shogun/features/Features.h>
 #include <shogun/io/SGIO.h>
 #include <shogun/mathematics/Math.h>
+#include <shogun/mathematics/eigen3.h>
 #include <shogun/mathematics/linalg/LinalgNamespace.h>
 #include <shogun/preprocessor/DensePreprocessor.h>
 #include <shogun/preprocessor/PruneVarSubMean.h>
 
 using namespace shogun;
+using namespace Eigen;
+
+/** number of vectors per block when computing statistics in parallel */
+static constexpr index_t STATISTICS_BLOCK_SIZE = 1024;
 
 CPruneVarSubMean::CPruneVarSubMean(bool divide)
 : CDensePreprocessor<float64_t>()
@@ -42,29 +47,47 @@ void CPruneVarSubMean::fit(CFeatures* features)
 	SGVector<float64_t> var(num_features);
 
 	auto feature_matrix = simple_features->get_feature_matrix();
+	Map<MatrixXd> fmatrix(feature_matrix.matrix, num_features, num_examples);
+
+	// statistics are summed per block of vectors first and the blocks are
+	// reduced in order, so results do not depend on the number of threads
+	index_t num_blocks =
+	    (num_examples + STATISTICS_BLOCK_SIZE - 1) / STATISTICS_BLOCK_SIZE;
+	MatrixXd block_sums(num_features, num_blocks);
 
 	// compute mean
-	m_mean = linalg::rowwise_sum(feature_matrix);
-	linalg::scale(m_mean, m_mean, 1.0 / num_examples);
+#pragma omp parallel for
+	for (index_t b = 0; b < num_blocks; b++)
+	{
+		index_t first = b * STATISTICS_BLOCK_SIZE;
+		index_t num_cols =
+		    std::min(STATISTICS_BLOCK_SIZE, num_examples - first);
+		block_sums.col(b) = fmatrix.middleCols(first, num_cols).rowwise().sum();
+	}
+	m_mean = SGVector<float64_t>(num_features);
+	Map<VectorXd> mean(m_mean.vector, num_features);
+	mean = block_sums.rowwise().sum() / num_examples;
 
 	// compute var
-	for (auto i : range(num_examples))
+#pragma omp parallel for
+	for (index_t b = 0; b < num_blocks; b++)
 	{
-		for (auto j : range(num_features))
-		{
-			auto diff =
-			    linalg::add(m_mean, feature_matrix.get_column(i), 1.0, -1.0);
-			var[j] += linalg::dot(diff, diff);
-		}
+		index_t first = b * STATISTICS_BLOCK_SIZE;
+		index_t num_cols =
+		    std::min(STATISTICS_BLOCK_SIZE, num_examples - first);
+		block_sums.col(b) = (fmatrix.middleCols(first, num_cols).colwise() -
+		                     mean)
+		                        .rowwise()
+		                        .squaredNorm();
 	}
+	Map<VectorXd>(var.vector, num_features) =
+	    block_sums.rowwise().sum() / num_examples;
 
 	int32_t num_ok = 0;
 	auto idx_ok = SGVector<int32_t>(num_features);
 
 	for (auto j : range(num_features))
 	{
-		var[j] /= num_examples;
-
 		if (var[j] >= 1e-14)
 		{
 			idx_ok[num_ok] = j;
@@ -105,23 +128,38 @@ CPruneVarSubMean::apply_to_matrix(SGMatrix<float64_t> matrix)
 	assert_fitted();
 
 	auto num_vectors = matrix.num_cols;
-	auto result = matrix;
-	result.num_rows = m_num_idx;
+	auto num_rows = matrix.num_rows;
 
-	for (auto i : range(num_vectors))
+	// every column is transformed in its own place first, the kept features
+	// move to the front as m_idx is increasing
+#pragma omp parallel for
+	for (index_t i = 0; i < num_vectors; i++)
 	{
-		auto v_src = matrix.get_column(i);
-		auto v_dst = result.get_column(i);
+		auto v = matrix.get_column_vector(i);
 
 		if (m_divide_by_std)
 		{
 			for (auto feat : range(m_num_idx))
-				v_dst[feat]=(v_src[m_idx[feat]]-m_mean[feat])/m_std[feat];
+				v[feat]=(v[m_idx[feat]]-m_mean[feat])/m_std[feat];
 		}
 		else
 		{
 			for (auto feat : range(m_num_idx))
-				v_dst[feat]=(v_src[m_idx[feat]]-m_mean[feat]);
+				v[feat]=(v[m_idx[feat]]-m_mean[feat]);
+		}
+	}
+
+	// pruned features are removed by moving the columns together, which
+	// has to be done in order
+	auto result = matrix;
+	result.num_rows = m_num_idx;
+	if (m_num_idx != num_rows)
+	{
+		for (index_t i = 1; i < num_vectors; i++)
+		{
+			memmove(
+			    result.get_column_vector(i), matrix.get_column_vector(i),
+			    sizeof(float64_t) * m_num_idx);
 		}
 	}
 
@@ -51,7 +51,12 @@ class CPruneVarSubMean : public CDensePreprocessor<float64_t>
 		/// return a type of preprocessor
 		virtual EPreprocessorType get_type() const { return P_PRUNEVARSUBMEAN; }
 
+		/// vectors are transformed independently of each other
+		virtual bool is_columnwise() const { return true; }
+
 	protected:
+		/// apply preproc in place, the kept features of each vector are
+		/// moved to the front of the matrix memory
 		virtual SGMatrix<float64_t> apply_to_matrix(SGMatrix<float64_t> matrix);
 
 	private:
@@ -6,10 +6,15 @@
 
 #include <algorithm>
 #include <shogun/base/range.h>
+#include <shogun/mathematics/eigen3.h>
 #include <shogun/mathematics/linalg/LinalgNamespace.h>
 #include <shogun/preprocessor/RescaleFeatures.h>
 
 using namespace shogun;
+using namespace Eigen;
+
+/** number of vectors per block when extracting statistics in parallel */
+static constexpr index_t STATISTICS_BLOCK_SIZE = 1024;
 
 CRescaleFeatures::CRescaleFeatures() : CDensePreprocessor<float64_t>()
 {
@@ -37,18 +42,39 @@ void CRescaleFeatures::fit(CFeatures* features)
 	m_min = SGVector<float64_t>(num_features);
 	m_range = SGVector<float64_t>(num_features);
 	auto feature_matrix = simple_features->get_feature_matrix();
-	for (index_t i = 0; i < num_features; i++)
+	REQUIRE(
+	    feature_matrix.num_cols > 0 && feature_matrix.num_rows == num_features,
+	    "Feature matrix (%dx%d) should have %d features and at least one "
+	    "vector!\n",
+	    feature_matrix.num_rows, feature_matrix.num_cols, num_features);
+	num_examples = feature_matrix.num_cols;
+	Map<MatrixXd> fmatrix(feature_matrix.matrix, num_features, num_examples);
+
+	/* min and max of blocks of vectors, the feature matrix is traversed
+	 * column by column */
+	index_t num_blocks =
+	    (num_examples + STATISTICS_BLOCK_SIZE - 1) / STATISTICS_BLOCK_SIZE;
+	MatrixXd block_min(num_features, num_blocks);
+	MatrixXd block_max(num_features, num_blocks);
+
+#pragma omp parallel for
+	for (index_t b = 0; b < num_blocks; b++)
 	{
-		SGVector<float64_t> vec = feature_matrix.get_row_vector(i);
-		float64_t cur_min = vec[0];
-		float64_t cur_max = vec[0];
+		index_t first = b * STATISTICS_BLOCK_SIZE;
+		index_t num_cols =
+		    std::min(STATISTICS_BLOCK_SIZE, num_examples - first);
+		auto block = fmatrix.middleCols(first, num_cols);
+		block_min.col(b) = block.rowwise().minCoeff();
+		block_max.col(b) = block.rowwise().maxCoeff();
+	}
 
-		/* find the max and min values in one loop */
-		for (index_t j = 1; j < vec.vlen; j++)
-		{
-			cur_min = std::min(vec[j], cur_min);
-			cur_max = std::max(vec[j], cur_max);
-		}
+	VectorXd feature_min = block_min.rowwise().minCoeff();
+	VectorXd feature_max = block_max.rowwise().maxCoeff();
+
+	for (index_t i = 0; i < num_features; i++)
+	{
+		float64_t cur_min = feature_min[i];
+		float64_t cur_max = feature_max[i];
 
 		/* only rescale if range > 0 */
 		if ((cur_max - cur_min) > 0)
@@ -78,12 +104,13 @@ CRescaleFeatures::apply_to_matrix(SGMatrix<float64_t> matrix)
 
 	ASSERT(matrix.num_rows == m_min.vlen);
 
-	for (auto i : range(matrix.num_cols))
-	{
-		auto vec = matrix.get_column(i);
-		linalg::add(vec, m_min, vec, 1.0, -1.0);
-		linalg::element_prod(vec, m_range, vec);
-	}
+	Map<MatrixXd> fmatrix(matrix.matrix, matrix.num_rows, matrix.num_cols);
+	Map<VectorXd> min(m_min.vector, m_min.vlen);
+	Map<VectorXd> inv_range(m_range.vector, m_range.vlen);
+
+#pragma omp parallel for
+	for (index_t i = 0; i < matrix.num_cols; i++)
+		fmatrix.col(i) = (fmatrix.col(i) - min).cwiseProduct(inv_range);
 
 	return matrix;
 }
@@ -63,6 +63,12 @@ namespace shogun
 			return P_RESCALEFEATURES;
 		}
 
+		/** vectors are rescaled independently of each other */
+		virtual bool is_columnwise() const
+		{
+			return true;
+		}
+
 	private:
 		void register_parameters();
 
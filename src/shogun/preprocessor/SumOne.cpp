@@ -6,11 +6,13 @@
 
 #include <shogun/features/Features.h>
 #include <shogun/mathematics/Math.h>
+#include <shogun/mathematics/eigen3.h>
 #include <shogun/mathematics/linalg/LinalgNamespace.h>
 #include <shogun/preprocessor/DensePreprocessor.h>
 #include <shogun/preprocessor/SumOne.h>
 
 using namespace shogun;
+using namespace Eigen;
 
 CSumOne::CSumOne()
 : CDensePreprocessor<float64_t>()
@@ -44,12 +46,12 @@ bool CSumOne::save(FILE* f)
 
 SGMatrix<float64_t> CSumOne::apply_to_matrix(SGMatrix<float64_t> matrix)
 {
-	for (int32_t i = 0; i < matrix.num_cols; i++)
-	{
-		auto vec = matrix.get_column(i);
-		auto sum = linalg::sum(vec);
-		linalg::scale(vec, vec, 1.0 / sum);
-	}
+	Map<MatrixXd> fmatrix(matrix.matrix, matrix.num_rows, matrix.num_cols);
+
+#pragma omp parallel for
+	for (index_t i = 0; i < matrix.num_cols; i++)
+		fmatrix.col(i) *= 1.0 / fmatrix.col(i).sum();
+
 	return matrix;
 }
 
@@ -52,6 +52,9 @@ class CSumOne : public CDensePreprocessor<float64_t>
 		/// return a type of preprocessor
 		virtual EPreprocessorType get_type() const { return P_SUMONE; }
 
+		/// vectors are transformed independently of each other
+		virtual bool is_columnwise() const { return true; }
+
 	protected:
 		virtual SGMatrix<float64_t> apply_to_matrix(SGMatrix<float64_t> matrix);
 };
@@ -0,0 +1,434 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ */
+
+#include <shogun/base/progress.h>
+#include <shogun/features/DenseFeatures.h>
+#include <shogun/features/SparseFeatures.h>
+#include <shogun/labels/RegressionLabels.h>
+#include <shogun/mathematics/Math.h>
+#include <shogun/mathematics/linalg/LinalgNamespace.h>
+#include <shogun/regression/ElasticNet.h>
+
+#include <algorithm>
+#include <functional>
+#include <numeric>
+#include <vector>
+
+using namespace shogun;
+
+namespace
+{
+/** columns of dense features, transposed so that every feature is
+ * contiguous
+ */
+class DenseColumns
+{
+public:
+	DenseColumns(CDenseFeatures<float64_t>* features)
+	{
+		auto X = features->get_feature_matrix();
+		m_Xt = SGMatrix<float64_t>(X.num_cols, X.num_rows);
+		for (index_t i = 0; i < X.num_cols; ++i)
+		{
+			for (index_t j = 0; j < X.num_rows; ++j)
+				m_Xt(i, j) = X(j, i);
+		}
+	}
+
+	int32_t get_num_vectors() const
+	{
+		return m_Xt.num_rows;
+	}
+
+	int32_t get_num_features() const
+	{
+		return m_Xt.num_cols;
+	}
+
+	float64_t dot(int32_t j, const float64_t* r) const
+	{
+		const float64_t* x = m_Xt.get_column_vector(j);
+		float64_t result = 0;
+		for (index_t i = 0; i < m_Xt.num_rows; ++i)
+			result += x[i] * r[i];
+		return result;
+	}
+
+	void add(int32_t j, float64_t alpha, float64_t* r) const
+	{
+		const float64_t* x = m_Xt.get_column_vector(j);
+		for (index_t i = 0; i < m_Xt.num_rows; ++i)
+			r[i] += alpha * x[i];
+	}
+
+	float64_t sum(int32_t j) const
+	{
+		const float64_t* x = m_Xt.get_column_vector(j);
+		return std::accumulate(x, x + m_Xt.num_rows, 0.0);
+	}
+
+	float64_t sqnorm(int32_t j) const
+	{
+		return dot(j, m_Xt.get_column_vector(j));
+	}
+
+private:
+	SGMatrix<float64_t> m_Xt;
+};
+
+/** columns of sparse features in compressed sparse column format */
+class SparseColumns
+{
+public:
+	SparseColumns(CSparseFeatures<float64_t>* features)
+	    : m_num_vectors(features->get_num_vectors()),
+	      m_col_start(features->get_num_features() + 1, 0)
+	{
+		for (index_t i = 0; i < m_num_vectors; ++i)
+		{
+			auto vec = features->get_sparse_feature_vector(i);
+			for (index_t e = 0; e < vec.num_feat_entries; ++e)
+				m_col_start[vec.features[e].feat_index + 1]++;
+			features->free_sparse_feature_vector(i);
+		}
+		std::partial_sum(
+		    m_col_start.begin(), m_col_start.end(), m_col_start.begin());
+
+		m_rows.resize(m_col_start.back());
+		m_values.resize(m_col_start.back());
+		std::vector<index_t> next(m_col_start.begin(), m_col_start.end() - 1);
+		for (index_t i = 0; i < m_num_vectors; ++i)
+		{
+			auto vec = features->get_sparse_feature_vector(i);
+			for (index_t e = 0; e < vec.num_feat_entries; ++e)
+			{
+				auto pos = next[vec.features[e].feat_index]++;
+				m_rows[pos] = i;
+				m_values[pos] = vec.features[e].entry;
+			}
+			features->free_sparse_feature_vector(i);
+		}
+	}
+
+	int32_t get_num_vectors() const
+	{
+		return m_num_vectors;
+	}
+
+	int32_t get_num_features() const
+	{
+		return m_col_start.size() - 1;
+	}
+
+	float64_t dot(int32_t j, const float64_t* r) const
+	{
+		float64_t result = 0;
+		for (auto e = m_col_start[j]; e < m_col_start[j + 1]; ++e)
+			result += m_values[e] * r[m_rows[e]];
+		return result;
+	}
+
+	void add(int32_t j, float64_t alpha, float64_t* r) const
+	{
+		for (auto e = m_col_start[j]; e < m_col_start[j + 1]; ++e)
+			r[m_rows[e]] += alpha * m_values[e];
+	}
+
+	float64_t sum(int32_t j) const
+	{
+		return std::accumulate(
+		    m_values.begin() + m_col_start[j],
+		    m_values.begin() + m_col_start[j + 1], 0.0);
+	}
+
+	float64_t sqnorm(int32_t j) const
+	{
+		float64_t result = 0;
+		for (auto e = m_col_start[j]; e < m_col_start[j + 1]; ++e)
+			result += m_values[e] * m_values[e];
+		return result;
+	}
+
+private:
+	int32_t m_num_vectors;
+	std::vector<index_t> m_col_start;
+	std::vector<index_t> m_rows;
+	std::vector<float64_t> m_values;
+};
+}
+
+CElasticNet::CElasticNet() : CLinearMachine()
+{
+	init();
+}
+
+CElasticNet::CElasticNet(float64_t l1_ratio) : CLinearMachine()
+{
+	init();
+	set_l1_ratio(l1_ratio);
+}
+
+CElasticNet::~CElasticNet()
+{
+}
+
+void CElasticNet::init()
+{
+	m_l1_ratio = 1.0;
+	m_num_lambdas = 100;
+	m_lambda_min_ratio = 1e-3;
+	m_epsilon = 1e-7;
+	m_max_iter = 1000;
+	m_use_bias = true;
+
+	SG_ADD(&m_l1_ratio, "l1_ratio", "Trade-off between l1 and l2 penalty",
+	    ParameterProperties::HYPER);
+	SG_ADD(&m_num_lambdas, "num_lambdas", "Number of regularization constants");
+	SG_ADD(&m_lambda_min_ratio, "lambda_min_ratio",
+	    "Ratio of smallest to largest regularization constant");
+	SG_ADD(&m_custom_lambdas, "custom_lambdas",
+	    "Regularization constants set by the user");
+	SG_ADD(&m_epsilon, "epsilon", "Convergence tolerance");
+	SG_ADD(&m_max_iter, "max_iter", "Max passes over the features per lambda");
+	SG_ADD(&m_use_bias, "use_bias", "Whether a bias is fitted");
+	SG_ADD(&m_lambdas, "lambdas", "Regularization constants of the path");
+	SG_ADD(&m_path_w, "path_w", "Weights of the path");
+	SG_ADD(&m_path_bias, "path_bias", "Biases of the path");
+}
+
+void CElasticNet::set_lambdas(SGVector<float64_t> lambdas)
+{
+	for (auto lambda : lambdas)
+	{
+		REQUIRE(lambda >= 0,
+			"Regularization constants (%f) must not be negative\n", lambda)
+	}
+	m_custom_lambdas = lambdas.clone();
+	std::sort(
+	    m_custom_lambdas.begin(), m_custom_lambdas.end(),
+	    std::greater<float64_t>());
+}
+
+SGVector<float64_t> CElasticNet::get_w_for_lambda(int32_t i) const
+{
+	REQUIRE(i >= 0 && i < get_path_size(),
+		"Index (%d) must be in [0, %d)\n", i, get_path_size())
+	SGVector<float64_t> w(m_path_w.num_rows);
+	sg_memcpy(w.vector, m_path_w.get_column_vector(i),
+		m_path_w.num_rows * sizeof(float64_t));
+	return w;
+}
+
+float64_t CElasticNet::get_bias_for_lambda(int32_t i) const
+{
+	REQUIRE(i >= 0 && i < get_path_size(),
+		"Index (%d) must be in [0, %d)\n", i, get_path_size())
+	return m_path_bias[i];
+}
+
+void CElasticNet::switch_w(int32_t i)
+{
+	set_w(get_w_for_lambda(i));
+	set_bias(get_bias_for_lambda(i));
+}
+
+bool CElasticNet::train_machine(CFeatures* data)
+{
+	REQUIRE(m_labels, "No labels set\n")
+	REQUIRE(m_labels->get_label_type() == LT_REGRESSION,
+		"Regression labels are required\n")
+
+	if (data)
+	{
+		REQUIRE(data->has_property(FP_DOT),
+			"Specified features are not of type CDotFeatures\n")
+		set_features((CDotFeatures*)data);
+	}
+	REQUIRE(features, "No features set\n")
+	REQUIRE(features->get_num_vectors() == m_labels->get_num_labels(),
+		"Number of vectors (%d) does not match number of labels (%d)\n",
+		features->get_num_vectors(), m_labels->get_num_labels())
+
+	auto y = regression_labels(m_labels)->get_labels();
+	if (features->get_feature_type() == F_DREAL &&
+	    features->get_feature_class() == C_DENSE)
+		train_path(DenseColumns(features->as<CDenseFeatures<float64_t>>()), y);
+	else if (features->get_feature_type() == F_DREAL &&
+	         features->get_feature_class() == C_SPARSE)
+		train_path(SparseColumns(features->as<CSparseFeatures<float64_t>>()), y);
+	else
+		SG_ERROR("%s supports dense and sparse real valued features only\n",
+			get_name())
+
+	switch_w(get_path_size() - 1);
+	return true;
+}
+
+template <class Columns>
+void CElasticNet::train_path(const Columns& X, SGVector<float64_t> y)
+{
+	int32_t n = X.get_num_vectors();
+	int32_t d = X.get_num_features();
+	REQUIRE(n > 0, "No training vectors\n")
+
+	// The features are centered implicitly when fitting a bias, so that
+	// sparse features stay sparse. The residual y-Xw-b then sums to zero and
+	// is kept as r-offset, where an update of a feature changes r only at
+	// its non-zero entries and shifts offset by its mean.
+	SGVector<float64_t> sums(d);
+	SGVector<float64_t> means(d);
+	SGVector<float64_t> sqnorms(d);
+	for (int32_t j = 0; j < d; ++j)
+	{
+		sums[j] = X.sum(j);
+		means[j] = m_use_bias ? sums[j] / n : 0.0;
+		// squared norm of the centered feature, divided by n
+		sqnorms[j] = (X.sqnorm(j) - n * means[j] * means[j]) / n;
+	}
+
+	float64_t y_mean = m_use_bias ? linalg::mean(y) : 0.0;
+	SGVector<float64_t> r(n);
+	for (int32_t i = 0; i < n; ++i)
+		r[i] = y[i] - y_mean;
+	float64_t offset = 0;
+	float64_t null_deviance = linalg::dot(r, r) / n;
+
+	// correlation of a centered feature with the residual, divided by n
+	auto correlation = [&](int32_t j) {
+		return (X.dot(j, r.vector) - offset * sums[j]) / n;
+	};
+	SGVector<float64_t> corr(d);
+	auto update_correlations = [&]() {
+#pragma omp parallel for
+		for (int32_t j = 0; j < d; ++j)
+			corr[j] = correlation(j);
+	};
+	update_correlations();
+
+	// the smallest lambda for which all weights are zero
+	float64_t lambda_max = 0;
+	for (int32_t j = 0; j < d; ++j)
+		lambda_max = CMath::max(lambda_max, CMath::abs(corr[j]) / m_l1_ratio);
+
+	if (m_custom_lambdas.vlen)
+		m_lambdas = m_custom_lambdas.clone();
+	else
+	{
+		m_lambdas = SGVector<float64_t>(m_num_lambdas);
+		for (int32_t k = 0; k < m_num_lambdas; ++k)
+		{
+			float64_t exponent =
+			    m_num_lambdas > 1 ? float64_t(k) / (m_num_lambdas - 1) : 0.0;
+			m_lambdas[k] = lambda_max * std::pow(m_lambda_min_ratio, exponent);
+		}
+	}
+
+	int32_t num_lambdas = m_lambdas.vlen;
+	m_path_w = SGMatrix<float64_t>(d, num_lambdas);
+	m_path_bias = SGVector<float64_t>(num_lambdas);
+
+	SGVector<float64_t> w(d);
+	w.zero();
+	std::vector<char> in_strong_set(d);
+	std::vector<int32_t> strong_set;
+	float64_t prev_lambda = CMath::max(lambda_max, m_lambdas[0]);
+	bool converged_all = true;
+
+	int32_t num_done = 0;
+	auto pb = SG_PROGRESS(range(num_lambdas));
+	for (int32_t k = 0; k < num_lambdas; ++k)
+	{
+		COMPUTATION_CONTROLLERS
+
+		float64_t lambda = m_lambdas[k];
+		float64_t l1 = lambda * m_l1_ratio;
+		float64_t l2 = lambda * (1 - m_l1_ratio);
+
+		// sequential strong rule: features whose correlation at the previous
+		// solution is small are likely zero at this lambda
+		float64_t threshold = m_l1_ratio * (2 * lambda - prev_lambda);
+		strong_set.clear();
+		for (int32_t j = 0; j < d; ++j)
+		{
+			in_strong_set[j] = w[j] != 0 || CMath::abs(corr[j]) >= threshold;
+			if (in_strong_set[j])
+				strong_set.push_back(j);
+		}
+
+		while (true)
+		{
+			// cyclic coordinate descent on the strong set
+			bool converged = false;
+			for (int32_t iter = 0; iter < m_max_iter && !converged; ++iter)
+			{
+				float64_t max_change = 0;
+				for (auto j : strong_set)
+				{
+					if (sqnorms[j] <= 0)
+						continue;
+
+					float64_t g = correlation(j) + sqnorms[j] * w[j];
+					float64_t shrunk = CMath::sign(g) *
+					                   CMath::max(0.0, CMath::abs(g) - l1);
+					float64_t w_new = shrunk / (sqnorms[j] + l2);
+					if (w_new != w[j])
+					{
+						float64_t delta = w_new - w[j];
+						X.add(j, -delta, r.vector);
+						offset -= delta * means[j];
+						w[j] = w_new;
+						max_change =
+						    CMath::max(max_change, sqnorms[j] * delta * delta);
+					}
+				}
+				converged = max_change <= m_epsilon * null_deviance;
+			}
+			converged_all &= converged;
+
+			// optimality conditions of the screened out features, which must
+			// have a correlation of at most l1 to be zero
+			update_correlations();
+			bool violated = false;
+			for (int32_t j = 0; j < d; ++j)
+			{
+				if (!in_strong_set[j] && CMath::abs(corr[j]) > l1)
+				{
+					in_strong_set[j] = true;
+					strong_set.push_back(j);
+					violated = true;
+				}
+			}
+			if (!violated)
+				break;
+		}
+
+		sg_memcpy(m_path_w.get_column_vector(k), w.vector, d * sizeof(float64_t));
+		m_path_bias[k] = y_mean - linalg::dot(means, w);
+		prev_lambda = lambda;
+		num_done++;
+
+		SG_DEBUG("lambda %f, %d non-zero weights\n", lambda,
+			int32_t(std::count_if(w.begin(), w.end(), [](float64_t v) { return v != 0; })));
+		pb.print_progress();
+	}
+	pb.complete();
+
+	// keep the computed part of the path if training was cancelled
+	if (num_done < num_lambdas)
+	{
+		REQUIRE(num_done > 0, "Training was cancelled before any lambda\n")
+		SGMatrix<float64_t> path_w(d, num_done);
+		sg_memcpy(path_w.matrix, m_path_w.matrix,
+			int64_t(d) * num_done * sizeof(float64_t));
+		m_path_w = path_w;
+		m_path_bias.resize_vector(num_done);
+		m_lambdas.resize_vector(num_done);
+	}
+
+	if (!converged_all)
+	{
+		SG_WARNING("Coordinate descent did not converge within %d passes "
+			"for all lambdas\n", m_max_iter);
+	}
+}
@@ -0,0 +1,259 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ */
+
+#ifndef _ELASTICNET_H__
+#define _ELASTICNET_H__
+
+#include <shogun/lib/config.h>
+
+#include <shogun/features/DotFeatures.h>
+#include <shogun/machine/LinearMachine.h>
+
+namespace shogun
+{
+
+/** @brief Class ElasticNet computes the regularization path of elastic net
+ * regression by cyclic coordinate descent, which is an alternative to
+ * CLeastAngleRegression for high-dimensional and sparse data.
+ *
+ * For every \f$\lambda\f$ of a decreasing grid, it solves
+ *
+ * \f[
+ * \min_{{\bf w},b} \frac{1}{2N}\sum_{i=1}^N(y_i-{\bf w}\cdot{\bf x}_i-b)^2 +
+ * \lambda\left(\alpha\|{\bf w}\|_1+\frac{1-\alpha}{2}\|{\bf w}\|_2^2\right)
+ * \f]
+ *
+ * where \f$\alpha\f$ is the l1 ratio; \f$\alpha=1\f$ is the LASSO. Each
+ * solution is started from the previous one. Features that are unlikely to
+ * be non-zero at a \f$\lambda\f$ are screened out with the sequential strong
+ * rule, and the optimality conditions of all features are checked after
+ * convergence; these checks are computed in parallel. The bias is fitted by
+ * implicit centering of the features, so sparse features stay sparse.
+ *
+ * Dense and sparse real valued features are supported. After training, the
+ * machine holds the estimator of the smallest \f$\lambda\f$, switch_w()
+ * selects another one of the path.
+ *
+ * Please see the following paper for more details.
+ *
+ * @code
+ * @article{friedman2010regularization,
+ *   title={Regularization paths for generalized linear models via coordinate descent},
+ *   author={Friedman, J. and Hastie, T. and Tibshirani, R.},
+ *   journal={Journal of statistical software},
+ *   volume={33},
+ *   number={1},
+ *   pages={1--22},
+ *   year={2010}
+ * }
+ * @endcode
+ */
+class CElasticNet : public CLinearMachine
+{
+public:
+	/** problem type */
+	MACHINE_PROBLEM_TYPE(PT_REGRESSION);
+
+	/** default constructor */
+	CElasticNet();
+
+	/** constructor
+	 *
+	 * @param l1_ratio trade-off between the l1 and the l2 penalty
+	 */
+	CElasticNet(float64_t l1_ratio);
+
+	/** destructor */
+	virtual ~CElasticNet();
+
+	/** set trade-off between the l1 and the l2 penalty
+	 *
+	 * @param l1_ratio in (0, 1], 1 is the LASSO
+	 */
+	void set_l1_ratio(float64_t l1_ratio)
+	{
+		REQUIRE(l1_ratio > 0 && l1_ratio <= 1,
+			"The l1 ratio (%f) must be in (0, 1]\n", l1_ratio)
+		m_l1_ratio = l1_ratio;
+	}
+
+	/** get trade-off between the l1 and the l2 penalty */
+	float64_t get_l1_ratio() const
+	{
+		return m_l1_ratio;
+	}
+
+	/** set number of regularization constants of the path, spaced
+	 * logarithmically from the smallest one that sets all weights to zero
+	 *
+	 * @param num_lambdas number of regularization constants
+	 */
+	void set_num_lambdas(int32_t num_lambdas)
+	{
+		REQUIRE(num_lambdas > 0, "The number of lambdas (%d) must be positive\n",
+			num_lambdas)
+		m_num_lambdas = num_lambdas;
+	}
+
+	/** get number of regularization constants of the path */
+	int32_t get_num_lambdas() const
+	{
+		return m_num_lambdas;
+	}
+
+	/** set ratio of the smallest to the largest regularization constant
+	 *
+	 * @param ratio in (0, 1)
+	 */
+	void set_lambda_min_ratio(float64_t ratio)
+	{
+		REQUIRE(ratio > 0 && ratio < 1,
+			"The lambda min ratio (%f) must be in (0, 1)\n", ratio)
+		m_lambda_min_ratio = ratio;
+	}
+
+	/** get ratio of the smallest to the largest regularization constant */
+	float64_t get_lambda_min_ratio() const
+	{
+		return m_lambda_min_ratio;
+	}
+
+	/** set regularization constants of the path, which replace the
+	 * logarithmic grid; they are used in decreasing order
+	 *
+	 * @param lambdas regularization constants, empty for the default grid
+	 */
+	void set_lambdas(SGVector<float64_t> lambdas);
+
+	/** get regularization constants of the path, of the last training if
+	 * it was trained
+	 */
+	SGVector<float64_t> get_lambdas() const
+	{
+		return m_lambdas;
+	}
+
+	/** set convergence tolerance, relative to the variance of the labels
+	 *
+	 * @param epsilon tolerance
+	 */
+	void set_epsilon(float64_t epsilon)
+	{
+		REQUIRE(epsilon > 0, "Epsilon (%f) must be positive\n", epsilon)
+		m_epsilon = epsilon;
+	}
+
+	/** get convergence tolerance */
+	float64_t get_epsilon() const
+	{
+		return m_epsilon;
+	}
+
+	/** set max number of passes over the features for each lambda
+	 *
+	 * @param max_iter max number of passes
+	 */
+	void set_max_iter(int32_t max_iter)
+	{
+		REQUIRE(max_iter > 0, "Max iterations (%d) must be positive\n", max_iter)
+		m_max_iter = max_iter;
+	}
+
+	/** get max number of passes over the features for each lambda */
+	int32_t get_max_iter() const
+	{
+		return m_max_iter;
+	}
+
+	/** set whether a bias is fitted
+	 *
+	 * @param use_bias whether to fit a bias
+	 */
+	void set_use_bias(bool use_bias)
+	{
+		m_use_bias = use_bias;
+	}
+
+	/** get whether a bias is fitted */
+	bool get_use_bias() const
+	{
+		return m_use_bias;
+	}
+
+	/** @return number of estimators on the path */
+	int32_t get_path_size() const
+	{
+		return m_path_w.num_cols;
+	}
+
+	/** get weights of the estimator of a regularization constant
+	 *
+	 * @param i index of the regularization constant in get_lambdas()
+	 * @return weights
+	 */
+	SGVector<float64_t> get_w_for_lambda(int32_t i) const;
+
+	/** get bias of the estimator of a regularization constant
+	 *
+	 * @param i index of the regularization constant in get_lambdas()
+	 * @return bias
+	 */
+	float64_t get_bias_for_lambda(int32_t i) const;
+
+	/** switch the machine to the estimator of a regularization constant
+	 *
+	 * @param i index of the regularization constant in get_lambdas()
+	 */
+	void switch_w(int32_t i);
+
+	/** @return object name */
+	virtual const char* get_name() const { return "ElasticNet"; }
+
+protected:
+	/** train the regularization path
+	 *
+	 * @param data training data, dense or sparse real valued features
+	 * @return whether training was successful
+	 */
+	virtual bool train_machine(CFeatures* data=NULL);
+
+#ifndef SWIG
+	/** computes the path on the columns, i.e. the features, of the data
+	 *
+	 * @param X columns of the data
+	 * @param y labels
+	 */
+	template <class Columns>
+	void train_path(const Columns& X, SGVector<float64_t> y);
+#endif
+
+private:
+	/** initialize and register parameters */
+	void init();
+
+private:
+	/** trade-off between the l1 and the l2 penalty */
+	float64_t m_l1_ratio;
+	/** number of regularization constants of the default grid */
+	int32_t m_num_lambdas;
+	/** ratio of the smallest to the largest constant of the default grid */
+	float64_t m_lambda_min_ratio;
+	/** regularization constants set by the user */
+	SGVector<float64_t> m_custom_lambdas;
+	/** convergence tolerance */
+	float64_t m_epsilon;
+	/** max number of passes over the features for each lambda */
+	int32_t m_max_iter;
+	/** whether a bias is fitted */
+	bool m_use_bias;
+
+	/** regularization constants of the path */
+	SGVector<float64_t> m_lambdas;
+	/** weights of the path, one column per regularization constant */
+	SGMatrix<float64_t> m_path_w;
+	/** biases of the path */
+	SGVector<float64_t> m_path_bias;
+};
+}
+#endif // _ELASTICNET_H__
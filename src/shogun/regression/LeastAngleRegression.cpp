@@ -43,10 +43,12 @@ void CLeastAngleRegression::init()
 	m_max_nonz = 0;
 	m_max_l1_norm = 0;
 	m_epsilon = CMath::MACHINE_EPSILON;
+	m_precompute_gram = false;
 	SG_ADD(&m_epsilon, "epsilon", "Epsilon for early stopping", ParameterProperties::HYPER);
 	SG_ADD(&m_max_nonz, "max_nonz", "Max number of non-zero variables", ParameterProperties::HYPER);
 	SG_ADD(&m_max_l1_norm, "max_l1_norm", "Max l1-norm of estimator", ParameterProperties::HYPER);
 	SG_ADD(&m_lasso, "lasso", "Max l1-norm of estimator", ParameterProperties::HYPER);
+	SG_ADD(&m_precompute_gram, "precompute_gram", "Whether the Gram matrix is precomputed");
 	watch_method("path_size", &CLeastAngleRegression::get_path_size);
 }
 
@@ -126,13 +128,24 @@ bool CLeastAngleRegression::train_machine_templated(CDenseFeatures<ST>* data)
 
 	// transpose(X) is more convenient to work with since we care
 	// about features here. After transpose, each row will be a data
-	// point while each column corresponds to a feature
-	SGMatrix<ST> X (n_vec, n_fea);
+	// point while each column corresponds to a feature. When the Gram
+	// matrix X'*X is precomputed, it replaces the transposed data and its
+	// active columns in the updates
+	SGMatrix<ST> X;
+	SGMatrix<ST> X_active;
+	SGMatrix<ST> gram;
 	typename SGMatrix<ST>::EigenMatrixXtMap map_Xr = data->get_feature_matrix();
-	typename SGMatrix<ST>::EigenMatrixXtMap map_X(X.matrix, n_vec, n_fea);
-	map_X = map_Xr.transpose();
-
-	SGMatrix<ST> X_active(n_vec, n_fea);
+	if (m_precompute_gram)
+		gram = data->cov();
+	else
+	{
+		X = SGMatrix<ST>(n_vec, n_fea);
+		X_active = SGMatrix<ST>(n_vec, n_fea);
+	}
+	typename SGMatrix<ST>::EigenMatrixXtMap map_X(X.matrix, X.num_rows, X.num_cols);
+	typename SGMatrix<ST>::EigenMatrixXtMap map_G(gram.matrix, gram.num_rows, gram.num_cols);
+	if (!m_precompute_gram)
+		map_X = map_Xr.transpose();
 
 	// beta is the estimator
 	vector<ST> beta(n_fea);
@@ -147,6 +160,8 @@ bool CLeastAngleRegression::train_machine_templated(CDenseFeatures<ST>* data)
 
 	// correlation
 	vector<ST> corr(n_fea);
+	// correlation with the equiangular direction
+	vector<ST> dir_corr(n_fea);
 	// sign of correlation
 	vector<ST> corr_sign(n_fea);
 
@@ -175,8 +190,13 @@ bool CLeastAngleRegression::train_machine_templated(CDenseFeatures<ST>* data)
 		// corr = X' * (y-mu) = - X'*mu + Xy
 		typename SGVector<ST>::EigenVectorXtMap map_corr(&corr[0], n_fea);
 		typename SGVector<ST>::EigenVectorXtMap map_mu(&mu[0], n_vec);
-		
-		map_corr = map_Xy - (map_Xr*map_mu);
+		typename SGVector<ST>::EigenVectorXtMap map_beta(&beta[0], n_fea);
+
+		// mu = X*beta, so that X'*mu = X'*X*beta
+		if (m_precompute_gram)
+			map_corr = map_Xy - (map_G*map_beta);
+		else
+			map_corr = map_Xy - (map_Xr*map_mu);
 		
 		// corr_sign = sign(corr)
 		for (size_t i=0; i < corr.size(); ++i)
@@ -192,17 +212,21 @@ bool CLeastAngleRegression::train_machine_templated(CDenseFeatures<ST>* data)
 			{ 
 				// R isn't allocated yet
 				R=SGMatrix<ST>(1,1);
-				ST diag_k = map_X.col(i_max_corr).dot(map_X.col(i_max_corr));
+				ST diag_k = m_precompute_gram ? gram(i_max_corr, i_max_corr) :
+					map_X.col(i_max_corr).dot(map_X.col(i_max_corr));
 				R(0, 0) = std::sqrt(diag_k);
 			}
+			else if (m_precompute_gram)
+				R=cholesky_insert_gram(gram, R, i_max_corr);
 			else
 				R=cholesky_insert(X, X_active, R, i_max_corr, m_num_active);
 			activate_variable(i_max_corr);
 		}
 
 		// Active variables
-		typename SGMatrix<ST>::EigenMatrixXtMap map_Xa(X_active.matrix, n_vec, m_num_active);
-		if (!lasso_cond)
+		typename SGMatrix<ST>::EigenMatrixXtMap map_Xa(X_active.matrix,
+				m_precompute_gram ? 0 : n_vec, m_precompute_gram ? 0 : m_num_active);
+		if (!lasso_cond && !m_precompute_gram)
 			map_Xa.col(m_num_active-1)=map_X.col(i_max_corr);
 		
 		SGVector<ST> corr_sign_a(m_num_active);
@@ -222,32 +246,48 @@ bool CLeastAngleRegression::train_machine_templated(CDenseFeatures<ST>* data)
 		typename SGVector<ST>::EigenVectorXt wA = AA*GA1;
 
 		// equiangular direction (unit vector)
-		vector<ST> u(n_vec);
-		typename SGVector<ST>::EigenVectorXtMap map_u(&u[0], n_vec);
-		
-		map_u = map_Xa*wA;
+		vector<ST> u;
+		typename SGVector<ST>::EigenVectorXtMap map_dir_corr(&dir_corr[0], n_fea);
+		if (m_precompute_gram)
+		{
+			// X'*u = X'*X_active*wA, the active columns of the Gram matrix
+			map_dir_corr.setZero();
+			for (index_t i=0; i < m_num_active; ++i)
+				map_dir_corr += wA(i)*map_G.col(m_active_set[i]);
+		}
+		else
+		{
+			u.resize(n_vec);
+			typename SGVector<ST>::EigenVectorXtMap map_u(&u[0], n_vec);
+			map_u = map_Xa*wA;
+
+			if (m_num_active < n_fea)
+			{
+				#pragma omp parallel for
+				for (index_t i=0; i < n_fea; ++i)
+				{
+					// correlation between X[:,i] and u
+					if (!m_is_active[i])
+						dir_corr[i] = map_u.dot(map_X.col(i));
+				}
+			}
+		}
 
 		ST gamma = max_corr / AA;
 		if (m_num_active < n_fea)
 		{
-			#pragma omp parallel for shared(gamma)
+			#pragma omp parallel for reduction(min:gamma)
 			for (index_t i=0; i < n_fea; ++i)
 			{
 				if (m_is_active[i])
 					continue;
 
-				// correlation between X[:,i] and u
-				ST dir_corr = map_u.dot(map_X.col(i));
-
-				ST tmp1 = (max_corr-corr[i])/(AA-dir_corr);
-				ST tmp2 = (max_corr+corr[i])/(AA+dir_corr);
-				#pragma omp critical
-				{
+				ST tmp1 = (max_corr-corr[i])/(AA-dir_corr[i]);
+				ST tmp2 = (max_corr+corr[i])/(AA+dir_corr[i]);
 				if (tmp1 > CMath::MACHINE_EPSILON && tmp1 < gamma)
 					gamma = tmp1;
 				if (tmp2 > CMath::MACHINE_EPSILON && tmp2 < gamma)
 					gamma = tmp2;
-				}
 			}
 		}
 		
@@ -278,7 +318,11 @@ bool CLeastAngleRegression::train_machine_templated(CDenseFeatures<ST>* data)
 		}
 
 		// update prediction: mu = mu + gamma * u
-		map_mu += gamma*map_u;
+		if (!m_precompute_gram)
+		{
+			typename SGVector<ST>::EigenVectorXtMap map_u(&u[0], n_vec);
+			map_mu += gamma*map_u;
+		}
 
 		// update estimator
 		for (index_t i=0; i < m_num_active; ++i)
@@ -296,7 +340,6 @@ bool CLeastAngleRegression::train_machine_templated(CDenseFeatures<ST>* data)
 				ST l1_prev = (ST) SGVector<ST>::onenorm(&m_beta_path_t[nloop][0], n_fea);
 				ST s = (get_max_l1_norm()-l1_prev)/(l1-l1_prev);
 
-				typename SGVector<ST>::EigenVectorXtMap map_beta(&beta[0], n_fea);
 				typename SGVector<ST>::EigenVectorXtMap map_beta_prev(&m_beta_path_t[nloop][0], n_fea);
 				map_beta = (1-s)*map_beta_prev + s*map_beta;
 			}
@@ -312,7 +355,7 @@ bool CLeastAngleRegression::train_machine_templated(CDenseFeatures<ST>* data)
 			// Remove column from active set
 			int32_t numRows = map_Xa.rows();
 			int32_t numCols = map_Xa.cols()-1;
-			if( i_kick < numCols )
+			if( !m_precompute_gram && i_kick < numCols )
 				map_Xa.block(0, i_kick, numRows, numCols-i_kick) = 
 					map_Xa.block(0, i_kick+1, numRows, numCols-i_kick).eval();			
 		}
@@ -385,6 +428,30 @@ SGMatrix<ST> CLeastAngleRegression::cholesky_insert(const SGMatrix<ST>& X,
 	return R_new;
 }
 
+template <typename ST>
+SGMatrix<ST> CLeastAngleRegression::cholesky_insert_gram(const SGMatrix<ST>& gram,
+		SGMatrix<ST>& R, int32_t i_max_corr)
+{
+	// col_k is the k-th column of (X'X) restricted to the active set
+	typename SGVector<ST>::EigenVectorXt R_k(m_num_active);
+	for (index_t i=0; i < m_num_active; ++i)
+		R_k(i) = gram(m_active_set[i], i_max_corr);
+	typename SGMatrix<ST>::EigenMatrixXtMap map_R(R.matrix, R.num_rows, R.num_cols);
+
+	// R' * R_k = (X' * X)_k = col_k, solving to get R_k
+	map_R.transpose().template triangularView<Lower>().template solveInPlace<OnTheLeft>(R_k);
+	ST R_kk = std::sqrt(gram(i_max_corr, i_max_corr) - R_k.dot(R_k));
+
+	SGMatrix<ST> R_new(m_num_active+1, m_num_active+1);
+	typename SGMatrix<ST>::EigenMatrixXtMap map_R_new(R_new.matrix, R_new.num_rows, R_new.num_cols);
+
+	map_R_new.block(0, 0, m_num_active, m_num_active) = map_R;
+	sg_memcpy(R_new.matrix+m_num_active*(m_num_active+1), R_k.data(), sizeof(ST)*(m_num_active));
+	map_R_new.row(m_num_active).setZero();
+	map_R_new(m_num_active, m_num_active) = R_kk;
+	return R_new;
+}
+
 template <typename ST>
 SGMatrix<ST> CLeastAngleRegression::cholesky_delete(SGMatrix<ST>& R, int32_t i_kick)
 {
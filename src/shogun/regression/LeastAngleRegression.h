@@ -120,6 +120,24 @@ public:
 		return m_max_l1_norm;
 	}
 
+	/** set whether the Gram matrix of the features is precomputed. The
+	 * correlations and the Cholesky updates are then computed from the
+	 * \f$D\times D\f$ Gram matrix instead of the data, which is much cheaper
+	 * when there are many more vectors than features.
+	 *
+	 * @param precompute_gram whether to precompute the Gram matrix
+	 */
+	void set_precompute_gram(bool precompute_gram)
+	{
+		m_precompute_gram = precompute_gram;
+	}
+
+	/** get whether the Gram matrix of the features is precomputed */
+	bool get_precompute_gram() const
+	{
+		return m_precompute_gram;
+	}
+
 	/** switch estimator
 	 *
 	 * @param num_variable number of non-zero coefficients
@@ -196,6 +214,10 @@ protected:
 	SGMatrix<ST> cholesky_insert(const SGMatrix<ST>& X, 
 			const SGMatrix<ST>& X_active, SGMatrix<ST>& R, int32_t i_max_corr, int32_t num_active);
 
+	template <typename ST>
+	SGMatrix<ST> cholesky_insert_gram(const SGMatrix<ST>& gram,
+			SGMatrix<ST>& R, int32_t i_max_corr);
+
 	template <typename ST>
 	SGMatrix<ST> cholesky_delete(SGMatrix<ST>& R, int32_t i_kick);
 
@@ -237,6 +259,7 @@ private:
 	}
 	
 	bool m_lasso; //!< enable lasso modification
+	bool m_precompute_gram; //!< work on the Gram matrix instead of the data
 
 	int32_t m_max_nonz;  //!< max number of non-zero variables for early stopping
 	float64_t m_max_l1_norm; //!< max l1-norm of beta (estimator) for early stopping
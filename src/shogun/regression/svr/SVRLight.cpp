@@ -30,24 +30,8 @@ extern "C" {
 
 #include <shogun/base/Parallel.h>
 
-#ifdef HAVE_PTHREAD
-#include <pthread.h>
-#endif
-
 using namespace shogun;
 
-#ifndef DOXYGEN_SHOULD_SKIP_THIS
-struct S_THREAD_PARAM_SVRLIGHT
-{
-	float64_t* lin;
-	int32_t start, end;
-	int32_t* active2dnum;
-	int32_t* docs;
-	CKernel* kernel;
-    int32_t num_vectors;
-};
-#endif // DOXYGEN_SHOULD_SKIP_THIS
-
 CSVRLight::CSVRLight(float64_t C, float64_t eps, CKernel* k, CLabels* lab)
 : CSVMLight(C, k, lab)
 {
@@ -357,18 +341,6 @@ float64_t CSVRLight::compute_objective_function(
   return(criterion);
 }
 
-void* CSVRLight::update_linear_component_linadd_helper(void *params_)
-{
-	S_THREAD_PARAM_SVRLIGHT * params = (S_THREAD_PARAM_SVRLIGHT*) params_ ;
-
-	int32_t jj=0, j=0 ;
-
-	for(jj=params->start;(jj<params->end) && (j=params->active2dnum[jj])>=0;jj++)
-		params->lin[j]+=params->kernel->compute_optimized(CSVRLight::regression_fix_index2(params->docs[j], params->num_vectors));
-
-	return NULL ;
-}
-
 int32_t CSVRLight::regression_fix_index(int32_t i)
 {
 	if (i>=num_vectors)
@@ -402,7 +374,7 @@ void CSVRLight::update_linear_component(
      /* based on the change of the variables */
      /* in the current working set */
 {
-	register int32_t i=0,ii=0,j=0,jj=0;
+	register int32_t i=0,ii=0;
 
 	if (kernel->has_property(KP_LINADD) && get_linadd_enabled())
 	{
@@ -425,56 +397,16 @@ void CSVRLight::update_linear_component(
 
 			if (num_working>0)
 			{
-			// TODO: port to use OpenMP backend instead of pthread
-#ifdef HAVE_PTHREAD
-				int32_t num_threads=parallel->get_num_threads();
-#else
-				int32_t num_threads=1;
-#endif
-				if (num_threads < 2)
-				{
-					for(jj=0;(j=active2dnum[jj])>=0;jj++) {
-						lin[j]+=kernel->compute_optimized(regression_fix_index(docs[j]));
-					}
-				}
-#ifdef HAVE_PTHREAD
-				else
+				int32_t num_elem=0;
+				while (active2dnum[num_elem]>=0)
+					num_elem++;
+
+				#pragma omp parallel for
+				for (int32_t k=0; k<num_elem; k++)
 				{
-					int32_t num_elem = 0 ;
-					for(jj=0;(j=active2dnum[jj])>=0;jj++) num_elem++ ;
-
-					pthread_t* threads = SG_MALLOC(pthread_t, num_threads-1);
-					S_THREAD_PARAM_SVRLIGHT* params = SG_MALLOC(S_THREAD_PARAM_SVRLIGHT, num_threads-1);
-					int32_t start = 0 ;
-					int32_t step = num_elem/num_threads ;
-					int32_t end = step ;
-
-					for (int32_t t=0; t<num_threads-1; t++)
-					{
-						params[t].kernel = kernel ;
-						params[t].lin = lin ;
-						params[t].docs = docs ;
-						params[t].active2dnum=active2dnum ;
-						params[t].start = start ;
-						params[t].end = end ;
-						params[t].num_vectors=num_vectors ;
-
-						start=end ;
-						end+=step ;
-						pthread_create(&threads[t], NULL, update_linear_component_linadd_helper, (void*)&params[t]) ;
-					}
-
-					for(jj=params[num_threads-2].end;(j=active2dnum[jj])>=0;jj++) {
-						lin[j]+=kernel->compute_optimized(regression_fix_index(docs[j]));
-					}
-					void* ret;
-					for (int32_t t=0; t<num_threads-1; t++)
-						pthread_join(threads[t], &ret) ;
-
-					SG_FREE(params);
-					SG_FREE(threads);
+					int32_t idx=active2dnum[k];
+					lin[idx]+=kernel->compute_optimized(regression_fix_index(docs[idx]));
 				}
-#endif
 			}
 		}
 	}
@@ -486,13 +418,8 @@ void CSVRLight::update_linear_component(
 					a, a_old, working2dnum, totdoc,	lin, aicache, c) ;
 		}
 		else {
-			for(jj=0;(i=working2dnum[jj])>=0;jj++) {
-				if(a[i] != a_old[i]) {
-					kernel->get_kernel_row(i,active2dnum,aicache);
-					for(ii=0;(j=active2dnum[ii])>=0;ii++)
-						lin[j]+=(a[i]-a_old[i])*aicache[j]*(float64_t)label[i];
-				}
-			}
+			update_linear_component_rows(working2dnum, active2dnum, a, a_old,
+				label, totdoc, lin);
 		}
 	}
 }
@@ -676,7 +603,7 @@ void CSVRLight::reactivate_inactive_examples(
         shrinking. */
      /* Computes lin for those variables from scratch. */
 {
-  register int32_t i=0,j,ii=0,jj,t,*changed2dnum,*inactive2dnum;
+  register int32_t i=0,t,*changed2dnum,*inactive2dnum;
   int32_t *changed,*inactive;
   register float64_t *a_old,dist;
   float64_t ex_c,target;
@@ -696,11 +623,15 @@ void CSVRLight::reactivate_inactive_examples(
 
 	  if (num_modified>0)
 	  {
-		  for(i=0;i<totdoc;i++) {
-			  if(!shrink_state->active[i]) {
-				  lin[i]=shrink_state->last_lin[i]+kernel->compute_optimized(regression_fix_index(docs[i]));
+		  float64_t* last_lin=shrink_state->last_lin;
+		  int32_t* active=shrink_state->active;
+
+		  #pragma omp parallel for
+		  for (int32_t k=0;k<totdoc;k++) {
+			  if(!active[k]) {
+				  lin[k]=last_lin[k]+kernel->compute_optimized(regression_fix_index(docs[k]));
 			  }
-			  shrink_state->last_lin[i]=lin[i];
+			  last_lin[k]=lin[k];
 		  }
 	  }
   }
@@ -723,11 +654,8 @@ void CSVRLight::reactivate_inactive_examples(
 		  compute_index(inactive,totdoc,inactive2dnum);
 		  compute_index(changed,totdoc,changed2dnum);
 
-		  for(ii=0;(i=changed2dnum[ii])>=0;ii++) {
-			  CKernelMachine::kernel->get_kernel_row(i,inactive2dnum,aicache);
-			  for(jj=0;(j=inactive2dnum[jj])>=0;jj++)
-				  lin[j]+=(a[i]-a_old[i])*aicache[j]*(float64_t)label[i];
-		  }
+		  update_linear_component_rows(changed2dnum, inactive2dnum, a, a_old,
+			  label, totdoc, lin);
 	  }
 	  SG_FREE(changed);
 	  SG_FREE(changed2dnum);
@@ -100,6 +100,11 @@ SGMatrix<float64_t> CDomainAdaptationMulticlassLibLinear::obtain_regularizer_mat
 	return w0;
 }
 
+SGMatrix<float64_t> CDomainAdaptationMulticlassLibLinear::get_all_submachine_outputs()
+{
+	return CMulticlassMachine::get_all_submachine_outputs();
+}
+
 CBinaryLabels* CDomainAdaptationMulticlassLibLinear::get_submachine_outputs(int32_t i)
 {
 	CBinaryLabels* target_outputs = CMulticlassMachine::get_submachine_outputs(i);
@@ -38,6 +38,9 @@ class CDomainAdaptationMulticlassLibLinear : public CMulticlassLibLinear
 		/** get submachine outputs */
 		virtual CBinaryLabels* get_submachine_outputs(int32_t);
 
+		/** get outputs of all submachines, each with the source machine */
+		virtual SGMatrix<float64_t> get_all_submachine_outputs();
+
 		/** get name */
 		virtual const char* get_name() const
 		{
@@ -0,0 +1,120 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ */
+
+#ifndef __BENCHMARK_UTILITIES_H__
+#define __BENCHMARK_UTILITIES_H__
+
+#include <benchmark/benchmark.h>
+
+#include <shogun/base/Parallel.h>
+#include <shogun/base/init.h>
+#include <shogun/base/range.h>
+#include <shogun/base/some.h>
+#include <shogun/features/DenseFeatures.h>
+#include <shogun/labels/BinaryLabels.h>
+#include <shogun/labels/MulticlassLabels.h>
+#include <shogun/labels/RegressionLabels.h>
+#include <shogun/mathematics/Math.h>
+#include <shogun/mathematics/Random.h>
+
+namespace shogun
+{
+
+/** seed of the random data, so that runs are comparable */
+static const uint32_t BENCHMARK_SEED = 17;
+
+/** @return num_dim x num_vecs features with entries uniform in [0.5, 1.5)
+ * that are valid input for histogram kernels and distances as well
+ */
+inline Some<CDenseFeatures<float64_t>>
+create_random_features(index_t num_dim, index_t num_vecs)
+{
+	sg_rand->set_seed(BENCHMARK_SEED);
+	SGMatrix<float64_t> mat(num_dim, num_vecs);
+	for (auto i : range(mat.size()))
+		mat[i] = CMath::random(0.0, 1.0) + 0.5;
+
+	return some<CDenseFeatures<float64_t>>(mat);
+}
+
+/** @return labels that depend on the first feature, to make the problem
+ * learnable
+ */
+inline Some<CBinaryLabels>
+create_binary_labels(CDenseFeatures<float64_t>* feats)
+{
+	SGVector<float64_t> labels(feats->get_num_vectors());
+	auto mat = feats->get_feature_matrix();
+	for (auto i : range(labels.vlen))
+		labels[i] = mat(0, i) > 1.0 ? 1 : -1;
+
+	return some<CBinaryLabels>(labels);
+}
+
+/** @return num_classes labels of slices of the first feature */
+inline Some<CMulticlassLabels>
+create_multiclass_labels(CDenseFeatures<float64_t>* feats, int32_t num_classes)
+{
+	SGVector<float64_t> labels(feats->get_num_vectors());
+	auto mat = feats->get_feature_matrix();
+	for (auto i : range(labels.vlen))
+		labels[i] = CMath::min(int32_t((mat(0, i) - 0.5) * num_classes),
+		                       num_classes - 1);
+
+	return some<CMulticlassLabels>(labels);
+}
+
+/** @return noisy sum of the features as targets */
+inline Some<CRegressionLabels>
+create_regression_labels(CDenseFeatures<float64_t>* feats)
+{
+	SGVector<float64_t> labels(feats->get_num_vectors());
+	auto mat = feats->get_feature_matrix();
+	for (auto i : range(labels.vlen))
+	{
+		labels[i] = CMath::normal_random(0.0, 0.1);
+		for (auto j : range(mat.num_rows))
+			labels[i] += mat(j, i);
+	}
+
+	return some<CRegressionLabels>(labels);
+}
+
+/** @brief Sets the number of threads of the global Parallel object for its
+ * lifetime, which all objects use unless told otherwise.
+ */
+class ScopedNumThreads
+{
+public:
+	ScopedNumThreads(int32_t num_threads) : m_parallel(get_global_parallel())
+	{
+		m_previous = m_parallel->get_num_threads();
+		m_parallel->set_num_threads(num_threads);
+	}
+
+	~ScopedNumThreads()
+	{
+		m_parallel->set_num_threads(m_previous);
+		SG_UNREF(m_parallel);
+	}
+
+private:
+	Parallel* m_parallel;
+	int32_t m_previous;
+};
+
+/** Adds arguments {size, num_threads} for sizes from min_size to max_size
+ * and 1, 2 and 4 threads
+ */
+inline void add_size_and_thread_args(
+    benchmark::internal::Benchmark* b, int64_t min_size, int64_t max_size)
+{
+	for (auto num_threads : {1, 2, 4})
+		for (auto size = min_size; size <= max_size; size *= 2)
+			b->Args({size, num_threads});
+	b->ArgNames({"n", "threads"});
+}
+}
+
+#endif // __BENCHMARK_UTILITIES_H__
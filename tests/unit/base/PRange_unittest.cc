@@ -2,7 +2,9 @@
 #include <gtest/gtest.h>
 #include <shogun/base/progress.h>
 #include <shogun/io/SGIO.h>
+#include <shogun/lib/Signal.h>
 #include <thread>
+#include <vector>
 
 using namespace shogun;
 
@@ -140,6 +142,42 @@ TEST(PRange, lambda_stop_shorter_method)
 	EXPECT_EQ(test, 3);
 }
 
+TEST(PRange, parallel_batches)
+{
+	range_io.enable_progress();
+	const int64_t count = 100000;
+	const int32_t num_threads = 4;
+	auto pb = progress("PROGRESS: ", range_io, range(count));
+
+	std::vector<std::thread> threads;
+	for (auto t : range(num_threads))
+	{
+		(void)t;
+		threads.emplace_back([&pb, count, num_threads]() {
+			auto batch = pb.batch();
+			for (int64_t i = 0; i < count / num_threads; i++)
+				batch.step();
+		});
+	}
+	for (auto& thread : threads)
+		thread.join();
+
+	EXPECT_EQ(pb.get_current_progress(), count);
+	pb.complete();
+}
+
+TEST(PRange, cancelled)
+{
+	auto pb = progress("PROGRESS: ", range_io, range(0, 10));
+	EXPECT_FALSE(pb.cancelled());
+
+	CSignal::cancel_computations();
+	EXPECT_TRUE(pb.cancelled());
+
+	auto next_pb = progress("PROGRESS: ", range_io, range(0, 10));
+	EXPECT_FALSE(next_pb.cancelled());
+}
+
 TEST(PRange, DISABLED_progress_incorrect_bounds_positive)
 {
 	range_io.enable_progress();
@@ -0,0 +1,74 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ */
+
+#include <gtest/gtest.h>
+#include <shogun/base/range.h>
+#include <shogun/base/some.h>
+#include <shogun/classifier/svm/OnlineSVMSGD.h>
+#include <shogun/features/DenseFeatures.h>
+#include <shogun/features/streaming/StreamingDenseFeatures.h>
+#include <shogun/mathematics/Math.h>
+
+using namespace shogun;
+
+static float64_t online_svmsgd_accuracy(ESGDParallelMode mode)
+{
+	const index_t dim = 10;
+	const index_t num_vectors = 3000;
+
+	sg_rand->set_seed(13);
+	SGMatrix<float64_t> data(dim, num_vectors);
+	SGVector<float64_t> labels(num_vectors);
+	for (auto i : range(num_vectors))
+	{
+		float64_t score = 0;
+		for (auto j : range(dim))
+		{
+			data(j, i) = CMath::randn_double();
+			score += (j % 2 ? 1.0 : -1.0) * data(j, i);
+		}
+		labels[i] = score >= 0 ? 1 : -1;
+	}
+
+	auto dense = some<CDenseFeatures<float64_t>>(data);
+	auto streaming =
+	    some<CStreamingDenseFeatures<float64_t>>(dense, labels.vector);
+	auto sgd = some<COnlineSVMSGD>(1.0, streaming);
+	sgd->set_lambda(1e-3);
+	sgd->set_epochs(3);
+	sgd->set_chunk_size(500);
+	sgd->set_parallel_mode(mode);
+	sgd->parallel->set_num_threads(4);
+	sgd->train();
+
+	auto losses = sgd->get_epoch_losses();
+	EXPECT_EQ(losses.vlen, 3);
+	EXPECT_LT(losses[losses.vlen - 1], losses[0]);
+
+	auto w = sgd->get_w();
+	index_t correct = 0;
+	for (auto i : range(num_vectors))
+	{
+		float64_t output = sgd->get_bias();
+		for (auto j : range(dim))
+			output += w[j] * data(j, i);
+		correct += (output >= 0 ? 1 : -1) == labels[i];
+	}
+	return float64_t(correct) / num_vectors;
+}
+
+TEST(OnlineSVMSGD, sequential)
+{
+	EXPECT_GT(online_svmsgd_accuracy(SGD_SEQUENTIAL), 0.9);
+}
+
+TEST(OnlineSVMSGD, hogwild)
+{
+	EXPECT_GT(online_svmsgd_accuracy(SGD_HOGWILD), 0.9);
+}
+
+TEST(OnlineSVMSGD, averaging)
+{
+	EXPECT_GT(online_svmsgd_accuracy(SGD_AVERAGING), 0.9);
+}
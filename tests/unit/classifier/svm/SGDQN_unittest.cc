@@ -0,0 +1,87 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ */
+
+#include <gtest/gtest.h>
+#include <shogun/base/range.h>
+#include <shogun/base/some.h>
+#include <shogun/classifier/svm/SGDQN.h>
+#include <shogun/evaluation/ContingencyTableEvaluation.h>
+#include <shogun/features/DenseFeatures.h>
+#include <shogun/features/SparseFeatures.h>
+#include <shogun/labels/BinaryLabels.h>
+#include <shogun/mathematics/Math.h>
+
+using namespace shogun;
+
+class SGDQNTest : public ::testing::Test
+{
+protected:
+	SGDQNTest() : labels(Some<CBinaryLabels>::from_raw(nullptr))
+	{
+	}
+
+	void SetUp()
+	{
+		sg_rand->set_seed(11);
+		data = SGMatrix<float64_t>(dim, num_vectors);
+		SGVector<float64_t> lab(num_vectors);
+		for (auto i : range(num_vectors))
+		{
+			float64_t score = 0;
+			for (auto j : range(dim))
+			{
+				/* a few non-zero features per vector */
+				data(j, i) = CMath::random(0.0, 1.0) < 0.3
+				                 ? CMath::randn_double()
+				                 : 0.0;
+				score += (j % 2 ? 1.0 : -1.0) * data(j, i);
+			}
+			lab[i] = score >= 0 ? 1 : -1;
+		}
+		labels = some<CBinaryLabels>(lab);
+	}
+
+	float64_t train_accuracy(CDotFeatures* features, ESGDParallelMode mode)
+	{
+		auto sgd = some<CSGDQN>(1.0, features, labels);
+		sgd->set_epochs(num_epochs);
+		sgd->set_parallel_mode(mode);
+		sgd->parallel->set_num_threads(4);
+		sgd->train();
+
+		auto losses = sgd->get_epoch_losses();
+		EXPECT_EQ(losses.vlen, num_epochs);
+		EXPECT_LT(losses[num_epochs - 1], losses[0]);
+
+		auto result = sgd->apply_binary(features);
+		CAccuracyMeasure accuracy;
+		auto value = accuracy.evaluate(result, labels);
+		SG_UNREF(result);
+		return value;
+	}
+
+	const index_t dim = 20;
+	const index_t num_vectors = 2000;
+	const int32_t num_epochs = 5;
+	SGMatrix<float64_t> data;
+	Some<CBinaryLabels> labels;
+};
+
+TEST_F(SGDQNTest, sequential)
+{
+	auto features = some<CDenseFeatures<float64_t>>(data);
+	EXPECT_GT(train_accuracy(features, SGD_SEQUENTIAL), 0.9);
+}
+
+TEST_F(SGDQNTest, averaging)
+{
+	auto features = some<CDenseFeatures<float64_t>>(data);
+	EXPECT_GT(train_accuracy(features, SGD_AVERAGING), 0.9);
+}
+
+TEST_F(SGDQNTest, hogwild)
+{
+	auto features = some<CSparseFeatures<float64_t>>(data);
+	EXPECT_GT(train_accuracy(features, SGD_HOGWILD), 0.9);
+}
@@ -6,6 +6,7 @@
 #include <gtest/gtest.h>
 #include <shogun/lib/common.h>
 #include <shogun/features/DenseFeatures.h>
+#include <shogun/mathematics/Math.h>
 
 #include <shogun/mathematics/eigen3.h>
 #include <shogun/converter/ica/FFSep.h>
@@ -60,3 +61,40 @@ TEST(CFFSep, blind_source_separation)
 	EXPECT_EQ(isperm,true);
 }
 
+
+TEST(CFFSep, lagged_covariances)
+{
+	// more samples than in a block of the parallel computation
+	const int n = 3;
+	const int T = 2500;
+	sg_rand->set_seed(12);
+	SGMatrix<float64_t> X(n,T);
+	for (int i = 0; i < n*T; i++)
+		X[i] = CMath::randn_double() + 1.0;
+	auto signals = some<CDenseFeatures<float64_t>>(X);
+
+	SGVector<float64_t> tau(3);
+	tau[0] = 0; tau[1] = 1; tau[2] = 1500;
+
+	auto ffsep = some<CFFSep>();
+	ffsep->set_tau(tau);
+	ffsep->fit(signals);
+	auto covs = ffsep->get_covs();
+
+	Eigen::Map<EMatrix> EX(X.matrix,n,T);
+	EVector mean = EX.rowwise().sum() / (float64_t)T;
+	EMatrix C = EX.colwise() - mean;
+	for (int t = 0; t < tau.vlen; t++)
+	{
+		int lag = tau[t];
+		EMatrix K = C.leftCols(T-lag) * C.rightCols(T-lag).transpose() / (float64_t)(T-lag);
+		EMatrix expected = (K + K.transpose()) / 2.0;
+
+		Eigen::Map<EMatrix> cov(covs.get_matrix(t),n,n);
+		for (int i = 0; i < n; i++)
+		{
+			for (int j = 0; j < n; j++)
+				EXPECT_NEAR(cov(i,j), expected(i,j), 1e-12);
+		}
+	}
+}
@@ -6,6 +6,7 @@
 #include <gtest/gtest.h>
 #include <shogun/lib/common.h>
 #include <shogun/features/DenseFeatures.h>
+#include <shogun/mathematics/Math.h>
 
 #include <shogun/mathematics/eigen3.h>
 
@@ -67,3 +68,35 @@ TEST(CFastICA, with_empty_feature)
 	auto ica = some<CFastICA>();
 	EXPECT_THROW(ica->transform(empty_feat), ShogunException);
 }
+
+TEST(CFastICA, independent_of_num_threads)
+{
+	// more samples than in a block of the parallel computation
+	const int n = 3;
+	const int T = 2500;
+	sg_rand->set_seed(12);
+	SGMatrix<float64_t> X(n,T);
+	for (int i = 0; i < n*T; i++)
+		X[i] = CMath::random(-1.0, 1.0) + 0.1*(i % n);
+	auto mixed_signals = some<CDenseFeatures<float64_t>>(X);
+
+	auto ica = some<CFastICA>();
+	auto num_threads = ica->parallel->get_num_threads();
+
+	// the partial sums of the blocks are added in the same order
+	ica->parallel->set_num_threads(1);
+	sg_rand->set_seed(3);
+	ica->fit(mixed_signals);
+	auto expected = ica->get_mixing_matrix().clone();
+
+	ica->parallel->set_num_threads(4);
+	sg_rand->set_seed(3);
+	ica->fit(mixed_signals);
+	auto mixing = ica->get_mixing_matrix();
+	ica->parallel->set_num_threads(num_threads);
+
+	ASSERT_EQ(mixing.num_rows, expected.num_rows);
+	ASSERT_EQ(mixing.num_cols, expected.num_cols);
+	for (int i = 0; i < mixing.num_rows*mixing.num_cols; i++)
+		EXPECT_EQ(mixing[i], expected[i]);
+}
@@ -6,6 +6,7 @@
 #include <gtest/gtest.h>
 #include <shogun/lib/common.h>
 #include <shogun/features/DenseFeatures.h>
+#include <shogun/mathematics/Math.h>
 
 #include <shogun/mathematics/eigen3.h>
 
@@ -61,3 +62,38 @@ TEST(CJade, blind_source_separation)
 	EXPECT_EQ(isperm,true);
 }
 
+TEST(CJade, independent_of_num_threads)
+{
+	const int n = 3;
+	const int T = 2500;
+	sg_rand->set_seed(12);
+	SGMatrix<float64_t> X(n,T);
+	for (int i = 0; i < n*T; i++)
+		X[i] = CMath::random(-1.0, 1.0) + 0.1*(i % n);
+	auto mixed_signals = some<CDenseFeatures<float64_t>>(X);
+
+	auto jade = some<CJade>();
+	auto num_threads = jade->parallel->get_num_threads();
+
+	// each row of cumulant matrices is computed by one thread
+	jade->parallel->set_num_threads(1);
+	jade->fit(mixed_signals);
+	auto expected_cumulants = jade->get_cumulant_matrix().clone();
+	auto expected_mixing = jade->get_mixing_matrix().clone();
+
+	jade->parallel->set_num_threads(4);
+	jade->fit(mixed_signals);
+	auto cumulants = jade->get_cumulant_matrix();
+	auto mixing = jade->get_mixing_matrix();
+	jade->parallel->set_num_threads(num_threads);
+
+	ASSERT_EQ(cumulants.num_rows, expected_cumulants.num_rows);
+	ASSERT_EQ(cumulants.num_cols, expected_cumulants.num_cols);
+	for (int i = 0; i < cumulants.num_rows*cumulants.num_cols; i++)
+		EXPECT_EQ(cumulants[i], expected_cumulants[i]);
+
+	ASSERT_EQ(mixing.num_rows, expected_mixing.num_rows);
+	ASSERT_EQ(mixing.num_cols, expected_mixing.num_cols);
+	for (int i = 0; i < mixing.num_rows*mixing.num_cols; i++)
+		EXPECT_EQ(mixing[i], expected_mixing[i]);
+}
@@ -6,12 +6,39 @@
 
 #include <gtest/gtest.h>
 
+#include <shogun/base/some.h>
 #include <shogun/distance/CustomMahalanobisDistance.h>
+#include <shogun/distance/EuclideanDistance.h>
 #include <shogun/features/DenseFeatures.h>
 #include <shogun/lib/SGMatrix.h>
+#include <shogun/lib/Signal.h>
+#include <shogun/lib/exception/ShogunException.h>
+
+#include <atomic>
 
 using namespace shogun;
 
+/** Euclidean distance that requests cancellation on its first evaluation */
+class CCancellingEuclideanDistance : public CEuclideanDistance
+{
+public:
+	CCancellingEuclideanDistance(
+		CDenseFeatures<float64_t>* l, CDenseFeatures<float64_t>* r)
+		: CEuclideanDistance(l, r), m_cancelled(false)
+	{
+	}
+
+protected:
+	virtual float64_t compute(int32_t idx_a, int32_t idx_b)
+	{
+		if (!m_cancelled.exchange(true))
+			CSignal::cancel_computations();
+		return CEuclideanDistance::compute(idx_a, idx_b);
+	}
+
+	std::atomic<bool> m_cancelled;
+};
+
 TEST(Distance, custom_mahalanobis)
 {
 	// Create a couple of simple 2D features
@@ -37,3 +64,19 @@ TEST(Distance, custom_mahalanobis)
 
 	SG_UNREF(distance)
 }
+
+TEST(Distance, get_distance_matrix_cancelled)
+{
+	SGMatrix<float64_t> feat_mat(2, 20);
+	for (index_t i=0; i<feat_mat.num_rows*feat_mat.num_cols; i++)
+		feat_mat[i] = i;
+	CDenseFeatures<float64_t>* feats = new CDenseFeatures<float64_t>(feat_mat);
+
+	auto distance = some<CCancellingEuclideanDistance>(feats, feats);
+	EXPECT_THROW(distance->get_distance_matrix(), ShogunException);
+
+	// a computation started after the cancellation is not affected
+	SGMatrix<float64_t> dm = distance->get_distance_matrix();
+	EXPECT_EQ(dm.num_rows, 20);
+	EXPECT_EQ(dm.num_cols, 20);
+}
@@ -6,6 +6,7 @@
  */
 
 #include <algorithm>
+#include <atomic>
 #include <gtest/gtest.h>
 #include <numeric>
 #include <shogun/base/some.h>
@@ -28,6 +29,34 @@ public:
 	}
 };
 
+/* features without a matrix, whose vectors are computed and cached */
+class CComputedFeaturesMock : public CDenseFeatures<float64_t>
+{
+public:
+	CComputedFeaturesMock(
+	    int32_t cache_size, int32_t num_feats, int32_t num_vecs)
+	    : CDenseFeatures<float64_t>(cache_size), num_computed(0)
+	{
+		set_num_features(num_feats);
+		set_num_vectors(num_vecs);
+	}
+
+	mutable std::atomic<int32_t> num_computed;
+
+protected:
+	virtual float64_t* compute_feature_vector(
+	    int32_t num, int32_t& len, float64_t* target = NULL) const
+	{
+		num_computed++;
+		len = num_features;
+		if (!target)
+			target = SG_MALLOC(float64_t, len);
+		for (auto i : range(len))
+			target[i] = int64_t(num) * len + i;
+		return target;
+	}
+};
+
 }
 
 using namespace shogun;
@@ -288,3 +317,155 @@ TEST(DenseFeaturesTest, view)
 			    feature_matrix_subset2(i, j), data(i, subset1[subset2[j]]));
 	}
 }
+
+TEST(DenseFeaturesTest, contiguous_subset)
+{
+	const index_t num_feats = 3;
+	const index_t num_vectors = 6;
+	SGMatrix<float64_t> data(num_feats, num_vectors);
+	std::iota(data.data(), data.data() + data.size(), 1);
+	auto feats = some<CDenseFeatures<float64_t>>(data);
+
+	SGVector<index_t> subset{2, 3, 4};
+	feats->add_subset(subset);
+
+	// vectors of a range subset point into the feature matrix
+	for (auto j : range(subset.vlen))
+	{
+		int32_t len;
+		bool dofree;
+		auto vec = feats->get_feature_vector(j, len, dofree);
+		EXPECT_EQ(len, num_feats);
+		EXPECT_FALSE(dofree);
+		EXPECT_EQ(vec, data.get_column_vector(subset[j]));
+		feats->free_feature_vector(vec, j, dofree);
+	}
+
+	auto subset_matrix = feats->get_feature_matrix();
+	for (auto j : range(subset.vlen))
+		for (auto i : range(num_feats))
+			EXPECT_EQ(subset_matrix(i, j), data(i, subset[j]));
+
+	feats->remove_subset();
+	EXPECT_EQ(feats->get_num_vectors(), num_vectors);
+	EXPECT_EQ(feats->get_feature_vector(5)[0], data(0, 5));
+}
+
+TEST(DenseFeaturesTest, subset_copy)
+{
+	const index_t num_feats = 3;
+	const index_t num_vectors = 6;
+	SGMatrix<float64_t> data(num_feats, num_vectors);
+	std::iota(data.data(), data.data() + data.size(), 1);
+	auto feats = some<CDenseFeatures<float64_t>>(data);
+
+	SGVector<index_t> subset{5, 0, 3};
+
+	// copy does not fit
+	feats->set_max_subset_copy_size(sizeof(float64_t));
+	feats->add_subset(subset);
+	for (auto j : range(subset.vlen))
+	{
+		int32_t len;
+		bool dofree;
+		auto vec = feats->get_feature_vector(j, len, dofree);
+		EXPECT_EQ(vec, data.get_column_vector(subset[j]));
+		feats->free_feature_vector(vec, j, dofree);
+	}
+	feats->remove_subset();
+
+	feats->set_max_subset_copy_size(
+	    num_feats * subset.vlen * sizeof(float64_t));
+	feats->add_subset(subset);
+	for (auto j : range(subset.vlen))
+	{
+		int32_t len;
+		bool dofree;
+		auto vec = feats->get_feature_vector(j, len, dofree);
+		EXPECT_NE(vec, data.get_column_vector(subset[j]));
+		for (auto i : range(num_feats))
+			EXPECT_EQ(vec[i], data(i, subset[j]));
+		feats->free_feature_vector(vec, j, dofree);
+	}
+
+	auto subset_matrix = feats->get_feature_matrix();
+	for (auto j : range(subset.vlen))
+		for (auto i : range(num_feats))
+			EXPECT_EQ(subset_matrix(i, j), data(i, subset[j]));
+}
+
+TEST(DenseFeaturesTest, feature_cache)
+{
+	const index_t num_feats = 4;
+	const index_t num_vectors = 10;
+	auto feats = some<CComputedFeaturesMock>(1, num_feats, num_vectors);
+
+	int32_t len;
+	bool dofree;
+	auto vec = feats->get_feature_vector(3, len, dofree);
+	ASSERT_EQ(len, num_feats);
+	EXPECT_FALSE(dofree);
+	for (auto i : range(num_feats))
+		EXPECT_EQ(vec[i], 3 * num_feats + i);
+	feats->free_feature_vector(vec, 3, dofree);
+
+	/* served from the cache */
+	auto cached = feats->get_feature_vector(3);
+	EXPECT_EQ(cached.vector, vec);
+	EXPECT_EQ(feats->num_computed, 1);
+	feats->free_feature_vector(cached, 3);
+
+	cached = feats->get_feature_vector(3);
+	EXPECT_EQ(feats->num_computed, 1);
+	feats->free_feature_vector(cached, 3);
+}
+
+TEST(DenseFeaturesTest, feature_cache_full)
+{
+	/* two cache lines */
+	const index_t num_feats = 1024 * 1024 / sizeof(float64_t) / 2;
+	const index_t num_vectors = 10;
+	auto feats = some<CComputedFeaturesMock>(1, num_feats, num_vectors);
+
+	/* vectors held by the caller are not evicted */
+	auto first = feats->get_feature_vector(0);
+	auto second = feats->get_feature_vector(1);
+	auto third = feats->get_feature_vector(2);
+	EXPECT_NE(third.vector, first.vector);
+	EXPECT_NE(third.vector, second.vector);
+	EXPECT_EQ(first[1], 1);
+	EXPECT_EQ(second[1], num_feats + 1);
+	EXPECT_EQ(third[1], 2 * num_feats + 1);
+	feats->free_feature_vector(third, 2);
+
+	/* the third vector was not cached */
+	feats->free_feature_vector(feats->get_feature_vector(2), 2);
+	EXPECT_EQ(feats->num_computed, 4);
+
+	feats->free_feature_vector(first, 0);
+	feats->free_feature_vector(second, 1);
+	EXPECT_EQ(feats->get_feature_vector(0).vector, first.vector);
+	EXPECT_EQ(feats->num_computed, 4);
+}
+
+TEST(DenseFeaturesTest, feature_cache_parallel)
+{
+	const index_t num_feats = 1024 * 1024 / sizeof(float64_t) / 32;
+	const index_t num_vectors = 64;
+	auto feats = some<CComputedFeaturesMock>(1, num_feats, num_vectors);
+
+	int64_t num_errors = 0;
+#pragma omp parallel for reduction(+ : num_errors)
+	for (index_t i = 0; i < 5000; i++)
+	{
+		auto num = (i * 7919) % num_vectors;
+		int32_t len;
+		bool dofree;
+		auto vec = feats->get_feature_vector(num, len, dofree);
+		for (auto j : range(len))
+			num_errors += vec[j] != int64_t(num) * num_feats + j;
+		feats->free_feature_vector(vec, num, dofree);
+	}
+
+	EXPECT_EQ(num_errors, 0);
+}
@@ -7,9 +7,39 @@
 #include <gtest/gtest.h>
 #include <shogun/features/DenseFeatures.h>
 #include <shogun/features/DotFeatures.h>
+#include <shogun/lib/Signal.h>
+#include <shogun/lib/exception/ShogunException.h>
+
+#include <atomic>
 
 using namespace shogun;
 
+/** dense features that request cancellation on their first dot product */
+class CCancellingDenseFeatures : public CDenseFeatures<float64_t>
+{
+public:
+	CCancellingDenseFeatures(SGMatrix<float64_t> matrix)
+	    : CDenseFeatures<float64_t>(matrix), m_cancelled(false)
+	{
+	}
+
+	virtual float64_t
+	dense_dot(int32_t vec_idx1, const float64_t* vec2, int32_t vec2_len) const
+	{
+		if (!m_cancelled.exchange(true))
+			CSignal::cancel_computations();
+		return CDenseFeatures<float64_t>::dense_dot(vec_idx1, vec2, vec2_len);
+	}
+
+	void reset()
+	{
+		m_cancelled = false;
+	}
+
+private:
+	mutable std::atomic<bool> m_cancelled;
+};
+
 class DotFeaturesTest : public ::testing::Test
 {
 protected:
@@ -121,3 +151,34 @@ TEST_F(DotFeaturesTest, compute_cov_nocopy)
 	for (index_t i = 0; i < (index_t)cov.size(); ++i)
 		EXPECT_NEAR(cov[i], ref_cov_ab[i], eps);
 }
+
+TEST_F(DotFeaturesTest, dense_dot_range_cancelled)
+{
+	auto feats = new CCancellingDenseFeatures(feats_a->get_feature_matrix());
+	SG_REF(feats);
+	SGVector<float64_t> w(dims);
+	w.set_const(1.0);
+	SGVector<float64_t> output(num_a);
+
+	EXPECT_THROW(
+	    feats->dense_dot_range(output.vector, 0, num_a, NULL, w.vector, dims, 0),
+	    ShogunException);
+
+	SGVector<int32_t> index(num_a);
+	index.range_fill();
+	feats->reset();
+	EXPECT_THROW(
+	    feats->dense_dot_range_subset(
+	        index.vector, num_a, output.vector, NULL, w.vector, dims, 0),
+	    ShogunException);
+
+	/* a computation started after the cancellation is not affected */
+	feats->dense_dot_range(output.vector, 0, num_a, NULL, w.vector, dims, 0);
+	for (index_t i = 0; i < num_a; ++i)
+	{
+		EXPECT_NEAR(
+		    output[i], feats_a->dense_dot(i, w.vector, dims), eps);
+	}
+
+	SG_UNREF(feats);
+}
@@ -635,3 +635,126 @@ TEST(CustomKernelTest, row_col_wise_sum_block_no_diag)
 	SG_UNREF(feats_p);
 	SG_UNREF(feats_q);
 }
+
+TEST(CustomKernelTest, half_precision_from_kernel)
+{
+	const index_t n=40;
+	const index_t d=3;
+
+	srand(100);
+	SGMatrix<float64_t> data(d, n);
+	Map<MatrixXd> data_m(data.matrix, data.num_rows, data.num_cols);
+	data_m=MatrixXd::Random(d, n);
+	CDenseFeatures<float64_t>* feats=new CDenseFeatures<float64_t>(data);
+	CGaussianKernel* kernel=new CGaussianKernel(feats, feats, 2);
+	SGMatrix<float64_t> expected=kernel->get_kernel_matrix();
+
+	ECustomKernelPrecision precisions[]={CKP_FLOAT16, CKP_BFLOAT16};
+	/* relative rounding errors of 11 and 8 significant bits */
+	float64_t tolerances[]={1.0/2048, 1.0/256};
+	for (index_t p=0; p<2; ++p)
+	{
+		CCustomKernel* custom=new CCustomKernel(kernel, precisions[p]);
+		EXPECT_EQ(precisions[p], custom->get_precision());
+		EXPECT_TRUE(custom->is_upper_triangle());
+		EXPECT_EQ(n, custom->get_num_vec_lhs());
+		EXPECT_EQ(n, custom->get_num_vec_rhs());
+
+		SGMatrix<float64_t> km=custom->get_kernel_matrix();
+		for (index_t i=0; i<n; ++i)
+		{
+			for (index_t j=0; j<n; ++j)
+			{
+				EXPECT_NEAR(expected(i, j), km(i, j),
+						tolerances[p]*expected(i, j));
+				EXPECT_EQ(km(i, j), km(j, i));
+			}
+		}
+
+		/* block sums are computed entry by entry */
+		EXPECT_NEAR(kernel->sum_symmetric_block(0, n),
+				custom->sum_symmetric_block(0, n), tolerances[p]*n*n);
+		EXPECT_NEAR(kernel->sum_block(0, 10, 10, 20),
+				custom->sum_block(0, 10, 10, 20), tolerances[p]*200);
+
+		/* a copy shares the storage */
+		CCustomKernel* copy=new CCustomKernel(custom);
+		EXPECT_EQ(precisions[p], copy->get_precision());
+		SGMatrix<float64_t> copy_km=copy->get_kernel_matrix();
+		for (index_t i=0; i<n*n; ++i)
+			EXPECT_EQ(km[i], copy_km[i]);
+
+		SG_UNREF(copy);
+		SG_UNREF(custom);
+	}
+
+	SG_UNREF(kernel);
+}
+
+TEST(CustomKernelTest, set_precision)
+{
+	const index_t rows=5;
+	const index_t cols=7;
+
+	SGMatrix<float64_t> full(rows, cols);
+	for (index_t i=0; i<rows*cols; ++i)
+		full[i]=(i-10)*1000.25;
+
+	CCustomKernel* custom=new CCustomKernel(full);
+	EXPECT_EQ(CKP_FLOAT32, custom->get_precision());
+
+	/* bfloat16 has the range of float32 */
+	custom->set_precision(CKP_BFLOAT16);
+	SGMatrix<float64_t> km=custom->get_kernel_matrix();
+	for (index_t i=0; i<rows*cols; ++i)
+		EXPECT_NEAR(full[i], km[i], CMath::abs(full[i])/256);
+
+	/* converting back gives the rounded values */
+	custom->set_precision(CKP_FLOAT32);
+	SGMatrix<float32_t> float32_km=custom->get_float32_kernel_matrix();
+	for (index_t i=0; i<rows*cols; ++i)
+		EXPECT_EQ(km[i], float32_km[i]);
+
+	/* precision set before the matrix */
+	custom->set_precision(CKP_FLOAT16);
+	SGMatrix<float64_t> symmetric(cols, cols);
+	for (index_t i=0; i<cols; ++i)
+	{
+		for (index_t j=0; j<cols; ++j)
+			symmetric(i, j)=1.0/(1+i+j);
+	}
+	custom->set_triangle_kernel_matrix_from_full(symmetric);
+	EXPECT_EQ(CKP_FLOAT16, custom->get_precision());
+	EXPECT_TRUE(custom->is_upper_triangle());
+
+	km=custom->get_kernel_matrix();
+	for (index_t i=0; i<cols*cols; ++i)
+		EXPECT_NEAR(symmetric[i], km[i], symmetric[i]/2048);
+
+	SG_UNREF(custom);
+}
+
+TEST(CustomKernelTest, half_conversion)
+{
+	EXPECT_EQ(0x3c00, CCustomKernel::encode_half(1.0, CKP_FLOAT16));
+	EXPECT_EQ(0xc000, CCustomKernel::encode_half(-2.0, CKP_FLOAT16));
+	EXPECT_EQ(0x7bff, CCustomKernel::encode_half(65504.0, CKP_FLOAT16));
+	EXPECT_EQ(0x7c00, CCustomKernel::encode_half(65520.0, CKP_FLOAT16));
+	EXPECT_EQ(0x0001, CCustomKernel::encode_half(1.0/16777216, CKP_FLOAT16));
+	/* ties round to even */
+	EXPECT_EQ(0x3c00, CCustomKernel::encode_half(1.0+1.0/2048, CKP_FLOAT16));
+	EXPECT_EQ(0x3c02, CCustomKernel::encode_half(1.0+3.0/2048, CKP_FLOAT16));
+	EXPECT_EQ(0x3f80, CCustomKernel::encode_half(1.0, CKP_BFLOAT16));
+	EXPECT_EQ(0x3f80, CCustomKernel::encode_half(1.0+1.0/256, CKP_BFLOAT16));
+
+	for (uint32_t half=0; half<0x7c00; ++half)
+	{
+		float32_t value=CCustomKernel::decode_half(half, CKP_FLOAT16);
+		EXPECT_EQ(half, CCustomKernel::encode_half(value, CKP_FLOAT16));
+		value=CCustomKernel::decode_half(half, CKP_BFLOAT16);
+		EXPECT_EQ(half, CCustomKernel::encode_half(value, CKP_BFLOAT16));
+	}
+	EXPECT_EQ(6.103515625e-05f,
+			CCustomKernel::decode_half(0x0400, CKP_FLOAT16));
+	EXPECT_EQ(-2.0f, CCustomKernel::decode_half(0xc000, CKP_BFLOAT16));
+}
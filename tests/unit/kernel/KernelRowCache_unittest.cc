@@ -0,0 +1,230 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ */
+
+#include <gtest/gtest.h>
+#include <shogun/base/range.h>
+#include <shogun/base/some.h>
+#include <shogun/features/DenseFeatures.h>
+#include <shogun/kernel/GaussianKernel.h>
+#include <shogun/kernel/KernelRowCache.h>
+#include <shogun/lib/Tracer.h>
+#include <shogun/mathematics/Math.h>
+
+#include <cmath>
+
+using namespace shogun;
+
+class KernelRowCacheTest : public ::testing::Test
+{
+protected:
+	KernelRowCacheTest()
+	    : features(Some<CDenseFeatures<float64_t>>::from_raw(nullptr)),
+	      kernel(Some<CGaussianKernel>::from_raw(nullptr))
+	{
+	}
+
+	void SetUp()
+	{
+		sg_rand->set_seed(7);
+		SGMatrix<float64_t> data(3, num_vectors);
+		for (auto i : range(data.size()))
+			data[i] = CMath::randn_double();
+
+		features = some<CDenseFeatures<float64_t>>(data);
+		kernel = some<CGaussianKernel>(features, features, 2.0);
+	}
+
+	const index_t num_vectors = 20;
+	Some<CDenseFeatures<float64_t>> features;
+	Some<CGaussianKernel> kernel;
+};
+
+TEST_F(KernelRowCacheTest, installs_itself)
+{
+	{
+		KernelRowCache cache(kernel, 1);
+		EXPECT_EQ(kernel->get_row_cache(), &cache);
+	}
+	EXPECT_EQ(kernel->get_row_cache(), nullptr);
+}
+
+TEST_F(KernelRowCacheTest, kernel_values)
+{
+	KernelRowCache cache(kernel, 1);
+	for (auto repetition : range(2))
+	{
+		for (auto i : range(num_vectors))
+		{
+			auto row = cache.get_row(kernel, i);
+			for (auto j : range(num_vectors))
+			{
+				EXPECT_EQ(row.kernel(j), kernel->kernel(i, j))
+				    << "in repetition " << repetition;
+			}
+			EXPECT_EQ(cache.diagonal(kernel, i), kernel->kernel(i, i));
+		}
+	}
+	EXPECT_EQ(cache.get_num_rows(), num_vectors);
+}
+
+TEST_F(KernelRowCacheTest, evicts_least_recently_used)
+{
+	/* room for two rows */
+	KernelRowCache cache(
+	    kernel, 2.0 * num_vectors * sizeof(float64_t) / (1 << 20));
+
+	cache.get_row(kernel, 0).kernel(1);
+	cache.get_row(kernel, 1);
+	cache.get_row(kernel, 0);
+
+	/* row 1 was used less recently than row 0 */
+	cache.get_row(kernel, 2);
+	EXPECT_EQ(cache.get_num_rows(), 2);
+
+	Tracer::reset();
+	Tracer::enable();
+	cache.get_row(kernel, 0).kernel(1);
+	cache.get_row(kernel, 1).kernel(0);
+	auto hits = Tracer::get_counters()[TC_CACHE_HITS];
+	auto misses = Tracer::get_counters()[TC_CACHE_MISSES];
+	Tracer::enable(false);
+	Tracer::reset();
+#ifdef USE_TRACING
+	EXPECT_EQ(hits, 1);
+	EXPECT_EQ(misses, 1);
+#else
+	EXPECT_EQ(hits + misses, 0);
+#endif
+}
+
+TEST_F(KernelRowCacheTest, keeps_rows_in_use)
+{
+	/* room for one row */
+	KernelRowCache cache(
+	    kernel, 1.0 * num_vectors * sizeof(float64_t) / (1 << 20));
+
+	auto row = cache.get_row(kernel, 0);
+	EXPECT_EQ(row.kernel(1), kernel->kernel(0, 1));
+	auto other = cache.get_row(kernel, 1);
+	EXPECT_EQ(cache.get_num_rows(), 2);
+	EXPECT_EQ(row.kernel(1), kernel->kernel(0, 1));
+	EXPECT_EQ(other.kernel(0), kernel->kernel(1, 0));
+}
+
+TEST_F(KernelRowCacheTest, global_indices)
+{
+	KernelRowCache cache(kernel, 1);
+	cache.get_row(kernel, 3).kernel(5);
+
+	/* local index 0 is global index 3, local index 1 is global index 5 */
+	SGVector<index_t> subset(2);
+	subset[0] = 3;
+	subset[1] = 5;
+	features->add_subset(subset);
+
+	EXPECT_EQ(cache.get_row(kernel, 0).kernel(1), kernel->kernel(0, 1));
+	EXPECT_EQ(cache.get_num_rows(), 1);
+
+	features->remove_subset();
+}
+
+TEST_F(KernelRowCacheTest, switches_subsets)
+{
+	KernelRowCache cache(kernel, 1);
+
+	SGVector<index_t> first(2);
+	first[0] = 0;
+	first[1] = 1;
+	features->add_subset(first);
+	kernel->init(features, features);
+	cache.get_row(kernel, 0).kernel(1);
+	EXPECT_EQ(cache.get_num_cols(), 2);
+	features->remove_subset();
+
+	/* the same features with a subset reaching further, the rows grow */
+	SGVector<index_t> second(2);
+	second[0] = 0;
+	second[1] = num_vectors - 1;
+	features->add_subset(second);
+	kernel->init(features, features);
+	EXPECT_EQ(cache.get_row(kernel, 0).kernel(1), kernel->kernel(0, 1));
+	EXPECT_EQ(cache.get_num_cols(), num_vectors);
+	EXPECT_EQ(cache.get_num_rows(), 1);
+
+	Tracer::reset();
+	Tracer::enable();
+	EXPECT_EQ(cache.get_row(kernel, 0).kernel(1), kernel->kernel(0, 1));
+	auto hits = Tracer::get_counters()[TC_CACHE_HITS];
+	Tracer::enable(false);
+	Tracer::reset();
+#ifdef USE_TRACING
+	EXPECT_EQ(hits, 1);
+#else
+	EXPECT_EQ(hits, 0);
+#endif
+
+	features->remove_subset();
+	kernel->init(features, features);
+}
+
+TEST_F(KernelRowCacheTest, subset_views)
+{
+	KernelRowCache cache(kernel, 1);
+	cache.get_row(kernel, 3).kernel(5);
+
+	/* a copy of the kernel on a view of the features shares the rows */
+	SGVector<index_t> subset(2);
+	subset[0] = 3;
+	subset[1] = 5;
+	auto view = features->shallow_subset_copy();
+	view->add_subset(subset);
+	auto copy = kernel->clone()->as<CKernel>();
+	copy->init(view, view);
+	copy->set_row_cache(&cache);
+
+	EXPECT_EQ(cache.get_row(copy, 0).kernel(1), kernel->kernel(3, 5));
+	EXPECT_EQ(cache.diagonal(copy, 1), kernel->kernel(5, 5));
+	EXPECT_EQ(cache.get_num_rows(), 1);
+
+	SG_UNREF(copy);
+	SG_UNREF(view);
+}
+
+TEST_F(KernelRowCacheTest, concurrent_rows)
+{
+	/* room for a few rows, so that rows are evicted while others are used */
+	KernelRowCache cache(
+	    kernel, 4.0 * num_vectors * sizeof(float64_t) / (1 << 20));
+
+	SGMatrix<float64_t> result(num_vectors, num_vectors);
+#pragma omp parallel for num_threads(4)
+	for (index_t k = 0; k < 4 * num_vectors; k++)
+	{
+		index_t i = k % num_vectors;
+		auto row = cache.get_row(kernel, i);
+		for (auto j : range(num_vectors))
+			result(i, j) = row.kernel(j);
+	}
+
+	for (auto i : range(num_vectors))
+	{
+		for (auto j : range(num_vectors))
+			EXPECT_EQ(result(i, j), kernel->kernel(i, j));
+	}
+}
+
+TEST_F(KernelRowCacheTest, other_features)
+{
+	KernelRowCache cache(kernel, 1);
+	cache.get_row(kernel, 0).kernel(0);
+
+	SGMatrix<float64_t> data(3, num_vectors);
+	data.zero();
+	auto other = some<CDenseFeatures<float64_t>>(data);
+	kernel->init(other, other);
+
+	/* the row of the old features is dropped */
+	EXPECT_EQ(cache.get_row(kernel, 0).kernel(1), 1.0);
+	EXPECT_EQ(cache.get_num_rows(), 1);
+}
@@ -29,14 +29,40 @@
  */
 
 #include <gtest/gtest.h>
+
+#include <atomic>
+
 #include <shogun/lib/common.h>
 #include <shogun/lib/SGVector.h>
 #include <shogun/lib/SGMatrix.h>
 #include <shogun/features/DenseFeatures.h>
+#include <shogun/base/some.h>
 #include <shogun/kernel/GaussianKernel.h>
+#include <shogun/lib/Signal.h>
+#include <shogun/lib/exception/ShogunException.h>
 
 using namespace shogun;
 
+/** Gaussian kernel that requests cancellation on its first evaluation */
+class CCancellingGaussianKernel : public CGaussianKernel
+{
+public:
+	CCancellingGaussianKernel(CDotFeatures* l, CDotFeatures* r, float64_t width)
+		: CGaussianKernel(l, r, width), m_cancelled(false)
+	{
+	}
+
+protected:
+	virtual float64_t compute(int32_t idx_a, int32_t idx_b)
+	{
+		if (!m_cancelled.exchange(true))
+			CSignal::cancel_computations();
+		return CGaussianKernel::compute(idx_a, idx_b);
+	}
+
+	std::atomic<bool> m_cancelled;
+};
+
 static SGMatrix<float64_t>
 generate_std_norm_matrix(const index_t num_feats, const index_t dim)
 {
@@ -412,3 +438,17 @@ TEST(Kernel, gaussian_get_kernel_matrix)
 
 	SG_UNREF(kernel);
 }
+
+TEST(Kernel, get_kernel_matrix_cancelled)
+{
+	SGMatrix<float64_t> data = generate_std_norm_matrix(50, 3);
+	CDenseFeatures<float64_t>* feats=new CDenseFeatures<float64_t>(data);
+
+	auto kernel=some<CCancellingGaussianKernel>(feats, feats, 2);
+	EXPECT_THROW(kernel->get_kernel_matrix(), ShogunException);
+
+	// a computation started after the cancellation is not affected
+	SGMatrix<float64_t> km=kernel->get_kernel_matrix();
+	EXPECT_EQ(km.num_rows, 50);
+	EXPECT_EQ(km.num_cols, 50);
+}
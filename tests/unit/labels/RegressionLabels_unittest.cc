@@ -35,3 +35,66 @@ TEST_F(RegressionLabels, regression_labels_from_regression)
 	auto labels2 = regression_labels(labels);
 	EXPECT_EQ(labels, labels2);
 }
+
+TEST_F(RegressionLabels, subset)
+{
+	auto labels = some<CRegressionLabels>(labels_regression);
+
+	SGVector<index_t> range_subset{1, 2};
+	labels->add_subset(range_subset);
+	ASSERT_EQ(labels->get_num_labels(), range_subset.vlen);
+	for (auto i : range(range_subset.vlen))
+		EXPECT_EQ(labels->get_label(i), labels_regression[range_subset[i]]);
+	labels->set_label(0, 3.0);
+	EXPECT_EQ(labels->get_label(0), 3.0);
+	EXPECT_EQ(labels_regression[1], 3.0);
+	labels->remove_subset();
+
+	SGVector<index_t> subset{3, 0, 2};
+	labels->add_subset(subset);
+	auto copy = labels->get_labels();
+	ASSERT_EQ(copy.vlen, subset.vlen);
+	for (auto i : range(subset.vlen))
+	{
+		EXPECT_EQ(labels->get_label(i), labels_regression[subset[i]]);
+		EXPECT_EQ(copy[i], labels_regression[subset[i]]);
+	}
+
+	// writes reach both the subset and the original labels
+	labels->set_label(1, 7.0);
+	EXPECT_EQ(labels->get_label(1), 7.0);
+	EXPECT_EQ(labels_regression[0], 7.0);
+
+	labels->remove_subset();
+	EXPECT_EQ(labels->get_num_labels(), n);
+	EXPECT_EQ(labels->get_label(0), 7.0);
+}
+
+TEST_F(RegressionLabels, subset_copy)
+{
+	auto labels = some<CRegressionLabels>(labels_regression);
+	SGVector<index_t> subset{3, 0, 2};
+
+	// no copy by default, so writes to the label vector are seen
+	labels->add_subset(subset);
+	labels_regression[3] = 5.0;
+	EXPECT_EQ(labels->get_label(0), 5.0);
+	labels->remove_subset();
+
+	labels->set_max_subset_copy_size(subset.vlen * sizeof(float64_t));
+	labels->add_subset(subset);
+	for (auto i : range(subset.vlen))
+		EXPECT_EQ(labels->get_label(i), labels_regression[subset[i]]);
+
+	// the setters drop the copy
+	labels->set_label(1, 7.0);
+	EXPECT_EQ(labels->get_label(1), 7.0);
+	EXPECT_EQ(labels_regression[0], 7.0);
+	labels_regression[2] = 9.0;
+	EXPECT_EQ(labels->get_label(2), 9.0);
+
+	labels->set_int_label(0, 1);
+	EXPECT_EQ(labels->get_label(0), 1.0);
+	labels->remove_subset();
+	EXPECT_EQ(labels->get_label(1), labels_regression[1]);
+}
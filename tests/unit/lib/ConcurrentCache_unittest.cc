@@ -0,0 +1,113 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ */
+
+#include <gtest/gtest.h>
+#include <shogun/base/range.h>
+#include <shogun/base/some.h>
+#include <shogun/lib/ConcurrentCache.h>
+
+using namespace shogun;
+
+TEST(ConcurrentCache, set_lock_unlock)
+{
+	const int64_t obj_size = 4;
+	auto cache = some<CConcurrentCache<float64_t>>(1, obj_size, 10);
+
+	EXPECT_FALSE(cache->is_cached(3));
+	EXPECT_EQ(cache->lock_entry(3), nullptr);
+
+	auto entry = cache->set_entry(3);
+	ASSERT_NE(entry, nullptr);
+	for (auto i : range(obj_size))
+		entry[i] = i;
+
+	// not visible before it is written and unlocked
+	EXPECT_EQ(cache->lock_entry(3), nullptr);
+	EXPECT_EQ(cache->set_entry(3), nullptr);
+	cache->unlock_entry(3);
+
+	EXPECT_TRUE(cache->is_cached(3));
+	auto cached = cache->lock_entry(3);
+	ASSERT_EQ(cached, entry);
+	for (auto i : range(obj_size))
+		EXPECT_EQ(cached[i], i);
+	cache->unlock_entry(3);
+}
+
+TEST(ConcurrentCache, pinned_entries_are_not_evicted)
+{
+	const int64_t obj_size = 1024 * 1024 / sizeof(float64_t) / 2;
+	// two cache lines in a single shard
+	auto cache = some<CConcurrentCache<float64_t>>(1, obj_size, 10, 1);
+
+	auto first = cache->set_entry(0);
+	auto second = cache->set_entry(1);
+	ASSERT_NE(first, nullptr);
+	ASSERT_NE(second, nullptr);
+
+	// both lines are pinned
+	EXPECT_EQ(cache->set_entry(2), nullptr);
+
+	cache->unlock_entry(1);
+	EXPECT_EQ(cache->set_entry(2), second);
+	EXPECT_FALSE(cache->is_cached(1));
+
+	cache->unlock_entry(0);
+	cache->unlock_entry(2);
+	EXPECT_TRUE(cache->is_cached(0));
+	EXPECT_TRUE(cache->is_cached(2));
+}
+
+TEST(ConcurrentCache, least_recently_used_is_evicted)
+{
+	const int64_t obj_size = 1024 * 1024 / sizeof(float64_t) / 2;
+	auto cache = some<CConcurrentCache<float64_t>>(1, obj_size, 10, 1);
+
+	cache->set_entry(0);
+	cache->set_entry(1);
+	cache->unlock_entry(0);
+	cache->unlock_entry(1);
+
+	// 0 becomes the most recently used entry
+	cache->lock_entry(0);
+	cache->unlock_entry(0);
+
+	ASSERT_NE(cache->set_entry(2), nullptr);
+	cache->unlock_entry(2);
+	EXPECT_TRUE(cache->is_cached(0));
+	EXPECT_FALSE(cache->is_cached(1));
+	EXPECT_TRUE(cache->is_cached(2));
+}
+
+TEST(ConcurrentCache, parallel_access)
+{
+	const int64_t num_entries = 64;
+	// 32 cache lines for 64 objects, so entries get evicted
+	const int64_t obj_size = 1024 * 1024 / sizeof(int64_t) / 32;
+	auto cache = some<CConcurrentCache<int64_t>>(1, obj_size, num_entries);
+
+	int64_t num_errors = 0;
+#pragma omp parallel for reduction(+ : num_errors)
+	for (int64_t i = 0; i < 10000; i++)
+	{
+		auto number = (i * 7919) % num_entries;
+		auto entry = cache->lock_entry(number);
+		if (!entry)
+		{
+			entry = cache->set_entry(number);
+			if (!entry)
+				continue;
+
+			for (auto j : range(obj_size))
+				entry[j] = number;
+		}
+
+		for (auto j : range(obj_size))
+			num_errors += entry[j] != number;
+
+		cache->unlock_entry(number);
+	}
+
+	EXPECT_EQ(num_errors, 0);
+}
@@ -0,0 +1,87 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ */
+
+#include <gtest/gtest.h>
+#include <shogun/base/range.h>
+#include <shogun/lib/MemoryArena.h>
+#include <shogun/lib/SGMatrix.h>
+#include <shogun/lib/SGVector.h>
+
+using namespace shogun;
+
+TEST(MemoryArena, scoped_allocations)
+{
+	MemoryArena arena(4096);
+	EXPECT_EQ(MemoryArena::current(), nullptr);
+
+	reset_allocation_counters();
+	{
+		ArenaScope scope(arena);
+		EXPECT_EQ(MemoryArena::current(), &arena);
+
+		for (auto i : range(1000))
+		{
+			SGVector<float64_t> vec(8);
+			for (auto j : range(vec.vlen))
+			{
+				EXPECT_EQ(vec[j], 0);
+				vec[j] = i;
+			}
+		}
+
+		SGMatrix<float64_t> mat(2, 3);
+		EXPECT_EQ(mat.size(), 6);
+
+		// too large for the arena
+		SGVector<float64_t> large(4096);
+		EXPECT_EQ(large.ref_count(), 1);
+	}
+	EXPECT_EQ(MemoryArena::current(), nullptr);
+
+	auto counters = get_allocation_counters();
+	EXPECT_EQ(counters.num_arena_allocs, 1001);
+	EXPECT_EQ(counters.num_heap_allocs, 1);
+	EXPECT_EQ(counters.heap_bytes, int64_t(4096 * sizeof(float64_t)));
+
+	// released blocks are reused
+	EXPECT_EQ(arena.get_num_blocks(), 1);
+}
+
+TEST(MemoryArena, outlives_scope)
+{
+	SGVector<float64_t> kept;
+	SGMatrix<float64_t> kept_matrix;
+	{
+		MemoryArena arena(4096);
+		ArenaScope scope(arena);
+
+		SGVector<float64_t> vec(4);
+		vec.range_fill();
+		kept = vec;
+
+		kept_matrix = SGMatrix<float64_t>(vec, 2, 2);
+	}
+
+	for (auto i : range(kept.vlen))
+		EXPECT_EQ(kept[i], i);
+	EXPECT_EQ(kept_matrix(1, 1), 3);
+	EXPECT_EQ(kept.ref_count(), 2);
+
+	kept.resize_vector(6);
+	EXPECT_EQ(kept.ref_count(), 1);
+	EXPECT_EQ(kept[3], 3);
+	EXPECT_EQ(kept[5], 0);
+	EXPECT_EQ(kept_matrix(1, 1), 3);
+}
+
+TEST(MemoryArena, nested_scopes)
+{
+	MemoryArena outer_arena, inner_arena;
+	ArenaScope outer(outer_arena);
+	{
+		ArenaScope inner(inner_arena);
+		EXPECT_EQ(MemoryArena::current(), &inner_arena);
+	}
+	EXPECT_EQ(MemoryArena::current(), &outer_arena);
+}
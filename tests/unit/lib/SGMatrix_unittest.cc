@@ -1,6 +1,8 @@
 #include <gtest/gtest.h>
 
+#include <shogun/base/range.h>
 #include <shogun/lib/SGMatrix.h>
+#include <shogun/lib/SGMatrixView.h>
 #include <shogun/lib/SGVector.h>
 #include <shogun/mathematics/Math.h>
 #include <shogun/mathematics/linalg/LinalgNamespace.h>
@@ -715,3 +717,57 @@ TEST(SGMatrixTest,iterator)
 	for (auto v: mat)
 		EXPECT_EQ(mat[index++], v);
 }
+
+TEST(SGMatrixTest, move)
+{
+	SGMatrix<float64_t> a(2, 3);
+	auto data = a.matrix;
+
+	SGMatrix<float64_t> b(std::move(a));
+	EXPECT_EQ(b.matrix, data);
+	EXPECT_EQ(b.num_rows, 2);
+	EXPECT_EQ(b.num_cols, 3);
+	EXPECT_EQ(b.ref_count(), 1);
+	EXPECT_EQ(a.matrix, nullptr);
+
+	SGMatrix<float64_t> c;
+	c = std::move(b);
+	EXPECT_EQ(c.matrix, data);
+	EXPECT_EQ(c.ref_count(), 1);
+	EXPECT_EQ(b.matrix, nullptr);
+}
+
+TEST(SGMatrixTest, view)
+{
+	SGMatrix<float64_t> mat(3, 2);
+	for (auto i : range(mat.size()))
+		mat[i] = i;
+
+	SGMatrixView<float64_t> view(mat);
+	EXPECT_EQ(mat.ref_count(), 1);
+	EXPECT_EQ(view.num_rows(), 3);
+	EXPECT_EQ(view.num_cols(), 2);
+	for (auto j : range(mat.num_cols))
+	{
+		auto col = view.get_column(j);
+		ASSERT_EQ(col.size(), mat.num_rows);
+		for (auto i : range(mat.num_rows))
+		{
+			EXPECT_EQ(view(i, j), mat(i, j));
+			EXPECT_EQ(col[i], mat(i, j));
+		}
+	}
+}
+
+TEST(SGMatrixTest, aligned)
+{
+	SGMatrix<float32_t> mat(3, 5);
+	EXPECT_TRUE(sg_is_aligned(mat.matrix, SG_DATA_ALIGNMENT));
+	for (auto i : range(mat.size()))
+		mat[i] = i;
+
+	auto copy = mat.clone();
+	EXPECT_TRUE(sg_is_aligned(copy.matrix, SG_DATA_ALIGNMENT));
+	for (auto i : range(mat.size()))
+		EXPECT_EQ(copy[i], i);
+}
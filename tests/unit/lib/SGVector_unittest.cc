@@ -2,11 +2,14 @@
 #include <shogun/base/range.h>
 #include <shogun/lib/SGMatrix.h>
 #include <shogun/lib/SGVector.h>
+#include <shogun/lib/SGVectorView.h>
 #include <shogun/mathematics/Math.h>
 #include <shogun/mathematics/linalg/LinalgNamespace.h>
 
 #include <shogun/mathematics/eigen3.h>
 
+#include <numeric>
+
 using namespace shogun;
 
 TEST(SGVectorTest,ctor)
@@ -468,3 +471,79 @@ TEST(SGVectorTest, as)
 		EXPECT_EQ((int32_t)data[i], vec_int[i]);
 	}
 }
+
+TEST(SGVectorTest, move)
+{
+	SGVector<float64_t> a(5);
+	a.range_fill();
+	auto data = a.vector;
+
+	SGVector<float64_t> b(std::move(a));
+	EXPECT_EQ(b.vector, data);
+	EXPECT_EQ(b.vlen, 5);
+	EXPECT_EQ(b.ref_count(), 1);
+	EXPECT_EQ(a.vector, nullptr);
+	EXPECT_EQ(a.vlen, 0);
+
+	SGVector<float64_t> c(3);
+	SGVector<float64_t> d(c);
+	d = std::move(b);
+	EXPECT_EQ(d.vector, data);
+	EXPECT_EQ(d.ref_count(), 1);
+	EXPECT_EQ(c.ref_count(), 1);
+	EXPECT_EQ(b.vector, nullptr);
+
+	// moved from vectors can be assigned again
+	b = d;
+	EXPECT_EQ(b.ref_count(), 2);
+	for (auto i : range(b.vlen))
+		EXPECT_EQ(b[i], i);
+}
+
+TEST(SGVectorTest, resize_vector_shared)
+{
+	SGVector<index_t> a(3);
+	a.range_fill();
+	SGVector<index_t> b(a);
+
+	a.resize_vector(5);
+	EXPECT_EQ(a.vlen, 5);
+	EXPECT_EQ(a.ref_count(), 1);
+	for (auto i : range(3))
+		EXPECT_EQ(a[i], i);
+	EXPECT_EQ(a[4], 0);
+
+	// other references keep the old data
+	EXPECT_EQ(b.vlen, 3);
+	EXPECT_EQ(b.ref_count(), 1);
+	EXPECT_EQ(b[2], 2);
+}
+
+TEST(SGVectorTest, view)
+{
+	SGVector<float64_t> a(4);
+	a.range_fill();
+
+	SGVectorView<float64_t> view(a);
+	EXPECT_EQ(a.ref_count(), 1);
+	ASSERT_EQ(view.size(), a.vlen);
+	EXPECT_EQ(view.data(), a.vector);
+	for (auto i : range(a.vlen))
+		EXPECT_EQ(view[i], a[i]);
+	EXPECT_EQ(std::accumulate(view.begin(), view.end(), 0.0), 6.0);
+}
+
+TEST(SGVectorTest, aligned)
+{
+	for (auto len : {1, 3, 17, 1000})
+	{
+		SGVector<float64_t> a(len);
+		EXPECT_TRUE(sg_is_aligned(a.vector, SG_DATA_ALIGNMENT));
+		a.range_fill();
+
+		auto b = a.clone();
+		EXPECT_TRUE(sg_is_aligned(b.vector, SG_DATA_ALIGNMENT));
+		for (auto i : range(len))
+			EXPECT_EQ(b[i], i);
+	}
+}
@@ -0,0 +1,100 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ */
+
+#include <gtest/gtest.h>
+#include <shogun/base/range.h>
+#include <shogun/base/some.h>
+#include <shogun/features/DenseFeatures.h>
+#include <shogun/kernel/GaussianKernel.h>
+#include <shogun/lib/Tracer.h>
+
+#include <thread>
+#include <vector>
+
+using namespace shogun;
+
+class TracerTest : public ::testing::Test
+{
+protected:
+	void SetUp()
+	{
+		Tracer::reset();
+		Tracer::enable();
+	}
+
+	void TearDown()
+	{
+		Tracer::enable(false);
+		Tracer::reset();
+	}
+};
+
+TEST_F(TracerTest, disabled)
+{
+	Tracer::enable(false);
+	Tracer::count(TC_CACHE_MISSES, 3);
+	{
+		TraceScope scope("disabled");
+	}
+
+	EXPECT_EQ(Tracer::get_counters()[TC_CACHE_MISSES], 0);
+	EXPECT_EQ(Tracer::get_num_events(), 0);
+}
+
+/* recording is compiled out without USE_TRACING */
+#ifdef USE_TRACING
+TEST_F(TracerTest, counters_of_all_threads)
+{
+	std::vector<std::thread> threads;
+	for (auto i : range(4))
+	{
+		threads.emplace_back([i]() {
+			for (int32_t j = 0; j < 1000; j++)
+				Tracer::count(TC_SOLVER_ITERATIONS, i + 1);
+		});
+	}
+	for (auto& thread : threads)
+		thread.join();
+
+	auto counters = Tracer::get_counters();
+	EXPECT_EQ(counters[TC_SOLVER_ITERATIONS], 10000);
+	EXPECT_EQ(counters[TC_CACHE_HITS], 0);
+}
+
+TEST_F(TracerTest, chrome_trace)
+{
+	{
+		TraceScope outer("outer");
+		TraceScope inner("inner \"quoted\"");
+		Tracer::count(TC_BYTES_PARSED, 42);
+	}
+	EXPECT_EQ(Tracer::get_num_events(), 2);
+
+	auto json = Tracer::to_chrome_trace();
+	EXPECT_NE(json.find("\"name\":\"outer\""), std::string::npos);
+	EXPECT_NE(json.find("\"name\":\"inner \\\"quoted\\\"\""), std::string::npos);
+	EXPECT_NE(json.find("\"ph\":\"X\""), std::string::npos);
+	EXPECT_NE(
+	    json.find("\"name\":\"bytes_parsed\",\"ph\":\"C\""), std::string::npos);
+	EXPECT_NE(json.find("\"value\":42"), std::string::npos);
+}
+
+TEST_F(TracerTest, kernel_matrix)
+{
+	const index_t num_vectors = 10;
+	SGMatrix<float64_t> data(2, num_vectors);
+	data.set_const(1.0);
+	auto feats = some<CDenseFeatures<float64_t>>(data);
+	auto kernel = some<CGaussianKernel>(feats, feats, 1.0);
+
+	kernel->get_kernel_matrix();
+
+	EXPECT_GE(
+	    Tracer::get_counters()[TC_KERNEL_EVALUATIONS],
+	    num_vectors * (num_vectors + 1) / 2);
+	EXPECT_NE(
+	    Tracer::to_chrome_trace().find("CKernel::get_kernel_matrix"),
+	    std::string::npos);
+}
+#endif // USE_TRACING
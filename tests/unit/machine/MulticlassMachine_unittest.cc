@@ -0,0 +1,413 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ */
+
+#include <gtest/gtest.h>
+#include <shogun/base/range.h>
+#include <shogun/base/some.h>
+#include <shogun/classifier/svm/LibLinear.h>
+#include <shogun/classifier/svm/LibSVM.h>
+#include <shogun/features/DenseFeatures.h>
+#include <shogun/kernel/GaussianKernel.h>
+#include <shogun/labels/MulticlassLabels.h>
+#include <shogun/lib/Signal.h>
+#include <shogun/lib/Tracer.h>
+#include <shogun/lib/exception/ShogunException.h>
+#include <shogun/machine/KernelMulticlassMachine.h>
+#include <shogun/machine/LinearMulticlassMachine.h>
+#include <shogun/mathematics/Math.h>
+#include <shogun/multiclass/MulticlassLibSVM.h>
+#include <shogun/multiclass/MulticlassOneVsOneStrategy.h>
+#include <shogun/multiclass/MulticlassOneVsRestStrategy.h>
+
+#include <atomic>
+#include <set>
+
+using namespace shogun;
+
+/** Gaussian kernel that requests cancellation on its next evaluation once
+ * armed
+ */
+class CCancellingGaussianKernel : public CGaussianKernel
+{
+public:
+	CCancellingGaussianKernel(CDotFeatures* l, CDotFeatures* r, float64_t width)
+	    : CGaussianKernel(l, r, width), m_armed(false)
+	{
+	}
+
+	void arm()
+	{
+		m_armed = true;
+	}
+
+protected:
+	virtual float64_t compute(int32_t idx_a, int32_t idx_b)
+	{
+		if (m_armed.exchange(false))
+			CSignal::cancel_computations();
+		return CGaussianKernel::compute(idx_a, idx_b);
+	}
+
+	std::atomic<bool> m_armed;
+};
+
+class MulticlassMachineTest : public ::testing::Test
+{
+protected:
+	MulticlassMachineTest()
+	    : features(Some<CDenseFeatures<float64_t>>::from_raw(nullptr)),
+	      multiclass_labels(Some<CMulticlassLabels>::from_raw(nullptr))
+	{
+	}
+
+	void SetUp()
+	{
+		const index_t num_vectors = 60;
+		const float64_t distance = 10;
+
+		sg_rand->set_seed(5);
+		SGMatrix<float64_t> data(num_classes, num_vectors);
+		SGVector<float64_t> labels(num_vectors);
+		for (auto i : range(num_vectors))
+		{
+			auto label = i % num_classes;
+			for (auto j : range(num_classes))
+				data(j, i) = CMath::randn_double();
+			data(label, i) += distance;
+			labels[i] = label;
+		}
+
+		features = some<CDenseFeatures<float64_t>>(data);
+		multiclass_labels = some<CMulticlassLabels>(labels);
+	}
+
+	/** expects the sub-machines of two trained machines to be the same */
+	void expect_same_submachines(
+	    CMulticlassMachine* machine, CMulticlassMachine* expected_machine)
+	{
+		ASSERT_EQ(
+		    machine->get_num_machines(), expected_machine->get_num_machines());
+		for (auto m : range(machine->get_num_machines()))
+		{
+			auto expected =
+			    expected_machine->get_machine(m)->as<CKernelMachine>();
+			auto submachine = machine->get_machine(m)->as<CKernelMachine>();
+			EXPECT_NEAR(submachine->get_bias(), expected->get_bias(), 1e-10);
+			EXPECT_EQ(
+			    submachine->get_num_support_vectors(),
+			    expected->get_num_support_vectors());
+			for (auto i : range(CMath::min(
+			         submachine->get_num_support_vectors(),
+			         expected->get_num_support_vectors())))
+			{
+				EXPECT_EQ(
+				    submachine->get_support_vector(i),
+				    expected->get_support_vector(i));
+				EXPECT_NEAR(
+				    submachine->get_alpha(i), expected->get_alpha(i), 1e-10);
+			}
+			SG_UNREF(expected);
+			SG_UNREF(submachine);
+		}
+	}
+
+	/** trains a kernel multiclass machine with and without a shared kernel
+	 * cache, expects fewer kernel evaluations and the same sub-machines
+	 */
+	void expect_shared_kernel_cache(bool one_vs_one, int32_t max_concurrent)
+	{
+		auto strategy = [one_vs_one]() -> CMulticlassStrategy* {
+			if (one_vs_one)
+				return new CMulticlassOneVsOneStrategy();
+			return new CMulticlassOneVsRestStrategy();
+		};
+
+		auto kernel = some<CGaussianKernel>(features, features, 10.0);
+		auto unshared = some<CKernelMulticlassMachine>(
+		    strategy(), kernel, new CLibSVM(), multiclass_labels);
+		unshared->parallel->set_num_threads(4);
+		unshared->set_max_concurrent_submachines(max_concurrent);
+		unshared->set_shared_kernel_cache(false);
+		auto shared = some<CKernelMulticlassMachine>(
+		    strategy(), kernel, new CLibSVM(), multiclass_labels);
+		shared->parallel->set_num_threads(4);
+		shared->set_max_concurrent_submachines(max_concurrent);
+		ASSERT_TRUE(shared->get_shared_kernel_cache());
+
+		Tracer::reset();
+		Tracer::enable();
+		unshared->train();
+		auto unshared_evaluations =
+		    Tracer::get_counters()[TC_KERNEL_EVALUATIONS];
+		Tracer::reset();
+		shared->train();
+		auto shared_evaluations =
+		    Tracer::get_counters()[TC_KERNEL_EVALUATIONS];
+		Tracer::enable(false);
+		Tracer::reset();
+
+		/* the sub-problems share vectors, the counters are zero without
+		 * tracing */
+		EXPECT_LE(shared_evaluations, unshared_evaluations);
+#ifdef USE_TRACING
+		EXPECT_LT(shared_evaluations, unshared_evaluations)
+		    << "with " << max_concurrent << " concurrent sub-machines";
+#endif
+		EXPECT_EQ(kernel->get_row_cache(), nullptr);
+
+		expect_same_submachines(shared, unshared);
+	}
+
+	const int32_t num_classes = 5;
+	Some<CDenseFeatures<float64_t>> features;
+	Some<CMulticlassLabels> multiclass_labels;
+};
+
+TEST_F(MulticlassMachineTest, linear_one_vs_one_concurrently)
+{
+	auto sequential = some<CLinearMulticlassMachine>(
+	    new CMulticlassOneVsOneStrategy(), features,
+	    new CLibLinear(L2R_L2LOSS_SVC_DUAL), multiclass_labels);
+	sequential->set_max_concurrent_submachines(1);
+	sequential->train();
+
+	auto concurrent = some<CLinearMulticlassMachine>(
+	    new CMulticlassOneVsOneStrategy(), features,
+	    new CLibLinear(L2R_L2LOSS_SVC_DUAL), multiclass_labels);
+	concurrent->parallel->set_num_threads(4);
+	concurrent->set_max_concurrent_submachines(3);
+	concurrent->train();
+
+	auto num_machines = num_classes * (num_classes - 1) / 2;
+	ASSERT_EQ(concurrent->get_num_machines(), num_machines);
+	ASSERT_EQ(sequential->get_num_machines(), num_machines);
+
+	/* the shared features are left without a subset */
+	EXPECT_EQ(
+	    features->get_num_vectors(), multiclass_labels->get_num_labels());
+
+	auto expected = sequential->apply_multiclass(features);
+	auto result = concurrent->apply_multiclass(features);
+	for (auto i : range(features->get_num_vectors()))
+	{
+		EXPECT_EQ(result->get_label(i), multiclass_labels->get_label(i));
+		EXPECT_EQ(result->get_label(i), expected->get_label(i));
+	}
+
+	SG_UNREF(expected);
+	SG_UNREF(result);
+}
+
+TEST_F(MulticlassMachineTest, kernel_one_vs_rest_concurrently)
+{
+	auto kernel = some<CGaussianKernel>(features, features, 10.0);
+	auto sequential = some<CKernelMulticlassMachine>(
+	    new CMulticlassOneVsRestStrategy(), kernel, new CLibSVM(),
+	    multiclass_labels);
+	sequential->set_max_concurrent_submachines(1);
+	sequential->train();
+
+	auto concurrent = some<CKernelMulticlassMachine>(
+	    new CMulticlassOneVsRestStrategy(), kernel, new CLibSVM(),
+	    multiclass_labels);
+	concurrent->parallel->set_num_threads(4);
+	concurrent->train();
+	ASSERT_EQ(concurrent->get_num_machines(), num_classes);
+
+	/* the kernel of the multiclass machine still has its features */
+	EXPECT_EQ(kernel->get_num_vec_lhs(), features->get_num_vectors());
+
+	for (auto m : range(num_classes))
+	{
+		auto expected = sequential->get_machine(m)->as<CKernelMachine>();
+		auto machine = concurrent->get_machine(m)->as<CKernelMachine>();
+		EXPECT_NEAR(machine->get_bias(), expected->get_bias(), 1e-10);
+		EXPECT_EQ(
+		    machine->get_num_support_vectors(),
+		    expected->get_num_support_vectors());
+		SG_UNREF(expected);
+		SG_UNREF(machine);
+	}
+
+	auto result = concurrent->apply_multiclass(features);
+	for (auto i : range(features->get_num_vectors()))
+		EXPECT_EQ(result->get_label(i), multiclass_labels->get_label(i));
+	SG_UNREF(result);
+}
+
+TEST_F(MulticlassMachineTest, kernel_one_vs_one_concurrently)
+{
+	auto kernel = some<CGaussianKernel>(features, features, 10.0);
+	auto machine = some<CKernelMulticlassMachine>(
+	    new CMulticlassOneVsOneStrategy(), kernel, new CLibSVM(),
+	    multiclass_labels);
+	machine->parallel->set_num_threads(4);
+	machine->set_max_concurrent_submachines(3);
+	machine->train();
+
+	auto num_machines = num_classes * (num_classes - 1) / 2;
+	ASSERT_EQ(machine->get_num_machines(), num_machines);
+
+	/* the sub-machines are trained on subset views, the shared features
+	 * are left without a subset */
+	EXPECT_EQ(
+	    features->get_num_vectors(), multiclass_labels->get_num_labels());
+	EXPECT_EQ(kernel->get_num_vec_lhs(), features->get_num_vectors());
+
+	/* support vectors are indices of the training features, and belong to
+	 * the two classes of their problem */
+	for (auto m : range(num_machines))
+	{
+		auto submachine = machine->get_machine(m)->as<CKernelMachine>();
+		std::set<float64_t> classes;
+		for (auto j : range(submachine->get_num_support_vectors()))
+		{
+			auto sv = submachine->get_support_vector(j);
+			ASSERT_GE(sv, 0);
+			ASSERT_LT(sv, features->get_num_vectors());
+			classes.insert(multiclass_labels->get_label(sv));
+		}
+		EXPECT_LE(classes.size(), 2);
+		SG_UNREF(submachine);
+	}
+
+	auto result = machine->apply_multiclass(features);
+	for (auto i : range(features->get_num_vectors()))
+		EXPECT_EQ(result->get_label(i), multiclass_labels->get_label(i));
+	SG_UNREF(result);
+}
+
+TEST_F(MulticlassMachineTest, shared_support_vector_outputs)
+{
+	auto kernel = some<CGaussianKernel>(features, features, 10.0);
+	auto svm = some<CMulticlassLibSVM>(1.0, kernel, multiclass_labels);
+	svm->train();
+
+	auto num_machines = svm->get_num_machines();
+	ASSERT_EQ(num_machines, num_classes * (num_classes - 1) / 2);
+
+	auto result = svm->apply_multiclass(features);
+	auto outputs = svm->get_all_submachine_outputs();
+	ASSERT_EQ(outputs.num_rows, features->get_num_vectors());
+	ASSERT_EQ(outputs.num_cols, num_machines);
+
+	/* same as applying the submachines one by one */
+	for (auto i : range(num_machines))
+	{
+		auto machine_outputs = svm->get_submachine_outputs(i);
+		for (auto j : range(features->get_num_vectors()))
+		{
+			EXPECT_NEAR(outputs(j, i), machine_outputs->get_value(j), 1e-10);
+			EXPECT_NEAR(
+			    result->get_multiclass_confidences(j)[i],
+			    machine_outputs->get_value(j), 1e-10);
+		}
+		SG_UNREF(machine_outputs);
+	}
+
+	for (auto i : range(features->get_num_vectors()))
+		EXPECT_EQ(result->get_label(i), multiclass_labels->get_label(i));
+	SG_UNREF(result);
+}
+
+TEST_F(MulticlassMachineTest, shared_support_vector_outputs_cancelled)
+{
+	auto kernel = some<CCancellingGaussianKernel>(features, features, 10.0);
+	auto svm = some<CMulticlassLibSVM>(1.0, kernel, multiclass_labels);
+	svm->train();
+
+	auto result = svm->apply_multiclass(features);
+	SG_UNREF(result);
+	kernel->arm();
+	EXPECT_THROW(svm->get_all_submachine_outputs(), ShogunException);
+}
+
+TEST_F(MulticlassMachineTest, shared_kernel_cache)
+{
+	auto kernel = some<CGaussianKernel>(features, features, 10.0);
+	auto unshared = some<CMulticlassLibSVM>(1.0, kernel, multiclass_labels);
+	unshared->set_shared_kernel_cache(false);
+	auto shared = some<CMulticlassLibSVM>(1.0, kernel, multiclass_labels);
+	ASSERT_TRUE(shared->get_shared_kernel_cache());
+
+	Tracer::reset();
+	Tracer::enable();
+	unshared->train();
+	auto unshared_evaluations =
+	    Tracer::get_counters()[TC_KERNEL_EVALUATIONS];
+	Tracer::reset();
+	shared->train();
+	auto shared_evaluations = Tracer::get_counters()[TC_KERNEL_EVALUATIONS];
+	Tracer::enable(false);
+	Tracer::reset();
+
+	/* each vector is in num_classes-1 sub-problems, the counters are zero
+	 * without tracing */
+	EXPECT_LE(shared_evaluations, unshared_evaluations);
+#ifdef USE_TRACING
+	EXPECT_LT(shared_evaluations, unshared_evaluations);
+#endif
+	/* the cache is removed after training */
+	EXPECT_EQ(kernel->get_row_cache(), nullptr);
+
+	ASSERT_EQ(shared->get_num_machines(), unshared->get_num_machines());
+	for (auto m : range(shared->get_num_machines()))
+	{
+		auto expected = unshared->get_machine(m)->as<CKernelMachine>();
+		auto machine = shared->get_machine(m)->as<CKernelMachine>();
+		EXPECT_NEAR(machine->get_bias(), expected->get_bias(), 1e-10);
+		ASSERT_EQ(
+		    machine->get_num_support_vectors(),
+		    expected->get_num_support_vectors());
+		for (auto i : range(machine->get_num_support_vectors()))
+		{
+			EXPECT_EQ(
+			    machine->get_support_vector(i),
+			    expected->get_support_vector(i));
+			EXPECT_NEAR(machine->get_alpha(i), expected->get_alpha(i), 1e-10);
+		}
+		SG_UNREF(expected);
+		SG_UNREF(machine);
+	}
+}
+
+TEST_F(MulticlassMachineTest, kernel_machine_shared_kernel_cache)
+{
+	/* sequentially and concurrently trained sub-machines */
+	for (auto max_concurrent : {1, 3})
+	{
+		expect_shared_kernel_cache(false, max_concurrent);
+		expect_shared_kernel_cache(true, max_concurrent);
+	}
+}
+
+TEST_F(MulticlassMachineTest, kernel_one_vs_one_sequentially)
+{
+	auto kernel = some<CGaussianKernel>(features, features, 10.0);
+	auto sequential = some<CKernelMulticlassMachine>(
+	    new CMulticlassOneVsOneStrategy(), kernel, new CLibSVM(),
+	    multiclass_labels);
+	sequential->set_max_concurrent_submachines(1);
+	sequential->train();
+
+	/* the subsets of the sub-problems are removed again */
+	EXPECT_EQ(
+	    features->get_num_vectors(), multiclass_labels->get_num_labels());
+	EXPECT_EQ(kernel->get_num_vec_lhs(), features->get_num_vectors());
+
+	auto concurrent = some<CKernelMulticlassMachine>(
+	    new CMulticlassOneVsOneStrategy(), kernel, new CLibSVM(),
+	    multiclass_labels);
+	concurrent->parallel->set_num_threads(4);
+	concurrent->set_max_concurrent_submachines(3);
+	concurrent->train();
+
+	/* support vectors are indices of the training features either way */
+	expect_same_submachines(sequential, concurrent);
+
+	auto result = sequential->apply_multiclass(features);
+	for (auto i : range(features->get_num_vectors()))
+		EXPECT_EQ(result->get_label(i), multiclass_labels->get_label(i));
+	SG_UNREF(result);
+}
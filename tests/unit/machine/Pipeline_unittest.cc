@@ -7,6 +7,9 @@
 #include <shogun/base/some.h>
 #include <shogun/lib/exception/InvalidStateException.h>
 #include <shogun/machine/Pipeline.h>
+#include <shogun/preprocessor/LogPlusOne.h>
+#include <shogun/preprocessor/NormOne.h>
+#include <shogun/preprocessor/RescaleFeatures.h>
 #include <stdexcept>
 
 using namespace shogun;
@@ -15,6 +18,7 @@ using ::testing::NiceMock;
 using ::testing::Return;
 using ::testing::_;
 using ::testing::InSequence;
+using ::testing::Invoke;
 
 class PipelineTest : public ::testing::Test
 {
@@ -98,3 +102,51 @@ TEST_F(PipelineTest, get)
 
 	SG_UNREF(pipeline);
 }
+
+TEST_F(PipelineTest, fused_preprocessors)
+{
+	const index_t num_features = 20;
+	const index_t num_vectors = 5000;
+	SGMatrix<float64_t> data(num_features, num_vectors);
+	for (auto j : range(num_vectors))
+		for (auto i : range(num_features))
+			data(i, j) = ((i * 31 + j * 17) % 101) / 10.0;
+
+	auto features = some<CDenseFeatures<float64_t>>(data.clone());
+	auto rescale = some<CRescaleFeatures>();
+	auto log = some<CLogPlusOne>();
+	auto norm = some<CNormOne>();
+	rescale->fit(features);
+
+	// reference: apply the stages one after another on a copy
+	auto expected = wrap(rescale->transform(features, false));
+	expected = wrap(log->transform(expected));
+	expected = wrap(norm->transform(expected));
+	auto expected_matrix =
+	    expected->as<CDenseFeatures<float64_t>>()->get_feature_matrix();
+
+	auto pipeline = some<CPipelineBuilder>()
+	                    ->over(rescale)
+	                    ->over(log)
+	                    ->over(norm)
+	                    ->then(machine);
+
+	SGMatrix<float64_t> actual_matrix;
+	EXPECT_CALL(*machine, apply(_))
+	    .WillOnce(Invoke([&actual_matrix](CFeatures* transformed) {
+		    actual_matrix = transformed->as<CDenseFeatures<float64_t>>()
+		                        ->get_feature_matrix();
+		    return nullptr;
+		}));
+	pipeline->apply(features);
+
+	ASSERT_EQ(actual_matrix.num_rows, num_features);
+	ASSERT_EQ(actual_matrix.num_cols, num_vectors);
+	for (auto i : range(actual_matrix.num_rows * actual_matrix.num_cols))
+		EXPECT_NEAR(actual_matrix[i], expected_matrix[i], 1e-12);
+
+	// fused application does not modify the input
+	EXPECT_TRUE(features->get_feature_matrix().equals(data));
+
+	SG_UNREF(pipeline);
+}
@@ -33,8 +33,31 @@
 #include <shogun/features/DenseFeatures.h>
 #include <shogun/distributions/KernelDensity.h>
 
+#include <cmath>
+
 using namespace shogun;
 
+static SGVector<float64_t> brute_force_log_density(SGMatrix<float64_t> data, SGMatrix<float64_t> test, EKDEKernelType kernel, float64_t h)
+{
+	SGVector<float64_t> res(test.num_cols);
+	for (int32_t i=0;i<test.num_cols;i++)
+	{
+		float64_t density=0;
+		for (int32_t j=0;j<data.num_cols;j++)
+		{
+			float64_t dist=0;
+			for (int32_t d=0;d<data.num_rows;d++)
+				dist+=CMath::sq(data(d,j)-test(d,i));
+
+			density+=std::exp(CKernelDensity::log_kernel(kernel,std::sqrt(dist),h));
+		}
+
+		res[i]=std::log(density/data.num_cols)+CKernelDensity::log_norm(kernel,h,data.num_rows);
+	}
+
+	return res;
+}
+
 TEST(KernelDensity,gaussian_kernel_with_euclidean_distance)
 {
 	SGMatrix<float64_t> data(2,4);
@@ -94,7 +117,7 @@ TEST(KernelDensity,gaussian_kernel_with_manhattan_distance)
 	CDenseFeatures<float64_t>* feats=new CDenseFeatures<float64_t>(data);
 
 
-	CKernelDensity* k=new CKernelDensity(1.0, K_GAUSSIAN, D_MANHATTAN);
+	CKernelDensity* k=new CKernelDensity(1.0, KDE_GAUSSIAN, D_MANHATTAN);
 	k->train(feats);
 
 	SGMatrix<float64_t> test(2,5);
@@ -138,7 +161,7 @@ TEST(KernelDensity,dual_tree)
 	CDenseFeatures<float64_t>* feats=new CDenseFeatures<float64_t>(data);
 
 
-	CKernelDensity* k=new CKernelDensity(1.0, K_GAUSSIAN, D_EUCLIDEAN, EM_BALLTREE_DUAL);
+	CKernelDensity* k=new CKernelDensity(1.0, KDE_GAUSSIAN, D_EUCLIDEAN, EM_BALLTREE_DUAL);
 	k->train(feats);
 
 	SGMatrix<float64_t> test(2,5);
@@ -180,12 +203,12 @@ TEST(KernelDensity,dual_tree_single_tree_equivalence)
 	CDenseFeatures<float64_t>* testfeats=new CDenseFeatures<float64_t>(test);
 
 
-	CKernelDensity* k=new CKernelDensity(1.0, K_GAUSSIAN, D_EUCLIDEAN, EM_BALLTREE_DUAL,5);
+	CKernelDensity* k=new CKernelDensity(1.0, KDE_GAUSSIAN, D_EUCLIDEAN, EM_BALLTREE_DUAL,5);
 	k->train(feats);
 	SGVector<float64_t> res_dual=k->get_log_density(testfeats,2);
 
 	SG_UNREF(k);
-	k=new CKernelDensity(1.0, K_GAUSSIAN, D_EUCLIDEAN, EM_BALLTREE_SINGLE,5);
+	k=new CKernelDensity(1.0, KDE_GAUSSIAN, D_EUCLIDEAN, EM_BALLTREE_SINGLE,5);
 	k->train(feats);
 	SGVector<float64_t> res_single=k->get_log_density(testfeats);
 
@@ -196,3 +219,130 @@ TEST(KernelDensity,dual_tree_single_tree_equivalence)
 	SG_UNREF(feats);
 	SG_UNREF(k);
 }
+
+TEST(KernelDensity,kernels_match_brute_force)
+{
+	sg_rand->set_seed(2);
+
+	SGMatrix<float64_t> data(3,200);
+	sg_rand->fill_array_oo(data.matrix,600);
+	CDenseFeatures<float64_t>* feats=new CDenseFeatures<float64_t>(data);
+
+	SGMatrix<float64_t> test(3,50);
+	sg_rand->fill_array_oo(test.matrix,150);
+	CDenseFeatures<float64_t>* testfeats=new CDenseFeatures<float64_t>(test);
+
+	EKDEKernelType kernels[]={KDE_GAUSSIAN,KDE_EXPONENTIAL,KDE_EPANECHNIKOV,KDE_TOPHAT};
+	EEvaluationMode modes[]={EM_KDTREE_SINGLE,EM_BALLTREE_SINGLE,EM_KDTREE_DUAL,EM_BALLTREE_DUAL};
+	for (auto kernel : kernels)
+	{
+		SGVector<float64_t> expected=brute_force_log_density(data,test,kernel,0.5);
+		for (auto mode : modes)
+		{
+			CKernelDensity* k=new CKernelDensity(0.5, kernel, D_EUCLIDEAN, mode, 5);
+			k->train(feats);
+			SGVector<float64_t> res=k->get_log_density(testfeats,3);
+
+			for (int32_t i=0;i<res.vlen;i++)
+				EXPECT_NEAR(res[i],expected[i],1e-8);
+
+			SG_UNREF(k);
+		}
+	}
+
+	SG_UNREF(testfeats);
+	SG_UNREF(feats);
+}
+
+TEST(KernelDensity,kernels_are_normalized)
+{
+	// Riemann sum over a 2-D grid that covers the support of the kernels
+	float64_t h=0.5;
+	float64_t step=0.01;
+	EKDEKernelType kernels[]={KDE_GAUSSIAN,KDE_EXPONENTIAL,KDE_EPANECHNIKOV,KDE_TOPHAT};
+	for (auto kernel : kernels)
+	{
+		float64_t integral=0;
+		for (float64_t x=-10+step/2;x<10;x+=step)
+		{
+			for (float64_t y=-10+step/2;y<10;y+=step)
+			{
+				float64_t dist=std::sqrt(x*x+y*y);
+				integral+=std::exp(CKernelDensity::log_kernel(kernel,dist,h))*step*step;
+			}
+		}
+
+		EXPECT_NEAR(integral*std::exp(CKernelDensity::log_norm(kernel,h,2)),1.0,1e-2);
+	}
+}
+
+TEST(KernelDensity,approximation_within_tolerance)
+{
+	sg_rand->set_seed(3);
+
+	SGMatrix<float64_t> data(2,500);
+	sg_rand->fill_array_oo(data.matrix,1000);
+	CDenseFeatures<float64_t>* feats=new CDenseFeatures<float64_t>(data);
+
+	SGMatrix<float64_t> test(2,200);
+	sg_rand->fill_array_oo(test.matrix,400);
+	CDenseFeatures<float64_t>* testfeats=new CDenseFeatures<float64_t>(test);
+
+	float64_t rtol=0.1;
+	SGVector<float64_t> expected=brute_force_log_density(data,test,KDE_GAUSSIAN,0.2);
+
+	// single tree evaluation bounds the error of every query point
+	CKernelDensity* k=new CKernelDensity(0.2, KDE_GAUSSIAN, D_EUCLIDEAN, EM_BALLTREE_SINGLE, 5, 0, rtol);
+	k->train(feats);
+	SGVector<float64_t> res=k->get_log_density(testfeats);
+	for (int32_t i=0;i<res.vlen;i++)
+		EXPECT_LE(CMath::abs(std::exp(res[i]-expected[i])-1),rtol);
+	SG_UNREF(k);
+
+	// dual tree evaluation bounds the error of the sum over the query points
+	k=new CKernelDensity(0.2, KDE_GAUSSIAN, D_EUCLIDEAN, EM_KDTREE_DUAL, 5);
+	k->set_rtol(rtol);
+	k->train(feats);
+	res=k->get_log_density(testfeats,5);
+	float64_t sum=0;
+	float64_t expected_sum=0;
+	for (int32_t i=0;i<res.vlen;i++)
+	{
+		sum+=std::exp(res[i]);
+		expected_sum+=std::exp(expected[i]);
+	}
+	EXPECT_LE(CMath::abs(sum/expected_sum-1),rtol);
+	SG_UNREF(k);
+
+	SG_UNREF(testfeats);
+	SG_UNREF(feats);
+}
+
+TEST(KernelDensity,dual_tree_independent_of_threads)
+{
+	sg_rand->set_seed(4);
+
+	SGMatrix<float64_t> data(3,300);
+	sg_rand->fill_array_oo(data.matrix,900);
+	CDenseFeatures<float64_t>* feats=new CDenseFeatures<float64_t>(data);
+
+	// enough query points to be split into several subtrees
+	SGMatrix<float64_t> test(3,1000);
+	sg_rand->fill_array_oo(test.matrix,3000);
+	CDenseFeatures<float64_t>* testfeats=new CDenseFeatures<float64_t>(test);
+
+	CKernelDensity* k=new CKernelDensity(0.3, KDE_EPANECHNIKOV, D_EUCLIDEAN, EM_BALLTREE_DUAL, 5, 1e-3, 1e-2);
+	k->train(feats);
+
+	k->parallel->set_num_threads(1);
+	SGVector<float64_t> res_sequential=k->get_log_density(testfeats,5);
+	k->parallel->set_num_threads(4);
+	SGVector<float64_t> res_parallel=k->get_log_density(testfeats,5);
+
+	for (int32_t i=0;i<res_parallel.vlen;i++)
+		EXPECT_EQ(res_parallel[i],res_sequential[i]);
+
+	SG_UNREF(testfeats);
+	SG_UNREF(feats);
+	SG_UNREF(k);
+}
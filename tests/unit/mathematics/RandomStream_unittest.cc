@@ -0,0 +1,169 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ */
+
+#include <gtest/gtest.h>
+#include <shogun/lib/SGVector.h>
+#include <shogun/mathematics/Math.h>
+#include <shogun/mathematics/RandomStream.h>
+#include <shogun/mathematics/Statistics.h>
+
+using namespace shogun;
+
+/* known answers of the Philox4x32-10 reference implementation */
+TEST(RandomStream, philox_known_answers)
+{
+	uint32_t result[4];
+
+	const uint32_t zero_key[2] = {0, 0};
+	RandomStream::philox(0, 0, zero_key, result);
+	EXPECT_EQ(0x6627e8d5U, result[0]);
+	EXPECT_EQ(0xe169c58dU, result[1]);
+	EXPECT_EQ(0xbc57ac4cU, result[2]);
+	EXPECT_EQ(0x9b00dbd8U, result[3]);
+
+	const uint32_t ones_key[2] = {0xffffffff, 0xffffffff};
+	RandomStream::philox(uint64_t(-1), uint64_t(-1), ones_key, result);
+	EXPECT_EQ(0x408f276dU, result[0]);
+	EXPECT_EQ(0x41c83b0eU, result[1]);
+	EXPECT_EQ(0xa20bc7c6U, result[2]);
+	EXPECT_EQ(0x6d5451fdU, result[3]);
+
+	const uint32_t pi_key[2] = {0xa4093822, 0x299f31d0};
+	RandomStream::philox(
+	    0x85a308d3243f6a88ULL, 0x0370734413198a2eULL, pi_key, result);
+	EXPECT_EQ(0xd16cfe09U, result[0]);
+	EXPECT_EQ(0x94fdccebU, result[1]);
+	EXPECT_EQ(0x5001e420U, result[2]);
+	EXPECT_EQ(0x24126ea1U, result[3]);
+}
+
+TEST(RandomStream, reproducible)
+{
+	RandomStream first(12345, 3);
+	RandomStream second(12345, 3);
+	EXPECT_EQ(12345U, first.get_seed());
+	EXPECT_EQ(3U, first.get_stream());
+
+	for (index_t i = 0; i < 100; i++)
+		EXPECT_EQ(first.random_64(), second.random_64());
+	EXPECT_EQ(first.get_position(), second.get_position());
+}
+
+TEST(RandomStream, streams_differ)
+{
+	RandomStream first(12345, 0);
+	RandomStream second(12345, 1);
+	RandomStream third(12346, 0);
+
+	index_t num_equal = 0;
+	for (index_t i = 0; i < 100; i++)
+	{
+		auto value = first.random_32();
+		num_equal += value == second.random_32();
+		num_equal += value == third.random_32();
+	}
+	EXPECT_LE(num_equal, 1);
+}
+
+TEST(RandomStream, discard)
+{
+	RandomStream stream(7, 2);
+	stream.random_32();
+	stream.discard(5);
+	EXPECT_EQ(6U, stream.get_position());
+
+	uint32_t block[4];
+	const uint32_t key[2] = {7, 0};
+	RandomStream::philox(6, 2, key, block);
+	for (index_t i = 0; i < 4; i++)
+		EXPECT_EQ(block[i], stream.random_32());
+}
+
+TEST(RandomStream, fill_array_as_scalar)
+{
+	RandomStream bulk(42, 5);
+	RandomStream scalar(42, 5);
+	SGVector<uint32_t> values(11);
+	bulk.fill_array(values.vector, values.vlen);
+	for (index_t i = 0; i < values.vlen; i++)
+		EXPECT_EQ(scalar.random_32(), values[i]);
+
+	SGVector<float64_t> uniform(7);
+	bulk.fill_array_co(uniform.vector, uniform.vlen);
+	scalar.discard(0);
+	for (index_t i = 0; i < uniform.vlen; i++)
+		EXPECT_EQ(scalar.random_half_open(), uniform[i]);
+}
+
+TEST(RandomStream, uniform_moments)
+{
+	RandomStream stream(1);
+	SGVector<float64_t> values(100001);
+	stream.fill_array_co(values.vector, values.vlen);
+
+	float64_t min = CMath::min(values.vector, values.vlen);
+	float64_t max = CMath::max(values.vector, values.vlen);
+	EXPECT_GE(min, 0.0);
+	EXPECT_LT(max, 1.0);
+	EXPECT_NEAR(0.5, CStatistics::mean(values), 5e-3);
+	EXPECT_NEAR(1.0 / 12, CStatistics::variance(values), 5e-3);
+
+	for (index_t i = 0; i < 1000; i++)
+	{
+		auto value = stream.random_open();
+		EXPECT_GT(value, 0.0);
+		EXPECT_LT(value, 1.0);
+	}
+}
+
+TEST(RandomStream, normal_moments)
+{
+	RandomStream stream(1);
+	SGVector<float64_t> values(100001);
+	stream.fill_array_normal(values.vector, values.vlen);
+	EXPECT_NEAR(0.0, CStatistics::mean(values), 1e-2);
+	EXPECT_NEAR(1.0, CStatistics::variance(values), 2e-2);
+
+	for (index_t i = 0; i < values.vlen; i++)
+		values[i] = stream.normal_distrib(2.0, 3.0);
+	EXPECT_NEAR(2.0, CStatistics::mean(values), 3e-2);
+	EXPECT_NEAR(9.0, CStatistics::variance(values), 2e-1);
+}
+
+TEST(RandomStream, random_range)
+{
+	RandomStream stream(3);
+	SGVector<index_t> counts(5);
+	counts.zero();
+	for (index_t i = 0; i < 50000; i++)
+	{
+		auto value = stream.random(-2, 2);
+		ASSERT_GE(value, -2);
+		ASSERT_LE(value, 2);
+		counts[value + 2]++;
+	}
+	for (index_t i = 0; i < counts.vlen; i++)
+		EXPECT_NEAR(10000, counts[i], 500);
+}
+
+TEST(RandomStream, permute)
+{
+	SGVector<index_t> first(20);
+	SGVector<index_t> second(20);
+	first.range_fill();
+	second.range_fill();
+
+	RandomStream stream(9, 4);
+	CMath::permute(first, stream);
+	stream = RandomStream(9, 4);
+	CMath::permute(second, stream);
+
+	SGVector<index_t> sorted = first.clone();
+	CMath::qsort(sorted.vector, sorted.vlen);
+	for (index_t i = 0; i < first.vlen; i++)
+	{
+		EXPECT_EQ(first[i], second[i]);
+		EXPECT_EQ(i, sorted[i]);
+	}
+}
@@ -742,6 +742,28 @@ TYPED_TEST(LinalgBackendEigenAllTypesTest, SGVector_dot)
 	EXPECT_NEAR(result, 5, get_epsilon<TypeParam>());
 }
 
+TEST(LinalgBackendEigen, SGVector_unaligned_views)
+{
+	const index_t size = 9;
+	SGVector<float64_t> a(size + 1), b(size + 1);
+	a.range_fill(0);
+	b.set_const(2);
+
+	// views at an offset are not aligned
+	SGVector<float64_t> a_view(a.vector, size, 1), b_view(b.vector, size, 1);
+	SGVector<float64_t> result(size);
+
+	EXPECT_NEAR(dot(a_view, b_view), 90, 1e-15);
+
+	add(a_view, b_view, result, 1.0, 2.0);
+	for (auto i : range(size))
+		EXPECT_NEAR(result[i], i + 5, 1e-15);
+
+	scale(a_view, result, 3.0);
+	for (auto i : range(size))
+		EXPECT_NEAR(result[i], 3 * (i + 1), 1e-15);
+}
+
 TYPED_TEST(LinalgBackendEigenNonIntegerTypesTest, eigensolver)
 {
 	const index_t n = 4;
@@ -8,11 +8,25 @@
 
 #include <shogun/features/DenseFeatures.h>
 #include <shogun/labels/MulticlassLabels.h>
+#include <shogun/mathematics/Math.h>
 #include <shogun/mathematics/linalg/LinalgNamespace.h>
 #include <shogun/metric/LMNNImpl.h>
 
 using namespace shogun;
 
+void expect_impostors_eq(const ImpostorsSetType& expected, const ImpostorsSetType& impostors)
+{
+	ASSERT_EQ(expected.size(), impostors.size());
+	auto it=impostors.begin();
+	for (const auto& node : expected)
+	{
+		EXPECT_EQ(node.example, it->example);
+		EXPECT_EQ(node.target, it->target);
+		EXPECT_EQ(node.impostor, it->impostor);
+		++it;
+	}
+}
+
 TEST(LMNNImpl,find_target_nn)
 {
 	// create features, each column is a feature vector
@@ -189,3 +203,76 @@ TEST(LMNNImpl,find_impostors_exact)
 	SG_UNREF(features)
 	SG_UNREF(labels)
 }
+
+TEST(LMNNImpl,find_impostors_brute_force)
+{
+	// three classes of random examples that overlap
+	int32_t d=3;
+	int32_t n=90;
+	sg_rand->set_seed(17);
+	SGMatrix<float64_t> feat_mat(d,n);
+	SGVector<float64_t> lab_vec(n);
+	for (int32_t i=0; i<n; i++)
+	{
+		lab_vec[i]=i%3;
+		for (int32_t j=0; j<d; j++)
+			feat_mat(j,i)=CMath::randn_double()+lab_vec[i];
+	}
+	CDenseFeatures<float64_t>* features=new CDenseFeatures<float64_t>(feat_mat);
+	CMulticlassLabels* labels=new CMulticlassLabels(lab_vec);
+
+	int32_t k=2;
+	SGMatrix<index_t> target_nn=CLMNNImpl::find_target_nn(features,labels,k);
+
+	SGMatrix<float64_t> L(d,d);
+	for (int32_t i=0; i<d*d; i++)
+		L[i]=CMath::randn_double();
+
+	ImpostorsSetType impostors =
+	    CLMNNImpl::find_impostors(features, labels, L, target_nn, 0, 1);
+
+	// impostors of all the examples against all the examples
+	auto LX=linalg::matrix_prod(L, feat_mat);
+	auto sqdist=[&](index_t a, index_t b)
+	{
+		float64_t result=0;
+		for (int32_t l=0; l<d; l++)
+			result+=(LX(l,a)-LX(l,b))*(LX(l,a)-LX(l,b));
+		return result;
+	};
+
+	ImpostorsSetType expected;
+	for (index_t i=0; i<n; i++)
+	{
+		for (index_t j=0; j<k; j++)
+		{
+			float64_t margin=sqdist(i,target_nn(j,i))+1;
+			for (index_t p=0; p<n; p++)
+			{
+				if (lab_vec[p]!=lab_vec[i] && sqdist(i,p)<=margin)
+					expected.insert(CImpostorNode(i,target_nn(j,i),p));
+			}
+		}
+	}
+
+	EXPECT_GT(expected.size(), 0);
+	expect_impostors_eq(expected, impostors);
+
+	// the impostors of a minibatch are the ones of its examples
+	SGVector<index_t> minibatch(10);
+	for (index_t i=0; i<minibatch.vlen; i++)
+		minibatch[i]=3*i+1;
+
+	ImpostorsSetType minibatch_impostors =
+	    CLMNNImpl::find_impostors_minibatch(features, labels, L, target_nn, minibatch);
+	ImpostorsSetType expected_minibatch;
+	for (const auto& node : expected)
+	{
+		if (node.example%3==1 && node.example<30)
+			expected_minibatch.insert(node);
+	}
+	expect_impostors_eq(expected_minibatch, minibatch_impostors);
+
+	SG_UNREF(features)
+	SG_UNREF(labels)
+}
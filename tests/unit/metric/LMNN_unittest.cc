@@ -9,6 +9,7 @@
 #include <shogun/base/some.h>
 #include <shogun/features/DenseFeatures.h>
 #include <shogun/labels/MulticlassLabels.h>
+#include <shogun/mathematics/Math.h>
 #include <shogun/metric/LMNN.h>
 
 using namespace shogun;
@@ -198,3 +199,103 @@ TEST(LMNN,train_diagonal)
 
 	SG_UNREF(lmnn)
 }
+
+TEST(LMNN, train_minibatch)
+{
+	SGMatrix<float64_t> feat_mat(2, 4);
+	feat_mat(0, 0) = 0;
+	feat_mat(1, 0) = 0;
+	feat_mat(0, 1) = 0;
+	feat_mat(1, 1) = -1;
+	feat_mat(0, 2) = 1;
+	feat_mat(1, 2) = 1;
+	feat_mat(0, 3) = -1;
+	feat_mat(1, 3) = 1;
+
+	auto features = some<CDenseFeatures<float64_t>>(feat_mat);
+
+	SGVector<float64_t> lab_vec(4);
+	lab_vec[0] = 0;
+	lab_vec[1] = 0;
+	lab_vec[2] = 1;
+	lab_vec[3] = 1;
+
+	auto labels = some<CMulticlassLabels>(lab_vec);
+
+	SGMatrix<float64_t> init_transform =
+	    SGMatrix<float64_t>::create_identity_matrix(2, 1);
+
+	// a minibatch of all the examples takes the same first steps as the full
+	// batch with exact impostors search; the step size is corrected after them
+	auto full = some<CLMNN>(features, labels, 1);
+	full->set_maxiter(2);
+	full->set_correction(1);
+	full->train(init_transform.clone());
+
+	auto minibatch = some<CLMNN>(features, labels, 1);
+	minibatch->set_maxiter(2);
+	minibatch->set_minibatch_size(4);
+	minibatch->train(init_transform.clone());
+
+	SGMatrix<float64_t> expected = full->get_linear_transform();
+	SGMatrix<float64_t> L = minibatch->get_linear_transform();
+	for (index_t i = 0; i < L.size(); ++i)
+		EXPECT_NEAR(L[i], expected[i], 1e-12);
+
+	auto expected_stat = full->get_statistics();
+	auto stat = minibatch->get_statistics();
+	ASSERT_EQ(stat->num_impostors.vlen, expected_stat->num_impostors.vlen);
+	for (index_t i = 0; i < stat->num_impostors.vlen; ++i)
+		EXPECT_EQ(stat->num_impostors[i], expected_stat->num_impostors[i]);
+
+	// smaller minibatches keep the step size
+	minibatch->set_maxiter(20);
+	minibatch->set_minibatch_size(2);
+	minibatch->train(init_transform.clone());
+	SG_UNREF(stat);
+	stat = minibatch->get_statistics();
+	EXPECT_EQ(stat->obj.vlen, 20);
+	for (index_t i = 0; i < stat->stepsize.vlen; ++i)
+		EXPECT_EQ(stat->stepsize[i], minibatch->get_stepsize());
+
+	SG_UNREF(expected_stat);
+	SG_UNREF(stat);
+}
+
+TEST(LMNN, independent_of_num_threads)
+{
+	// more target neighbour pairs than in a block of the gradient
+	const index_t num_vectors = 150;
+	const index_t num_classes = 3;
+	sg_rand->set_seed(17);
+	SGMatrix<float64_t> feat_mat(3, num_vectors);
+	SGVector<float64_t> lab_vec(num_vectors);
+	for (index_t i = 0; i < num_vectors; ++i)
+	{
+		lab_vec[i] = i % num_classes;
+		for (index_t j = 0; j < feat_mat.num_rows; ++j)
+			feat_mat(j, i) = CMath::randn_double() + (j == i % num_classes);
+	}
+
+	auto features = some<CDenseFeatures<float64_t>>(feat_mat);
+	auto labels = some<CMulticlassLabels>(lab_vec);
+	SGMatrix<float64_t> init_transform =
+	    SGMatrix<float64_t>::create_identity_matrix(3, 1);
+
+	// the partial sums of the gradient are added in the same order
+	auto lmnn = some<CLMNN>(features, labels, 3);
+	auto num_threads = lmnn->parallel->get_num_threads();
+	lmnn->set_maxiter(5);
+	lmnn->parallel->set_num_threads(1);
+	lmnn->train(init_transform.clone());
+	SGMatrix<float64_t> expected = lmnn->get_linear_transform().clone();
+
+	lmnn->parallel->set_num_threads(4);
+	lmnn->train(init_transform.clone());
+	SGMatrix<float64_t> L = lmnn->get_linear_transform();
+	lmnn->parallel->set_num_threads(num_threads);
+
+	ASSERT_EQ(L.size(), expected.size());
+	for (index_t i = 0; i < L.size(); ++i)
+		EXPECT_EQ(L[i], expected[i]);
+}
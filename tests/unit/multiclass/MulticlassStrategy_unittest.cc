@@ -1,5 +1,8 @@
 #include <shogun/multiclass/MulticlassOneVsOneStrategy.h>
 #include <shogun/multiclass/MulticlassOneVsRestStrategy.h>
+#include <shogun/multiclass/ecoc/ECOCEDDecoder.h>
+#include <shogun/multiclass/ecoc/ECOCHDDecoder.h>
+#include <shogun/mathematics/Math.h>
 #include <shogun/labels/BinaryLabels.h>
 #include <shogun/labels/MulticlassLabels.h>
 #include <gtest/gtest.h>
@@ -128,3 +131,127 @@ TEST(MulticlassStrategy,rescale_ova_hamamura)
 	EXPECT_NEAR(scores[1],0.3333333333333333,1E-5);
 	EXPECT_NEAR(scores[2],0.3333333333333333,1E-5);
 }
+
+/* more vectors than fit into one block of the batched decisions */
+static SGMatrix<float64_t> random_outputs(int32_t num_vectors, int32_t num_outputs)
+{
+	sg_rand->set_seed(17);
+	SGMatrix<float64_t> outputs(num_vectors, num_outputs);
+	for (int32_t i=0; i<outputs.num_rows*outputs.num_cols; i++)
+		outputs[i] = CMath::randn_double();
+
+	return outputs;
+}
+
+TEST(MulticlassStrategy,decide_labels_ova)
+{
+	SGMatrix<float64_t> outputs = random_outputs(600, 4);
+
+	CMulticlassOneVsRestStrategy ova;
+	ova.set_num_classes(4);
+	SGVector<int32_t> labels = ova.decide_labels(outputs);
+
+	ASSERT_EQ(labels.vlen, outputs.num_rows);
+	for (int32_t i=0; i<outputs.num_rows; i++)
+		EXPECT_EQ(labels[i], ova.decide_label(outputs.get_row_vector(i)));
+}
+
+TEST(MulticlassStrategy,decide_labels_ovo)
+{
+	SGMatrix<float64_t> outputs = random_outputs(600, 10);
+	/* ties in the votes are decided by the decision values */
+	outputs(0, 0) = 0;
+
+	CMulticlassOneVsOneStrategy ovo;
+	ovo.set_num_classes(5);
+	SGVector<int32_t> labels = ovo.decide_labels(outputs);
+
+	ASSERT_EQ(labels.vlen, outputs.num_rows);
+	for (int32_t i=0; i<outputs.num_rows; i++)
+		EXPECT_EQ(labels[i], ovo.decide_label(outputs.get_row_vector(i)));
+}
+
+TEST(MulticlassStrategy,decide_label_ovo_tie)
+{
+	/* classes 0 and 1 get two votes each, class 1 with the larger sum of
+	 * decision values */
+	SGMatrix<float64_t> outputs(1, 6);
+	outputs(0, 0) = 0.6;
+	outputs(0, 1) = -0.9;
+	outputs(0, 2) = 0.3;
+	outputs(0, 3) = 0.8;
+	outputs(0, 4) = 0.7;
+	outputs(0, 5) = -0.4;
+
+	CMulticlassOneVsOneStrategy ovo;
+	ovo.set_num_classes(4);
+	EXPECT_EQ(ovo.decide_label(outputs.get_row_vector(0)), 1);
+	EXPECT_EQ(ovo.decide_labels(outputs)[0], 1);
+}
+
+TEST(MulticlassStrategy,rescale_all_outputs_ova_softmax)
+{
+	SGMatrix<float64_t> outputs = random_outputs(300, 3);
+	SGVector<float64_t> As(3);
+	SGVector<float64_t> Bs(3);
+	for (int32_t i=0; i<3; i++)
+	{
+		As[i] = (i+1)*0.1;
+		Bs[i] = -0.1*i;
+	}
+
+	CMulticlassOneVsRestStrategy ova(OVA_SOFTMAX);
+	ova.set_num_classes(3);
+	SGMatrix<float64_t> rescaled = ova.rescale_all_outputs(outputs.clone(), As, Bs);
+
+	ASSERT_EQ(rescaled.num_rows, outputs.num_rows);
+	ASSERT_EQ(rescaled.num_cols, 3);
+	for (int32_t i=0; i<outputs.num_rows; i++)
+	{
+		SGVector<float64_t> scores = outputs.get_row_vector(i);
+		ova.rescale_outputs(scores,As,Bs);
+		for (int32_t j=0; j<3; j++)
+			EXPECT_NEAR(rescaled(i, j), scores[j], 1E-12);
+	}
+}
+
+TEST(MulticlassStrategy,rescale_all_outputs_ovo_hastie)
+{
+	SGMatrix<float64_t> outputs = random_outputs(20, 6);
+	for (int32_t i=0; i<outputs.num_rows*outputs.num_cols; i++)
+		outputs[i] = 1.0/(1.0+std::exp(outputs[i]));
+
+	CMulticlassOneVsOneStrategy ovo(OVO_HASTIE);
+	ovo.set_num_classes(4);
+	SGMatrix<float64_t> rescaled = ovo.rescale_all_outputs(outputs, SGVector<float64_t>(), SGVector<float64_t>());
+
+	ASSERT_EQ(rescaled.num_rows, outputs.num_rows);
+	ASSERT_EQ(rescaled.num_cols, 4);
+	for (int32_t i=0; i<outputs.num_rows; i++)
+	{
+		SGVector<float64_t> scores = outputs.get_row_vector(i);
+		ovo.rescale_outputs(scores);
+		for (int32_t j=0; j<4; j++)
+			EXPECT_NEAR(rescaled(i, j), scores[j], 1E-12);
+	}
+}
+
+TEST(MulticlassStrategy,decide_labels_ecoc)
+{
+	SGMatrix<float64_t> outputs = random_outputs(300, 4);
+	SGMatrix<int32_t> codebook(4, 3);
+	for (int32_t i=0; i<codebook.num_rows*codebook.num_cols; i++)
+		codebook[i] = i%3-1;
+
+	CECOCHDDecoder hd;
+	SGVector<int32_t> hd_labels = hd.decide_labels(outputs, codebook);
+	CECOCEDDecoder ed;
+	SGVector<int32_t> ed_labels = ed.decide_labels(outputs, codebook);
+
+	for (int32_t i=0; i<outputs.num_rows; i++)
+	{
+		SGVector<float64_t> query = outputs.get_row_vector(i);
+		EXPECT_EQ(hd_labels[i], hd.decide_label(query, codebook));
+		EXPECT_EQ(ed_labels[i], ed.decide_label(query, codebook));
+	}
+}
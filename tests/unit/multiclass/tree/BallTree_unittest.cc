@@ -31,6 +31,7 @@
 #include <gtest/gtest.h>
 #include <shogun/features/DenseFeatures.h>
 #include <shogun/lib/SGMatrix.h>
+#include <shogun/mathematics/Math.h>
 #include <shogun/multiclass/tree/BallTree.h>
 
 using namespace shogun;
@@ -52,33 +53,33 @@ TEST(BallTree,tree_structure)
 	CBallTree* tree=new CBallTree();
 	tree->build_tree(feats);
 
-	CBinaryTreeMachineNode<NbodyTreeNodeData>* node=dynamic_cast<CBinaryTreeMachineNode<NbodyTreeNodeData>*>(tree->get_root());
+	ASSERT_EQ(7,tree->get_num_nodes());
+	NbodyTreeNodeData node=tree->get_node_data(0);
 
-	EXPECT_EQ(0,node->data.start_idx);
-	EXPECT_EQ(3,node->data.end_idx);
-	EXPECT_EQ(0,node->data.center[0]);
-	EXPECT_EQ(0,node->data.center[1]);
-	EXPECT_EQ(4,node->data.radius);
+	EXPECT_EQ(0,node.start_idx);
+	EXPECT_EQ(3,node.end_idx);
+	EXPECT_EQ(0,node.center[0]);
+	EXPECT_EQ(0,node.center[1]);
+	EXPECT_EQ(4,node.radius);
 
-	CBinaryTreeMachineNode<NbodyTreeNodeData>* child=node->left();
+	NbodyTreeNodeData child=tree->get_node_data(tree->get_left_child(0));
+	EXPECT_FALSE(child.is_leaf);
 
-	EXPECT_EQ(0,child->data.start_idx);
-	EXPECT_EQ(1,child->data.end_idx);
-	EXPECT_EQ(-2.5,child->data.center[0]);
-	EXPECT_EQ(1,child->data.center[1]);
+	EXPECT_EQ(0,child.start_idx);
+	EXPECT_EQ(1,child.end_idx);
+	EXPECT_EQ(-2.5,child.center[0]);
+	EXPECT_EQ(1,child.center[1]);
 
-	SG_UNREF(child);
-	child=node->right();
+	child=tree->get_node_data(tree->get_right_child(0));
+	EXPECT_FALSE(child.is_leaf);
 
-	EXPECT_EQ(2,child->data.start_idx);
-	EXPECT_EQ(3,child->data.end_idx);
-	EXPECT_EQ(2.5,child->data.center[0]);
-	EXPECT_EQ(-1,child->data.center[1]);
+	EXPECT_EQ(2,child.start_idx);
+	EXPECT_EQ(3,child.end_idx);
+	EXPECT_EQ(2.5,child.center[0]);
+	EXPECT_EQ(-1,child.center[1]);
 
-	SG_UNREF(node);
 	SG_UNREF(tree);
 	SG_UNREF(feats);
-	SG_UNREF(child);
 }
 
 TEST(BallTree, knn_query)
@@ -115,3 +116,67 @@ TEST(BallTree, knn_query)
 	SG_UNREF(feats);
 	SG_UNREF(tree);
 }
+
+TEST(BallTree, knn_query_matches_brute_force)
+{
+	sg_rand->set_seed(7);
+
+	// enough vectors for the subtrees to be built in parallel
+	SGMatrix<float64_t> data(3,5000);
+	sg_rand->fill_array_oo(data.matrix,data.num_rows*data.num_cols);
+	CDenseFeatures<float64_t>* feats=new CDenseFeatures<float64_t>(data);
+
+	SGMatrix<float64_t> test_data(3,200);
+	sg_rand->fill_array_oo(test_data.matrix,test_data.num_rows*test_data.num_cols);
+	CDenseFeatures<float64_t>* qfeats=new CDenseFeatures<float64_t>(test_data);
+
+	CBallTree* tree=new CBallTree(5);
+	tree->parallel->set_num_threads(4);
+	tree->build_tree(feats);
+
+	// every vector of a node is within its bounding box
+	for (index_t i=0;i<tree->get_num_nodes();i++)
+	{
+		NbodyTreeNodeData node=tree->get_node_data(i);
+		SGVector<index_t> ids=tree->get_rearranged_vector_ids();
+		for (index_t j=node.start_idx;j<=node.end_idx;j++)
+		{
+			for (index_t d=0;d<data.num_rows;d++)
+			{
+				EXPECT_LE(node.bbox_lower[d],data(d,ids[j]));
+				EXPECT_GE(node.bbox_upper[d],data(d,ids[j]));
+			}
+		}
+	}
+
+	int32_t k=5;
+	tree->query_knn(qfeats,k);
+	SGMatrix<index_t> ind=tree->get_knn_indices();
+	SGMatrix<float64_t> dists=tree->get_knn_dists();
+
+	SGVector<float64_t> brute_dists(data.num_cols);
+	SGVector<index_t> brute_ind(data.num_cols);
+	for (index_t i=0;i<test_data.num_cols;i++)
+	{
+		for (index_t j=0;j<data.num_cols;j++)
+		{
+			float64_t dist=0;
+			for (index_t d=0;d<data.num_rows;d++)
+				dist+=CMath::sq(data(d,j)-test_data(d,i));
+
+			brute_dists[j]=std::sqrt(dist);
+			brute_ind[j]=j;
+		}
+		CMath::qsort_index(brute_dists.vector,brute_ind.vector,brute_dists.vlen);
+
+		for (int32_t j=0;j<k;j++)
+		{
+			EXPECT_EQ(brute_ind[j],ind(j,i));
+			EXPECT_NEAR(brute_dists[j],dists(j,i),1e-12);
+		}
+	}
+
+	SG_UNREF(qfeats);
+	SG_UNREF(feats);
+	SG_UNREF(tree);
+}
@@ -153,6 +153,47 @@ TEST_F(RandomForest, classify_non_nominal_test)
 	SG_UNREF(eval);
 }
 
+TEST_F(RandomForest, seeded_independent_of_threads)
+{
+	SGVector<float64_t> expected;
+	float64_t expected_oob_error = 0;
+	for (auto num_threads : {1, 4})
+	{
+		CRandomForest* c = new CRandomForest(
+		    weather_features_train, weather_labels_train, 50, 2);
+		c->set_feature_types(weather_ft);
+		c->set_combination_rule(new CMajorityVote());
+		c->set_rand_seed(12345);
+		c->parallel->set_num_threads(num_threads);
+		c->train(weather_features_train);
+
+		/* the global generator is not used */
+		sg_rand->set_seed(num_threads);
+
+		CMulticlassLabels* result =
+		    (CMulticlassLabels*)c->apply(weather_features_test);
+		CMulticlassAccuracy* eval = new CMulticlassAccuracy();
+		float64_t oob_error = c->get_oob_error(eval);
+		SGVector<float64_t> values = result->get_labels();
+
+		if (num_threads == 1)
+		{
+			expected = values;
+			expected_oob_error = oob_error;
+		}
+		else
+		{
+			for (index_t i = 0; i < values.vlen; i++)
+				EXPECT_EQ(expected[i], values[i]);
+			EXPECT_EQ(expected_oob_error, oob_error);
+		}
+
+		SG_UNREF(result);
+		SG_UNREF(c);
+		SG_UNREF(eval);
+	}
+}
+
 TEST_F(RandomForest, score_compare_sklearn_toydata)
 {
 	sg_rand->set_seed(1);
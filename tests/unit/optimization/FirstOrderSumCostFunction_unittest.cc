@@ -0,0 +1,156 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ */
+
+#include <gtest/gtest.h>
+#include <shogun/base/Parallel.h>
+#include <shogun/lib/SGMatrix.h>
+#include <shogun/mathematics/Math.h>
+#include <shogun/optimization/FirstOrderSumCostFunction.h>
+#include <shogun/optimization/lbfgs/LBFGSMinimizer.h>
+
+using namespace shogun;
+
+/** least squares \f$\sum_i (y_i-w^T x_i)^2\f$ */
+class SumLeastSquaresCostFunction : public FirstOrderSumCostFunction
+{
+public:
+	SumLeastSquaresCostFunction(SGMatrix<float64_t> X, SGVector<float64_t> y)
+		:FirstOrderSumCostFunction(), m_X(X), m_y(y), m_w(X.num_rows)
+	{
+		m_w.zero();
+	}
+
+	virtual index_t get_sample_size() { return m_y.vlen; }
+
+	virtual SGVector<float64_t> obtain_variable_reference() { return m_w; }
+
+	virtual const char* get_name() const { return "SumLeastSquaresCostFunction"; }
+
+protected:
+	virtual float64_t get_block_cost(index_t begin, index_t end)
+	{
+		float64_t cost=0;
+		for (index_t i=begin; i<end; i++)
+			cost+=CMath::sq(residual(i));
+		return cost;
+	}
+
+	virtual float64_t add_block_cost_and_gradient(index_t begin, index_t end,
+		SGVector<float64_t> gradient)
+	{
+		float64_t cost=0;
+		for (index_t i=begin; i<end; i++)
+		{
+			float64_t r=residual(i);
+			cost+=r*r;
+			for (index_t j=0; j<m_X.num_rows; j++)
+				gradient[j]-=2*r*m_X(j, i);
+		}
+		return cost;
+	}
+
+private:
+	float64_t residual(index_t i) const
+	{
+		float64_t r=m_y[i];
+		for (index_t j=0; j<m_X.num_rows; j++)
+			r-=m_w[j]*m_X(j, i);
+		return r;
+	}
+
+	SGMatrix<float64_t> m_X;
+	SGVector<float64_t> m_y;
+	SGVector<float64_t> m_w;
+};
+
+static void generate_least_squares(index_t dim, index_t num_samples,
+	SGMatrix<float64_t>& X, SGVector<float64_t>& y, SGVector<float64_t>& truth)
+{
+	X=SGMatrix<float64_t>(dim, num_samples);
+	y=SGVector<float64_t>(num_samples);
+	truth=SGVector<float64_t>(dim);
+	for (index_t j=0; j<dim; j++)
+		truth[j]=j+1;
+	for (index_t i=0; i<num_samples; i++)
+	{
+		y[i]=0;
+		for (index_t j=0; j<dim; j++)
+		{
+			X(j, i)=CMath::randn_double();
+			y[i]+=truth[j]*X(j, i);
+		}
+	}
+}
+
+TEST(FirstOrderSumCostFunction, cost_and_gradient)
+{
+	sg_rand->set_seed(3);
+	SGMatrix<float64_t> X;
+	SGVector<float64_t> y, truth;
+	generate_least_squares(4, 1000, X, y, truth);
+
+	SumLeastSquaresCostFunction* fun=new SumLeastSquaresCostFunction(X, y);
+	SG_REF(fun);
+	fun->set_min_block_size(64);
+	SGVector<float64_t> w=fun->obtain_variable_reference();
+	w.set_const(0.5);
+
+	float64_t expected_cost=0;
+	SGVector<float64_t> expected_gradient(w.vlen);
+	expected_gradient.zero();
+	for (index_t i=0; i<y.vlen; i++)
+	{
+		float64_t r=y[i];
+		for (index_t j=0; j<w.vlen; j++)
+			r-=w[j]*X(j, i);
+		expected_cost+=r*r;
+		for (index_t j=0; j<w.vlen; j++)
+			expected_gradient[j]-=2*r*X(j, i);
+	}
+
+	float64_t cost=fun->get_cost();
+	EXPECT_NEAR(cost, expected_cost, 1e-8*expected_cost);
+
+	SGVector<float64_t> gradient=fun->get_gradient();
+	SGVector<float64_t> fused_gradient(w.vlen);
+	float64_t fused_cost=fun->get_cost_and_gradient(fused_gradient);
+	EXPECT_EQ(fused_cost, cost);
+	for (index_t j=0; j<w.vlen; j++)
+	{
+		EXPECT_NEAR(gradient[j], expected_gradient[j], 1e-8);
+		EXPECT_EQ(fused_gradient[j], gradient[j]);
+	}
+
+	/* the blocks do not depend on the number of threads */
+	int32_t num_threads=fun->parallel->get_num_threads();
+	fun->parallel->set_num_threads(1);
+	SGVector<float64_t> sequential_gradient(w.vlen);
+	float64_t sequential_cost=fun->get_cost_and_gradient(sequential_gradient);
+	fun->parallel->set_num_threads(num_threads);
+	EXPECT_EQ(sequential_cost, cost);
+	for (index_t j=0; j<w.vlen; j++)
+		EXPECT_EQ(sequential_gradient[j], gradient[j]);
+
+	SG_UNREF(fun);
+}
+
+TEST(FirstOrderSumCostFunction, lbfgs_minimize)
+{
+	sg_rand->set_seed(5);
+	SGMatrix<float64_t> X;
+	SGVector<float64_t> y, truth;
+	generate_least_squares(5, 500, X, y, truth);
+
+	SumLeastSquaresCostFunction* fun=new SumLeastSquaresCostFunction(X, y);
+	fun->set_min_block_size(32);
+	SGVector<float64_t> w=fun->obtain_variable_reference();
+
+	FirstOrderMinimizer* opt=new CLBFGSMinimizer(fun);
+	float64_t cost=opt->minimize();
+	EXPECT_NEAR(cost, 0.0, 1e-6);
+	for (index_t j=0; j<w.vlen; j++)
+		EXPECT_NEAR(w[j], truth[j], 1e-5);
+
+	delete opt;
+}
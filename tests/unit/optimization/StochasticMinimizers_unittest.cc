@@ -34,6 +34,7 @@
 
 #include <shogun/optimization/L2Penalty.h>
 #include <shogun/optimization/SGDMinimizer.h>
+#include <shogun/optimization/SparseLeastSquaresCostFunction.h>
 #include <shogun/optimization/GradientDescendUpdater.h>
 #include <shogun/optimization/ConstLearningRate.h>
 #include <shogun/mathematics/eigen3.h>
@@ -51,6 +52,10 @@
 #include <shogun/optimization/ElasticNetPenalty.h>
 #include <shogun/optimization/SMIDASMinimizer.h>
 #include <shogun/optimization/PNormMappingFunction.h>
+#include <shogun/optimization/AdaGradUpdater.h>
+#include <shogun/mathematics/Math.h>
+#include <shogun/lib/exception/ShogunException.h>
+#include <algorithm>
 using namespace shogun;
 using namespace Eigen;
 
@@ -454,6 +459,57 @@ void RegressionFixture::init()
 	y[9]=30.801085;
 }
 
+/* uses the dense path of the minimizers */
+class DenseLeastSquaresCostFunction: public SparseLeastSquaresCostFunction
+{
+public:
+	virtual bool has_sparse_gradient() { return false; }
+	virtual const char* get_name() const { return "DenseLeastSquaresCostFunction"; }
+};
+
+/* sample gradients with an index beyond the variables */
+class InvalidIndexCostFunction: public SparseLeastSquaresCostFunction
+{
+public:
+	virtual SGSparseVector<float64_t> get_sparse_sample_gradient(index_t idx)
+	{
+		SGSparseVector<float64_t> result(1);
+		result.features[0].feat_index=obtain_variable_reference().vlen;
+		result.features[0].entry=1.0;
+		return result;
+	}
+	virtual const char* get_name() const { return "InvalidIndexCostFunction"; }
+};
+
+/* samples with a few non-zero features of a linear model */
+static void generate_sparse_regression(SGSparseMatrix<float64_t>& features,
+	SGVector<float64_t>& labels, index_t num_features, index_t num_vectors,
+	index_t num_entries)
+{
+	SGVector<float64_t> w(num_features);
+	for(index_t j=0; j<num_features; j++)
+		w[j]=CMath::randn_double();
+
+	features=SGSparseMatrix<float64_t>(num_features, num_vectors);
+	labels=SGVector<float64_t>(num_vectors);
+	for(index_t i=0; i<num_vectors; i++)
+	{
+		SGVector<index_t> indices(num_features);
+		indices.range_fill();
+		CMath::permute(indices);
+		std::sort(indices.vector, indices.vector+num_entries);
+
+		SGSparseVector<float64_t> x(num_entries);
+		for(index_t k=0; k<num_entries; k++)
+		{
+			x.features[k].feat_index=indices[k];
+			x.features[k].entry=CMath::randn_double();
+		}
+		features[i]=x;
+		labels[i]=x.dense_dot(1.0, w.vector, w.vlen, 0.0);
+	}
+}
+
 TEST(SGDMinimizer,test1)
 {
 	SGVector<float64_t> w(3);
@@ -1086,3 +1142,147 @@ TEST(SMIDASMinimizer, test1)
 
 	delete opt;
 }
+
+TEST(SGDMinimizer, sparse_gradient)
+{
+	sg_rand->set_seed(17);
+	SGSparseMatrix<float64_t> features;
+	SGVector<float64_t> labels;
+	generate_sparse_regression(features, labels, 100, 200, 5);
+
+	SGVector<float64_t> result[2];
+	for(index_t sparse=0; sparse<2; sparse++)
+	{
+		SparseLeastSquaresCostFunction* fun=sparse ?
+			new SparseLeastSquaresCostFunction() : new DenseLeastSquaresCostFunction();
+		fun->set_data(features, labels);
+
+		SGDMinimizer* opt=new SGDMinimizer(fun);
+		ConstLearningRate* rate=new ConstLearningRate();
+		rate->set_const_learning_rate(0.05);
+		opt->set_learning_rate(rate);
+		opt->set_gradient_updater(new GradientDescendUpdater());
+		opt->set_number_passes(3);
+		opt->minimize();
+
+		result[sparse]=fun->obtain_variable_reference();
+		delete opt;
+	}
+
+	// untouched coordinates do not move in plain gradient descend
+	for(index_t j=0; j<result[0].vlen; j++)
+		EXPECT_NEAR(result[1][j], result[0][j], 1e-12);
+}
+
+TEST(DescendUpdater, sparse_update_catch_up)
+{
+	const index_t num_variables=20;
+	const index_t num_steps=50;
+	const index_t num_entries=3;
+	sg_rand->set_seed(3);
+
+	for(index_t type=0; type<4; type++)
+	{
+		DescendUpdater* updaters[2];
+		for(index_t i=0; i<2; i++)
+		{
+			if(type<2)
+			{
+				GradientDescendUpdater* updater=new GradientDescendUpdater();
+				if(type==0)
+					updater->set_descend_correction(new StandardMomentumCorrection());
+				else
+					updater->set_descend_correction(new NesterovMomentumCorrection());
+				updaters[i]=updater;
+			}
+			else if(type==2)
+				updaters[i]=new RmsPropUpdater(0.1, 1e-6, 0.9);
+			else
+				updaters[i]=new AdaGradUpdater(0.1, 1e-6);
+			SG_REF(updaters[i]);
+		}
+
+		SGVector<float64_t> dense_variable(num_variables);
+		SGVector<float64_t> sparse_variable(num_variables);
+		for(index_t j=0; j<num_variables; j++)
+			dense_variable[j]=sparse_variable[j]=CMath::randn_double();
+
+		for(index_t step=0; step<num_steps; step++)
+		{
+			SGVector<index_t> indices(num_variables);
+			indices.range_fill();
+			CMath::permute(indices);
+
+			SGSparseVector<float64_t> direction(num_entries);
+			SGVector<float64_t> dense_direction(num_variables);
+			dense_direction.set_const(0.0);
+			for(index_t k=0; k<num_entries; k++)
+			{
+				direction.features[k].feat_index=indices[k];
+				direction.features[k].entry=CMath::randn_double();
+				dense_direction[indices[k]]=direction.features[k].entry;
+			}
+
+			updaters[0]->update_variable(dense_variable, dense_direction, 0.1);
+			updaters[1]->update_variable_sparse(sparse_variable, direction, 0.1);
+		}
+		updaters[1]->finish_sparse_update(sparse_variable);
+
+		for(index_t j=0; j<num_variables; j++)
+			EXPECT_NEAR(sparse_variable[j], dense_variable[j], 1e-10) << "updater " << type;
+
+		SG_UNREF(updaters[0]);
+		SG_UNREF(updaters[1]);
+	}
+}
+
+TEST(SGDMinimizer, hogwild)
+{
+	sg_rand->set_seed(5);
+	SGSparseMatrix<float64_t> features;
+	SGVector<float64_t> labels;
+	generate_sparse_regression(features, labels, 50, 1000, 5);
+
+	SparseLeastSquaresCostFunction* fun=new SparseLeastSquaresCostFunction();
+	fun->set_data(features, labels);
+	float64_t initial_cost=fun->get_cost();
+
+	SGDMinimizer* opt=new SGDMinimizer(fun);
+	opt->parallel->set_num_threads(4);
+	ConstLearningRate* rate=new ConstLearningRate();
+	rate->set_const_learning_rate(0.02);
+	opt->set_learning_rate(rate);
+	opt->set_gradient_updater(new GradientDescendUpdater());
+	opt->set_number_passes(20);
+	opt->set_hogwild(true);
+	float64_t cost=opt->minimize();
+
+	// noise free labels are fitted
+	EXPECT_LT(cost, 1e-3*initial_cost);
+	EXPECT_EQ(opt->get_iteration_counter(), 20*labels.vlen);
+
+	delete opt;
+}
+
+TEST(SGDMinimizer, hogwild_invalid_index)
+{
+	sg_rand->set_seed(5);
+	SGSparseMatrix<float64_t> features;
+	SGVector<float64_t> labels;
+	generate_sparse_regression(features, labels, 10, 100, 2);
+
+	InvalidIndexCostFunction* fun=new InvalidIndexCostFunction();
+	fun->set_data(features, labels);
+
+	SGDMinimizer* opt=new SGDMinimizer(fun);
+	opt->parallel->set_num_threads(4);
+	ConstLearningRate* rate=new ConstLearningRate();
+	rate->set_const_learning_rate(0.02);
+	opt->set_learning_rate(rate);
+	opt->set_gradient_updater(new GradientDescendUpdater());
+	opt->set_number_passes(1);
+	opt->set_hogwild(true);
+	EXPECT_THROW(opt->minimize(), ShogunException);
+
+	delete opt;
+}
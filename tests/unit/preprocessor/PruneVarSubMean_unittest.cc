@@ -0,0 +1,61 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ */
+
+#include <gtest/gtest.h>
+#include <shogun/mathematics/Math.h>
+#include <shogun/preprocessor/PruneVarSubMean.h>
+
+using namespace shogun;
+
+TEST(PruneVarSubMean, transform)
+{
+	index_t num_features = 4;
+	index_t num_vectors = 3000;
+	SGMatrix<float64_t> m(num_features, num_vectors);
+	sg_rand->set_seed(12345);
+	for (auto i : range(num_vectors))
+	{
+		m(0, i) = sg_rand->std_normal_distrib();
+		m(1, i) = 1.0;
+		m(2, i) = 10.0 * sg_rand->std_normal_distrib() + 5.0;
+		m(3, i) = 0.1 * sg_rand->std_normal_distrib();
+	}
+	auto em = m.clone();
+
+	auto feats = some<CDenseFeatures<float64_t>>(m);
+	auto preproc = some<CPruneVarSubMean>(true);
+	preproc->fit(feats);
+
+	/* per feature mean and standard deviation */
+	SGVector<float64_t> mean(num_features), stddev(num_features);
+	for (auto j : range(num_features))
+	{
+		SGVector<float64_t> row = em.get_row_vector(j);
+		mean[j] = SGVector<float64_t>::sum(row) / num_vectors;
+		float64_t var = 0;
+		for (auto i : range(num_vectors))
+			var += CMath::sq(row[i] - mean[j]);
+		stddev[j] = std::sqrt(var / num_vectors);
+	}
+
+	feats =
+	    wrap(preproc->transform(feats)->as<CDenseFeatures<float64_t>>());
+
+	/* pruning is done in place */
+	EXPECT_EQ(m.matrix, feats->get_feature_matrix().matrix);
+
+	/* the constant feature is removed */
+	index_t kept[] = {0, 2, 3};
+	ASSERT_EQ(feats->get_num_features(), 3);
+	ASSERT_EQ(feats->get_num_vectors(), num_vectors);
+	for (auto i : range(num_vectors))
+	{
+		SGVector<float64_t> vec = feats->get_feature_vector(i);
+		for (auto j : range(3))
+		{
+			float64_t e = (em(kept[j], i) - mean[kept[j]]) / stddev[kept[j]];
+			EXPECT_NEAR(e, vec[j], 1e-10);
+		}
+	}
+}
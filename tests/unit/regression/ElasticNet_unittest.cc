@@ -0,0 +1,194 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ */
+
+#include <gtest/gtest.h>
+#include <shogun/base/some.h>
+#include <shogun/features/DenseFeatures.h>
+#include <shogun/features/SparseFeatures.h>
+#include <shogun/labels/RegressionLabels.h>
+#include <shogun/mathematics/Math.h>
+#include <shogun/mathematics/linalg/LinalgNamespace.h>
+#include <shogun/regression/ElasticNet.h>
+
+using namespace shogun;
+
+class ElasticNetTest : public ::testing::Test
+{
+protected:
+	ElasticNetTest()
+	    : features(Some<CDenseFeatures<float64_t>>::from_raw(nullptr)),
+	      labels(Some<CRegressionLabels>::from_raw(nullptr))
+	{
+	}
+
+	void SetUp()
+	{
+		sg_rand->set_seed(3);
+		data = SGMatrix<float64_t>(num_features, num_vectors);
+		data.zero();
+		y = SGVector<float64_t>(num_vectors);
+		for (auto i = 0; i < num_vectors; ++i)
+		{
+			// sparse data, the labels depend on the first three features
+			for (auto j = 0; j < num_features; ++j)
+			{
+				if (CMath::random(0.0, 1.0) < 0.3)
+					data(j, i) = CMath::randn_double();
+			}
+			y[i] = 3 * data(0, i) - 2 * data(1, i) + data(2, i) + 1 +
+			       0.1 * CMath::randn_double();
+		}
+
+		features = some<CDenseFeatures<float64_t>>(data);
+		labels = some<CRegressionLabels>(y);
+	}
+
+	/** checks the optimality conditions of the estimator of a lambda */
+	void expect_optimal(CElasticNet* machine, int32_t k, float64_t tolerance)
+	{
+		auto lambda = machine->get_lambdas()[k];
+		auto alpha = machine->get_l1_ratio();
+		auto w = machine->get_w_for_lambda(k);
+		auto b = machine->get_bias_for_lambda(k);
+
+		SGVector<float64_t> residual(num_vectors);
+		float64_t residual_sum = 0;
+		for (auto i = 0; i < num_vectors; ++i)
+		{
+			residual[i] = y[i] - b;
+			for (auto j = 0; j < num_features; ++j)
+				residual[i] -= w[j] * data(j, i);
+			residual_sum += residual[i];
+		}
+		EXPECT_NEAR(residual_sum / num_vectors, 0, tolerance);
+
+		for (auto j = 0; j < num_features; ++j)
+		{
+			float64_t corr = 0;
+			for (auto i = 0; i < num_vectors; ++i)
+				corr += data(j, i) * residual[i];
+			corr /= num_vectors;
+
+			if (w[j] != 0)
+			{
+				EXPECT_NEAR(
+				    corr,
+				    lambda * (alpha * CMath::sign(w[j]) + (1 - alpha) * w[j]),
+				    tolerance)
+				    << "for lambda " << k << " and feature " << j;
+			}
+			else
+				EXPECT_LE(CMath::abs(corr), lambda * alpha + tolerance);
+		}
+	}
+
+	const int32_t num_features = 20;
+	const int32_t num_vectors = 100;
+	SGMatrix<float64_t> data;
+	SGVector<float64_t> y;
+	Some<CDenseFeatures<float64_t>> features;
+	Some<CRegressionLabels> labels;
+};
+
+TEST_F(ElasticNetTest, lasso_path)
+{
+	auto lasso = some<CElasticNet>(1.0);
+	lasso->set_num_lambdas(20);
+	lasso->set_epsilon(1e-12);
+	lasso->set_labels(labels);
+	lasso->train(features);
+
+	auto lambdas = lasso->get_lambdas();
+	ASSERT_EQ(lambdas.vlen, 20);
+	ASSERT_EQ(lasso->get_path_size(), 20);
+	for (auto k = 1; k < lambdas.vlen; ++k)
+		EXPECT_LT(lambdas[k], lambdas[k - 1]);
+	EXPECT_NEAR(lambdas[19], lambdas[0] * lasso->get_lambda_min_ratio(), 1e-12);
+
+	// the largest lambda sets all the weights to zero
+	auto w = lasso->get_w_for_lambda(0);
+	for (auto j = 0; j < num_features; ++j)
+		EXPECT_EQ(w[j], 0);
+	EXPECT_NEAR(lasso->get_bias_for_lambda(0), linalg::mean(y), 1e-12);
+
+	for (auto k = 0; k < lasso->get_path_size(); ++k)
+		expect_optimal(lasso, k, 1e-5);
+
+	// the machine has the estimator of the smallest lambda, which recovers
+	// the features the labels depend on
+	w = lasso->get_w();
+	EXPECT_NEAR(w[0], 3, 0.1);
+	EXPECT_NEAR(w[1], -2, 0.1);
+	EXPECT_NEAR(w[2], 1, 0.1);
+	EXPECT_NEAR(lasso->get_bias(), 1, 0.1);
+}
+
+TEST_F(ElasticNetTest, elastic_net_path)
+{
+	auto elastic_net = some<CElasticNet>(0.5);
+	SGVector<float64_t> lambdas(3);
+	lambdas[0] = 0.01;
+	lambdas[1] = 1;
+	lambdas[2] = 0.1;
+	elastic_net->set_lambdas(lambdas);
+	elastic_net->set_epsilon(1e-12);
+	elastic_net->set_labels(labels);
+	elastic_net->train(features);
+
+	// the lambdas are used in decreasing order
+	auto path_lambdas = elastic_net->get_lambdas();
+	ASSERT_EQ(path_lambdas.vlen, 3);
+	EXPECT_EQ(path_lambdas[0], 1);
+	EXPECT_EQ(path_lambdas[1], 0.1);
+	EXPECT_EQ(path_lambdas[2], 0.01);
+
+	for (auto k = 0; k < elastic_net->get_path_size(); ++k)
+		expect_optimal(elastic_net, k, 1e-5);
+
+	elastic_net->switch_w(1);
+	auto w = elastic_net->get_w();
+	auto expected = elastic_net->get_w_for_lambda(1);
+	for (auto j = 0; j < num_features; ++j)
+		EXPECT_EQ(w[j], expected[j]);
+	EXPECT_EQ(elastic_net->get_bias(), elastic_net->get_bias_for_lambda(1));
+}
+
+TEST_F(ElasticNetTest, sparse_features)
+{
+	auto dense = some<CElasticNet>(0.8);
+	dense->set_num_lambdas(10);
+	dense->set_labels(labels);
+	dense->train(features);
+
+	auto sparse_features = some<CSparseFeatures<float64_t>>(features);
+	auto sparse = some<CElasticNet>(0.8);
+	sparse->set_num_lambdas(10);
+	sparse->set_labels(labels);
+	sparse->train(sparse_features);
+
+	ASSERT_EQ(sparse->get_path_size(), dense->get_path_size());
+	for (auto k = 0; k < dense->get_path_size(); ++k)
+	{
+		EXPECT_NEAR(sparse->get_lambdas()[k], dense->get_lambdas()[k], 1e-12);
+		auto expected = dense->get_w_for_lambda(k);
+		auto w = sparse->get_w_for_lambda(k);
+		for (auto j = 0; j < num_features; ++j)
+			EXPECT_NEAR(w[j], expected[j], 1e-8);
+		EXPECT_NEAR(
+		    sparse->get_bias_for_lambda(k), dense->get_bias_for_lambda(k),
+		    1e-8);
+	}
+}
+
+TEST_F(ElasticNetTest, without_bias)
+{
+	auto lasso = some<CElasticNet>(1.0);
+	lasso->set_use_bias(false);
+	lasso->set_num_lambdas(5);
+	lasso->set_labels(labels);
+	lasso->train(features);
+
+	for (auto k = 0; k < lasso->get_path_size(); ++k)
+		EXPECT_EQ(lasso->get_bias_for_lambda(k), 0);
+}
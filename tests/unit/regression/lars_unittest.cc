@@ -29,6 +29,7 @@
 */
 
 #include <gtest/gtest.h>
+#include <shogun/base/some.h>
 #include <shogun/features/DenseFeatures.h>
 #include <shogun/lib/SGMatrix.h>
 #include <shogun/regression/LeastAngleRegression.h>
@@ -495,3 +496,34 @@ TEST(LeastAngleRegression, early_stop_l1_norm)
 	SG_UNREF(features);
 	SG_UNREF(labels);
 }
+
+TEST(LeastAngleRegression, precompute_gram)
+{
+	SGMatrix<float64_t> data(3,5);
+	SGVector<float64_t> lab(5);
+	generate_data_n_greater_d(data, lab);
+
+	auto features=some<CDenseFeatures<float64_t>>(data);
+	auto labels=some<CRegressionLabels>(lab);
+
+	for (auto lasso : {true, false})
+	{
+		auto lars=some<CLeastAngleRegression>(lasso);
+		lars->set_labels(labels);
+		lars->train(features);
+
+		auto gram_lars=some<CLeastAngleRegression>(lasso);
+		gram_lars->set_precompute_gram(true);
+		gram_lars->set_labels(labels);
+		gram_lars->train(features);
+
+		ASSERT_EQ(gram_lars->get_path_size(), lars->get_path_size());
+		for (int32_t i=0; i<lars->get_path_size(); i++)
+		{
+			SGVector<float64_t> expected=lars->get_w_for_var(i);
+			SGVector<float64_t> w=gram_lars->get_w_for_var(i);
+			for (int32_t j=0; j<w.vlen; j++)
+				EXPECT_NEAR(w[j], expected[j], 1e-10);
+		}
+	}
+}